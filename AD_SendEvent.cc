@@ -9,6 +9,8 @@
 #include "ns3/core-module.h"
 
 #include "AD_SendEvent.h"
+#include "EEBTPProfiler.h"
+#include "EEBTPCausalGraph.h"
 
 namespace ns3
 {
@@ -25,6 +27,9 @@ namespace ns3
 
 	void ADSendEvent::Notify()
 	{
+		EEBTP_PROFILE_SCOPE("ADSendEvent::Notify");
+		if (EEBTPCausalGraph::isEnabled())
+			EEBTPCausalGraph::onTimerFired(Now().GetNanoSeconds(), this->prot->GetDevice()->GetNode()->GetId(), this);
 		this->prot->sendApplicationData(gs, seqNo);
 	}
 }
@@ -9,6 +9,7 @@
 #include "ns3/ptr.h"
 #include "ns3/packet.h"
 #include "ns3/integer.h"
+#include "ns3/simulator.h"
 
 #include "EEBTPDataHeader.h"
 #include "ApplicationDataHandler.h"
@@ -89,6 +90,7 @@ namespace ns3
 			else
 				NS_LOG_DEBUG("Received missing data packet with dSeqNo = " << header.GetSequenceNumber());
 
+			this->latency.record(Simulator::Now().GetNanoSeconds() - header.GetOriginTime());
 			return true;
 		}
 		return false;
@@ -133,4 +135,14 @@ namespace ns3
 	{
 		return this->packetCount;
 	}
+
+	const LatencyHistogram &ApplicationDataHandler::getLatency()
+	{
+		return this->latency;
+	}
+
+	void ApplicationDataHandler::getMemoryUsage(MemoryUsage &usage)
+	{
+		usage.bytes[MemoryUsage::APPLICATION_DATA] += sizeof(ApplicationDataHandler) + MemoryUsage::getBytes(this->missingSeqNos);
+	}
 }
@@ -13,6 +13,9 @@
 #include "ns3/object.h"
 #include "ns3/packet.h"
 
+#include "MemoryUsage.h"
+#include "LatencyHistogram.h"
+
 namespace ns3
 {
 	class ApplicationDataHandler : public Object
@@ -33,11 +36,17 @@ namespace ns3
 
 		uint32_t getPacketCount();
 
+		//Time from the initiator to this node of every packet delivered
+		const LatencyHistogram &getLatency();
+
+		void getMemoryUsage(MemoryUsage &usage);
+
 	private:
 		uint32_t currentSeqNo;
 		uint32_t packetCount;
 
 		std::vector<uint32_t> missingSeqNos;
+		LatencyHistogram latency;
 	};
 }
 
@@ -9,6 +9,8 @@
 #include "ns3/core-module.h"
 
 #include "CC_SendEvent.h"
+#include "EEBTPProfiler.h"
+#include "EEBTPCausalGraph.h"
 
 namespace ns3
 {
@@ -31,6 +33,9 @@ namespace ns3
 
 	void CCSendEvent::Notify()
 	{
+		EEBTP_PROFILE_SCOPE("CCSendEvent::Notify");
+		if (EEBTPCausalGraph::isEnabled())
+			EEBTPCausalGraph::onTimerFired(Now().GetNanoSeconds(), this->prot->GetDevice()->GetNode()->GetId(), this);
 		NS_LOG_DEBUG("[" << this->prot->GetDevice()->GetNode()->GetId() << " / " << Now() << "]: CCSendEvent fired with originator: " << this->originator << ", nP: " << this->newParent << ", oP: " << this->oldParent);
 		this->prot->Send(this->gs, this->originator, this->newParent, this->oldParent, this->seqNo, this->txPower, this);
 		this->counter++;
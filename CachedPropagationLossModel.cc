@@ -0,0 +1,211 @@
+/*
+ * CachedPropagationLossModel.cc
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include "float.h"
+#include "algorithm"
+#include "ns3/log.h"
+#include "ns3/double.h"
+
+#include "CachedPropagationLossModel.h"
+
+namespace ns3
+{
+	NS_LOG_COMPONENT_DEFINE("CachedPropagationLossModel");
+	NS_OBJECT_ENSURE_REGISTERED(CachedPropagationLossModel);
+
+	CachedPropagationLossModel::CachedPropagationLossModel()
+	{
+		this->maxLoss = 130;
+		this->cutoffRxPower = -1000;
+		this->valid = false;
+		this->givenLinks = false;
+		this->nEntries = 0;
+		this->nHits = 0;
+		this->nMisses = 0;
+	}
+
+	CachedPropagationLossModel::~CachedPropagationLossModel()
+	{
+	}
+
+	TypeId CachedPropagationLossModel::GetTypeId()
+	{
+		static TypeId tid = TypeId("ns3::CachedPropagationLossModel")
+								.SetParent<PropagationLossModel>()
+								.SetGroupName("Propagation")
+								.AddConstructor<CachedPropagationLossModel>()
+								.AddAttribute("MaxLoss",
+											  "Highest loss (dB) which is stored. Pairs with a higher loss are cut off.",
+											  DoubleValue(130),
+											  MakeDoubleAccessor(&CachedPropagationLossModel::maxLoss),
+											  MakeDoubleChecker<double>())
+								.AddAttribute("CutoffRxPower",
+											  "RX power (dBm) returned for pairs that have been cut off.",
+											  DoubleValue(-1000),
+											  MakeDoubleAccessor(&CachedPropagationLossModel::cutoffRxPower),
+											  MakeDoubleChecker<double>());
+		return tid;
+	}
+
+	TypeId CachedPropagationLossModel::GetInstanceTypeId() const
+	{
+		return GetTypeId();
+	}
+
+	void CachedPropagationLossModel::DoDispose()
+	{
+		this->model = 0;
+		this->mobilities.clear();
+		this->index.clear();
+		this->rows.clear();
+		PropagationLossModel::DoDispose();
+	}
+
+	void CachedPropagationLossModel::setModel(Ptr<PropagationLossModel> model)
+	{
+		this->model = model;
+		this->valid = false;
+	}
+
+	void CachedPropagationLossModel::addMobilityModel(Ptr<MobilityModel> mobility)
+	{
+		if (this->index.find(PeekPointer(mobility)) != this->index.end())
+			return;
+
+		this->index[PeekPointer(mobility)] = this->mobilities.size();
+		this->mobilities.push_back(mobility);
+		this->dirty.push_back(true);
+		this->valid = false;
+		mobility->TraceConnectWithoutContext("CourseChange", MakeCallback(&CachedPropagationLossModel::onCourseChange, this));
+	}
+
+	/*
+	 * Link known in advance, the indices are in the order of addMobilityModel()
+	 */
+	void CachedPropagationLossModel::addLink(uint32_t sender, uint32_t receiver, double loss)
+	{
+		if (this->rows.size() < this->mobilities.size())
+			this->rows.resize(this->mobilities.size());
+
+		this->rows[sender].push_back(Entry(receiver, loss));
+		this->givenLinks = true;
+		this->valid = false;
+	}
+
+	/*
+	 * Calculates the sparse loss matrix. The loss is calculated for 0 dBm, so
+	 * txPowerDbm - loss is the same value the wrapped model returns.
+	 */
+	void CachedPropagationLossModel::precompute()
+	{
+		NS_ASSERT_MSG(this->model != 0, "CachedPropagationLossModel needs a model to wrap");
+
+		//Already calculated, e.g. before the topology was forked for several protocol variants
+		if (this->valid)
+			return;
+
+		uint32_t n = this->mobilities.size();
+		if (this->givenLinks)
+		{
+			this->rows.resize(n);
+			this->dirty = std::vector<bool>(n, false);
+			this->nEntries = 0;
+			for (uint32_t i = 0; i < n; i++)
+			{
+				std::sort(this->rows[i].begin(), this->rows[i].end());
+				this->nEntries += this->rows[i].size();
+			}
+
+			this->valid = true;
+			NS_LOG_DEBUG("Using " << this->nEntries << " given links");
+			return;
+		}
+
+		this->rows = std::vector<std::vector<Entry>>(n);
+		this->dirty = std::vector<bool>(n, false);
+		this->nEntries = 0;
+
+		for (uint32_t i = 0; i < n; i++)
+		{
+			for (uint32_t j = 0; j < n; j++)
+			{
+				if (i == j)
+					continue;
+
+				double loss = -this->model->CalcRxPower(0, this->mobilities[i], this->mobilities[j]);
+				if (loss <= this->maxLoss)
+					this->rows[i].push_back(Entry(j, loss));
+			}
+			this->nEntries += this->rows[i].size();
+		}
+
+		this->valid = true;
+		NS_LOG_DEBUG("Cached " << this->nEntries << " of " << ((uint64_t)n * (n - 1)) << " links with a loss up to " << this->maxLoss << "dB");
+	}
+
+	void CachedPropagationLossModel::onCourseChange(Ptr<const MobilityModel> mobility)
+	{
+		std::unordered_map<const MobilityModel *, uint32_t>::iterator it = this->index.find(PeekPointer(mobility));
+		if (it != this->index.end() && it->second < this->dirty.size())
+			this->dirty[it->second] = true;
+	}
+
+	int64_t CachedPropagationLossModel::getIndex(Ptr<const MobilityModel> mobility) const
+	{
+		std::unordered_map<const MobilityModel *, uint32_t>::const_iterator it = this->index.find(PeekPointer(mobility));
+		if (it == this->index.end())
+			return -1;
+		return it->second;
+	}
+
+	double CachedPropagationLossModel::DoCalcRxPower(double txPowerDbm, Ptr<MobilityModel> a, Ptr<MobilityModel> b) const
+	{
+		return this->calcRxPower(txPowerDbm, this->getIndex(a), a, b);
+	}
+
+	/*
+	 * The GridYansWifiChannel looks the sender up once per transmission, its
+	 * workers pass copies of the sender mobility model which are not registered
+	 */
+	double CachedPropagationLossModel::calcRxPower(double txPowerDbm, int64_t senderIndex, Ptr<MobilityModel> a, Ptr<MobilityModel> b) const
+	{
+		int64_t i = this->valid ? senderIndex : -1;
+		int64_t j = this->valid ? this->getIndex(b) : -1;
+		if (i < 0 || j < 0 || this->dirty[i] || this->dirty[j])
+		{
+			this->nMisses++;
+			return this->model->CalcRxPower(txPowerDbm, a, b);
+		}
+
+		this->nHits++;
+		const std::vector<Entry> &row = this->rows[i];
+		std::vector<Entry>::const_iterator it = std::lower_bound(row.begin(), row.end(), Entry(j, -DBL_MAX));
+		if (it != row.end() && it->first == j)
+			return txPowerDbm - it->second;
+
+		return this->cutoffRxPower;
+	}
+
+	int64_t CachedPropagationLossModel::DoAssignStreams(int64_t stream)
+	{
+		return this->model->AssignStreams(stream);
+	}
+
+	uint64_t CachedPropagationLossModel::getNEntries()
+	{
+		return this->nEntries;
+	}
+
+	uint64_t CachedPropagationLossModel::getNHits()
+	{
+		return this->nHits;
+	}
+
+	uint64_t CachedPropagationLossModel::getNMisses()
+	{
+		return this->nMisses;
+	}
+}
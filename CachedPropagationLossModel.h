@@ -0,0 +1,86 @@
+/*
+ * CachedPropagationLossModel.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#ifndef BROADCAST_CACHEDPROPAGATIONLOSSMODEL_H_
+#define BROADCAST_CACHEDPROPAGATIONLOSSMODEL_H_
+
+#include "atomic"
+#include "vector"
+#include "unordered_map"
+#include "ns3/mobility-model.h"
+#include "ns3/propagation-loss-model.h"
+
+namespace ns3
+{
+	/*
+	 * Caches the loss of a deterministic propagation loss model for static nodes.
+	 *
+	 * precompute() (scheduled at the start of the simulation) calculates the
+	 * loss between all registered mobility models once with the wrapped model. Only pairs with a loss up to
+	 * 'MaxLoss' are stored (one sorted row per sender), all other pairs are
+	 * returned with 'CutoffRxPower'. MaxLoss has to be larger than the highest
+	 * TX power minus the lowest RX sensitivity, so that all cut pairs would be
+	 * dropped by the channel anyway.
+	 *
+	 * Instead the links can be given with addLink() (e.g. from a scenario
+	 * file), precompute() only sorts them then.
+	 *
+	 * A course change of a registered mobility model invalidates its row and
+	 * column: the pairs of this node are calculated by the wrapped model again
+	 * until precompute() is called. Unknown mobility models are always passed
+	 * to the wrapped model.
+	 */
+	class CachedPropagationLossModel : public PropagationLossModel
+	{
+	public:
+		CachedPropagationLossModel();
+		virtual ~CachedPropagationLossModel();
+
+		static TypeId GetTypeId();
+		virtual TypeId GetInstanceTypeId() const;
+
+		void setModel(Ptr<PropagationLossModel> model);
+		void addMobilityModel(Ptr<MobilityModel> mobility);
+		void addLink(uint32_t sender, uint32_t receiver, double loss);
+		void precompute();
+
+		void onCourseChange(Ptr<const MobilityModel> mobility);
+
+		//Index of a registered mobility model, -1 if it is unknown
+		int64_t getIndex(Ptr<const MobilityModel> mobility) const;
+		//CalcRxPower() with the index of the sender a already looked up
+		double calcRxPower(double txPowerDbm, int64_t senderIndex, Ptr<MobilityModel> a, Ptr<MobilityModel> b) const;
+
+		uint64_t getNEntries();
+		uint64_t getNHits();
+		uint64_t getNMisses();
+
+	private:
+		typedef std::pair<uint32_t, double> Entry;
+
+		Ptr<PropagationLossModel> model;
+		double maxLoss;
+		double cutoffRxPower;
+
+		bool valid;
+		bool givenLinks;
+		std::vector<Ptr<MobilityModel>> mobilities;
+		std::unordered_map<const MobilityModel *, uint32_t> index;
+		std::vector<std::vector<Entry>> rows;
+		std::vector<bool> dirty;
+
+		uint64_t nEntries;
+		//Atomic since the GridYansWifiChannel may call from several threads
+		mutable std::atomic<uint64_t> nHits;
+		mutable std::atomic<uint64_t> nMisses;
+
+		virtual double DoCalcRxPower(double txPowerDbm, Ptr<MobilityModel> a, Ptr<MobilityModel> b) const;
+		virtual int64_t DoAssignStreams(int64_t stream);
+		virtual void DoDispose();
+	};
+}
+
+#endif /* BROADCAST_CACHEDPROPAGATIONLOSSMODEL_H_ */
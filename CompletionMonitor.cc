@@ -0,0 +1,142 @@
+/*
+ * CompletionMonitor.cc
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+#include "GameState.h"
+#include "EEBTProtocol.h"
+#include "CompletionMonitor.h"
+#include "ApplicationDataHandler.h"
+
+namespace ns3
+{
+	NS_LOG_COMPONENT_DEFINE("CompletionMonitor");
+	NS_OBJECT_ENSURE_REGISTERED(CompletionMonitor);
+
+	CompletionMonitor::CompletionMonitor()
+	{
+		this->gid = 0;
+		this->lastFrames = 0;
+		this->complete = false;
+	}
+
+	CompletionMonitor::~CompletionMonitor()
+	{
+	}
+
+	TypeId CompletionMonitor::GetTypeId()
+	{
+		static TypeId tid = TypeId("ns3::CompletionMonitor").SetParent<Object>().AddConstructor<CompletionMonitor>();
+		return tid;
+	}
+
+	TypeId CompletionMonitor::GetInstanceTypeId() const
+	{
+		return GetTypeId();
+	}
+
+	void CompletionMonitor::DoDispose()
+	{
+		Simulator::Cancel(this->checkEvent);
+		this->devices = NetDeviceContainer();
+		Object::DoDispose();
+	}
+
+	void CompletionMonitor::setup(NetDeviceContainer devices, uint64_t gid, Time interval, Time quietTime)
+	{
+		this->devices = devices;
+		this->gid = gid;
+		this->interval = interval;
+		this->quietTime = quietTime;
+	}
+
+	/*
+	 * Starts the checks, 'limit' is the time limit of the simulation
+	 */
+	void CompletionMonitor::start(Time limit)
+	{
+		this->limit = limit;
+		this->lastFrames = 0;
+		this->lastActivity = Now();
+		this->complete = false;
+		this->checkEvent = Simulator::Schedule(this->interval, &CompletionMonitor::check, this);
+	}
+
+	void CompletionMonitor::check()
+	{
+		uint64_t frames = 0;
+		uint32_t delivered = 0, nodes = 0;
+		bool done = this->isBroadcastComplete(&frames, &delivered, &nodes);
+
+		if (frames != this->lastFrames)
+		{
+			this->lastFrames = frames;
+			this->lastActivity = Now();
+		}
+
+		if (done && Now() - this->lastActivity >= this->quietTime)
+		{
+			this->complete = true;
+			this->completionTime = Now();
+			NS_LOG_DEBUG("Broadcast complete at " << Now() << ", last frame activity at " << this->lastActivity << ", " << delivered << " of " << nodes << " nodes received all packets");
+			Simulator::Stop();
+			return;
+		}
+
+		if (Now() + this->interval < this->limit)
+			this->checkEvent = Simulator::Schedule(this->interval, &CompletionMonitor::check, this);
+	}
+
+	/*
+	 * Checks the games and the application data. 'frames' is set to the number
+	 * of EEBTP frames sent and received so far, 'delivered' to the number of
+	 * 'nodes' which received all packets
+	 */
+	bool CompletionMonitor::isBroadcastComplete(uint64_t *frames, uint32_t *delivered, uint32_t *nodes)
+	{
+		bool done = true;
+		for (NetDeviceContainer::Iterator i = this->devices.Begin(); i != this->devices.End(); i++)
+		{
+			Ptr<EEBTProtocol> proto = (*i)->GetObject<EEBTProtocol>();
+			if (proto == 0 || !proto->hasGameState(this->gid))
+				continue;
+
+			Ptr<EEBTPPacketManager> pm = proto->getPacketManager();
+			for (uint8_t ft = 0; ft < 8; ft++)
+				*frames += pm->getFrameTypeSent(this->gid, ft) + pm->getFrameTypeRecv(this->gid, ft);
+
+			Ptr<GameState> gs = proto->getGameState(this->gid);
+			(*nodes)++;
+			if (gs->isInitiator() || (int)gs->getApplicationDataHandler()->getPacketCount() >= proto->maxPackets)
+				(*delivered)++;
+
+			if (!gs->gameFinished())
+				done = false;
+			else if (gs->isInitiator() && gs->hasChilds() && proto->getSendCounter() < proto->maxPackets)
+				done = false;
+		}
+		return done;
+	}
+
+	bool CompletionMonitor::isComplete()
+	{
+		return this->complete;
+	}
+
+	Time CompletionMonitor::getCompletionTime()
+	{
+		return this->completionTime;
+	}
+
+	//Time between the early stop and the time limit
+	Time CompletionMonitor::getIdleTime()
+	{
+		if (!this->complete)
+			return Seconds(0);
+		return this->limit - this->completionTime;
+	}
+}
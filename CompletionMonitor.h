@@ -0,0 +1,70 @@
+/*
+ * CompletionMonitor.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#ifndef BROADCAST_COMPLETIONMONITOR_H_
+#define BROADCAST_COMPLETIONMONITOR_H_
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/net-device-container.h"
+
+namespace ns3
+{
+	/*
+	 * Stops the simulation as soon as an EEBTP broadcast is complete.
+	 *
+	 * Every 'interval' the monitor checks that
+	 * 	- every node with a GameState has finished its game
+	 * 	- the initiator has sent all 'maxPackets' application data packets (or
+	 * 		has no children and will never send any)
+	 * 	- no EEBTP frame was sent or received in the whole network for
+	 * 		'quietTime'. The packet counts alone are not enough: nodes which
+	 * 		miss packets never get all of them and forwarded frames may still
+	 * 		be on the air when the last node got the last packet
+	 *
+	 * Nodes which never heard a frame have no GameState and are ignored. The
+	 * time limit of the simulation stays as a backstop. Everything after the
+	 * stop would have been idle time, see getIdleTime().
+	 */
+	class CompletionMonitor : public Object
+	{
+	public:
+		CompletionMonitor();
+		virtual ~CompletionMonitor();
+
+		static TypeId GetTypeId();
+		virtual TypeId GetInstanceTypeId() const;
+
+		void setup(NetDeviceContainer devices, uint64_t gid, Time interval, Time quietTime);
+		void start(Time limit);
+
+		bool isComplete();
+		Time getCompletionTime();
+		Time getIdleTime();
+
+	private:
+		NetDeviceContainer devices;
+		uint64_t gid;
+		Time interval;
+		Time quietTime;
+		Time limit;
+
+		uint64_t lastFrames;
+		Time lastActivity;
+
+		bool complete;
+		Time completionTime;
+		EventId checkEvent;
+
+		void check();
+		bool isBroadcastComplete(uint64_t *frames, uint32_t *delivered, uint32_t *nodes);
+
+		virtual void DoDispose();
+	};
+}
+
+#endif /* BROADCAST_COMPLETIONMONITOR_H_ */
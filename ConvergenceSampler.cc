@@ -0,0 +1,124 @@
+/*
+ * ConvergenceSampler.cc
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include "cfloat"
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/wifi-utils.h"
+
+#include "GameState.h"
+#include "EEBTProtocol.h"
+#include "CycleWatchDog.h"
+#include "ConvergenceSampler.h"
+
+namespace ns3
+{
+	NS_LOG_COMPONENT_DEFINE("ConvergenceSampler");
+	NS_OBJECT_ENSURE_REGISTERED(ConvergenceSampler);
+
+	ConvergenceSampler::ConvergenceSampler()
+	{
+		this->gid = 0;
+		this->lastParentChanges = 0;
+	}
+
+	ConvergenceSampler::~ConvergenceSampler()
+	{
+	}
+
+	TypeId ConvergenceSampler::GetTypeId()
+	{
+		static TypeId tid = TypeId("ns3::ConvergenceSampler").SetParent<Object>().AddConstructor<ConvergenceSampler>();
+		return tid;
+	}
+
+	TypeId ConvergenceSampler::GetInstanceTypeId() const
+	{
+		return GetTypeId();
+	}
+
+	void ConvergenceSampler::DoDispose()
+	{
+		Simulator::Cancel(this->sampleEvent);
+		this->devices = NetDeviceContainer();
+		Object::DoDispose();
+	}
+
+	void ConvergenceSampler::setup(NetDeviceContainer devices, uint64_t gid, Time interval)
+	{
+		this->devices = devices;
+		this->gid = gid;
+		this->interval = interval;
+	}
+
+	/*
+	 * Starts the sampling, 'limit' is the time limit of the simulation
+	 */
+	void ConvergenceSampler::start(Time limit)
+	{
+		this->limit = limit;
+		this->lastParentChanges = 0;
+		this->samples.clear();
+		this->sampleEvent = Simulator::Schedule(this->interval, &ConvergenceSampler::sample, this);
+	}
+
+	/*
+	 * Stops the sampling after the simulation, the state at the end is added
+	 * if the last sample is older (e.g. after an early stop)
+	 */
+	void ConvergenceSampler::finish()
+	{
+		Simulator::Cancel(this->sampleEvent);
+		if (this->samples.empty() || this->samples.back().time < Now())
+			this->record();
+	}
+
+	void ConvergenceSampler::sample()
+	{
+		this->record();
+		if (Now() + this->interval < this->limit)
+			this->sampleEvent = Simulator::Schedule(this->interval, &ConvergenceSampler::sample, this);
+	}
+
+	void ConvergenceSampler::record()
+	{
+		Sample s = Sample();
+		s.time = Now();
+
+		uint64_t parentChanges = 0;
+		Ptr<CycleWatchDog> cwd;
+		for (NetDeviceContainer::Iterator i = this->devices.Begin(); i != this->devices.End(); i++)
+		{
+			Ptr<EEBTProtocol> proto = (*i)->GetObject<EEBTProtocol>();
+			if (proto == 0)
+				continue;
+
+			cwd = proto->getCycleWatchDog();
+			s.framesInFlight += proto->getPacketManager()->getControlFramesInFlight();
+			if (!proto->hasGameState(this->gid))
+				continue;
+
+			Ptr<GameState> gs = proto->getGameState(this->gid);
+			if (gs->getHighestTxPower() > -FLT_MAX)
+				s.txPower += DbmToW(gs->getHighestTxPower());
+			if (gs->isInitiator() || gs->getParent() != 0)
+				s.connected++;
+			parentChanges += gs->getParentChanges();
+		}
+
+		s.parentChanges = parentChanges - this->lastParentChanges;
+		this->lastParentChanges = parentChanges;
+		if (cwd != 0)
+			s.liveCycles = cwd->getLiveCycles(this->gid);
+		this->samples.push_back(s);
+	}
+
+	std::vector<ConvergenceSampler::Sample> ConvergenceSampler::getSamples()
+	{
+		return this->samples;
+	}
+}
@@ -0,0 +1,72 @@
+/*
+ * ConvergenceSampler.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#ifndef BROADCAST_CONVERGENCESAMPLER_H_
+#define BROADCAST_CONVERGENCESAMPLER_H_
+
+#include "vector"
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/net-device-container.h"
+
+namespace ns3
+{
+	/*
+	 * Samples the state of the whole tree of a game every 'interval', to see
+	 * how fast a cycle prevention method converges to its final cost:
+	 * 	- txPower: sum of the highest TX powers (hTx) of all nodes in W
+	 * 	- connected: nodes with a parent, the initiator included
+	 * 	- parentChanges: parent changes of all nodes since the last sample
+	 * 	- liveCycles: cycles of the CycleWatchDog which are not broken yet
+	 * 	- framesInFlight: control frames queued, on air or waiting for the ACK
+	 *
+	 * Nodes which never heard a frame have no GameState and are ignored.
+	 */
+	class ConvergenceSampler : public Object
+	{
+	public:
+		struct Sample
+		{
+			Time time;
+			double txPower;
+			uint32_t connected;
+			uint32_t parentChanges;
+			uint32_t liveCycles;
+			uint32_t framesInFlight;
+		};
+
+		ConvergenceSampler();
+		virtual ~ConvergenceSampler();
+
+		static TypeId GetTypeId();
+		virtual TypeId GetInstanceTypeId() const;
+
+		void setup(NetDeviceContainer devices, uint64_t gid, Time interval);
+		void start(Time limit);
+		void finish();
+
+		std::vector<Sample> getSamples();
+
+	private:
+		NetDeviceContainer devices;
+		uint64_t gid;
+		Time interval;
+		Time limit;
+
+		uint64_t lastParentChanges;
+		std::vector<Sample> samples;
+		EventId sampleEvent;
+
+		void sample();
+		void record();
+
+		virtual void DoDispose();
+	};
+}
+
+#endif /* BROADCAST_CONVERGENCESAMPLER_H_ */
@@ -9,6 +9,7 @@
 
 #include "EEBTProtocol.h"
 #include "CycleWatchDog.h"
+#include "EEBTPProfiler.h"
 
 namespace ns3
 {
@@ -18,6 +19,7 @@ namespace ns3
 	CycleWatchDog::CycleWatchDog()
 	{
 		this->uniqueCycles = 0;
+		this->eventTrace = 0;
 	}
 
 	CycleWatchDog::~CycleWatchDog()
@@ -44,6 +46,7 @@ namespace ns3
 
 	void CycleWatchDog::checkForCycles(uint64_t gid, Ptr<NetDevice> device)
 	{
+		EEBTP_PROFILE_SCOPE("CycleWatchDog::checkForCycles");
 		Mac48Address currentParent = Mac48Address::GetBroadcast();
 		Ptr<EEBTProtocol> proto = device->GetObject<EEBTProtocol>();
 		Ptr<GameState> gs = proto->getGameState(gid);
@@ -98,6 +101,14 @@ namespace ns3
 					}
 					this->uniqueCycles++;
 
+					proto->cycleDetectedTrace(gid, ci->getNodes().size());
+					if (this->eventTrace != 0)
+					{
+						Ptr<EEBTPNode> parent = gs->getParent();
+						this->eventTrace->record(Now().GetNanoSeconds(), device->GetNode()->GetId(), EEBTPEventTrace::CYCLE_DETECTED, EEBTPEventTrace::NO_FRAME,
+												 (parent != 0) ? EEBTPEventTrace::getAddress(parent->getAddress()) : EEBTPEventTrace::BROADCAST, ci->getNodes().size(), 0, 0);
+					}
+
 					//Add the node to the list
 					ci->addNode(proto->GetDevice());
 
@@ -118,6 +129,52 @@ namespace ns3
 		return this->uniqueCycles;
 	}
 
+	/*
+	 * Number of cycles of the game which have not been broken yet. Every cycle
+	 * is listed at all of its nodes, it is only counted at the node which
+	 * detected it
+	 */
+	uint32_t CycleWatchDog::getLiveCycles(uint64_t gid)
+	{
+		uint32_t live = 0;
+		for (std::pair<const uint32_t, std::vector<Ptr<CycleInfo>>> &node : this->cycles[gid])
+		{
+			for (Ptr<CycleInfo> ci : node.second)
+			{
+				if (ci->getNodeId() == node.first && ci->getEndTime().GetNanoSeconds() == 0)
+					live++;
+			}
+		}
+		return live;
+	}
+
+	/*
+	 * Cycle lists of a node in all games, a CycleInfo is counted at the node
+	 * which detected it
+	 */
+	void CycleWatchDog::getMemoryUsage(uint32_t nodeId, MemoryUsage &usage)
+	{
+		for (std::pair<const uint64_t, std::map<uint32_t, std::vector<Ptr<CycleInfo>>>> &game : this->cycles)
+		{
+			std::map<uint32_t, std::vector<Ptr<CycleInfo>>>::iterator it = game.second.find(nodeId);
+			if (it == game.second.end())
+				continue;
+
+			usage.bytes[MemoryUsage::CYCLES] += MemoryUsage::TREE_NODE_SIZE + sizeof(*it) + MemoryUsage::getBytes(it->second);
+			for (Ptr<CycleInfo> ci : it->second)
+			{
+				if (ci->getNodeId() == nodeId)
+					usage.bytes[MemoryUsage::CYCLES] += sizeof(CycleInfo) + ci->getNodes().size() * sizeof(Ptr<NetDevice>);
+			}
+		}
+	}
+
+	//Every new cycle is recorded if a trace is set
+	void CycleWatchDog::setEventTrace(EEBTPEventTrace *eventTrace)
+	{
+		this->eventTrace = eventTrace;
+	}
+
 	NS_OBJECT_ENSURE_REGISTERED(CycleInfo);
 
 	CycleInfo::CycleInfo()
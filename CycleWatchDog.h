@@ -13,6 +13,9 @@
 #include "ns3/core-module.h"
 #include "ns3/network-module.h"
 
+#include "EEBTPEventTrace.h"
+#include "MemoryUsage.h"
+
 namespace ns3
 {
 	class CycleInfo : public Object
@@ -68,9 +71,15 @@ namespace ns3
 		std::vector<Ptr<CycleInfo>> getCycles(uint64_t gid, uint32_t nodeId);
 
 		uint32_t getUniqueCycles();
+		uint32_t getLiveCycles(uint64_t gid);
+
+		void getMemoryUsage(uint32_t nodeId, MemoryUsage &usage);
+
+		void setEventTrace(EEBTPEventTrace *eventTrace);
 
 	private:
 		uint32_t uniqueCycles;
+		EEBTPEventTrace *eventTrace;
 		NetDeviceContainer ndc;
 		std::map<uint64_t, std::map<uint32_t, std::vector<Ptr<CycleInfo>>>> cycles;
 	};
@@ -0,0 +1,234 @@
+/*
+ * EEBTPCausalGraph.cc
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include "algorithm"
+
+#include "EEBTPCausalGraph.h"
+
+namespace ns3
+{
+	bool EEBTPCausalGraph::enabled = false;
+	uint32_t EEBTPCausalGraph::current = 0;
+	uint32_t EEBTPCausalGraph::lastFinished = 0;
+
+	//Frames are identified by the sender address (lower 48 bits) and the EEBTP sequence number
+	static inline uint64_t getFrameKey(uint64_t sender, uint16_t seqNo)
+	{
+		return (sender << 16) | seqNo;
+	}
+
+	std::vector<EEBTPCausalGraph::Action> &EEBTPCausalGraph::getActions()
+	{
+		static std::vector<Action> actions;
+		return actions;
+	}
+
+	std::unordered_map<uint64_t, uint32_t> &EEBTPCausalGraph::getFrames()
+	{
+		static std::unordered_map<uint64_t, uint32_t> frames;
+		return frames;
+	}
+
+	std::unordered_map<const void *, uint32_t> &EEBTPCausalGraph::getTimers()
+	{
+		static std::unordered_map<const void *, uint32_t> timers;
+		return timers;
+	}
+
+	void EEBTPCausalGraph::enable(bool enabled)
+	{
+		EEBTPCausalGraph::enabled = enabled;
+	}
+
+	//Forgets the actions of the last run
+	void EEBTPCausalGraph::reset()
+	{
+		EEBTPCausalGraph::getActions().clear();
+		EEBTPCausalGraph::getFrames().clear();
+		EEBTPCausalGraph::getTimers().clear();
+		EEBTPCausalGraph::current = 0;
+		EEBTPCausalGraph::lastFinished = 0;
+	}
+
+	//Returns the ID of the new action, IDs start at 1
+	uint32_t EEBTPCausalGraph::add(int64_t time, uint32_t node, uint8_t action, uint8_t frameType, uint32_t cause)
+	{
+		Action a;
+		a.time = time;
+		a.cause = cause;
+		a.node = node;
+		a.action = action;
+		a.frameType = frameType;
+
+		std::vector<Action> &actions = EEBTPCausalGraph::getActions();
+		actions.push_back(a);
+		return actions.size();
+	}
+
+	void EEBTPCausalGraph::onStart(int64_t time, uint32_t node)
+	{
+		if (!EEBTPCausalGraph::enabled)
+			return;
+		EEBTPCausalGraph::current = EEBTPCausalGraph::add(time, node, START, NO_FRAME, 0);
+	}
+
+	void EEBTPCausalGraph::onSend(int64_t time, uint32_t node, uint64_t sender, uint16_t seqNo, uint8_t frameType)
+	{
+		if (!EEBTPCausalGraph::enabled)
+			return;
+		EEBTPCausalGraph::getFrames()[getFrameKey(sender, seqNo)] = EEBTPCausalGraph::add(time, node, FRAME_SENT, frameType, EEBTPCausalGraph::current);
+	}
+
+	//Attempts of frames which were not sent by the protocol (e.g. before enable()) are ignored
+	void EEBTPCausalGraph::onTxStart(int64_t time, uint32_t node, uint64_t sender, uint16_t seqNo, uint8_t frameType)
+	{
+		if (!EEBTPCausalGraph::enabled)
+			return;
+
+		std::unordered_map<uint64_t, uint32_t>::iterator it = EEBTPCausalGraph::getFrames().find(getFrameKey(sender, seqNo));
+		if (it == EEBTPCausalGraph::getFrames().end())
+			return;
+
+		uint8_t previous = EEBTPCausalGraph::getAction(it->second).action;
+		uint8_t action = (previous == TX_START || previous == TX_RETRY) ? TX_RETRY : TX_START;
+		it->second = EEBTPCausalGraph::add(time, node, action, frameType, it->second);
+	}
+
+	//The reception is the current action while the node handles it
+	void EEBTPCausalGraph::onReceive(int64_t time, uint32_t node, uint64_t sender, uint16_t seqNo, uint8_t frameType)
+	{
+		if (!EEBTPCausalGraph::enabled)
+			return;
+
+		std::unordered_map<uint64_t, uint32_t>::iterator it = EEBTPCausalGraph::getFrames().find(getFrameKey(sender, seqNo));
+		uint32_t cause = (it != EEBTPCausalGraph::getFrames().end()) ? it->second : 0;
+		EEBTPCausalGraph::current = EEBTPCausalGraph::add(time, node, FRAME_RECEIVED, frameType, cause);
+	}
+
+	void EEBTPCausalGraph::onTimerFired(int64_t time, uint32_t node, const void *timer)
+	{
+		if (!EEBTPCausalGraph::enabled)
+			return;
+
+		std::unordered_map<const void *, uint32_t>::iterator it = EEBTPCausalGraph::getTimers().find(timer);
+		EEBTPCausalGraph::onTimerFired(time, node, (it != EEBTPCausalGraph::getTimers().end()) ? it->second : (uint32_t)0);
+	}
+
+	//For timers which carry their cause themselves
+	void EEBTPCausalGraph::onTimerFired(int64_t time, uint32_t node, uint32_t cause)
+	{
+		if (!EEBTPCausalGraph::enabled)
+			return;
+		EEBTPCausalGraph::current = EEBTPCausalGraph::add(time, node, TIMER_FIRED, NO_FRAME, cause);
+	}
+
+	void EEBTPCausalGraph::onGameFinished(int64_t time, uint32_t node)
+	{
+		if (!EEBTPCausalGraph::enabled)
+			return;
+		EEBTPCausalGraph::lastFinished = EEBTPCausalGraph::add(time, node, GAME_FINISHED, NO_FRAME, EEBTPCausalGraph::current);
+	}
+
+	uint32_t EEBTPCausalGraph::getNActions()
+	{
+		return EEBTPCausalGraph::getActions().size();
+	}
+
+	const EEBTPCausalGraph::Action &EEBTPCausalGraph::getAction(uint32_t id)
+	{
+		return EEBTPCausalGraph::getActions()[id - 1];
+	}
+
+	/*
+	 * Steps from the first known cause to the last finished game, empty if no
+	 * game was finished
+	 */
+	std::vector<EEBTPCausalGraph::Step> EEBTPCausalGraph::getCriticalPath()
+	{
+		std::vector<Step> path;
+		for (uint32_t id = EEBTPCausalGraph::lastFinished; id != 0; id = EEBTPCausalGraph::getAction(id).cause)
+		{
+			Step s;
+			s.id = id;
+			s.action = EEBTPCausalGraph::getAction(id);
+			s.wait = (s.action.cause != 0) ? s.action.time - EEBTPCausalGraph::getAction(s.action.cause).time : 0;
+
+			switch (s.action.action)
+			{
+			case TIMER_FIRED:
+				s.category = TIMER;
+				break;
+			case TX_START:
+				s.category = MAC_ACCESS;
+				break;
+			case TX_RETRY:
+				s.category = MAC_RETRY;
+				break;
+			case FRAME_RECEIVED:
+				s.category = AIR;
+				break;
+			default:
+				s.category = DECISION;
+			}
+			path.push_back(s);
+		}
+		std::reverse(path.begin(), path.end());
+		return path;
+	}
+
+	EEBTPCausalGraph::Breakdown EEBTPCausalGraph::getBreakdown(const std::vector<Step> &path)
+	{
+		Breakdown b = Breakdown();
+		for (const Step &s : path)
+		{
+			b.time[s.category] += s.wait;
+			b.steps[s.category]++;
+		}
+		return b;
+	}
+
+	const char *EEBTPCausalGraph::getActionName(uint8_t action)
+	{
+		switch (action)
+		{
+		case START:
+			return "START";
+		case FRAME_SENT:
+			return "FRAME_SENT";
+		case TX_START:
+			return "TX_START";
+		case TX_RETRY:
+			return "TX_RETRY";
+		case FRAME_RECEIVED:
+			return "FRAME_RECEIVED";
+		case TIMER_FIRED:
+			return "TIMER_FIRED";
+		case GAME_FINISHED:
+			return "GAME_FINISHED";
+		default:
+			return "UNKNOWN";
+		}
+	}
+
+	const char *EEBTPCausalGraph::getCategoryName(uint8_t category)
+	{
+		switch (category)
+		{
+		case DECISION:
+			return "decision";
+		case TIMER:
+			return "timer";
+		case MAC_ACCESS:
+			return "mac_access";
+		case MAC_RETRY:
+			return "mac_retry";
+		case AIR:
+			return "air";
+		default:
+			return "unknown";
+		}
+	}
+}
@@ -0,0 +1,133 @@
+/*
+ * EEBTPCausalGraph.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#ifndef BROADCAST_EEBTPCAUSALGRAPH_H_
+#define BROADCAST_EEBTPCAUSALGRAPH_H_
+
+#include "vector"
+#include "cstdint"
+#include "unordered_map"
+
+namespace ns3
+{
+	/*
+	 * Happens-before graph of the protocol actions of a run, without ns-3
+	 * dependencies. Process wide like the EEBTPProfiler, disabled by default;
+	 * while disabled every hook returns after one check.
+	 *
+	 * Every action has the ID of the action which caused it (0: none):
+	 * 	- a received frame was caused by the last transmission attempt of the
+	 * 		frame (sender address and EEBTP sequence number), an attempt by the
+	 * 		previous attempt or the frame sent by the protocol
+	 * 	- a fired timer was caused by the action that was current when the
+	 * 		timer was scheduled (onTimerSet())
+	 * 	- everything else, e.g. frames sent and finished games, by the current
+	 * 		action: the reception or the timer the node is handling
+	 *
+	 * getCriticalPath() follows the causes back from the last finished game.
+	 * Every step is put into a category by the kind of its action, the wait is
+	 * the time since its cause.
+	 */
+	class EEBTPCausalGraph
+	{
+	public:
+		enum ACTION : uint8_t
+		{
+			START = 0,			//The initiator starts the broadcast
+			FRAME_SENT = 1,		//Handed to the MAC (or the link layer)
+			TX_START = 2,		//First transmission attempt
+			TX_RETRY = 3,		//MAC retransmission
+			FRAME_RECEIVED = 4, //Handed to the protocol
+			TIMER_FIRED = 5,
+			GAME_FINISHED = 6,
+			N_ACTIONS = 7
+		};
+
+		enum CATEGORY : uint8_t
+		{
+			DECISION = 0,	//START, FRAME_SENT, GAME_FINISHED (no simulated time)
+			TIMER = 1,		//Waiting for a timer: retransmissions, ND interval, data pacing
+			MAC_ACCESS = 2, //Queue and backoff before the first attempt
+			MAC_RETRY = 3,	//From one attempt to the next
+			AIR = 4,		//Last attempt until the reception
+			N_CATEGORIES = 5
+		};
+
+		struct Action
+		{
+			int64_t time; //Nanoseconds
+			uint32_t cause;
+			uint32_t node;
+			uint8_t action;
+			uint8_t frameType; //0xff if there is no frame
+		};
+
+		struct Step
+		{
+			uint32_t id;
+			Action action;
+			int64_t wait; //Time since the cause
+			uint8_t category;
+		};
+
+		struct Breakdown
+		{
+			int64_t time[N_CATEGORIES];
+			uint32_t steps[N_CATEGORIES];
+		};
+
+		static const uint8_t NO_FRAME = 0xff;
+
+		static void enable(bool enabled);
+		static inline bool isEnabled()
+		{
+			return EEBTPCausalGraph::enabled;
+		}
+		static void reset();
+
+		static inline uint32_t getCurrent()
+		{
+			return EEBTPCausalGraph::current;
+		}
+
+		//Remembers the current action as the cause of the timer
+		static inline void onTimerSet(const void *timer)
+		{
+			if (EEBTPCausalGraph::enabled)
+				EEBTPCausalGraph::getTimers()[timer] = EEBTPCausalGraph::current;
+		}
+
+		static void onStart(int64_t time, uint32_t node);
+		static void onSend(int64_t time, uint32_t node, uint64_t sender, uint16_t seqNo, uint8_t frameType);
+		static void onTxStart(int64_t time, uint32_t node, uint64_t sender, uint16_t seqNo, uint8_t frameType);
+		static void onReceive(int64_t time, uint32_t node, uint64_t sender, uint16_t seqNo, uint8_t frameType);
+		static void onTimerFired(int64_t time, uint32_t node, const void *timer);
+		static void onTimerFired(int64_t time, uint32_t node, uint32_t cause);
+		static void onGameFinished(int64_t time, uint32_t node);
+
+		static uint32_t getNActions();
+		static const Action &getAction(uint32_t id);
+
+		static std::vector<Step> getCriticalPath();
+		static Breakdown getBreakdown(const std::vector<Step> &path);
+
+		static const char *getActionName(uint8_t action);
+		static const char *getCategoryName(uint8_t category);
+
+	private:
+		static bool enabled;
+		static uint32_t current;
+		static uint32_t lastFinished;
+
+		static std::vector<Action> &getActions();
+		static std::unordered_map<uint64_t, uint32_t> &getFrames();
+		static std::unordered_map<const void *, uint32_t> &getTimers();
+
+		static uint32_t add(int64_t time, uint32_t node, uint8_t action, uint8_t frameType, uint32_t cause);
+	};
+}
+
+#endif /* BROADCAST_EEBTPCAUSALGRAPH_H_ */
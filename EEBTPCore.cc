@@ -0,0 +1,1485 @@
+/*
+ * EEBTPCore.cc
+ *
+ *  Created on: 19.10.2026
+ *
+ *  The state machine of EEBTProtocol and the state of its games, without ns-3:
+ *  	- addresses are the 48 bits of the MAC address in an uint64_t
+ *  	- the neighbors are owned by the Game (never removed)
+ *  	- retransmissions and neighbor discovery rounds are timers of the Transport
+ *  	- the ack state of a frame comes from Transport::getTxStatus()
+ */
+
+#include "cmath"
+#include "cfloat"
+#include "algorithm"
+
+#include "EEBTPCore.h"
+#include "EEBTPCore_Mutex.h"
+#include "EEBTPCore_SrcPath.h"
+
+namespace eebtp
+{
+	const uint32_t Core::MAX_UNCHANGED_ROUNDS = 10;
+
+	Config::Config()
+	{
+		this->maxAllowedTxPower = 23.0;
+		this->ackTimeout = 75000;					 //802.11a
+		this->neighborDiscoveryInterval = 18000000; //2000 slots of 9us
+		this->applicationDataInterval = 10000000;
+		this->maxPackets = 1000;
+		this->dataLength = 1000;
+
+		this->maxRetransmissions = 20;
+		this->ackPollFactor = 100;
+		this->ackRetryFactor = 200;
+		this->maxUnchangedRounds = Core::MAX_UNCHANGED_ROUNDS;
+		this->txPowerMargin = 5.0;
+	}
+
+	/*
+	 * Implementation Neighbor
+	 */
+	Neighbor::Neighbor(Address address, double power)
+	{
+		this->address = address;
+		this->parent = NO_ADDRESS;
+
+		this->finished = false;
+		this->reachPowerProblem = false;
+		this->reachPowerChanged = false;
+
+		this->noise = 0;
+		this->rxPower = 0;
+		this->reachPower = FLT_MAX;
+		this->highestMaxTxPower = power;
+		this->secondMaxTxPower = power;
+
+		this->connCounter = 0;
+
+		this->pathChanged = false;
+	}
+
+	//Same comparison as EEBTPNode::setReachPower()
+	void Neighbor::setReachPower(double reachPower)
+	{
+		if (this->reachPower < reachPower + 0.0000001 && this->reachPower > reachPower - 0.0000001)
+			this->reachPowerChanged = true;
+		this->reachPower = reachPower;
+	}
+
+	//Same comparison as EEBTPNode::setSrcPath()
+	void Neighbor::setSrcPath(const std::vector<Address> &path)
+	{
+		this->pathChanged = (path != this->srcPath);
+		this->srcPath = path;
+	}
+
+	bool Neighbor::isOnPath(Address address) const
+	{
+		return std::find(this->srcPath.begin(), this->srcPath.end(), address) != this->srcPath.end();
+	}
+
+	/*
+	 * Implementation Game
+	 */
+	Game::Game(bool initiator, uint64_t gid, Address myAddress)
+	{
+		this->gameId = gid;
+		this->myAddress = myAddress;
+		this->initiator = initiator;
+		this->finished = false;
+		this->finishTime = 0;
+
+		this->needCycleCheck = false;
+		this->doIncrementAfterConfirm = false;
+		this->unchangedCounter = 0;
+		this->rejectionCounter = 0;
+
+		this->highestTxPower = Core::wToDbm(0);
+		this->secondTxPower = Core::wToDbm(0);
+
+		this->parent = 0;
+		this->contactedParent = 0;
+
+		this->locked = false;
+		this->lockedBy = BROADCAST;
+		this->parentWaitingForLock = false;
+		this->parentWaitingLockOriginator = NO_ADDRESS;
+		this->newParentWaitingForLock = false;
+		this->newParentWaitingLockOriginator = NO_ADDRESS;
+
+		this->lastParentUpdate = 0;
+		this->emptyPathOnConnect = false;
+		this->parentUnchangedCounter = 0;
+
+		this->dataSeqNo = 0;
+		this->packetCount = 0;
+	}
+
+	/*
+	 * Sequence numbers by sender and frame type
+	 */
+	uint16_t Game::getLastSeqNo(Address sender, uint8_t ft)
+	{
+		return this->frameTypeCache[sender][ft];
+	}
+
+	std::array<uint16_t, N_FRAME_TYPES> &Game::getLastSeqNos(Address sender)
+	{
+		return this->frameTypeCache[sender];
+	}
+
+	bool Game::checkLastFrameType(Address sender, uint8_t ft, uint16_t seqNo)
+	{
+		return Core::isNewerSeqNo(seqNo, this->frameTypeCache[sender][ft]);
+	}
+
+	void Game::updateLastFrameType(Address sender, uint8_t ft, uint16_t seqNo)
+	{
+		this->frameTypeCache[sender][ft] = seqNo;
+	}
+
+	void Game::incrementUnchangedCounter()
+	{
+		if (!this->locked)
+			this->unchangedCounter++;
+	}
+
+	/*
+	 * NeighborList, kept in the order of the first contact
+	 */
+	Neighbor *Game::getNeighbor(Address address)
+	{
+		std::unordered_map<Address, Neighbor *>::iterator it = this->neighborIndex.find(address);
+		if (it != this->neighborIndex.end())
+			return it->second;
+		return 0;
+	}
+
+	Neighbor *Game::addNeighbor(Address address)
+	{
+		this->neighbors.push_back(std::unique_ptr<Neighbor>(new Neighbor(address, FLT_MIN)));
+		Neighbor *node = this->neighbors.back().get();
+		this->neighborIndex[address] = node;
+		return node;
+	}
+
+	uint32_t Game::getNNeighbors() const
+	{
+		return this->neighbors.size();
+	}
+
+	Neighbor *Game::getNeighbor(uint32_t index) const
+	{
+		if (index < this->neighbors.size())
+			return this->neighbors[index].get();
+		return 0;
+	}
+
+	/*
+	 * Searches the neighbor with the lowest cost of new connection
+	 * who is NOT blacklisted (GameState::getCheapestNeighbor())
+	 */
+	Neighbor *Game::getCheapestNeighbor()
+	{
+		double cost = FLT_MAX;
+		double threshold = Core::dbmToW(1.0);
+		Neighbor *neighbor = this->parent;
+
+		double connCost = this->getCostOfCurrentConn();
+		if (connCost <= 0.0001 && connCost >= -0.0001)
+		{
+			if (this->parent != 0)
+				cost = Core::dbmToW(this->parent->highestMaxTxPower) - Core::dbmToW(this->parent->secondMaxTxPower);
+
+			for (const std::unique_ptr<Neighbor> &n : this->neighbors)
+			{
+				Neighbor *node = n.get();
+				if (this->isBlacklisted(node->address, node->parent))
+					continue;
+				if (this->isChild(node))
+					continue;
+				if (node->reachPower > 23.0)
+					continue;
+				if (node == this->parent)
+					continue;
+				if (node->isOnPath(this->myAddress))
+					continue;
+				if (node->connCounter > 5)
+					continue;
+
+				double costOfNewConn = Core::dbmToW(node->reachPower) - Core::dbmToW(node->highestMaxTxPower);
+				costOfNewConn += threshold;
+
+				if (costOfNewConn <= cost)
+				{
+					neighbor = node;
+					cost = costOfNewConn;
+				}
+			}
+		}
+
+		return neighbor;
+	}
+
+	/*
+	 * ChildList
+	 */
+	bool Game::isChild(Address address) const
+	{
+		for (Neighbor *n : this->childList)
+			if (n->address == address)
+				return true;
+		return false;
+	}
+
+	bool Game::isChild(const Neighbor *node) const
+	{
+		for (Neighbor *n : this->childList)
+			if (n == node)
+				return true;
+		return false;
+	}
+
+	void Game::addChild(Neighbor *node)
+	{
+		if (!this->isChild(node))
+			this->childList.push_back(node);
+		this->findHighestTxPowers();
+	}
+
+	void Game::removeChild(Neighbor *node)
+	{
+		std::vector<Neighbor *>::iterator it = std::find(this->childList.begin(), this->childList.end(), node);
+		if (it != this->childList.end())
+			this->childList.erase(it);
+		this->findHighestTxPowers();
+	}
+
+	uint32_t Game::getNChilds() const
+	{
+		return this->childList.size();
+	}
+
+	Neighbor *Game::getChild(uint32_t index) const
+	{
+		return this->childList[index];
+	}
+
+	bool Game::allChildsFinished() const
+	{
+		for (Neighbor *n : this->childList)
+			if (!n->finished)
+				return false;
+		return true;
+	}
+
+	/*
+	 * Transmission power
+	 */
+	void Game::findHighestTxPowers()
+	{
+		double maxTx = Core::wToDbm(0);
+		double sMaxTx = Core::wToDbm(0);
+		for (Neighbor *child : this->childList)
+		{
+			double reachPower = child->reachPower;
+			if (reachPower > maxTx)
+			{
+				sMaxTx = maxTx;
+				maxTx = reachPower;
+			}
+			else if (sMaxTx < maxTx && reachPower > sMaxTx && reachPower < maxTx)
+				sMaxTx = reachPower;
+		}
+
+		this->highestTxPower = maxTx;
+		this->secondTxPower = sMaxTx;
+	}
+
+	double Game::getCostOfCurrentConn() const
+	{
+		if (this->parent != 0)
+			return Core::dbmToW(this->parent->highestMaxTxPower) - Core::dbmToW(this->parent->reachPower);
+		return 0;
+	}
+
+	/*
+	 * LastParentStack
+	 */
+	bool Game::hasLastParents() const
+	{
+		return !this->lastParents.empty();
+	}
+
+	Neighbor *Game::popLastParent()
+	{
+		if (this->lastParents.empty())
+			return 0;
+
+		Neighbor *node = this->lastParents.back();
+		node->connCounter = 0;
+		this->lastParents.pop_back();
+		return node;
+	}
+
+	Neighbor *Game::getLastParent() const
+	{
+		if (this->lastParents.empty())
+			return 0;
+		return this->lastParents.back();
+	}
+
+	void Game::pushLastParent(Neighbor *node)
+	{
+		for (std::vector<Neighbor *>::iterator it = this->lastParents.begin(); it != this->lastParents.end(); it++)
+		{
+			if ((*it) == node || (*it)->address == node->address)
+			{
+				(*it)->connCounter++;
+				this->lastParents.erase(it);
+				break;
+			}
+		}
+		this->lastParents.push_back(node);
+	}
+
+	void Game::clearLastParents()
+	{
+		for (Neighbor *node : this->lastParents)
+			node->connCounter = 0;
+		this->lastParents.clear();
+	}
+
+	/*
+	 * Blacklist management
+	 */
+	bool Game::isBlacklisted(Address node, Address parent)
+	{
+		std::unordered_map<Address, Address>::iterator it = this->blacklist.find(node);
+		return it != this->blacklist.end() && it->second == parent && parent != NO_ADDRESS;
+	}
+
+	bool Game::isBlacklisted(const Neighbor *node)
+	{
+		return this->isBlacklisted(node->address, node->parent);
+	}
+
+	void Game::updateBlacklist(Address node, Address parent)
+	{
+		this->blacklist[node] = parent;
+	}
+
+	void Game::resetBlacklist()
+	{
+		this->blacklist.clear();
+		for (const std::unique_ptr<Neighbor> &n : this->neighbors)
+			n->connCounter = 0;
+	}
+
+	/*
+	 * Locks of the child nodes (CoreMutex)
+	 */
+	bool Game::isLocked(Address child) const
+	{
+		return std::find(this->locks.begin(), this->locks.end(), child) != this->locks.end();
+	}
+
+	void Game::lock(Address child, bool l)
+	{
+		std::vector<Address>::iterator it = std::find(this->locks.begin(), this->locks.end(), child);
+		if (l && it == this->locks.end())
+			this->locks.push_back(child);
+		else if (!l && it != this->locks.end())
+			this->locks.erase(it);
+	}
+
+	uint32_t Game::getNChildsLocked() const
+	{
+		return this->locks.size();
+	}
+
+	void Game::resetChildLocks()
+	{
+		this->locks.clear();
+	}
+
+	/*
+	 * Events
+	 */
+	void Game::resetNeighborDiscoveryEvent()
+	{
+		if (this->ndEvent)
+			*this->ndEvent = true;
+		this->ndEvent.reset();
+	}
+
+	/*
+	 * Sliding window of the application data (ApplicationDataHandler)
+	 */
+	bool Game::acceptApplicationData(uint32_t seqNo)
+	{
+		if (seqNo > this->dataSeqNo + 16)
+			return false;
+
+		std::vector<uint32_t>::iterator it = std::find(this->missingSeqNos.begin(), this->missingSeqNos.end(), seqNo);
+		if (it != this->missingSeqNos.end())
+		{
+			this->missingSeqNos.erase(it);
+			return true;
+		}
+
+		if (this->dataSeqNo >= seqNo)
+			return false;
+
+		this->packetCount++;
+		this->dataSeqNo++;
+		while (this->dataSeqNo != seqNo)
+		{
+			this->missingSeqNos.push_back(this->dataSeqNo);
+			this->dataSeqNo++;
+		}
+		return true;
+	}
+
+	/*
+	 * Implementation Core
+	 */
+	Core *Core::create(uint8_t variant, Address myAddress, Transport *transport, Config config)
+	{
+		switch (variant)
+		{
+		case CYCLE_TEST_ASYNC:
+			return new Core(myAddress, transport, config);
+		case MUTEX:
+			return new CoreMutex(myAddress, transport, config);
+		case PATH_TO_SRC:
+			return new CoreSrcPath(myAddress, transport, config);
+		default:
+			return 0;
+		}
+	}
+
+	Core::Core(Address myAddress, Transport *transport, Config config)
+	{
+		this->myAddress = myAddress;
+		this->transport = transport;
+		this->listener = 0;
+		this->config = config;
+
+		this->seqNo = 0;
+		this->sendCounter = 0;
+	}
+
+	Core::~Core()
+	{
+		this->games.clear();
+		this->seqNoCache.clear();
+	}
+
+	uint8_t Core::getVariant() const
+	{
+		return CYCLE_TEST_ASYNC;
+	}
+
+	Address Core::getAddress() const
+	{
+		return this->myAddress;
+	}
+
+	const Config &Core::getConfig() const
+	{
+		return this->config;
+	}
+
+	void Core::setListener(Listener *listener)
+	{
+		this->listener = listener;
+	}
+
+	double Core::dbmToW(double dbm)
+	{
+		return std::pow(10.0, dbm / 10.0) / 1000.0;
+	}
+
+	double Core::wToDbm(double w)
+	{
+		return 10.0 * std::log10(w) + 30.0;
+	}
+
+	bool Core::isNewerSeqNo(uint16_t seqNo, uint16_t last)
+	{
+		if (seqNo == 0)
+			return false;
+		return last == 0 || (int16_t)(uint16_t)(seqNo - last) > 0;
+	}
+
+	/*
+	 * Games
+	 */
+	Game *Core::getGame(uint64_t gid)
+	{
+		for (const std::unique_ptr<Game> &game : this->games)
+			if (game->gameId == gid)
+				return game.get();
+
+		this->games.push_back(std::unique_ptr<Game>(new Game(false, gid, this->myAddress)));
+		return this->games.back().get();
+	}
+
+	Game *Core::initGame(uint64_t gid)
+	{
+		for (const std::unique_ptr<Game> &game : this->games)
+			if (game->gameId == gid)
+				return game.get();
+
+		this->games.push_back(std::unique_ptr<Game>(new Game(true, gid, this->myAddress)));
+		return this->games.back().get();
+	}
+
+	uint32_t Core::getNGames() const
+	{
+		return this->games.size();
+	}
+
+	Game *Core::getGameByIndex(uint32_t index) const
+	{
+		return this->games[index].get();
+	}
+
+	uint32_t Core::getSendCounter() const
+	{
+		return this->sendCounter;
+	}
+
+	uint16_t Core::nextSeqNo()
+	{
+		if (++this->seqNo == 0)
+			this->seqNo = 1;
+		return this->seqNo;
+	}
+
+	/*
+	 * Duplicate check of every sender (SeqNoCache). Instead of the last 1000
+	 * received sequence numbers, the received ones of the last WINDOW numbers
+	 * of the sender are kept as bits. A sender counts up and its frames arrive
+	 * in order, so a duplicate is always a retransmission of one of its last
+	 * frames. Older numbers count as new, like the ones that dropped out of
+	 * the 1000 entries of SeqNoCache.
+	 */
+	bool Core::checkForDuplicate(Address sender, uint16_t seqNo)
+	{
+		SeqNoCache &cache = this->seqNoCache[sender];
+		uint64_t bit = (uint64_t)1 << (seqNo % 64);
+		uint64_t &word = cache.received[(seqNo % SeqNoCache::WINDOW) / 64];
+
+		if (Core::isNewerSeqNo(seqNo, cache.newest))
+		{
+			//Move the window, the numbers in between were not received
+			uint16_t distance = seqNo - cache.newest;
+			if (cache.newest == 0 || distance >= SeqNoCache::WINDOW)
+				cache.received.fill(0);
+			else
+			{
+				for (uint16_t s = cache.newest + 1; s != seqNo; s++)
+					cache.received[(s % SeqNoCache::WINDOW) / 64] &= ~((uint64_t)1 << (s % 64));
+			}
+			cache.newest = seqNo;
+			word |= bit;
+			return false;
+		}
+
+		if ((uint16_t)(cache.newest - seqNo) >= SeqNoCache::WINDOW)
+			return false;
+		if (word & bit)
+			return true;
+		word |= bit;
+		return false;
+	}
+
+	double Core::calculateTxPower(double rxPower, double txPower, double noise, double minSNR)
+	{
+		double snr = rxPower - noise;
+		double neededPower = (txPower - (snr - minSNR));
+
+		if (neededPower <= this->config.maxAllowedTxPower)
+			neededPower = std::min(neededPower + this->config.txPowerMargin, this->config.maxAllowedTxPower);
+		return neededPower;
+	}
+
+	/*
+	 * Receive method (EEBTProtocol::Receive())
+	 */
+	void Core::receive(const Frame &frame, const RxInfo &rx)
+	{
+		double maxTx = this->config.maxAllowedTxPower;
+
+		if (this->checkForDuplicate(frame.sender, frame.seqNo))
+			return;
+
+		Game *gs = this->getGame(frame.gameId);
+		if (!this->acceptFrame(gs, frame))
+			return;
+
+		Neighbor *node = gs->getNeighbor(frame.sender);
+		if (node == 0)
+			node = gs->addNeighbor(frame.sender);
+
+		if (frame.frameType != APPLICATION_DATA)
+		{
+			node->parent = frame.parent;
+			node->setReachPower(this->calculateTxPower(rx.signal, frame.txPower, rx.noise, rx.minSnr));
+			node->rxPower = rx.signal;
+			node->noise = rx.noise;
+			node->highestMaxTxPower = frame.highestMaxTxPower;
+			node->secondMaxTxPower = frame.secondHighestMaxTxPower;
+			//A game is never reopened, a frame sent before the node finished may arrive after the END_OF_GAME we sent it
+			node->finished = node->finished || frame.gameFinished;
+			gs->findHighestTxPowers();
+
+			//If the node has a reachpower that is higher than our maximum allowed txPower
+			if (node->reachPower > maxTx)
+			{
+				node->reachPowerProblem = true;
+
+				//If this node is a child of us, handle as parent revocation and reject the connection
+				if (gs->isChild(node) && frame.frameType != PARENT_REVOCATION)
+				{
+					gs->updateLastFrameType(frame.sender, PARENT_REVOCATION, frame.seqNo);
+					this->handleParentRevocation(gs, node);
+					this->send(gs, CHILD_REJECTION, node->address, node->reachPower);
+					return;
+				}
+			}
+			else
+				node->reachPowerProblem = false;
+
+			//If node had receiving problems
+			if (frame.receivingProblems)
+			{
+				node->reachPowerProblem = true;
+
+				if (gs->isChild(node) && frame.frameType != PARENT_REVOCATION)
+				{
+					if (node->reachPower > maxTx)
+					{
+						gs->updateLastFrameType(frame.sender, PARENT_REVOCATION, frame.seqNo);
+						this->handleParentRevocation(gs, node);
+						this->send(gs, CHILD_REJECTION, node->address, node->reachPower);
+						return;
+					}
+					else
+					{
+						gs->unchangedCounter = 0;
+						this->send(gs, NEIGHBOR_DISCOVERY, BROADCAST, maxTx);
+					}
+				}
+			}
+		}
+
+		this->dispatch(gs, node, frame);
+
+		node->reachPowerChanged = false;
+		node->pathChanged = false;
+	}
+
+	//Only newer frames of a type are handled, cycle checks are always forwarded
+	bool Core::acceptFrame(Game *gs, const Frame &frame)
+	{
+		std::array<uint16_t, N_FRAME_TYPES> &lastSeqNos = gs->getLastSeqNos(frame.sender);
+		if (!Core::isNewerSeqNo(frame.seqNo, lastSeqNos[frame.frameType]) && frame.frameType != CYCLE_CHECK)
+			return false;
+
+		lastSeqNos[frame.frameType] = frame.seqNo;
+		return true;
+	}
+
+	void Core::dispatch(Game *gs, Neighbor *node, const Frame &frame)
+	{
+		switch (frame.frameType)
+		{
+		case CYCLE_CHECK:
+			this->handleCycleCheck(gs, node, frame);
+			break;
+		case NEIGHBOR_DISCOVERY:
+			this->handleNeighborDiscovery(gs, node);
+			break;
+		case CHILD_REQUEST:
+			this->handleChildRequest(gs, node);
+			break;
+		case CHILD_CONFIRMATION:
+			this->handleChildConfirmation(gs, node);
+			break;
+		case CHILD_REJECTION:
+			this->handleChildRejection(gs, node);
+			break;
+		case PARENT_REVOCATION:
+			this->handleParentRevocation(gs, node);
+			break;
+		case END_OF_GAME:
+			this->handleEndOfGame(gs, node);
+			break;
+		case APPLICATION_DATA:
+			this->handleApplicationData(gs, frame);
+			break;
+		default:
+			break;
+		}
+	}
+
+	/*
+	 * Send methods
+	 * 	- send(): frame type, recipient and transmission power
+	 * 	- sendCycleCheck(): cycle check to our parent
+	 * 	- sendFrame(): final send method which takes care of the sequence
+	 * 		number, the transmission power and the retransmissions
+	 */
+	void Core::send(Game *gs, uint8_t ft, Address recipient, double txPower)
+	{
+		Frame frame = Frame();
+		frame.frameType = ft;
+		frame.recipient = recipient;
+
+		if (ft == CHILD_REJECTION && gs->isChild(recipient))
+			gs->removeChild(gs->getNeighbor(recipient));
+
+		this->sendFrame(gs, frame, txPower, false);
+	}
+
+	void Core::sendCycleCheck(Game *gs, Address originator, Address newParent, Address oldParent)
+	{
+		//If we are currently switching our parent, we will send a cycle check after connecting
+		if (gs->parent == 0)
+			return;
+
+		Frame frame = Frame();
+		frame.frameType = CYCLE_CHECK;
+		frame.recipient = gs->parent->address;
+		frame.originator = originator;
+		frame.newParent = newParent;
+		frame.oldParent = oldParent;
+		this->sendFrame(gs, frame, gs->parent->reachPower, false);
+	}
+
+	void Core::sendFrame(Game *gs, Frame frame, double txPower, bool isRetransmission)
+	{
+		//Adjust the transmission power
+		frame.receivingProblems = false;
+		if (txPower > this->config.maxAllowedTxPower)
+		{
+			txPower = this->config.maxAllowedTxPower;
+			frame.receivingProblems = true;
+		}
+		gs->findHighestTxPowers();
+
+		if (!isRetransmission)
+			frame.seqNo = this->nextSeqNo();
+		frame.retransmission = isRetransmission;
+
+		if (frame.frameType == NEIGHBOR_DISCOVERY && !this->checkNeighborDiscovery(gs))
+			return;
+
+		frame.gameId = gs->gameId;
+		frame.sender = this->myAddress;
+		frame.txPower = txPower;
+		frame.parent = (gs->parent == 0) ? BROADCAST : gs->parent->address;
+		frame.highestMaxTxPower = gs->highestTxPower;
+		frame.secondHighestMaxTxPower = gs->secondTxPower;
+		frame.gameFinished = gs->finished;
+		this->completeFrame(gs, frame);
+
+		uint8_t ft = frame.frameType;
+		if (ft == CYCLE_CHECK || ft == CHILD_REQUEST || ft == CHILD_CONFIRMATION || ft == CHILD_REJECTION || ft == PARENT_REVOCATION || ft == END_OF_GAME)
+			this->scheduleRetransmission(gs, frame, txPower);
+
+		this->transport->send(frame);
+	}
+
+	bool Core::checkNeighborDiscovery(Game *gs)
+	{
+		return this->checkNeighborDiscoverySendEvent(gs);
+	}
+
+	void Core::completeFrame(Game *, Frame &)
+	{
+	}
+
+	void Core::scheduleRetransmission(Game *gs, const Frame &frame, double txPower)
+	{
+		std::shared_ptr<Retransmission> r = this->createRetransmission(gs, frame, txPower);
+		if (frame.frameType == CYCLE_CHECK)
+			this->transport->schedule(this->config.ackTimeout * this->config.ackPollFactor, std::bind(&Core::onCycleCheckRetransmission, this, r));
+		else
+			this->transport->schedule(this->config.ackTimeout * this->config.ackPollFactor, std::bind(&Core::onRetransmission, this, r));
+	}
+
+	std::shared_ptr<Core::Retransmission> Core::createRetransmission(Game *gs, const Frame &frame, double txPower)
+	{
+		std::shared_ptr<Retransmission> r = std::make_shared<Retransmission>();
+		r->gid = gs->gameId;
+		r->ft = frame.frameType;
+		r->recipient = frame.recipient;
+		r->seqNo = frame.seqNo;
+		r->txPower = txPower;
+		r->counter = 0;
+		r->originator = frame.originator;
+		r->newParent = frame.newParent;
+		r->oldParent = frame.oldParent;
+		return r;
+	}
+
+	//Checks if a unicast frame needs a retransmission
+	void Core::onRetransmission(std::shared_ptr<Retransmission> r)
+	{
+		Game *gs = this->getGame(r->gid);
+		Neighbor *node = gs->getNeighbor(r->recipient);
+
+		if (r->ft == CHILD_REQUEST && (node == 0 || gs->contactedParent != node))
+		{
+			r->counter++;
+			return;
+		}
+
+		TxStatus status = this->transport->getTxStatus(r->seqNo);
+		if (status == TX_ACKED)
+			this->transport->releaseTxStatus(r->seqNo);
+		else if (status == TX_LOST || r->counter > this->config.maxRetransmissions)
+		{
+			if (r->counter > this->config.maxRetransmissions && r->ft == CHILD_REQUEST && r->txPower >= this->config.maxAllowedTxPower)
+				this->handleChildRejection(gs, node);
+			this->transport->releaseTxStatus(r->seqNo);
+
+			Frame frame = Frame();
+			frame.frameType = r->ft;
+			frame.seqNo = r->seqNo;
+			frame.recipient = r->recipient;
+			this->sendFrame(gs, frame, r->txPower + 1, true);
+		}
+		else
+			this->transport->schedule(this->config.ackTimeout * this->config.ackRetryFactor, std::bind(&Core::onRetransmission, this, r));
+
+		r->counter++;
+	}
+
+	//Checks if a cycle check needs a retransmission
+	void Core::onCycleCheckRetransmission(std::shared_ptr<Retransmission> r)
+	{
+		Game *gs = this->getGame(r->gid);
+
+		TxStatus status = this->transport->getTxStatus(r->seqNo);
+		if (status == TX_ACKED)
+			this->transport->releaseTxStatus(r->seqNo);
+		else if (status == TX_LOST || r->counter > this->config.maxRetransmissions)
+		{
+			this->transport->releaseTxStatus(r->seqNo);
+
+			if (gs->parent != 0)
+			{
+				Frame frame = Frame();
+				frame.frameType = CYCLE_CHECK;
+				frame.seqNo = r->seqNo;
+				frame.recipient = gs->parent->address;
+				frame.originator = r->originator;
+				frame.newParent = r->newParent;
+				frame.oldParent = r->oldParent;
+				this->sendFrame(gs, frame, gs->parent->reachPower + 1, true);
+			}
+		}
+		else
+			this->transport->schedule(this->config.ackTimeout * this->config.ackRetryFactor, std::bind(&Core::onCycleCheckRetransmission, this, r));
+
+		r->counter++;
+	}
+
+	void Core::onNeighborDiscovery(uint64_t gid, std::shared_ptr<bool> event)
+	{
+		if (*event)
+			return;
+		this->send(this->getGame(gid), NEIGHBOR_DISCOVERY, BROADCAST, this->config.maxAllowedTxPower);
+	}
+
+	/*
+	 * Handle the cycle check (FrameType 0)
+	 */
+	void Core::handleCycleCheck(Game *gs, Neighbor *, const Frame &frame)
+	{
+		if (gs->initiator)
+			return;
+
+		//Only the addresses and the parent of the new parent are evaluated
+		Address originator = frame.originator;
+		Address newParent = frame.newParent;
+		Address oldParent = frame.oldParent;
+		Neighbor *newParentNode = gs->getNeighbor(newParent);
+		Address newParentsParent = (newParentNode != 0) ? newParentNode->parent : NO_ADDRESS;
+
+		if (originator != this->myAddress)
+		{
+			//We are not the originator of that packet nor the initiator of the game. Sending this packet to our parent
+			this->sendCycleCheck(gs, originator, newParent, oldParent);
+			return;
+		}
+
+		if (gs->parent != 0 && newParent == gs->parent->address)
+		{
+			//Cycle detected, set my parent with its parent on the blacklist
+			this->updateBlacklist(gs, gs->parent->address, gs->parent->parent);
+
+			this->disconnectOldParent(gs);
+
+			//Remove all my previous parents from the list until the oldParent occurs
+			if (gs->hasLastParents())
+			{
+				Neighbor *p = gs->popLastParent();
+				while (p->address != oldParent && gs->hasLastParents())
+					p = gs->popLastParent();
+			}
+
+			//Try to connect to one of our last parents
+			Neighbor *lastParent = gs->popLastParent();
+			while (lastParent != 0)
+			{
+				this->contactNode(gs, lastParent);
+				if (gs->contactedParent == 0)
+					lastParent = gs->popLastParent();
+				else
+					break;
+			}
+
+			//If we could not contact a lastParent, search for cheapest neighbor
+			if (gs->contactedParent == 0)
+			{
+				this->contactCheapestNeighbor(gs);
+
+				//If we are not able to find a valid cheapest neighbor, disconnect child nodes and try again
+				if (gs->contactedParent == 0)
+				{
+					this->disconnectAllChildNodes(gs);
+					this->contactCheapestNeighbor(gs);
+				}
+			}
+		}
+		else
+		{
+			//Blacklist newParent, since this route creates a cycle
+			this->updateBlacklist(gs, newParent, newParentsParent);
+		}
+	}
+
+	/*
+	 * Handle neighbor discovery (FrameType 1)
+	 */
+	void Core::handleNeighborDiscovery(Game *gs, Neighbor *node)
+	{
+		double maxTx = this->config.maxAllowedTxPower;
+
+		if (gs->initiator || gs->isBlacklisted(node))
+			return;
+
+		if (gs->isChild(node))
+		{
+			//If the reachpower of this child changed, inform neighbors
+			if (node->reachPowerChanged && gs->finished)
+				this->send(gs, NEIGHBOR_DISCOVERY, BROADCAST, maxTx);
+			return;
+		}
+
+		if (node->reachPower > maxTx || node->connCounter > 5 || node == gs->getLastParent() || gs->contactedParent != 0)
+			return;
+
+		//If we have no parent and are not connecting to one
+		if (gs->parent == 0)
+		{
+			gs->rejectionCounter = 0;
+			this->contactNode(gs, node);
+			return;
+		}
+
+		if (node == gs->parent)
+			return;
+
+		//Only if we are (one of) the nodes that are the farthest away, it is useful to switch (else no savings)
+		Neighbor *parent = gs->parent;
+		double connCost = (parent->highestMaxTxPower - parent->reachPower);
+		if (connCost <= 0.00001 && connCost >= -0.00001)
+		{
+			//TX power our parent can save if we leave and the cost of the new connection
+			double saving = Core::dbmToW(parent->highestMaxTxPower) - Core::dbmToW(parent->secondMaxTxPower);
+			double costOfNewConn = Core::dbmToW(node->reachPower) - Core::dbmToW(node->highestMaxTxPower);
+
+			if (costOfNewConn <= saving)
+			{
+				//No real saving and too many unchanged rounds
+				if (costOfNewConn < saving + 0.0001 && costOfNewConn > saving - 0.0001 && (gs->finished || gs->unchangedCounter >= this->config.maxUnchangedRounds))
+					return;
+				this->contactNode(gs, node);
+			}
+		}
+	}
+
+	/*
+	 * Handle child request (FrameType 2)
+	 * Sent by child, received by parent
+	 */
+	void Core::handleChildRequest(Game *gs, Neighbor *node)
+	{
+		//Check if we received a parent revocation after this child request
+		if (gs->checkLastFrameType(node->address, CHILD_REQUEST, gs->getLastSeqNo(node->address, PARENT_REVOCATION)))
+			return;
+
+		//Reject child request if the reach power for this node exceeds our maxAllowedTxPower
+		if (node->reachPower > this->config.maxAllowedTxPower)
+			return this->send(gs, CHILD_REJECTION, node->address, node->reachPower);
+
+		if (gs->parent == node || gs->contactedParent == node)
+			return this->send(gs, CHILD_REJECTION, node->address, node->reachPower);
+
+		//If we are not the initiator and we are not connected, reject and contact the cheapest neighbor
+		if (!gs->initiator && gs->parent == 0 && gs->contactedParent == 0)
+		{
+			this->send(gs, CHILD_REJECTION, node->address, node->reachPower);
+
+			//Like EEBTProtocol, continue with accepting the child if we failed too often
+			if (!(gs->rejectionCounter > (gs->getNNeighbors() * 2) && gs->parent == 0))
+				return this->contactCheapestNeighbor(gs);
+		}
+
+		if (gs->isChild(node))
+		{
+			this->send(gs, CHILD_CONFIRMATION, node->address, node->reachPower);
+			return;
+		}
+
+		gs->addChild(node);
+		node->parent = this->myAddress;
+		this->send(gs, CHILD_CONFIRMATION, node->address, node->reachPower);
+
+		//Reset the unchanged counter since the topology changed, else force the new child to finish its game
+		if (!gs->finished)
+			gs->unchangedCounter = 0;
+		else
+			this->handleEndOfGame(gs, node);
+
+		//If we already forwarded application data and now have one child, continue sending application data
+		if (gs->finished && gs->dataSeqNo > 0 && gs->getNChilds() == 1)
+			this->sendNextApplicationData(gs, (uint16_t)gs->dataSeqNo);
+	}
+
+	/*
+	 * Handle child confirmation (FrameType 3)
+	 * Sent by parent, received by child
+	 */
+	void Core::handleChildConfirmation(Game *gs, Neighbor *node)
+	{
+		if (gs->checkLastFrameType(node->address, CHILD_CONFIRMATION, gs->getLastSeqNo(node->address, CHILD_REJECTION)))
+			return this->send(gs, PARENT_REVOCATION, node->address, node->reachPower);
+
+		if (gs->parent != 0)
+		{
+			//...and we did not contact a new one, send parent revocation to sender
+			if (gs->contactedParent != node)
+			{
+				if (gs->parent == node)
+					return;
+				return this->send(gs, PARENT_REVOCATION, node->address, node->reachPower);
+			}
+			else if (gs->finished)
+				this->disconnectOldParent(gs);
+		}
+		else if (node != gs->contactedParent)
+			return this->send(gs, PARENT_REVOCATION, node->address, node->reachPower);
+
+		//Set new parent
+		this->setParent(gs, node);
+		node->connCounter++;
+		gs->contactedParent = 0;
+
+		if (gs->doIncrementAfterConfirm)
+			gs->incrementUnchangedCounter();
+
+		//Check if we noted a possible better parent in the past
+		if (gs->unchangedCounter < this->config.maxUnchangedRounds)
+			this->contactCheapestNeighbor(gs);
+
+		if (gs->contactedParent != 0)
+		{
+			gs->needCycleCheck = true;
+			return;
+		}
+
+		//If we have child nodes, do a cycle check
+		if (gs->getNChilds() > 0)
+		{
+			Address oldParent = gs->hasLastParents() ? gs->getLastParent()->address : gs->parent->address;
+			this->sendCycleCheck(gs, this->myAddress, gs->parent->address, oldParent);
+			gs->needCycleCheck = false;
+		}
+
+		if (node->finished)
+			this->handleEndOfGame(gs, node);
+		else if (gs->finished)
+			this->send(gs, END_OF_GAME, gs->parent->address, gs->parent->reachPower);
+
+		//Reset the unchanged counter, since our topology changed
+		if (!gs->doIncrementAfterConfirm && gs->unchangedCounter < this->config.maxUnchangedRounds)
+			gs->unchangedCounter = 0;
+		gs->doIncrementAfterConfirm = false;
+
+		//Inform our neighbors
+		this->send(gs, NEIGHBOR_DISCOVERY, BROADCAST, this->config.maxAllowedTxPower);
+
+		gs->rejectionCounter = 0;
+	}
+
+	/*
+	 * Handle child rejection (FrameType 4)
+	 * Sent by parent, received by child
+	 */
+	void Core::handleChildRejection(Game *gs, Neighbor *node)
+	{
+		if (gs->checkLastFrameType(node->address, CHILD_REJECTION, gs->getLastSeqNo(node->address, CHILD_CONFIRMATION)))
+			return;
+
+		//Check if node is our parent or the node we want to connect to
+		if (node != gs->parent && node != gs->contactedParent)
+			return;
+
+		if (node == gs->parent)
+		{
+			this->setParent(gs, 0);
+			if (gs->finished && gs->contactedParent != 0)
+				return;
+		}
+		else
+			node->connCounter++;
+
+		gs->resetNeighborDiscoveryEvent();
+
+		//Add contacted parent to blacklist (only if is was not a reach power problem)
+		if (!node->reachPowerProblem)
+			this->updateBlacklist(gs, node->address, node->parent);
+
+		gs->contactedParent = 0;
+
+		if (gs->rejectionCounter > (gs->getNNeighbors() * 2) && gs->parent == 0)
+		{
+			//Failed too often, waiting for new neighbor discovery frames. Finished neighbors
+			//stay silent, so the own timer contacts the cheapest neighbor again after its rounds
+			this->resetBlacklist(gs);
+			this->disconnectAllChildNodes(gs);
+			this->send(gs, NEIGHBOR_DISCOVERY, BROADCAST, this->config.maxAllowedTxPower);
+			return;
+		}
+
+		//If our game is not finished yet and we have a last parent, connect to the old one
+		if (!gs->finished && gs->hasLastParents())
+		{
+			Neighbor *lastParent = gs->popLastParent();
+			while (lastParent != 0)
+			{
+				this->contactNode(gs, lastParent);
+				if (gs->contactedParent == 0)
+					lastParent = gs->popLastParent();
+				else
+					break;
+			}
+		}
+
+		//If we did not found a not blacklisted old parent, contact cheapest neighbor
+		if (gs->contactedParent == 0)
+		{
+			this->contactCheapestNeighbor(gs);
+
+			if (gs->contactedParent == 0)
+			{
+				//If the game is already finished and we did not disconnect our old parent
+				if (gs->finished && gs->parent != 0)
+				{
+					if (gs->needCycleCheck && gs->getNChilds() > 0)
+					{
+						Address oldParent = gs->hasLastParents() ? gs->getLastParent()->address : gs->parent->address;
+						this->sendCycleCheck(gs, this->myAddress, gs->parent->address, oldParent);
+						gs->needCycleCheck = false;
+					}
+					return;
+				}
+
+				//If this also fails, disconnect child nodes and try again
+				this->disconnectAllChildNodes(gs);
+				this->contactCheapestNeighbor(gs);
+			}
+
+			gs->doIncrementAfterConfirm = false;
+			gs->unchangedCounter = 0;
+		}
+
+		gs->rejectionCounter++;
+	}
+
+	/*
+	 * Handle parent revocation (FrameType 5)
+	 * Sent by child, received by parent
+	 */
+	void Core::handleParentRevocation(Game *gs, Neighbor *node)
+	{
+		if (gs->checkLastFrameType(node->address, PARENT_REVOCATION, gs->getLastSeqNo(node->address, CHILD_REQUEST)))
+			return;
+
+		if (!gs->isChild(node->address))
+			return;
+
+		gs->removeChild(node);
+
+		if (!gs->finished)
+		{
+			gs->unchangedCounter = 0;
+			gs->resetNeighborDiscoveryEvent();
+		}
+
+		if (gs->parent != 0 || gs->initiator)
+			this->send(gs, NEIGHBOR_DISCOVERY, BROADCAST, this->config.maxAllowedTxPower);
+	}
+
+	/*
+	 * Handle end of game (FrameType 6)
+	 * Sent by child, received by parent
+	 */
+	void Core::handleEndOfGame(Game *gs, Neighbor *node)
+	{
+		if (node == gs->parent && gs->contactedParent == 0)
+		{
+			gs->resetNeighborDiscoveryEvent();
+
+			if (gs->getNChilds() > 0 && !gs->allChildsFinished())
+			{
+				for (uint32_t i = 0; i < gs->getNChilds(); i++)
+				{
+					Neighbor *child = gs->getChild(i);
+					this->send(gs, END_OF_GAME, child->address, child->reachPower);
+					this->handleEndOfGame(gs, child);
+				}
+			}
+
+			node->finished = true;
+			this->setFinished(gs);
+		}
+		else if (gs->isChild(node->address))
+			node->finished = true;
+	}
+
+	/*
+	 * Handle application data (FrameType 7)
+	 * Sent by parent, received by child
+	 */
+	void Core::handleApplicationData(Game *gs, const Frame &frame)
+	{
+		if (gs->acceptApplicationData(frame.dataSeqNo) && gs->getNChilds() > 0)
+			this->sendApplicationData(gs, frame.dataSeqNo, frame.dataLength, frame.dataOriginTime);
+	}
+
+	/*
+	 * Helper methods
+	 */
+	void Core::contactCheapestNeighbor(Game *gs)
+	{
+		Neighbor *cheapestNeighbor = gs->getCheapestNeighbor();
+		if (cheapestNeighbor != gs->parent)
+			this->contactNode(gs, cheapestNeighbor);
+	}
+
+	//Sends the CHILD_REQUEST to a new parent
+	void Core::contactNode(Game *gs, Neighbor *node)
+	{
+		if (gs->isBlacklisted(node) || gs->isChild(node) || gs->parent == node)
+			return;
+
+		if (node->reachPower > this->config.maxAllowedTxPower)
+			return;
+
+		//Wait for the response of the contacted node
+		if (gs->contactedParent != 0)
+			return;
+
+		Neighbor *parent = gs->parent;
+
+		gs->resetNeighborDiscoveryEvent();
+
+		if (parent != 0)
+		{
+			//If the connection to the new parent costs the same as to the old parent,
+			//we still increment the unchanged counter since we don't want to end in a loop
+			double costOfCurrentConn = gs->getCostOfCurrentConn();
+			double saving = Core::dbmToW(parent->highestMaxTxPower) - Core::dbmToW(parent->secondMaxTxPower);
+			double costOfNewConn = Core::dbmToW(node->reachPower) - Core::dbmToW(node->highestMaxTxPower);
+
+			if (costOfCurrentConn < 0.0001 && costOfCurrentConn > -0.0001)
+			{
+				if (saving < costOfNewConn + 0.0001 && saving > costOfNewConn - 0.0001)
+					gs->doIncrementAfterConfirm = true;
+			}
+		}
+
+		//If the game is finished, we disconnect after the next successful connection
+		if (!gs->finished)
+			this->disconnectOldParent(gs);
+
+		gs->contactedParent = node;
+		this->send(gs, CHILD_REQUEST, node->address, node->reachPower);
+	}
+
+	void Core::finishGame(Game *gs)
+	{
+		if (gs->contactedParent != 0)
+			return;
+
+		this->setFinished(gs);
+		gs->resetNeighborDiscoveryEvent();
+
+		if (gs->parent != 0)
+			this->send(gs, END_OF_GAME, gs->parent->address, gs->parent->reachPower);
+		else if (gs->initiator)
+			this->sendNextApplicationData(gs, 0);
+	}
+
+	bool Core::checkNeighborDiscoverySendEvent(Game *gs)
+	{
+		if (!gs->ndEvent)
+			gs->ndEvent = std::make_shared<bool>(false);
+
+		if ((gs->unchangedCounter >= this->config.maxUnchangedRounds && gs->allChildsFinished()) && (!gs->initiator || gs->getNChilds() > 0))
+		{
+			if (!gs->initiator)
+				this->contactCheapestNeighbor(gs);
+
+			gs->resetNeighborDiscoveryEvent();
+
+			//If we did not contact a new node, finish the game
+			if (gs->contactedParent == 0)
+				this->finishGame(gs);
+		}
+		else
+		{
+			this->transport->schedule(this->config.neighborDiscoveryInterval, std::bind(&Core::onNeighborDiscovery, this, gs->gameId, gs->ndEvent));
+			gs->incrementUnchangedCounter();
+		}
+
+		return !gs->finished;
+	}
+
+	void Core::disconnectOldParent(Game *gs)
+	{
+		Neighbor *parent = gs->parent;
+		if (parent == 0)
+			return;
+
+		this->send(gs, PARENT_REVOCATION, parent->address, parent->reachPower);
+
+		if (!gs->isBlacklisted(parent))
+			gs->pushLastParent(parent);
+
+		parent->highestMaxTxPower = Core::wToDbm(0);
+		parent->secondMaxTxPower = Core::wToDbm(0);
+
+		this->setParent(gs, 0);
+	}
+
+	void Core::disconnectAllChildNodes(Game *gs)
+	{
+		while (gs->getNChilds() > 0)
+		{
+			Neighbor *child = gs->getChild(0);
+			child->setSrcPath(std::vector<Address>());
+			this->send(gs, CHILD_REJECTION, child->address, child->reachPower);
+			gs->removeChild(child);
+		}
+
+		this->resetBlacklist(gs);
+		gs->clearLastParents();
+		gs->unchangedCounter = 0;
+	}
+
+	/*
+	 * Changes of the game state, the blacklist changes are passed to the Listener
+	 */
+	void Core::setParent(Game *gs, Neighbor *node)
+	{
+		Neighbor *oldParent = gs->parent;
+		gs->parent = node;
+		if (node == oldParent)
+			return;
+
+		//For CoreMutex: our old parent is not waiting for us anymore
+		gs->parentWaitingForLock = false;
+	}
+
+	//Like the finish time, the last call counts
+	void Core::setFinished(Game *gs)
+	{
+		gs->finished = true;
+		gs->finishTime = this->transport->now();
+	}
+
+	void Core::updateBlacklist(Game *gs, Address node, Address parent)
+	{
+		gs->updateBlacklist(node, parent);
+		if (this->listener != 0)
+			this->listener->blacklistUpdated(gs->gameId, node, parent);
+	}
+
+	void Core::resetBlacklist(Game *gs)
+	{
+		gs->resetBlacklist();
+		if (this->listener != 0)
+			this->listener->blacklistReset(gs->gameId);
+	}
+
+	/*
+	 * Application data
+	 * 	- sendApplicationData(): broadcasts one data frame to our children
+	 * 	- sendNextApplicationData(): the initiator sends the next frame once
+	 * 		the last one has been acked
+	 */
+	void Core::sendApplicationData(Game *gs, uint32_t dataSeqNo, uint32_t dataLength, int64_t originTime)
+	{
+		gs->findHighestTxPowers();
+
+		Frame frame = Frame();
+		frame.seqNo = this->nextSeqNo();
+
+		if (gs->initiator)
+			this->transport->schedule(this->config.applicationDataInterval, std::bind(&Core::sendNextApplicationData, this, gs, frame.seqNo));
+
+		frame.frameType = APPLICATION_DATA;
+		frame.gameId = gs->gameId;
+		frame.sender = this->myAddress;
+		frame.recipient = BROADCAST;
+		frame.txPower = gs->highestTxPower;
+		frame.parent = (gs->parent == 0) ? BROADCAST : gs->parent->address;
+		frame.highestMaxTxPower = gs->highestTxPower;
+		frame.secondHighestMaxTxPower = gs->secondTxPower;
+		frame.gameFinished = gs->finished;
+		frame.dataSeqNo = dataSeqNo;
+		frame.dataLength = dataLength;
+		frame.dataOriginTime = originTime;
+
+		this->transport->send(frame);
+	}
+
+	void Core::sendNextApplicationData(Game *gs, uint16_t seqNo)
+	{
+		if (!gs->initiator || gs->getNChilds() == 0 || this->sendCounter >= this->config.maxPackets)
+			return;
+
+		if (this->transport->getTxStatus(seqNo) == TX_ACKED || this->sendCounter == 0)
+		{
+			uint32_t dataSeqNo = gs->dataSeqNo;
+			gs->dataSeqNo++;
+			this->sendApplicationData(gs, dataSeqNo, this->config.dataLength, this->transport->now());
+			this->sendCounter++;
+		}
+		else
+			this->transport->schedule(this->config.applicationDataInterval, std::bind(&Core::sendNextApplicationData, this, gs, seqNo));
+	}
+}
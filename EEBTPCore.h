@@ -0,0 +1,416 @@
+/*
+ * EEBTPCore.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#ifndef BROADCAST_EEBTPCORE_H_
+#define BROADCAST_EEBTPCORE_H_
+
+#include "array"
+#include "memory"
+#include "vector"
+#include "cstdint"
+#include "functional"
+#include "unordered_map"
+
+/*
+ * ns-3 free core of the EEBT protocol.
+ *
+ * The core holds the state machine of the protocol (handle*, contactNode,
+ * the neighbor discovery rounds and the retransmissions) and the game
+ * state. Everything it needs from the outside is behind Transport:
+ * 	- send(): hands a frame to the link layer
+ * 	- schedule(): one-shot timers in nanoseconds
+ * 	- getTxStatus(): ack state of a sent unicast frame
+ *
+ * Core is the cycle prevention CYCLE_TEST_ASYNC, CoreMutex and CoreSrcPath
+ * (EEBTPCore_Mutex.h, EEBTPCore_SrcPath.h) override its handlers.
+ * EEBTProtocolCore binds the CYCLE_TEST_ASYNC core to a WifiNetDevice
+ * (cpm=CORE), the tools in tools/ run every variant on an in-memory
+ * message bus.
+ */
+namespace eebtp
+{
+	typedef uint64_t Address;
+
+	static const Address BROADCAST = 0xffffffffffffULL;
+	static const Address NO_ADDRESS = 0;
+
+	enum FrameType : uint8_t
+	{
+		CYCLE_CHECK = 0,
+		NEIGHBOR_DISCOVERY = 1,
+		CHILD_REQUEST = 2,
+		CHILD_CONFIRMATION = 3,
+		CHILD_REJECTION = 4,
+		PARENT_REVOCATION = 5,
+		END_OF_GAME = 6,
+		APPLICATION_DATA = 7,
+		N_FRAME_TYPES = 8
+	};
+
+	//Cycle prevention method of a core (EEBTProtocolHelper::CYCLE_PREV_METHOD)
+	enum Variant : uint8_t
+	{
+		CYCLE_TEST_ASYNC = 0,
+		MUTEX = 1,
+		PATH_TO_SRC = 2,
+		N_VARIANTS = 3
+	};
+
+	enum TxStatus : uint8_t
+	{
+		TX_PENDING = 0,
+		TX_ACKED = 1,
+		TX_LOST = 2
+	};
+
+	//Fixed size content of an EEBTPHeader (plus the EEBTPDataHeader for application data)
+	struct FrameHeader
+	{
+		uint8_t frameType;
+		uint16_t seqNo;
+		uint64_t gameId;
+		Address sender;
+		Address recipient;
+		Address parent;
+		double txPower;
+		double highestMaxTxPower;
+		double secondHighestMaxTxPower;
+		bool gameFinished;
+		bool receivingProblems;
+		bool neededLockUpdate; //Mutex: CHILD_CONFIRMATION while locked, the originator holds the lock
+		bool retransmission;   //Sent again by the core (not on air)
+
+		Address originator;
+		Address newParent;
+		Address oldParent;
+
+		uint32_t dataSeqNo;
+		uint32_t dataLength;
+		int64_t dataOriginTime; //ns, when the initiator sent the data
+	};
+
+	//A frame with the path to the initiator of EEBTPHeaderSrcPath (empty for the other variants)
+	struct Frame : public FrameHeader
+	{
+		std::vector<Address> srcPath;
+	};
+
+	//What the PHY measured for a received frame (EEBTPTag)
+	struct RxInfo
+	{
+		double signal;
+		double noise;
+		double minSnr;
+	};
+
+	struct Config
+	{
+		double maxAllowedTxPower;
+		int64_t ackTimeout;					//ns
+		int64_t neighborDiscoveryInterval;	//ns
+		int64_t applicationDataInterval;	//ns
+		uint32_t maxPackets;
+		uint32_t dataLength;
+
+		uint32_t maxRetransmissions;		//Ack polls before a frame is sent again
+		uint32_t ackPollFactor;				//First ack poll after this many ack timeouts
+		uint32_t ackRetryFactor;			//Further ack polls after this many ack timeouts
+		uint32_t maxUnchangedRounds;
+		double txPowerMargin;				//dB
+
+		Config();
+	};
+
+	class Transport
+	{
+	public:
+		typedef std::function<void()> Callback;
+
+		virtual ~Transport() {}
+
+		virtual void send(const Frame &frame) = 0;
+		virtual void schedule(int64_t delay, Callback callback) = 0;
+		virtual int64_t now() = 0;
+
+		virtual TxStatus getTxStatus(uint16_t seqNo) = 0;
+		virtual void releaseTxStatus(uint16_t seqNo) = 0;
+	};
+
+	/*
+	 * Gets informed about changes of the game state (the trace sources of
+	 * EEBTProtocol), all methods are optional
+	 */
+	class Listener
+	{
+	public:
+		virtual ~Listener() {}
+
+		//Game ID, node and the parent of the node that is blacklisted
+		virtual void blacklistUpdated(uint64_t, Address, Address) {}
+		virtual void blacklistReset(uint64_t) {}
+	};
+
+	/*
+	 * Another node as seen by this node (EEBTPNode)
+	 */
+	struct Neighbor
+	{
+		Address address;
+		Address parent;
+
+		bool finished;
+		bool reachPowerProblem;
+		bool reachPowerChanged;
+
+		double noise;
+		double rxPower;
+		double reachPower;
+		double highestMaxTxPower;
+		double secondMaxTxPower;
+
+		uint32_t connCounter;
+
+		//Path to the initiator the node sent last (CoreSrcPath)
+		std::vector<Address> srcPath;
+		bool pathChanged;
+
+		Neighbor(Address address, double power);
+		void setReachPower(double reachPower);
+		void setSrcPath(const std::vector<Address> &path);
+		bool isOnPath(Address address) const;
+	};
+
+	/*
+	 * Game state of one game (GameState)
+	 */
+	class Game
+	{
+	public:
+		Game(bool initiator, uint64_t gid, Address myAddress);
+
+		uint64_t gameId;
+		Address myAddress;
+		bool initiator;
+		bool finished;
+		int64_t finishTime;
+
+		bool needCycleCheck;
+		bool doIncrementAfterConfirm;
+		uint32_t unchangedCounter;
+		uint32_t rejectionCounter;
+
+		double highestTxPower;
+		double secondTxPower;
+
+		Neighbor *parent;
+		Neighbor *contactedParent;
+
+		//Neighbor discovery chain, all pending firings share the flag
+		std::shared_ptr<bool> ndEvent;
+
+		//Locks of the subtree (CoreMutex)
+		bool locked;
+		Address lockedBy;
+		bool parentWaitingForLock;
+		Address parentWaitingLockOriginator;
+		bool newParentWaitingForLock;
+		Address newParentWaitingLockOriginator;
+
+		//Checks of the parent path (CoreSrcPath), all pending firings share the flag
+		int64_t lastParentUpdate;
+		bool emptyPathOnConnect;
+		uint32_t parentUnchangedCounter;
+		std::shared_ptr<bool> ppcEvent;
+
+		//Application data window (ApplicationDataHandler)
+		uint32_t dataSeqNo;
+		uint32_t packetCount;
+		std::vector<uint32_t> missingSeqNos;
+
+		uint16_t getLastSeqNo(Address sender, uint8_t ft);
+		std::array<uint16_t, N_FRAME_TYPES> &getLastSeqNos(Address sender);
+		bool checkLastFrameType(Address sender, uint8_t ft, uint16_t seqNo);
+		void updateLastFrameType(Address sender, uint8_t ft, uint16_t seqNo);
+
+		//Stays unchanged while the subtree is locked
+		void incrementUnchangedCounter();
+
+		Neighbor *getNeighbor(Address address);
+		Neighbor *addNeighbor(Address address);
+		uint32_t getNNeighbors() const;
+		Neighbor *getNeighbor(uint32_t index) const;
+		Neighbor *getCheapestNeighbor();
+
+		bool isChild(Address address) const;
+		bool isChild(const Neighbor *node) const;
+		void addChild(Neighbor *node);
+		void removeChild(Neighbor *node);
+		uint32_t getNChilds() const;
+		Neighbor *getChild(uint32_t index) const;
+		bool allChildsFinished() const;
+
+		void findHighestTxPowers();
+		double getCostOfCurrentConn() const;
+
+		bool hasLastParents() const;
+		Neighbor *popLastParent();
+		Neighbor *getLastParent() const;
+		void pushLastParent(Neighbor *node);
+		void clearLastParents();
+
+		bool isBlacklisted(Address node, Address parent);
+		bool isBlacklisted(const Neighbor *node);
+		void updateBlacklist(Address node, Address parent);
+		void resetBlacklist();
+
+		bool isLocked(Address child) const;
+		void lock(Address child, bool l);
+		uint32_t getNChildsLocked() const;
+		void resetChildLocks();
+
+		void resetNeighborDiscoveryEvent();
+		bool acceptApplicationData(uint32_t seqNo);
+
+	private:
+		std::vector<std::unique_ptr<Neighbor>> neighbors;
+		std::unordered_map<Address, Neighbor *> neighborIndex;
+		std::vector<Neighbor *> childList;
+		std::vector<Neighbor *> lastParents;
+		std::unordered_map<Address, Address> blacklist;
+		std::unordered_map<Address, std::array<uint16_t, N_FRAME_TYPES>> frameTypeCache;
+		std::vector<Address> locks;
+	};
+
+	/*
+	 * Protocol instance of one node (cycle prevention CYCLE_TEST_ASYNC)
+	 *
+	 * The handlers and the hooks of sendFrame() are virtual, CoreMutex and
+	 * CoreSrcPath override them like EEBTProtocolMutex and EEBTProtocolSrcPath
+	 * do with EEBTProtocol.
+	 */
+	class Core
+	{
+	public:
+		static const uint32_t MAX_UNCHANGED_ROUNDS;
+
+		Core(Address myAddress, Transport *transport, Config config);
+		virtual ~Core();
+
+		//Creates the core of a cycle prevention method (Variant), 0 if it is unknown
+		static Core *create(uint8_t variant, Address myAddress, Transport *transport, Config config);
+		virtual uint8_t getVariant() const;
+
+		Address getAddress() const;
+		const Config &getConfig() const;
+		void setListener(Listener *listener);
+
+		Game *getGame(uint64_t gid);
+		Game *initGame(uint64_t gid);
+		uint32_t getNGames() const;
+		Game *getGameByIndex(uint32_t index) const;
+		uint32_t getSendCounter() const;
+
+		void receive(const Frame &frame, const RxInfo &rx);
+		void send(Game *game, uint8_t ft, Address recipient, double txPower);
+
+		double calculateTxPower(double rxPower, double txPower, double noise, double minSNR);
+
+		static double dbmToW(double dbm);
+		static double wToDbm(double w);
+
+		//Sequence numbers wrap, they are compared as serial numbers (RFC 1982). 0 is never sent, it marks 'nothing received'
+		static bool isNewerSeqNo(uint16_t seqNo, uint16_t last);
+
+	protected:
+		struct Retransmission
+		{
+			uint64_t gid;
+			uint8_t ft;
+			Address recipient;
+			uint16_t seqNo;
+			double txPower;
+			uint32_t counter;
+
+			Address originator;
+			Address newParent;
+			Address oldParent;
+		};
+
+		Transport *transport;
+		Listener *listener;
+		Config config;
+
+		/*
+		 * Hooks of receive() and sendFrame()
+		 * 	- acceptFrame(): checks and updates the last sequence number of the frame type
+		 * 	- dispatch(): calls the handler of the frame type
+		 * 	- checkNeighborDiscovery(): false if a neighbor discovery must not be sent
+		 * 	- completeFrame(): variant specific fields of a frame to send
+		 * 	- scheduleRetransmission(): ack polling of a sent unicast frame
+		 */
+		virtual bool acceptFrame(Game *gs, const Frame &frame);
+		virtual void dispatch(Game *gs, Neighbor *node, const Frame &frame);
+		virtual bool checkNeighborDiscovery(Game *gs);
+		virtual void completeFrame(Game *gs, Frame &frame);
+		virtual void scheduleRetransmission(Game *gs, const Frame &frame, double txPower);
+
+		virtual void handleCycleCheck(Game *gs, Neighbor *node, const Frame &frame);
+		virtual void handleNeighborDiscovery(Game *gs, Neighbor *node);
+		virtual void handleChildRequest(Game *gs, Neighbor *node);
+		virtual void handleChildConfirmation(Game *gs, Neighbor *node);
+		virtual void handleChildRejection(Game *gs, Neighbor *node);
+		virtual void handleParentRevocation(Game *gs, Neighbor *node);
+		virtual void handleEndOfGame(Game *gs, Neighbor *node);
+		virtual void handleApplicationData(Game *gs, const Frame &frame);
+
+		void sendCycleCheck(Game *gs, Address originator, Address newParent, Address oldParent);
+		void sendFrame(Game *gs, Frame frame, double txPower, bool isRetransmission);
+		std::shared_ptr<Retransmission> createRetransmission(Game *gs, const Frame &frame, double txPower);
+		void onRetransmission(std::shared_ptr<Retransmission> r);
+
+		virtual void contactCheapestNeighbor(Game *gs);
+		virtual void contactNode(Game *gs, Neighbor *node);
+		bool checkNeighborDiscoverySendEvent(Game *gs);
+		void finishGame(Game *gs);
+		void disconnectOldParent(Game *gs);
+		void disconnectAllChildNodes(Game *gs);
+
+		void setParent(Game *gs, Neighbor *node);
+		void setFinished(Game *gs);
+		void updateBlacklist(Game *gs, Address node, Address parent);
+		void resetBlacklist(Game *gs);
+
+	private:
+		//The received sequence numbers of one sender within a window that ends with the newest one
+		struct SeqNoCache
+		{
+			static const uint16_t WINDOW = 1024;
+
+			uint16_t newest;							//0: nothing received
+			std::array<uint64_t, WINDOW / 64> received;	//Bit seqNo % WINDOW is set if seqNo was received
+
+			SeqNoCache() : newest(0), received() {}
+		};
+
+		Address myAddress;
+
+		uint16_t seqNo;
+		uint32_t sendCounter;
+		std::vector<std::unique_ptr<Game>> games;
+		std::unordered_map<Address, SeqNoCache> seqNoCache;
+
+		uint16_t nextSeqNo();
+		bool checkForDuplicate(Address sender, uint16_t seqNo);
+
+		void onCycleCheckRetransmission(std::shared_ptr<Retransmission> r);
+		void onNeighborDiscovery(uint64_t gid, std::shared_ptr<bool> event);
+
+		void sendApplicationData(Game *gs, uint32_t dataSeqNo, uint32_t dataLength, int64_t originTime);
+		void sendNextApplicationData(Game *gs, uint16_t seqNo);
+	};
+}
+
+#endif /* BROADCAST_EEBTPCORE_H_ */
@@ -0,0 +1,308 @@
+/*
+ * EEBTPCoreRecord.cc
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include "cerrno"
+#include "cstring"
+
+#include "EEBTPCoreRecord.h"
+
+namespace eebtp
+{
+	struct RecordHeader
+	{
+		char magic[8];
+		uint32_t recordSize;
+		uint32_t variant;
+		Address address;
+
+		double maxAllowedTxPower;
+		int64_t ackTimeout;
+		int64_t neighborDiscoveryInterval;
+		int64_t applicationDataInterval;
+		uint32_t maxPackets;
+		uint32_t dataLength;
+		uint32_t maxRetransmissions;
+		uint32_t ackPollFactor;
+		uint32_t ackRetryFactor;
+		uint32_t maxUnchangedRounds;
+		double txPowerMargin;
+	};
+
+	const char *RecordEntry::getKindName(uint8_t kind)
+	{
+		switch (kind)
+		{
+		case RECEIVE:
+			return "RECEIVE";
+		case TIMER:
+			return "TIMER";
+		case TX_STATUS:
+			return "TX_STATUS";
+		case INIT_GAME:
+			return "INIT_GAME";
+		case SEND:
+			return "SEND";
+		case SENT:
+			return "SENT";
+		default:
+			return "UNKNOWN";
+		}
+	}
+
+	Recorder::Recorder()
+	{
+		this->file = 0;
+		this->nRecords = 0;
+	}
+
+	Recorder::~Recorder()
+	{
+		this->close();
+	}
+
+	bool Recorder::open(std::string fileName, uint8_t variant, Address address, const Config &config)
+	{
+		this->close();
+		this->error.clear();
+		this->nRecords = 0;
+
+		this->file = std::fopen(fileName.c_str(), "wb");
+		if (this->file == 0)
+		{
+			this->error = "Cannot open " + fileName + ": " + std::strerror(errno);
+			return false;
+		}
+
+		RecordHeader header = RecordHeader();
+		std::memcpy(header.magic, "EEBTPCR2", 8);
+		header.recordSize = sizeof(RecordEntry);
+		header.variant = variant;
+		header.address = address;
+		header.maxAllowedTxPower = config.maxAllowedTxPower;
+		header.ackTimeout = config.ackTimeout;
+		header.neighborDiscoveryInterval = config.neighborDiscoveryInterval;
+		header.applicationDataInterval = config.applicationDataInterval;
+		header.maxPackets = config.maxPackets;
+		header.dataLength = config.dataLength;
+		header.maxRetransmissions = config.maxRetransmissions;
+		header.ackPollFactor = config.ackPollFactor;
+		header.ackRetryFactor = config.ackRetryFactor;
+		header.maxUnchangedRounds = config.maxUnchangedRounds;
+		header.txPowerMargin = config.txPowerMargin;
+
+		this->fileName = fileName;
+		if (std::fwrite(&header, sizeof(header), 1, this->file) != 1)
+		{
+			this->error = "Cannot write " + fileName + ": " + std::strerror(errno);
+			std::fclose(this->file);
+			this->file = 0;
+			return false;
+		}
+		return true;
+	}
+
+	bool Recorder::isOpen()
+	{
+		return this->file != 0;
+	}
+
+	//Returns false if any write of this record failed
+	bool Recorder::close()
+	{
+		if (this->file == 0)
+			return true;
+
+		if (std::fclose(this->file) != 0 && this->error.empty())
+			this->error = "Cannot close " + this->fileName + ": " + std::strerror(errno);
+		this->file = 0;
+		return this->error.empty();
+	}
+
+	std::string Recorder::getError()
+	{
+		return this->error;
+	}
+
+	//The path follows the entry (empty for all variants but PATH_TO_SRC)
+	void Recorder::write(RecordEntry &entry, const std::vector<Address> &path)
+	{
+		if (this->file == 0)
+			return;
+
+		entry.pathLength = path.size();
+		if (std::fwrite(&entry, sizeof(entry), 1, this->file) != 1 && this->error.empty())
+			this->error = "Cannot write " + this->fileName + ": " + std::strerror(errno);
+		if (!path.empty() && std::fwrite(path.data(), sizeof(Address), path.size(), this->file) != path.size() && this->error.empty())
+			this->error = "Cannot write " + this->fileName + ": " + std::strerror(errno);
+		this->nRecords++;
+	}
+
+	void Recorder::onReceive(int64_t time, const Frame &frame, const RxInfo &rx)
+	{
+		RecordEntry entry = RecordEntry();
+		entry.time = time;
+		entry.kind = RecordEntry::RECEIVE;
+		entry.seqNo = frame.seqNo;
+		entry.frame = frame;
+		entry.rx = rx;
+		this->write(entry, frame.srcPath);
+	}
+
+	void Recorder::onTimer(int64_t time)
+	{
+		RecordEntry entry = RecordEntry();
+		entry.time = time;
+		entry.kind = RecordEntry::TIMER;
+		this->write(entry, std::vector<Address>());
+	}
+
+	void Recorder::onTxStatus(int64_t time, uint16_t seqNo, TxStatus status)
+	{
+		RecordEntry entry = RecordEntry();
+		entry.time = time;
+		entry.kind = RecordEntry::TX_STATUS;
+		entry.txStatus = status;
+		entry.seqNo = seqNo;
+		this->write(entry, std::vector<Address>());
+	}
+
+	void Recorder::onInitGame(int64_t time, uint64_t gid)
+	{
+		RecordEntry entry = RecordEntry();
+		entry.time = time;
+		entry.kind = RecordEntry::INIT_GAME;
+		entry.frame.gameId = gid;
+		this->write(entry, std::vector<Address>());
+	}
+
+	void Recorder::onSend(int64_t time, uint64_t gid, uint8_t ft, Address recipient, double txPower)
+	{
+		RecordEntry entry = RecordEntry();
+		entry.time = time;
+		entry.kind = RecordEntry::SEND;
+		entry.frame.gameId = gid;
+		entry.frame.frameType = ft;
+		entry.frame.recipient = recipient;
+		entry.frame.txPower = txPower;
+		this->write(entry, std::vector<Address>());
+	}
+
+	void Recorder::onSent(int64_t time, const Frame &frame)
+	{
+		RecordEntry entry = RecordEntry();
+		entry.time = time;
+		entry.kind = RecordEntry::SENT;
+		entry.seqNo = frame.seqNo;
+		entry.frame = frame;
+		this->write(entry, frame.srcPath);
+	}
+
+	uint64_t Recorder::getNRecords()
+	{
+		return this->nRecords;
+	}
+
+	RecordReader::RecordReader()
+	{
+		this->file = 0;
+		this->variant = CYCLE_TEST_ASYNC;
+		this->address = NO_ADDRESS;
+	}
+
+	RecordReader::~RecordReader()
+	{
+		this->close();
+	}
+
+	bool RecordReader::open(std::string fileName)
+	{
+		this->close();
+		this->error.clear();
+
+		this->file = std::fopen(fileName.c_str(), "rb");
+		if (this->file == 0)
+		{
+			this->error = "Cannot open " + fileName + ": " + std::strerror(errno);
+			return false;
+		}
+
+		RecordHeader header;
+		if (std::fread(&header, sizeof(header), 1, this->file) != 1 || std::memcmp(header.magic, "EEBTPCR2", 8) != 0)
+		{
+			this->error = fileName + " is no core record";
+			this->close();
+			return false;
+		}
+		if (header.recordSize != sizeof(RecordEntry))
+		{
+			this->error = fileName + " has records of " + std::to_string(header.recordSize) + " bytes, expected " + std::to_string(sizeof(RecordEntry));
+			this->close();
+			return false;
+		}
+		if (header.variant >= N_VARIANTS)
+		{
+			this->error = fileName + " has the unknown variant " + std::to_string(header.variant);
+			this->close();
+			return false;
+		}
+
+		this->variant = header.variant;
+		this->address = header.address;
+		this->config.maxAllowedTxPower = header.maxAllowedTxPower;
+		this->config.ackTimeout = header.ackTimeout;
+		this->config.neighborDiscoveryInterval = header.neighborDiscoveryInterval;
+		this->config.applicationDataInterval = header.applicationDataInterval;
+		this->config.maxPackets = header.maxPackets;
+		this->config.dataLength = header.dataLength;
+		this->config.maxRetransmissions = header.maxRetransmissions;
+		this->config.ackPollFactor = header.ackPollFactor;
+		this->config.ackRetryFactor = header.ackRetryFactor;
+		this->config.maxUnchangedRounds = header.maxUnchangedRounds;
+		this->config.txPowerMargin = header.txPowerMargin;
+		return true;
+	}
+
+	void RecordReader::close()
+	{
+		if (this->file != 0)
+			std::fclose(this->file);
+		this->file = 0;
+	}
+
+	std::string RecordReader::getError()
+	{
+		return this->error;
+	}
+
+	uint8_t RecordReader::getVariant()
+	{
+		return this->variant;
+	}
+
+	Address RecordReader::getAddress()
+	{
+		return this->address;
+	}
+
+	const Config &RecordReader::getConfig()
+	{
+		return this->config;
+	}
+
+	bool RecordReader::next(RecordEntry &entry, std::vector<Address> &path)
+	{
+		if (this->file == 0 || std::fread(&entry, sizeof(entry), 1, this->file) != 1)
+			return false;
+
+		path.resize(entry.pathLength);
+		if (!path.empty() && std::fread(path.data(), sizeof(Address), path.size(), this->file) != path.size())
+		{
+			this->error = "The record ends within a path";
+			return false;
+		}
+		return true;
+	}
+}
@@ -0,0 +1,115 @@
+/*
+ * EEBTPCoreRecord.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#ifndef BROADCAST_EEBTPCORERECORD_H_
+#define BROADCAST_EEBTPCORERECORD_H_
+
+#include "string"
+#include "cstdio"
+#include "cstdint"
+#include "vector"
+
+#include "EEBTPCore.h"
+
+namespace eebtp
+{
+	/*
+	 * Record of everything a single protocol core got from the outside, so its
+	 * run can be replayed without the network (tools/EEBTPCoreReplay.cc):
+	 * 	- RECEIVE: frame and PHY info (EEBTPTag) handed to Core::receive()
+	 * 	- TIMER: a timer of the core fired
+	 * 	- TX_STATUS: answer of Transport::getTxStatus() (MAC ack or loss)
+	 * 	- INIT_GAME, SEND: calls of the application (the initiator starts)
+	 * 	- SENT: frame the core handed to the transport, only to check the
+	 * 		replay
+	 *
+	 * The core is deterministic, so the inputs in their order are enough:
+	 * the replay recreates the timers itself. Records are the raw structs,
+	 * the file is only readable by a build with the same EEBTPCore.h. The
+	 * variant of the core is in the file header, the path of a RECEIVE or
+	 * SENT frame (PATH_TO_SRC) follows its record as 'pathLength' addresses.
+	 */
+	struct RecordEntry
+	{
+		enum Kind : uint8_t
+		{
+			RECEIVE = 0,
+			TIMER = 1,
+			TX_STATUS = 2,
+			INIT_GAME = 3,
+			SEND = 4,
+			SENT = 5,
+			N_KINDS = 6
+		};
+
+		int64_t time; //ns
+		uint8_t kind;
+		uint8_t txStatus;
+		uint16_t seqNo;
+		uint16_t pathLength;
+		uint16_t reserved;
+		FrameHeader frame; //SEND: gameId, frameType, recipient and txPower
+		RxInfo rx;
+
+		static const char *getKindName(uint8_t kind);
+	};
+
+	class Recorder
+	{
+	public:
+		Recorder();
+		virtual ~Recorder();
+
+		bool open(std::string fileName, uint8_t variant, Address address, const Config &config);
+		bool isOpen();
+		bool close();
+		std::string getError();
+
+		void onReceive(int64_t time, const Frame &frame, const RxInfo &rx);
+		void onTimer(int64_t time);
+		void onTxStatus(int64_t time, uint16_t seqNo, TxStatus status);
+		void onInitGame(int64_t time, uint64_t gid);
+		void onSend(int64_t time, uint64_t gid, uint8_t ft, Address recipient, double txPower);
+		void onSent(int64_t time, const Frame &frame);
+
+		uint64_t getNRecords();
+
+	private:
+		FILE *file;
+		std::string fileName;
+		std::string error;
+		uint64_t nRecords;
+
+		void write(RecordEntry &entry, const std::vector<Address> &path);
+	};
+
+	class RecordReader
+	{
+	public:
+		RecordReader();
+		virtual ~RecordReader();
+
+		bool open(std::string fileName);
+		void close();
+		std::string getError();
+
+		uint8_t getVariant();
+		Address getAddress();
+		const Config &getConfig();
+
+		//Returns false at the end of the record
+		bool next(RecordEntry &entry, std::vector<Address> &path);
+
+	private:
+		FILE *file;
+		std::string error;
+		uint8_t variant;
+		Address address;
+		Config config;
+	};
+}
+
+#endif /* BROADCAST_EEBTPCORERECORD_H_ */
@@ -0,0 +1,547 @@
+/*
+ * EEBTPCore_Mutex.cc
+ *
+ *  Created on: 19.10.2026
+ *
+ *  The decisions are the ones of EEBTProtocolMutex, a temporary EEBTPNode
+ *  of a lock originator is replaced by its address.
+ */
+
+#include "EEBTPCore_Mutex.h"
+
+namespace eebtp
+{
+	CoreMutex::CoreMutex(Address myAddress, Transport *transport, Config config) : Core(myAddress, transport, config)
+	{
+	}
+
+	CoreMutex::~CoreMutex()
+	{
+	}
+
+	uint8_t CoreMutex::getVariant() const
+	{
+		return MUTEX;
+	}
+
+	//Cycle checks are the locks, they are handled only once like all other frames
+	bool CoreMutex::acceptFrame(Game *gs, const Frame &frame)
+	{
+		std::array<uint16_t, N_FRAME_TYPES> &lastSeqNos = gs->getLastSeqNos(frame.sender);
+		if (!Core::isNewerSeqNo(frame.seqNo, lastSeqNos[frame.frameType]))
+			return false;
+
+		lastSeqNos[frame.frameType] = frame.seqNo;
+
+		//Child confirmation of a locked parent
+		gs->newParentWaitingForLock = frame.neededLockUpdate;
+		gs->newParentWaitingLockOriginator = frame.neededLockUpdate ? frame.originator : NO_ADDRESS;
+		return true;
+	}
+
+	bool CoreMutex::checkNeighborDiscovery(Game *gs)
+	{
+		bool send = this->checkNeighborDiscoverySendEvent(gs);
+		return send && !gs->locked;
+	}
+
+	void CoreMutex::completeFrame(Game *gs, Frame &frame)
+	{
+		if (frame.frameType == CHILD_CONFIRMATION && gs->locked)
+		{
+			frame.neededLockUpdate = true;
+			frame.originator = gs->lockedBy;
+		}
+
+		frame.gameFinished = (gs->getNChilds() > 0 && gs->allChildsFinished()) || gs->finished;
+	}
+
+	void CoreMutex::scheduleRetransmission(Game *gs, const Frame &frame, double txPower)
+	{
+		if (frame.frameType != CYCLE_CHECK)
+			return Core::scheduleRetransmission(gs, frame, txPower);
+
+		std::shared_ptr<Retransmission> r = this->createRetransmission(gs, frame, txPower);
+		this->transport->schedule(this->config.ackTimeout * this->config.ackPollFactor, std::bind(&CoreMutex::onLockRetransmission, this, r));
+	}
+
+	//Checks if a lock needs a retransmission (MutexSendEvent)
+	void CoreMutex::onLockRetransmission(std::shared_ptr<Retransmission> r)
+	{
+		Game *gs = this->getGame(r->gid);
+
+		TxStatus status = this->transport->getTxStatus(r->seqNo);
+		if (status == TX_ACKED)
+			this->transport->releaseTxStatus(r->seqNo);
+		else if (status == TX_LOST || r->counter > this->config.maxRetransmissions)
+		{
+			//Only if the receiver is still our child or our parent
+			Neighbor *receiver = gs->getNeighbor(r->recipient);
+			if (receiver != 0 && (gs->isChild(receiver) || receiver == gs->parent))
+			{
+				Frame frame = Frame();
+				frame.frameType = CYCLE_CHECK;
+				frame.seqNo = r->seqNo;
+				frame.recipient = r->recipient;
+				frame.originator = r->originator;
+				frame.newParent = r->newParent;
+				frame.oldParent = r->oldParent;
+				this->sendFrame(gs, frame, receiver->reachPower + 1, true);
+			}
+			this->transport->releaseTxStatus(r->seqNo);
+		}
+		else
+			this->transport->schedule(this->config.ackTimeout * this->config.ackRetryFactor, std::bind(&CoreMutex::onLockRetransmission, this, r));
+
+		r->counter++;
+	}
+
+	//Send method for locking child nodes in subtree
+	void CoreMutex::sendLock(Game *gs, Neighbor *receiver, Address originator, Address newOriginator, Address lockHolder)
+	{
+		Frame frame = Frame();
+		frame.frameType = CYCLE_CHECK;
+		frame.recipient = receiver->address;
+		frame.originator = originator;
+		frame.newParent = newOriginator;
+		frame.oldParent = lockHolder;
+		this->sendFrame(gs, frame, receiver->reachPower, false);
+	}
+
+	/*
+	 * Handle the cycle check (FrameType 0), carries the locks
+	 */
+	void CoreMutex::handleCycleCheck(Game *gs, Neighbor *node, const Frame &frame)
+	{
+		this->handleLock(gs, node, frame.originator, frame.newParent, frame.oldParent);
+	}
+
+	void CoreMutex::handleLock(Game *gs, Neighbor *node, Address originator, Address newOriginator, Address lockHolder)
+	{
+		//The initiator cannot be a child of someone
+		if (gs->initiator)
+			return;
+
+		if (gs->parent == node)
+		{
+			//If we are currently locked by ourself, we probably want to switch our parent
+			if (gs->locked && gs->lockedBy == this->getAddress())
+			{
+				//If the game already finished, we note the lock request and look after it when we got rejected
+				if (gs->finished)
+				{
+					gs->parentWaitingForLock = true;
+					gs->parentWaitingLockOriginator = originator;
+				}
+				return;
+			}
+
+			if (originator != BROADCAST)
+			{
+				//New lock, lock the subtree and respond if we have no child nodes
+				if (originator != this->getAddress())
+				{
+					gs->lockedBy = originator;
+					this->lockChildNodes(gs);
+					this->checkNodeLocks(gs);
+				}
+			}
+			else if (newOriginator != BROADCAST)
+			{
+				//Updated lock
+				if (newOriginator != this->getAddress())
+				{
+					gs->lockedBy = newOriginator;
+					this->lockChildNodes(gs);
+					this->checkNodeLocks(gs);
+				}
+			}
+			else
+			{
+				//Unlock the subtree and broadcast neighbor discovery frames again
+				this->unlockChildNodes(gs);
+				this->send(gs, NEIGHBOR_DISCOVERY, BROADCAST, this->config.maxAllowedTxPower);
+			}
+		}
+		else if (gs->contactedParent == node)
+		{
+			//The child confirmation of the parent we want to connect to is late
+			gs->newParentWaitingForLock = true;
+			gs->newParentWaitingLockOriginator = originator;
+		}
+		else if (gs->isChild(node))
+		{
+			//A child confirms its locked subtree, if it is locked for our lock holder
+			if (lockHolder == gs->lockedBy)
+			{
+				gs->lock(node->address, true);
+				this->checkNodeLocks(gs);
+			}
+		}
+	}
+
+	/*
+	 * Handle neighbor discovery (FrameType 1)
+	 */
+	void CoreMutex::handleNeighborDiscovery(Game *gs, Neighbor *node)
+	{
+		if (gs->locked)
+			return;
+
+		if (gs->initiator)
+			gs->unchangedCounter = 0;
+
+		if (node->reachPower <= this->config.maxAllowedTxPower && !gs->isChild(node))
+			gs->rejectionCounter = 0;
+
+		Core::handleNeighborDiscovery(gs, node);
+	}
+
+	/*
+	 * Handle child request (FrameType 2)
+	 * Sent by child, received by parent
+	 */
+	void CoreMutex::handleChildRequest(Game *gs, Neighbor *node)
+	{
+		if (gs->checkLastFrameType(node->address, CHILD_REQUEST, gs->getLastSeqNo(node->address, PARENT_REVOCATION)))
+			return;
+
+		if (!gs->initiator && !gs->isChild(node))
+		{
+			if (gs->locked)
+			{
+				//Reject the lock holder (cycle), the node we want to connect to and requests after our own one (deadlocks)
+				if (gs->lockedBy == node->address)
+					return this->send(gs, CHILD_REJECTION, node->address, node->reachPower);
+				else if (node == gs->contactedParent)
+					return this->send(gs, CHILD_REJECTION, node->address, node->reachPower);
+				else if (gs->getNChildsLocked() >= gs->getNChilds())
+					return this->send(gs, CHILD_REJECTION, node->address, node->reachPower);
+			}
+			else if (gs->parent == 0 && gs->contactedParent == 0)
+			{
+				//We are not connected to the source node
+				this->send(gs, CHILD_REJECTION, node->address, node->reachPower);
+
+				if (gs->rejectionCounter > (gs->getNNeighbors() * 2) && gs->parent == 0)
+					return;
+				return this->contactCheapestNeighbor(gs);
+			}
+		}
+
+		Core::handleChildRequest(gs, node);
+	}
+
+	/*
+	 * Handle child confirmation (FrameType 3)
+	 * Sent by parent, received by child
+	 */
+	void CoreMutex::handleChildConfirmation(Game *gs, Neighbor *node)
+	{
+		if (gs->checkLastFrameType(node->address, CHILD_CONFIRMATION, gs->getLastSeqNo(node->address, CHILD_REJECTION)))
+			return;
+
+		if (gs->parent != 0)
+		{
+			//...and we did not contact a new one, send parent revocation to sender
+			if (gs->contactedParent != node)
+			{
+				if (gs->parent == node)
+					return;
+				return this->send(gs, PARENT_REVOCATION, node->address, node->reachPower);
+			}
+			else if (gs->finished)
+				this->disconnectOldParent(gs);
+		}
+		else if (node != gs->contactedParent)
+			return this->send(gs, PARENT_REVOCATION, node->address, node->reachPower);
+
+		//Set new parent
+		this->setParent(gs, node);
+		node->connCounter++;
+		gs->contactedParent = 0;
+
+		if (gs->doIncrementAfterConfirm)
+			gs->incrementUnchangedCounter();
+
+		//Check if we noted a possible better parent in the past
+		if (gs->unchangedCounter < this->config.maxUnchangedRounds && !gs->newParentWaitingForLock)
+			this->contactCheapestNeighbor(gs);
+
+		if (gs->contactedParent != 0)
+		{
+			if (!(gs->finished && gs->parent != 0))
+			{
+				gs->newParentWaitingForLock = false;
+				gs->newParentWaitingLockOriginator = NO_ADDRESS;
+			}
+			return;
+		}
+
+		gs->rejectionCounter = 0;
+
+		if (node->finished)
+			this->handleEndOfGame(gs, node);
+
+		//If we finished our game earlier, send END_OF_GAME to our parent
+		if (gs->finished)
+			this->send(gs, END_OF_GAME, gs->parent->address, gs->parent->reachPower);
+
+		if (gs->newParentWaitingForLock)
+		{
+			//Take over the lock of our new parent
+			gs->lockedBy = BROADCAST;
+			this->handleLock(gs, gs->parent, gs->newParentWaitingLockOriginator, BROADCAST, BROADCAST);
+
+			gs->newParentWaitingForLock = false;
+			gs->newParentWaitingLockOriginator = NO_ADDRESS;
+		}
+		else
+		{
+			this->unlockChildNodes(gs);
+
+			//Reset the unchanged counter, since our topology changed
+			if (!gs->doIncrementAfterConfirm && gs->unchangedCounter < this->config.maxUnchangedRounds)
+				gs->unchangedCounter = 0;
+			gs->doIncrementAfterConfirm = false;
+
+			//Inform our neighbors
+			this->send(gs, NEIGHBOR_DISCOVERY, BROADCAST, this->config.maxAllowedTxPower);
+		}
+	}
+
+	/*
+	 * Handle child rejection (FrameType 4)
+	 * Sent by parent, received by child
+	 */
+	void CoreMutex::handleChildRejection(Game *gs, Neighbor *node)
+	{
+		if (gs->checkLastFrameType(node->address, CHILD_REJECTION, gs->getLastSeqNo(node->address, CHILD_CONFIRMATION)))
+			return;
+
+		//Check if node is our parent or the node we want to connect to
+		if (node != gs->parent && node != gs->contactedParent)
+			return;
+
+		if (node == gs->parent)
+		{
+			this->setParent(gs, 0);
+
+			//If we are locked (not by ourself), we need to update the lock since we must connect to a new parent
+			if (gs->locked && gs->lockedBy != this->getAddress())
+			{
+				gs->locked = false;
+				gs->resetChildLocks();
+				gs->contactedParent = 0;
+			}
+		}
+		else
+			node->connCounter++;
+
+		gs->resetNeighborDiscoveryEvent();
+
+		//Add contacted parent to blacklist (only if is was not a reach power problem)
+		if (!node->reachPowerProblem)
+			this->updateBlacklist(gs, node->address, node->parent);
+
+		gs->contactedParent = 0;
+
+		if (gs->rejectionCounter > (gs->getNNeighbors() * 2) && gs->parent == 0)
+		{
+			//Failed too often, waiting for new neighbor discovery frames
+			gs->locked = false;
+			this->resetBlacklist(gs);
+			gs->resetChildLocks();
+			this->disconnectAllChildNodes(gs);
+			gs->lockedBy = BROADCAST;
+			this->send(gs, NEIGHBOR_DISCOVERY, BROADCAST, this->config.maxAllowedTxPower);
+			return;
+		}
+
+		this->contactCheapestNeighbor(gs);
+
+		if (gs->contactedParent == 0)
+		{
+			node->connCounter = 0;
+
+			//If we are still connected to our parent while the game is finished...
+			if (gs->finished && gs->parent != 0)
+			{
+				//...and our parent is waiting for its lock, update the subtree
+				if (gs->parentWaitingForLock)
+				{
+					gs->lockedBy = BROADCAST;
+					this->handleLock(gs, gs->parent, BROADCAST, gs->parentWaitingLockOriginator, BROADCAST);
+				}
+				else
+					this->unlockChildNodes(gs);
+			}
+			else
+			{
+				//Disconnect child nodes and try again
+				this->disconnectAllChildNodes(gs);
+				this->contactCheapestNeighbor(gs);
+
+				if (gs->contactedParent == 0)
+				{
+					gs->locked = false;
+					gs->resetChildLocks();
+					gs->lockedBy = BROADCAST;
+				}
+			}
+		}
+
+		gs->doIncrementAfterConfirm = false;
+		gs->unchangedCounter = 0;
+		gs->rejectionCounter++;
+	}
+
+	/*
+	 * Handle parent revocation (FrameType 5)
+	 * Sent by child, received by parent
+	 */
+	void CoreMutex::handleParentRevocation(Game *gs, Neighbor *node)
+	{
+		if (gs->checkLastFrameType(node->address, PARENT_REVOCATION, gs->getLastSeqNo(node->address, CHILD_REQUEST)))
+			return;
+
+		if (!gs->isChild(node->address))
+			return;
+
+		gs->lock(node->address, false);
+		gs->removeChild(node);
+
+		if (!gs->finished)
+		{
+			gs->unchangedCounter = 0;
+			gs->resetNeighborDiscoveryEvent();
+
+			if ((!gs->locked && gs->parent != 0) || gs->initiator)
+				this->send(gs, NEIGHBOR_DISCOVERY, BROADCAST, this->config.maxAllowedTxPower);
+		}
+
+		this->checkNodeLocks(gs);
+	}
+
+	/*
+	 * Helper methods
+	 */
+
+	//Locks the subtree before the CHILD_REQUEST is sent
+	void CoreMutex::contactNode(Game *gs, Neighbor *node)
+	{
+		if (!gs->locked)
+		{
+			gs->contactedParent = node;
+			gs->resetNeighborDiscoveryEvent();
+
+			if (!gs->finished)
+				this->disconnectOldParent(gs);
+
+			gs->lockedBy = this->getAddress();
+			this->lockChildNodes(gs);
+			this->checkNodeLocks(gs);
+			return;
+		}
+
+		//Locked by someone else
+		if (gs->lockedBy != this->getAddress())
+			return;
+
+		if (node == gs->parent)
+		{
+			if (gs->parentWaitingForLock)
+			{
+				gs->lockedBy = gs->parentWaitingLockOriginator;
+				this->lockChildNodes(gs);
+				this->checkNodeLocks(gs);
+			}
+			else
+				this->unlockChildNodes(gs);
+		}
+		else if (!(gs->finished && gs->getNChildsLocked() < gs->getNChilds()))
+		{
+			//Our subtree is locked, contact the node
+			gs->contactedParent = 0;
+			Core::contactNode(gs, node);
+		}
+	}
+
+	void CoreMutex::lockChildNodes(Game *gs)
+	{
+		bool wasLockedBefore = gs->locked;
+		gs->locked = true;
+
+		gs->resetChildLocks();
+		gs->unchangedCounter = 0;
+		gs->resetNeighborDiscoveryEvent();
+
+		for (uint32_t i = 0; i < gs->getNChilds(); i++)
+		{
+			if (wasLockedBefore)
+				this->sendLock(gs, gs->getChild(i), BROADCAST, gs->lockedBy, BROADCAST);
+			else
+				this->sendLock(gs, gs->getChild(i), gs->lockedBy, BROADCAST, BROADCAST);
+		}
+	}
+
+	void CoreMutex::unlockChildNodes(Game *gs)
+	{
+		gs->locked = false;
+
+		if (gs->getNChilds() > 0)
+		{
+			for (uint32_t i = 0; i < gs->getNChilds(); i++)
+			{
+				gs->lock(gs->getChild(i)->address, false);
+				this->sendLock(gs, gs->getChild(i), BROADCAST, BROADCAST, BROADCAST);
+			}
+			gs->resetChildLocks();
+		}
+
+		gs->lockedBy = BROADCAST;
+	}
+
+	void CoreMutex::disconnectOldParent(Game *gs)
+	{
+		gs->parentWaitingForLock = false;
+		gs->parentWaitingLockOriginator = NO_ADDRESS;
+
+		Core::disconnectOldParent(gs);
+	}
+
+	/*
+	 * Check the lock status
+	 * If all child nodes are locked, the node we locked for gets contacted or
+	 * our parent is informed that our subtree is locked
+	 */
+	void CoreMutex::checkNodeLocks(Game *gs)
+	{
+		if (!gs->locked || gs->getNChildsLocked() < gs->getNChilds() || gs->initiator)
+			return;
+
+		if (gs->lockedBy != this->getAddress())
+		{
+			if (gs->parent != 0)
+				this->sendLock(gs, gs->parent, BROADCAST, BROADCAST, gs->lockedBy);
+			return;
+		}
+
+		if (gs->contactedParent == 0)
+			return this->unlockChildNodes(gs);
+
+		//Check if there is a possible better parent then the one we want to connect to
+		Neighbor *cheapestNeighbor = gs->getCheapestNeighbor();
+		if (cheapestNeighbor == 0)
+		{
+			//All nodes are out of range
+			gs->contactedParent = 0;
+			gs->locked = false;
+			gs->resetChildLocks();
+			gs->lockedBy = BROADCAST;
+			this->disconnectAllChildNodes(gs);
+		}
+		else
+			this->contactNode(gs, cheapestNeighbor);
+	}
+}
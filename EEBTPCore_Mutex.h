@@ -0,0 +1,62 @@
+/*
+ * EEBTPCore_Mutex.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#ifndef BROADCAST_EEBTPCORE_MUTEX_H_
+#define BROADCAST_EEBTPCORE_MUTEX_H_
+
+#include "EEBTPCore.h"
+
+namespace eebtp
+{
+	/*
+	 * Cycle prevention MUTEX (EEBTProtocolMutex)
+	 *
+	 * Before a node contacts a new parent it locks its subtree. The locks
+	 * are CYCLE_CHECK frames to the child nodes:
+	 * 	- originator: new lock holder
+	 * 	- newParent: updated lock holder
+	 * 	- oldParent: lock holder a child confirms its locked subtree for
+	 * If all fields are BROADCAST, the subtree is unlocked.
+	 */
+	class CoreMutex : public Core
+	{
+	public:
+		CoreMutex(Address myAddress, Transport *transport, Config config);
+		virtual ~CoreMutex();
+
+		virtual uint8_t getVariant() const;
+
+	protected:
+		virtual bool acceptFrame(Game *gs, const Frame &frame);
+		virtual bool checkNeighborDiscovery(Game *gs);
+		virtual void completeFrame(Game *gs, Frame &frame);
+		virtual void scheduleRetransmission(Game *gs, const Frame &frame, double txPower);
+
+		virtual void handleCycleCheck(Game *gs, Neighbor *node, const Frame &frame);
+		virtual void handleNeighborDiscovery(Game *gs, Neighbor *node);
+		virtual void handleChildRequest(Game *gs, Neighbor *node);
+		virtual void handleChildConfirmation(Game *gs, Neighbor *node);
+		virtual void handleChildRejection(Game *gs, Neighbor *node);
+		virtual void handleParentRevocation(Game *gs, Neighbor *node);
+
+		virtual void contactNode(Game *gs, Neighbor *node);
+
+		//Hides Core::disconnectOldParent(), the handlers of Core still use the one of Core
+		void disconnectOldParent(Game *gs);
+
+	private:
+		void handleLock(Game *gs, Neighbor *node, Address originator, Address newOriginator, Address lockHolder);
+
+		void sendLock(Game *gs, Neighbor *receiver, Address originator, Address newOriginator, Address lockHolder);
+		void onLockRetransmission(std::shared_ptr<Retransmission> r);
+
+		void lockChildNodes(Game *gs);
+		void unlockChildNodes(Game *gs);
+		void checkNodeLocks(Game *gs);
+	};
+}
+
+#endif /* BROADCAST_EEBTPCORE_MUTEX_H_ */
@@ -0,0 +1,307 @@
+/*
+ * EEBTPCore_SrcPath.cc
+ *
+ *  Created on: 19.10.2026
+ *
+ *  The decisions are the ones of EEBTProtocolSrcPath, the ParentPathCheckEvent
+ *  is a cancel flag shared by all pending firings (Game::ppcEvent).
+ */
+
+#include "algorithm"
+
+#include "EEBTPCore_SrcPath.h"
+
+namespace eebtp
+{
+	CoreSrcPath::CoreSrcPath(Address myAddress, Transport *transport, Config config) : Core(myAddress, transport, config)
+	{
+		this->timeToWait = this->config.ackTimeout * this->config.ackPollFactor * 3 / 2;
+	}
+
+	CoreSrcPath::~CoreSrcPath()
+	{
+	}
+
+	uint8_t CoreSrcPath::getVariant() const
+	{
+		return PATH_TO_SRC;
+	}
+
+	//Cycle checks request the path, they are handled only once like all other frames
+	bool CoreSrcPath::acceptFrame(Game *gs, const Frame &frame)
+	{
+		std::array<uint16_t, N_FRAME_TYPES> &lastSeqNos = gs->getLastSeqNos(frame.sender);
+		if (!Core::isNewerSeqNo(frame.seqNo, lastSeqNos[frame.frameType]))
+			return false;
+
+		lastSeqNos[frame.frameType] = frame.seqNo;
+		return true;
+	}
+
+	//Updates the path to the source of the sender
+	void CoreSrcPath::dispatch(Game *gs, Neighbor *node, const Frame &frame)
+	{
+		uint8_t ft = frame.frameType;
+		if ((ft == CYCLE_CHECK || ft == NEIGHBOR_DISCOVERY || ft == CHILD_CONFIRMATION) && frame.srcPath.size() > 0)
+			node->setSrcPath(frame.srcPath);
+
+		Core::dispatch(gs, node, frame);
+	}
+
+	//After the game is finished, neighbor discovery frames are sent on every change
+	bool CoreSrcPath::checkNeighborDiscovery(Game *gs)
+	{
+		if (!gs->finished)
+			return this->checkNeighborDiscoverySendEvent(gs);
+
+		gs->resetNeighborDiscoveryEvent();
+		return true;
+	}
+
+	void CoreSrcPath::completeFrame(Game *gs, Frame &frame)
+	{
+		uint8_t ft = frame.frameType;
+		if (ft == CYCLE_CHECK || ft == NEIGHBOR_DISCOVERY || ft == CHILD_CONFIRMATION)
+		{
+			//Path of our parent (or the one we connect to) with us at the end
+			frame.srcPath.clear();
+			if (gs->parent != 0)
+				frame.srcPath = gs->parent->srcPath;
+			else if (gs->contactedParent != 0)
+				frame.srcPath = gs->contactedParent->srcPath;
+
+			if (gs->parent != 0 || gs->contactedParent != 0 || gs->initiator)
+				frame.srcPath.push_back(this->getAddress());
+		}
+
+		frame.parent = this->getAddress();
+		frame.gameFinished = (gs->getNChilds() > 0 && gs->allChildsFinished()) || gs->finished;
+	}
+
+	//Cycle checks are retransmitted like all other unicast frames (SendEvent)
+	void CoreSrcPath::scheduleRetransmission(Game *gs, const Frame &frame, double txPower)
+	{
+		std::shared_ptr<Retransmission> r = this->createRetransmission(gs, frame, txPower);
+		this->transport->schedule(this->config.ackTimeout * this->config.ackPollFactor, std::bind(&CoreSrcPath::onRetransmission, this, r));
+	}
+
+	//EEBTProtocolSrcPath schedules the check at Now() + timeToWait as a delay, so it came later the longer the game ran
+	void CoreSrcPath::scheduleParentPathCheck(Game *gs)
+	{
+		this->transport->schedule(this->timeToWait, std::bind(&CoreSrcPath::onParentPathCheck, this, gs->gameId, gs->ppcEvent));
+	}
+
+	void CoreSrcPath::onParentPathCheck(uint64_t gid, std::shared_ptr<bool> event)
+	{
+		if (*event)
+			return;
+		this->checkParentPathStatus(this->getGame(gid));
+	}
+
+	/*
+	 * Handle the cycle check (FrameType 0), requests our path
+	 */
+	void CoreSrcPath::handleCycleCheck(Game *gs, Neighbor *node, const Frame &)
+	{
+		if (gs->isChild(node))
+			return this->send(gs, CYCLE_CHECK, node->address, node->reachPower);
+
+		if (node != gs->parent)
+			return;
+
+		gs->lastParentUpdate = this->transport->now();
+		if (!gs->initiator && this->checkParentPath(gs) && node->pathChanged && !gs->ndEvent && gs->contactedParent == 0)
+		{
+			gs->parentUnchangedCounter = 0;
+			this->send(gs, NEIGHBOR_DISCOVERY, BROADCAST, this->config.maxAllowedTxPower);
+			if (gs->finished)
+				this->send(gs, NEIGHBOR_DISCOVERY, BROADCAST, this->config.maxAllowedTxPower);
+		}
+		else
+			gs->parentUnchangedCounter++;
+
+		if (gs->ppcEvent)
+			*gs->ppcEvent = true;
+		gs->ppcEvent = std::make_shared<bool>(false);
+		this->scheduleParentPathCheck(gs);
+	}
+
+	/*
+	 * Handle neighbor discovery (FrameType 1)
+	 */
+	void CoreSrcPath::handleNeighborDiscovery(Game *gs, Neighbor *node)
+	{
+		if (gs->initiator || !this->checkParentPath(gs))
+			return;
+
+		Core::handleNeighborDiscovery(gs, node);
+
+		if (gs->parent != node)
+			return;
+
+		gs->lastParentUpdate = this->transport->now();
+
+		//If our parent's path has changed, check it again later
+		if (gs->contactedParent == 0)
+		{
+			if (node->pathChanged)
+			{
+				gs->parentUnchangedCounter = 0;
+				if (!gs->ppcEvent)
+					gs->ppcEvent = std::make_shared<bool>(false);
+				else if (!*gs->ppcEvent)
+					this->scheduleParentPathCheck(gs);
+			}
+			else
+				gs->parentUnchangedCounter++;
+		}
+	}
+
+	/*
+	 * Handle child request (FrameType 2)
+	 * Sent by child, received by parent
+	 */
+	void CoreSrcPath::handleChildRequest(Game *gs, Neighbor *node)
+	{
+		//Reject nodes on the path of our parent
+		const std::vector<Address> *path = 0;
+		if (gs->parent != 0)
+			path = &gs->parent->srcPath;
+		else if (gs->contactedParent != 0)
+			path = &gs->contactedParent->srcPath;
+
+		if (path != 0 && std::find(path->begin(), path->end(), node->address) != path->end())
+			return this->send(gs, CHILD_REJECTION, node->address, node->reachPower);
+
+		Core::handleChildRequest(gs, node);
+	}
+
+	/*
+	 * Handle child confirmation (FrameType 3)
+	 * Sent by parent, received by child
+	 */
+	void CoreSrcPath::handleChildConfirmation(Game *gs, Neighbor *node)
+	{
+		if (gs->checkLastFrameType(node->address, CHILD_CONFIRMATION, gs->getLastSeqNo(node->address, CHILD_REJECTION)))
+			return;
+
+		if (gs->parent != 0)
+		{
+			//...and we did not contact a new one, send parent revocation to sender
+			if (gs->contactedParent != node)
+			{
+				if (gs->parent == node)
+					return;
+				return this->send(gs, PARENT_REVOCATION, node->address, node->reachPower);
+			}
+			else if (gs->finished)
+				this->disconnectOldParent(gs);
+		}
+		else if (node != gs->contactedParent)
+			return this->send(gs, PARENT_REVOCATION, node->address, node->reachPower);
+
+		//Set new parent
+		this->setParent(gs, node);
+		node->connCounter++;
+		gs->contactedParent = 0;
+
+		if (gs->doIncrementAfterConfirm)
+			gs->incrementUnchangedCounter();
+
+		//Check if we noted a possible better parent in the past
+		if (gs->unchangedCounter < this->config.maxUnchangedRounds)
+			this->contactCheapestNeighbor(gs);
+
+		if (gs->contactedParent != 0 || !this->checkParentPath(gs))
+			return;
+
+		gs->emptyPathOnConnect = node->srcPath.empty();
+
+		if (node->finished)
+			this->handleEndOfGame(gs, node);
+
+		//If we finished our game earlier, send END_OF_GAME to our parent
+		if (gs->finished)
+			this->send(gs, END_OF_GAME, gs->parent->address, gs->parent->reachPower);
+
+		gs->lastParentUpdate = this->transport->now();
+		gs->parentUnchangedCounter = 0;
+		if (!gs->ppcEvent)
+			gs->ppcEvent = std::make_shared<bool>(false);
+		this->scheduleParentPathCheck(gs);
+
+		//Reset the unchanged counter, since our topology changed
+		if (!gs->doIncrementAfterConfirm && gs->unchangedCounter < this->config.maxUnchangedRounds)
+			gs->unchangedCounter = 0;
+		gs->doIncrementAfterConfirm = false;
+
+		this->send(gs, NEIGHBOR_DISCOVERY, BROADCAST, this->config.maxAllowedTxPower);
+
+		gs->rejectionCounter = 0;
+	}
+
+	/*
+	 * Helper methods
+	 */
+	void CoreSrcPath::contactNode(Game *gs, Neighbor *node)
+	{
+		//We are on the path of the node
+		if (node->isOnPath(this->getAddress()))
+			return;
+
+		Core::contactNode(gs, node);
+	}
+
+	//Leaves the parent if we are on its path (cycle), returns false in that case
+	bool CoreSrcPath::checkParentPath(Game *gs)
+	{
+		Neighbor *parent = gs->parent;
+		if (parent != 0 && (parent->isOnPath(this->getAddress()) || (gs->emptyPathOnConnect && parent->srcPath.empty())))
+		{
+			gs->parentUnchangedCounter = 0;
+			gs->resetNeighborDiscoveryEvent();
+
+			this->disconnectOldParent(gs);
+			this->contactCheapestNeighbor(gs);
+
+			if (gs->contactedParent == 0)
+			{
+				//If this also fails, disconnect child nodes and try again
+				this->disconnectAllChildNodes(gs);
+				this->resetBlacklist(gs);
+				this->contactCheapestNeighbor(gs);
+
+				//Waiting for new neighbor discovery frames
+				if (gs->contactedParent == 0)
+					gs->rejectionCounter = (gs->getNNeighbors() * 2) + 1;
+			}
+
+			gs->doIncrementAfterConfirm = false;
+			gs->unchangedCounter = 0;
+			return false;
+		}
+
+		gs->emptyPathOnConnect = false;
+		return true;
+	}
+
+	//Requests the path of our parent if it did not send it for timeToWait
+	void CoreSrcPath::checkParentPathStatus(Game *gs)
+	{
+		if (gs->contactedParent != 0)
+			return;
+
+		Neighbor *parent = gs->parent;
+		if (parent == 0 || gs->parentUnchangedCounter > 5)
+			return;
+
+		if (this->transport->now() > gs->lastParentUpdate + this->timeToWait)
+		{
+			if (gs->ppcEvent)
+				*gs->ppcEvent = true;
+			this->send(gs, CYCLE_CHECK, parent->address, parent->reachPower);
+		}
+		else if (gs->ppcEvent)
+			this->scheduleParentPathCheck(gs);
+	}
+}
@@ -0,0 +1,60 @@
+/*
+ * EEBTPCore_SrcPath.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#ifndef BROADCAST_EEBTPCORE_SRCPATH_H_
+#define BROADCAST_EEBTPCORE_SRCPATH_H_
+
+#include "EEBTPCore.h"
+
+namespace eebtp
+{
+	/*
+	 * Cycle prevention PATH_TO_SRC (EEBTProtocolSrcPath)
+	 *
+	 * Cycle checks, neighbor discoveries and child confirmations carry the
+	 * path to the initiator (Frame::srcPath). A node never connects to a
+	 * node that has it on its path and leaves its parent as soon as it is
+	 * on the path of its parent. If the parent stays silent, the path is
+	 * requested with a cycle check (parent path check).
+	 *
+	 * The frames have no parent field, the sender is taken as the parent of
+	 * itself like in EEBTProtocolSrcPath (Frame::parent is the sender).
+	 */
+	class CoreSrcPath : public Core
+	{
+	public:
+		CoreSrcPath(Address myAddress, Transport *transport, Config config);
+		virtual ~CoreSrcPath();
+
+		virtual uint8_t getVariant() const;
+
+	protected:
+		virtual bool acceptFrame(Game *gs, const Frame &frame);
+		virtual void dispatch(Game *gs, Neighbor *node, const Frame &frame);
+		virtual bool checkNeighborDiscovery(Game *gs);
+		virtual void completeFrame(Game *gs, Frame &frame);
+		virtual void scheduleRetransmission(Game *gs, const Frame &frame, double txPower);
+
+		virtual void handleCycleCheck(Game *gs, Neighbor *node, const Frame &frame);
+		virtual void handleNeighborDiscovery(Game *gs, Neighbor *node);
+		virtual void handleChildRequest(Game *gs, Neighbor *node);
+		virtual void handleChildConfirmation(Game *gs, Neighbor *node);
+
+		virtual void contactNode(Game *gs, Neighbor *node);
+
+		bool checkParentPath(Game *gs);
+
+	private:
+		//ns, 1.5 ack polls. EEBTProtocolSrcPath computes the value in us but waits as many ms
+		int64_t timeToWait;
+
+		void scheduleParentPathCheck(Game *gs);
+		void onParentPathCheck(uint64_t gid, std::shared_ptr<bool> event);
+		void checkParentPathStatus(Game *gs);
+	};
+}
+
+#endif /* BROADCAST_EEBTPCORE_SRCPATH_H_ */
@@ -17,6 +17,7 @@ namespace ns3
 	{
 		this->seqNo = 0;
 		this->dataLen = 0;
+		this->originTime = 0;
 	}
 
 	EEBTPDataHeader::~EEBTPDataHeader()
@@ -46,7 +47,7 @@ namespace ns3
 
 	uint32_t EEBTPDataHeader::GetSerializedSize() const
 	{
-		uint32_t sSize = 8;
+		uint32_t sSize = 8 + EEBTPDataHeader::ORIGIN_TIME_SIZE;
 
 		return sSize;
 	}
@@ -56,16 +57,20 @@ namespace ns3
 		start.WriteU32(this->seqNo);
 
 		start.WriteU32(this->dataLen);
+
+		start.WriteU64(this->originTime);
 	}
 
 	uint32_t EEBTPDataHeader::Deserialize(Buffer::Iterator start)
 	{
-		uint32_t bytesRead = 8;
+		uint32_t bytesRead = 8 + EEBTPDataHeader::ORIGIN_TIME_SIZE;
 
 		this->seqNo = start.ReadU32();
 
 		this->dataLen = start.ReadU32();
 
+		this->originTime = start.ReadU64();
+
 		return bytesRead;
 	}
 
@@ -94,4 +99,23 @@ namespace ns3
 	{
 		this->dataLen = len;
 	}
+
+	/*
+	 * Getter and Setter for the origin time
+	 */
+	int64_t EEBTPDataHeader::GetOriginTime()
+	{
+		return this->originTime;
+	}
+
+	void EEBTPDataHeader::SetOriginTime(int64_t time)
+	{
+		this->originTime = time;
+	}
+
+	//Bytes of payload after the header, so header and payload are 8 + 'dataLength' bytes
+	uint32_t EEBTPDataHeader::GetPayloadSize(uint32_t dataLength)
+	{
+		return (dataLength > EEBTPDataHeader::ORIGIN_TIME_SIZE) ? dataLength - EEBTPDataHeader::ORIGIN_TIME_SIZE : 0;
+	}
 }
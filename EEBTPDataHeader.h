@@ -12,9 +12,17 @@
 
 namespace ns3
 {
+	/*
+	 * Header of the application data. The origin time (set by the initiator,
+	 * kept by every forwarder) takes ORIGIN_TIME_SIZE bytes of the data, the
+	 * senders shorten the payload by these bytes so the frames keep their
+	 * size on air.
+	 */
 	class EEBTPDataHeader : public Header
 	{
 	public:
+		static const uint32_t ORIGIN_TIME_SIZE = 8;
+
 		EEBTPDataHeader();
 		virtual ~EEBTPDataHeader();
 
@@ -31,9 +39,16 @@ namespace ns3
 		uint32_t GetDataLength();
 		void SetDataLength(uint32_t len);
 
+		//Nanoseconds
+		int64_t GetOriginTime();
+		void SetOriginTime(int64_t time);
+
+		static uint32_t GetPayloadSize(uint32_t dataLength);
+
 	protected:
 		uint32_t seqNo;
 		uint32_t dataLen;
+		int64_t originTime;
 	};
 }
 
@@ -0,0 +1,388 @@
+/*
+ * EEBTPEnergyAttribution.cc
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include "ns3/log.h"
+#include "ns3/double.h"
+#include "ns3/pointer.h"
+#include "ns3/simulator.h"
+#include "ns3/wifi-utils.h"
+#include "ns3/wifi-radio-energy-model.h"
+
+#include "EEBTPEnergyAttribution.h"
+
+namespace ns3
+{
+	NS_LOG_COMPONENT_DEFINE("EEBTPEnergyAttribution");
+	NS_OBJECT_ENSURE_REGISTERED(EEBTPEnergyAttribution);
+
+	//IDLE, CCA_BUSY, TX, RX, SWITCHING, SLEEP, OFF
+	const uint8_t EEBTPEnergyAttribution::N_STATES = 7;
+
+	EEBTPEnergyAttribution::EEBTPEnergyAttribution()
+	{
+		this->nodeId = 0;
+		this->voltage = 0;
+		this->idleCurrent = 0;
+		this->ccaBusyCurrent = 0;
+		this->rxCurrent = 0;
+		this->txCurrent = 0;
+		this->switchingCurrent = 0;
+		this->sleepCurrent = 0;
+
+		this->hasPending = false;
+
+		this->nextTxKnown = false;
+		this->nextTxGid = 0;
+		this->nextTxFt = 0;
+		this->nextTxPower = 0;
+
+		this->nextRxKnown = false;
+		this->nextRxGid = 0;
+		this->nextRxFt = 0;
+
+		this->stateEnergy = std::vector<double>(EEBTPEnergyAttribution::N_STATES, 0.0);
+		this->unattributedEnergy = 0;
+	}
+
+	EEBTPEnergyAttribution::~EEBTPEnergyAttribution()
+	{
+		this->frameEnergyRecv.clear();
+		this->frameEnergySent.clear();
+		this->stateEnergy.clear();
+	}
+
+	TypeId EEBTPEnergyAttribution::GetTypeId()
+	{
+		static TypeId tid = TypeId("ns3::EEBTPEnergyAttribution")
+								.SetParent<Object>()
+								.AddConstructor<EEBTPEnergyAttribution>();
+		return tid;
+	}
+
+	TypeId EEBTPEnergyAttribution::GetInstanceTypeId() const
+	{
+		return GetTypeId();
+	}
+
+	/*
+	 * Reads the supply voltage and the state currents of the WifiRadioEnergyModel
+	 * installed on the node of the given device and connects to the PHY state trace
+	 */
+	void EEBTPEnergyAttribution::setDevice(Ptr<WifiNetDevice> device)
+	{
+		this->device = device;
+		this->nodeId = this->device->GetNode()->GetId();
+		this->energySource = this->device->GetNode()->GetObject<EnergySourceContainer>()->Get(0);
+		this->voltage = this->energySource->GetSupplyVoltage();
+
+		DeviceEnergyModelContainer models = this->energySource->FindDeviceEnergyModels("ns3::WifiRadioEnergyModel");
+		if (models.GetN() > 0)
+		{
+			Ptr<DeviceEnergyModel> model = models.Get(0);
+			this->energyModel = model;
+
+			DoubleValue current;
+			model->GetAttribute("IdleCurrentA", current);
+			this->idleCurrent = current.Get();
+			model->GetAttribute("CcaBusyCurrentA", current);
+			this->ccaBusyCurrent = current.Get();
+			model->GetAttribute("RxCurrentA", current);
+			this->rxCurrent = current.Get();
+			model->GetAttribute("TxCurrentA", current);
+			this->txCurrent = current.Get();
+			model->GetAttribute("SwitchingCurrentA", current);
+			this->switchingCurrent = current.Get();
+			model->GetAttribute("SleepCurrentA", current);
+			this->sleepCurrent = current.Get();
+
+			PointerValue ptr;
+			model->GetAttribute("TxCurrentModel", ptr);
+			this->txCurrentModel = ptr.Get<WifiTxCurrentModel>();
+		}
+		else
+			NS_LOG_ERROR("[Node " << this->device->GetNode()->GetId() << "]: No WifiRadioEnergyModel installed. Energy attribution is disabled.");
+
+		PointerValue ptr;
+		this->device->GetPhy()->GetAttribute("State", ptr);
+		Ptr<WifiPhyStateHelper> stateHelper = DynamicCast<WifiPhyStateHelper>(ptr.Get<WifiPhyStateHelper>());
+		stateHelper->TraceConnectWithoutContext("State", MakeCallback(&EEBTPEnergyAttribution::onPhyStateChanged, this));
+	}
+
+	/*
+	 * Frame hooks
+	 * 	- setTxFrame: The next TX interval belongs to this frame (called on PhyTxBegin)
+	 * 	- setTxUnknown: The next TX interval belongs to a frame of another protocol or the MAC
+	 * 	- setRxFrame: The current or the next RX interval belongs to this frame (called on PhyRxBegin)
+	 */
+	void EEBTPEnergyAttribution::setTxFrame(uint64_t gid, uint8_t ft, double txPowerDbm)
+	{
+		this->nextTxKnown = true;
+		this->nextTxGid = gid;
+		this->nextTxFt = ft;
+		this->nextTxPower = txPowerDbm;
+	}
+
+	void EEBTPEnergyAttribution::setTxUnknown(double txPowerDbm)
+	{
+		this->nextTxKnown = false;
+		this->nextTxPower = txPowerDbm;
+	}
+
+	void EEBTPEnergyAttribution::setRxFrame(uint64_t gid, uint8_t ft)
+	{
+		//EEBTPLinkLayer logs the RX interval when it starts...
+		if (this->hasPending && this->pending.state == WifiPhyState::RX && this->pending.start == Now())
+		{
+			this->pending.known = true;
+			this->pending.gid = gid;
+			this->pending.ft = ft;
+			return;
+		}
+
+		//...the WifiPhyStateHelper only when it ends or a TX interrupts it
+		this->nextRxKnown = true;
+		this->nextRxGid = gid;
+		this->nextRxFt = ft;
+		this->nextRxTime = Now();
+	}
+
+	void EEBTPEnergyAttribution::onPhyStateChanged(Time start, Time duration, WifiPhyState state)
+	{
+		if (this->hasPending)
+		{
+			//An interrupted reception is logged a second time with its real duration
+			if (state == this->pending.state && start == this->pending.start)
+			{
+				this->pending.duration = duration;
+				return;
+			}
+
+			this->flushPending(start);
+		}
+
+		Interval interval;
+		interval.start = start;
+		interval.duration = duration;
+		interval.state = state;
+		interval.current = this->getStateCurrent(state);
+		interval.known = false;
+		interval.gid = 0;
+		interval.ft = 0;
+
+		if (state == WifiPhyState::TX)
+		{
+			interval.current = this->getTxCurrent(this->nextTxPower);
+			interval.known = this->nextTxKnown;
+			interval.gid = this->nextTxGid;
+			interval.ft = this->nextTxFt;
+			this->nextTxKnown = false;
+		}
+		else if (state == WifiPhyState::RX && this->nextRxKnown && this->nextRxTime <= start + duration)
+		{
+			interval.known = true;
+			interval.gid = this->nextRxGid;
+			interval.ft = this->nextRxFt;
+			this->nextRxKnown = false;
+		}
+
+		this->pending = interval;
+		this->hasPending = true;
+
+		//Only TX and RX intervals can be interrupted or need a frame, everything else is final
+		if (state != WifiPhyState::TX && state != WifiPhyState::RX)
+			this->flushPending(start + duration);
+	}
+
+	void EEBTPEnergyAttribution::flushPending(Time limit)
+	{
+		Time end = this->pending.start + this->pending.duration;
+		if (limit < end)
+			end = std::max(limit, this->pending.start);
+
+		double energy = this->integrate(this->pending.current, end - this->pending.start);
+		this->stateEnergy[static_cast<uint8_t>(this->pending.state)] += energy;
+
+		if (this->recorder != 0)
+			this->record(this->pending, end, energy);
+
+		if (this->pending.state == WifiPhyState::TX || this->pending.state == WifiPhyState::RX)
+		{
+			if (!this->pending.known)
+				this->unattributedEnergy += energy;
+			else if (this->pending.state == WifiPhyState::TX)
+				this->frameEnergySent[this->pending.gid][this->pending.ft] += energy;
+			else
+				this->frameEnergyRecv[this->pending.gid][this->pending.ft] += energy;
+		}
+
+		if (end > this->lastEnd)
+			this->lastEnd = end;
+		this->hasPending = false;
+	}
+
+	/*
+	 * Time series recording
+	 * 	- setRecorder: Forward all intervals to the given recorder and record the
+	 * 		deltas of the 'TotalEnergyConsumption' trace of the energy model
+	 * 	- flushRecorder: Records the (idle) time since the last logged state up to now
+	 */
+	void EEBTPEnergyAttribution::setRecorder(Ptr<EEBTPEnergyRecorder> recorder)
+	{
+		this->recorder = recorder;
+		this->recordedUntil = Now();
+
+		if (this->energyModel != 0)
+			this->energyModel->TraceConnectWithoutContext("TotalEnergyConsumption", MakeCallback(&EEBTPEnergyAttribution::onTotalEnergyConsumption, this));
+	}
+
+	void EEBTPEnergyAttribution::onTotalEnergyConsumption(double oldValue, double newValue)
+	{
+		this->recorder->addEnergy(this->nodeId, Now(), newValue - oldValue, EEBTPEnergyRecorder::MODEL_TOTAL);
+	}
+
+	void EEBTPEnergyAttribution::flushRecorder()
+	{
+		if (this->recorder == 0)
+			return;
+
+		if (this->hasPending && this->pending.start + this->pending.duration <= Now())
+			this->flushPending(Now());
+
+		Time start = std::max(this->lastEnd, this->recordedUntil);
+		if (!this->hasPending && Now() > start)
+			this->recorder->addInterval(this->nodeId, start, Now(), this->integrate(this->idleCurrent, Now() - start), EEBTPEnergyRecorder::STATE_IDLE);
+		this->recordedUntil = Now();
+	}
+
+	void EEBTPEnergyAttribution::record(Interval interval, Time end, double energy)
+	{
+		uint8_t column = EEBTPEnergyRecorder::STATE_OTHER;
+		switch (interval.state)
+		{
+		case WifiPhyState::IDLE:
+			column = EEBTPEnergyRecorder::STATE_IDLE;
+			break;
+		case WifiPhyState::CCA_BUSY:
+			column = EEBTPEnergyRecorder::STATE_CCA_BUSY;
+			break;
+		case WifiPhyState::TX:
+			column = EEBTPEnergyRecorder::STATE_TX;
+			break;
+		case WifiPhyState::RX:
+			column = EEBTPEnergyRecorder::STATE_RX;
+			break;
+		default:
+			break;
+		}
+		this->recorder->addInterval(this->nodeId, interval.start, end, energy, column);
+
+		if (interval.state == WifiPhyState::TX || interval.state == WifiPhyState::RX)
+		{
+			if (!interval.known || interval.ft >= 8)
+				column = EEBTPEnergyRecorder::UNATTRIBUTED;
+			else if (interval.state == WifiPhyState::TX)
+				column = EEBTPEnergyRecorder::FRAME_TX + interval.ft;
+			else
+				column = EEBTPEnergyRecorder::FRAME_RX + interval.ft;
+			this->recorder->addInterval(this->nodeId, interval.start, end, energy, column);
+		}
+	}
+
+	/*
+	 * Current helper
+	 */
+	double EEBTPEnergyAttribution::getStateCurrent(WifiPhyState state)
+	{
+		switch (state)
+		{
+		case WifiPhyState::IDLE:
+			return this->idleCurrent;
+		case WifiPhyState::CCA_BUSY:
+			return this->ccaBusyCurrent;
+		case WifiPhyState::TX:
+			return this->txCurrent;
+		case WifiPhyState::RX:
+			return this->rxCurrent;
+		case WifiPhyState::SWITCHING:
+			return this->switchingCurrent;
+		case WifiPhyState::SLEEP:
+			return this->sleepCurrent;
+		case WifiPhyState::OFF:
+		default:
+			return 0;
+		}
+	}
+
+	//Same as WifiRadioEnergyModel::SetTxCurrentFromModel
+	double EEBTPEnergyAttribution::getTxCurrent(double txPowerDbm)
+	{
+		if (this->txCurrentModel != 0)
+			return this->txCurrentModel->CalcTxCurrent(txPowerDbm);
+		return this->txCurrent;
+	}
+
+	//Same integration as the BasicEnergySource
+	double EEBTPEnergyAttribution::integrate(double current, Time duration)
+	{
+		return (current * this->voltage * duration.GetNanoSeconds()) / 1e9;
+	}
+
+	/*
+	 * Getter for statistics
+	 * The pending TX/RX interval is only included once it has ended
+	 */
+	double EEBTPEnergyAttribution::getEnergyByRecvFrame(uint64_t gid, uint8_t ft)
+	{
+		if (this->hasPending && this->pending.start + this->pending.duration <= Now())
+			this->flushPending(Now());
+		return this->frameEnergyRecv[gid][ft];
+	}
+
+	double EEBTPEnergyAttribution::getEnergyBySentFrame(uint64_t gid, uint8_t ft)
+	{
+		if (this->hasPending && this->pending.start + this->pending.duration <= Now())
+			this->flushPending(Now());
+		return this->frameEnergySent[gid][ft];
+	}
+
+	double EEBTPEnergyAttribution::getEnergyByState(WifiPhyState state)
+	{
+		if (this->hasPending && this->pending.start + this->pending.duration <= Now())
+			this->flushPending(Now());
+		return this->stateEnergy[static_cast<uint8_t>(state)];
+	}
+
+	//The state after the last logged interval is not logged before the next transition, hence it is counted as idle
+	double EEBTPEnergyAttribution::getIdleEnergy()
+	{
+		double energy = this->getEnergyByState(WifiPhyState::IDLE);
+		if (!this->hasPending && Now() > this->lastEnd)
+			energy += this->integrate(this->idleCurrent, Now() - this->lastEnd);
+		return energy;
+	}
+
+	//Energy an idle radio consumes in 'duration', e.g. for the time cut off by an early stop
+	double EEBTPEnergyAttribution::getIdleEnergy(Time duration)
+	{
+		return this->integrate(this->idleCurrent, duration);
+	}
+
+	double EEBTPEnergyAttribution::getUnattributedEnergy()
+	{
+		if (this->hasPending && this->pending.start + this->pending.duration <= Now())
+			this->flushPending(Now());
+		return this->unattributedEnergy;
+	}
+
+	double EEBTPEnergyAttribution::getTotalEnergy()
+	{
+		double energy = this->getIdleEnergy();
+		for (uint8_t i = 0; i < EEBTPEnergyAttribution::N_STATES; i++)
+			if (i != static_cast<uint8_t>(WifiPhyState::IDLE))
+				energy += this->stateEnergy[i];
+		return energy;
+	}
+}
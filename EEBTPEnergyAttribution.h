@@ -0,0 +1,129 @@
+/*
+ * EEBTPEnergyAttribution.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#ifndef BROADCAST_EEBTPENERGYATTRIBUTION_H_
+#define BROADCAST_EEBTPENERGYATTRIBUTION_H_
+
+#include "map"
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+#include "ns3/energy-module.h"
+#include "ns3/wifi-phy-state.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/wifi-tx-current-model.h"
+
+#include "EEBTPEnergyRecorder.h"
+
+namespace ns3
+{
+	/*
+	 * Attributes the energy of a node to the frames occupying its radio.
+	 *
+	 * The engine is fed by the 'State' trace of the WifiPhyStateHelper. Every
+	 * logged state interval is integrated with the current of this state (as
+	 * configured at the WifiRadioEnergyModel) and assigned to the frame which
+	 * occupied the radio during the interval:
+	 * 	- TX intervals belong to the frame announced by setTxFrame() (PhyTxBegin
+	 * 		is fired right before the PHY switches to TX)
+	 * 	- RX intervals belong to the frame announced by setRxFrame() (PhyRxBegin).
+	 * 		The Wi-Fi PHY logs an RX interval only when it ends, so the frame is
+	 * 		kept until then; EEBTPLinkLayer logs it before it announces the frame
+	 * 	- IDLE, CCA_BUSY and all other states are only accounted per state
+	 *
+	 * The last TX/RX interval is kept pending until the next state is logged,
+	 * since it may be logged a second time with its real duration (an RX that
+	 * is interrupted by a TX). A pending interval ends where the next one
+	 * starts: EEBTPLinkLayer has no collision model and delivers overlapping
+	 * frames, their RX intervals are truncated without a note, so the overlap
+	 * counts once and belongs to the later frame.
+	 */
+	class EEBTPEnergyAttribution : public Object
+	{
+	public:
+		static const uint8_t N_STATES;
+
+		EEBTPEnergyAttribution();
+		virtual ~EEBTPEnergyAttribution();
+
+		static TypeId GetTypeId();
+		virtual TypeId GetInstanceTypeId() const;
+
+		void setDevice(Ptr<WifiNetDevice> device);
+
+		void setTxFrame(uint64_t gid, uint8_t ft, double txPowerDbm);
+		void setTxUnknown(double txPowerDbm);
+		void setRxFrame(uint64_t gid, uint8_t ft);
+
+		void onPhyStateChanged(Time start, Time duration, WifiPhyState state);
+
+		void setRecorder(Ptr<EEBTPEnergyRecorder> recorder);
+		void onTotalEnergyConsumption(double oldValue, double newValue);
+		void flushRecorder();
+
+		double getEnergyByRecvFrame(uint64_t gid, uint8_t ft);
+		double getEnergyBySentFrame(uint64_t gid, uint8_t ft);
+		double getEnergyByState(WifiPhyState state);
+		double getIdleEnergy();
+		double getIdleEnergy(Time duration);
+		double getUnattributedEnergy();
+		double getTotalEnergy();
+
+	private:
+		struct Interval
+		{
+			Time start;
+			Time duration;
+			WifiPhyState state;
+			double current;
+			bool known;
+			uint64_t gid;
+			uint8_t ft;
+		};
+
+		Ptr<WifiNetDevice> device;
+		Ptr<EnergySource> energySource;
+		Ptr<WifiTxCurrentModel> txCurrentModel;
+		Ptr<DeviceEnergyModel> energyModel;
+		Ptr<EEBTPEnergyRecorder> recorder;
+		uint32_t nodeId;
+		Time recordedUntil;
+
+		double voltage;
+		double idleCurrent;
+		double ccaBusyCurrent;
+		double rxCurrent;
+		double txCurrent;
+		double switchingCurrent;
+		double sleepCurrent;
+
+		bool hasPending;
+		Interval pending;
+		Time lastEnd;
+
+		bool nextTxKnown;
+		uint64_t nextTxGid;
+		uint8_t nextTxFt;
+		double nextTxPower;
+
+		bool nextRxKnown;
+		uint64_t nextRxGid;
+		uint8_t nextRxFt;
+		Time nextRxTime;
+
+		std::vector<double> stateEnergy;
+		double unattributedEnergy;
+		std::map<uint64_t, std::map<uint8_t, double>> frameEnergySent;
+		std::map<uint64_t, std::map<uint8_t, double>> frameEnergyRecv;
+
+		void flushPending(Time limit);
+		double getStateCurrent(WifiPhyState state);
+		double getTxCurrent(double txPowerDbm);
+		double integrate(double current, Time duration);
+		void record(Interval interval, Time end, double energy);
+	};
+}
+
+#endif /* BROADCAST_EEBTPENERGYATTRIBUTION_H_ */
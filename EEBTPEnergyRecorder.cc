@@ -0,0 +1,186 @@
+/*
+ * EEBTPEnergyRecorder.cc
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include <fstream>
+
+#include "ns3/log.h"
+
+#include "EEBTPEnergyRecorder.h"
+
+namespace ns3
+{
+	NS_LOG_COMPONENT_DEFINE("EEBTPEnergyRecorder");
+	NS_OBJECT_ENSURE_REGISTERED(EEBTPEnergyRecorder);
+
+	EEBTPEnergyRecorder::EEBTPEnergyRecorder()
+	{
+		this->nBuckets = 0;
+		this->usedBuckets = 0;
+		this->bucketWidth = MilliSeconds(100);
+	}
+
+	EEBTPEnergyRecorder::~EEBTPEnergyRecorder()
+	{
+		this->series.clear();
+	}
+
+	TypeId EEBTPEnergyRecorder::GetTypeId()
+	{
+		static TypeId tid = TypeId("ns3::EEBTPEnergyRecorder")
+								.SetParent<Object>()
+								.AddConstructor<EEBTPEnergyRecorder>();
+		return tid;
+	}
+
+	TypeId EEBTPEnergyRecorder::GetInstanceTypeId() const
+	{
+		return GetTypeId();
+	}
+
+	void EEBTPEnergyRecorder::setup(uint32_t nNodes, Time bucketWidth)
+	{
+		NS_ASSERT_MSG(bucketWidth.IsStrictlyPositive(), "Bucket width must be positive");
+		this->bucketWidth = bucketWidth;
+		this->nBuckets = 0;
+		this->usedBuckets = 0;
+		this->series = std::vector<std::vector<float>>(nNodes);
+	}
+
+	Time EEBTPEnergyRecorder::getBucketWidth()
+	{
+		return this->bucketWidth;
+	}
+
+	/*
+	 * Returns the cell of a node, bucket and column. The series of all
+	 * nodes grow together, so every node has the same number of buckets.
+	 */
+	float *EEBTPEnergyRecorder::getCell(uint32_t nodeId, uint32_t bucket, uint8_t column)
+	{
+		NS_ASSERT_MSG(nodeId < this->series.size(), "Unknown node " << nodeId);
+
+		if (bucket >= this->nBuckets)
+		{
+			//Grow in steps to keep the number of reallocations low
+			this->nBuckets = std::max(bucket + 1, this->nBuckets * 2);
+			for (std::vector<float> &s : this->series)
+				s.resize(this->nBuckets * EEBTPEnergyRecorder::N_COLUMNS, 0.0f);
+		}
+		if (bucket >= this->usedBuckets)
+			this->usedBuckets = bucket + 1;
+
+		return &this->series[nodeId][bucket * EEBTPEnergyRecorder::N_COLUMNS + column];
+	}
+
+	//Adds energy which was spent at one point in time
+	void EEBTPEnergyRecorder::addEnergy(uint32_t nodeId, Time t, double energy, uint8_t column)
+	{
+		*this->getCell(nodeId, t.GetNanoSeconds() / this->bucketWidth.GetNanoSeconds(), column) += energy;
+	}
+
+	//Adds energy which was spent equally over the interval [start, end) and splits it at the bucket borders
+	void EEBTPEnergyRecorder::addInterval(uint32_t nodeId, Time start, Time end, double energy, uint8_t column)
+	{
+		int64_t s = start.GetNanoSeconds();
+		int64_t e = end.GetNanoSeconds();
+		int64_t width = this->bucketWidth.GetNanoSeconds();
+
+		if (e <= s)
+			return;
+
+		uint32_t first = s / width;
+		uint32_t last = (e - 1) / width;
+		if (first == last)
+		{
+			*this->getCell(nodeId, first, column) += energy;
+			return;
+		}
+
+		double rate = energy / (e - s);
+		for (uint32_t b = first; b <= last; b++)
+		{
+			int64_t bStart = std::max(s, (int64_t)b * width);
+			int64_t bEnd = std::min(e, (int64_t)(b + 1) * width);
+			*this->getCell(nodeId, b, column) += rate * (bEnd - bStart);
+		}
+	}
+
+	std::string EEBTPEnergyRecorder::getColumnName(uint8_t column)
+	{
+		static const char *frameTypes[] = {"cycle_check", "neighbor_discovery", "child_request", "child_confirmation", "child_rejection", "parent_revocation", "end_of_game", "application_data"};
+
+		if (column >= EEBTPEnergyRecorder::FRAME_TX && column < EEBTPEnergyRecorder::FRAME_RX)
+			return std::string("tx_") + frameTypes[column - EEBTPEnergyRecorder::FRAME_TX];
+		if (column >= EEBTPEnergyRecorder::FRAME_RX && column < EEBTPEnergyRecorder::UNATTRIBUTED)
+			return std::string("rx_") + frameTypes[column - EEBTPEnergyRecorder::FRAME_RX];
+
+		switch (column)
+		{
+		case EEBTPEnergyRecorder::STATE_IDLE:
+			return "state_idle";
+		case EEBTPEnergyRecorder::STATE_CCA_BUSY:
+			return "state_cca_busy";
+		case EEBTPEnergyRecorder::STATE_TX:
+			return "state_tx";
+		case EEBTPEnergyRecorder::STATE_RX:
+			return "state_rx";
+		case EEBTPEnergyRecorder::STATE_OTHER:
+			return "state_other";
+		case EEBTPEnergyRecorder::UNATTRIBUTED:
+			return "unattributed";
+		case EEBTPEnergyRecorder::MODEL_TOTAL:
+		default:
+			return "model_total";
+		}
+	}
+
+	/*
+	 * Writes the series in the columnar format described in the header
+	 */
+	bool EEBTPEnergyRecorder::write(std::string fileName)
+	{
+		std::ofstream out(fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!out.is_open())
+		{
+			NS_LOG_ERROR("Cannot open energy series file " << fileName);
+			return false;
+		}
+
+		uint32_t nNodes = this->series.size();
+		uint32_t nColumns = EEBTPEnergyRecorder::N_COLUMNS;
+		int64_t width = this->bucketWidth.GetNanoSeconds();
+
+		out.write("EEBTPER1", 8);
+		out.write((const char *)&nNodes, sizeof(nNodes));
+		out.write((const char *)&this->usedBuckets, sizeof(this->usedBuckets));
+		out.write((const char *)&nColumns, sizeof(nColumns));
+		out.write((const char *)&width, sizeof(width));
+
+		for (uint8_t c = 0; c < nColumns; c++)
+		{
+			std::string name = EEBTPEnergyRecorder::getColumnName(c);
+			uint8_t len = name.size();
+			out.write((const char *)&len, 1);
+			out.write(name.c_str(), len);
+		}
+
+		//Transpose from the row-wise storage into one column after another
+		std::vector<float> column(this->usedBuckets);
+		for (uint8_t c = 0; c < nColumns; c++)
+		{
+			for (uint32_t n = 0; n < nNodes; n++)
+			{
+				for (uint32_t b = 0; b < this->usedBuckets; b++)
+					column[b] = this->series[n][b * nColumns + c];
+				out.write((const char *)column.data(), column.size() * sizeof(float));
+			}
+		}
+
+		out.close();
+		NS_LOG_DEBUG("Wrote energy series of " << nNodes << " nodes and " << this->usedBuckets << " buckets to " << fileName);
+		return !out.fail();
+	}
+}
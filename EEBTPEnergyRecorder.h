@@ -0,0 +1,76 @@
+/*
+ * EEBTPEnergyRecorder.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#ifndef BROADCAST_EEBTPENERGYRECORDER_H_
+#define BROADCAST_EEBTPENERGYRECORDER_H_
+
+#include "string"
+#include "vector"
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+
+namespace ns3
+{
+	/*
+	 * Records the energy of every node in fixed buckets of simulated time.
+	 *
+	 * The EEBTPEnergyAttribution of every node forwards its integrated state
+	 * intervals (split by radio state and frame type) and the deltas of the
+	 * 'TotalEnergyConsumption' trace of the WifiRadioEnergyModel. Nothing is
+	 * recorded (and no trace is connected) if no recorder is set.
+	 *
+	 * File format (host byte order):
+	 * 	char[8]		magic "EEBTPER1"
+	 * 	uint32		number of nodes
+	 * 	uint32		number of buckets
+	 * 	uint32		number of columns
+	 * 	int64		bucket width in nanoseconds
+	 * 	per column:	uint8 name length, name
+	 * 	per column:	float32[nodes * buckets] in Joule, node-major
+	 */
+	class EEBTPEnergyRecorder : public Object
+	{
+	public:
+		enum COLUMN : uint8_t
+		{
+			STATE_IDLE = 0,
+			STATE_CCA_BUSY = 1,
+			STATE_TX = 2,
+			STATE_RX = 3,
+			STATE_OTHER = 4,
+			FRAME_TX = 5,  //+ frame type (8 columns)
+			FRAME_RX = 13, //+ frame type (8 columns)
+			UNATTRIBUTED = 21,
+			MODEL_TOTAL = 22,
+			N_COLUMNS = 23
+		};
+
+		EEBTPEnergyRecorder();
+		virtual ~EEBTPEnergyRecorder();
+
+		static TypeId GetTypeId();
+		virtual TypeId GetInstanceTypeId() const;
+
+		void setup(uint32_t nNodes, Time bucketWidth);
+		Time getBucketWidth();
+
+		void addInterval(uint32_t nodeId, Time start, Time end, double energy, uint8_t column);
+		void addEnergy(uint32_t nodeId, Time t, double energy, uint8_t column);
+
+		bool write(std::string fileName);
+
+	private:
+		Time bucketWidth;
+		uint32_t nBuckets;
+		uint32_t usedBuckets;
+		std::vector<std::vector<float>> series;
+
+		float *getCell(uint32_t nodeId, uint32_t bucket, uint8_t column);
+		static std::string getColumnName(uint8_t column);
+	};
+}
+
+#endif /* BROADCAST_EEBTPENERGYRECORDER_H_ */
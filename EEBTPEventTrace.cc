@@ -0,0 +1,168 @@
+/*
+ * EEBTPEventTrace.cc
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include "cerrno"
+#include "cstddef"
+#include "cstring"
+
+#include "fcntl.h"
+#include "unistd.h"
+
+#include "EEBTPEventTrace.h"
+
+namespace ns3
+{
+	struct EEBTPEventTraceHeader
+	{
+		char magic[8];
+		uint32_t recordSize;
+		uint32_t nEvents;
+		uint64_t overwritten;
+	};
+
+	static_assert(sizeof(EEBTPEventTrace::Record) == 32, "EEBTPEventTrace::Record must not have padding");
+
+	EEBTPEventTrace::EEBTPEventTrace()
+	{
+		this->fd = -1;
+		this->next = 0;
+		this->keepLast = false;
+		this->wrapped = false;
+		this->overwritten = 0;
+	}
+
+	EEBTPEventTrace::~EEBTPEventTrace()
+	{
+		this->close();
+	}
+
+	bool EEBTPEventTrace::open(std::string fileName, uint32_t capacity, bool keepLast)
+	{
+		this->close();
+		this->error.clear();
+
+		this->fd = ::open(fileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+		if (this->fd < 0)
+		{
+			this->error = "Cannot open " + fileName + ": " + std::strerror(errno);
+			return false;
+		}
+
+		EEBTPEventTraceHeader header = EEBTPEventTraceHeader();
+		std::memcpy(header.magic, "EEBTPET1", 8);
+		header.recordSize = sizeof(Record);
+		header.nEvents = EEBTPEventTrace::N_EVENTS;
+		if (write(this->fd, &header, sizeof(header)) != (ssize_t)sizeof(header))
+		{
+			this->error = "Cannot write " + fileName + ": " + std::strerror(errno);
+			::close(this->fd);
+			this->fd = -1;
+			return false;
+		}
+
+		this->fileName = fileName;
+		this->ring.assign(capacity > 0 ? capacity : 1, Record());
+		this->next = 0;
+		this->keepLast = keepLast;
+		this->wrapped = false;
+		this->overwritten = 0;
+		return true;
+	}
+
+	bool EEBTPEventTrace::isOpen()
+	{
+		return this->fd >= 0;
+	}
+
+	/*
+	 * Writes the remaining records, returns false if any write of this trace
+	 * failed
+	 */
+	bool EEBTPEventTrace::close()
+	{
+		if (!this->isOpen())
+			return true;
+
+		if (this->keepLast && this->wrapped)
+		{
+			this->overwritten += this->next;
+			this->writeRecords(this->ring.data() + this->next, this->ring.size() - this->next);
+		}
+		this->writeRecords(this->ring.data(), this->next);
+
+		if (pwrite(this->fd, &this->overwritten, sizeof(this->overwritten), offsetof(EEBTPEventTraceHeader, overwritten)) != (ssize_t)sizeof(this->overwritten) && this->error.empty())
+			this->error = "Cannot write " + this->fileName + ": " + std::strerror(errno);
+		if (::close(this->fd) != 0 && this->error.empty())
+			this->error = "Cannot close " + this->fileName + ": " + std::strerror(errno);
+
+		this->fd = -1;
+		this->ring.clear();
+		this->ring.shrink_to_fit();
+		this->next = 0;
+		return this->error.empty();
+	}
+
+	std::string EEBTPEventTrace::getError()
+	{
+		return this->error;
+	}
+
+	//Called by record() when the ring is full
+	void EEBTPEventTrace::wrap()
+	{
+		if (this->keepLast)
+		{
+			if (this->wrapped)
+				this->overwritten += this->ring.size();
+			this->wrapped = true;
+		}
+		else
+			this->writeRecords(this->ring.data(), this->ring.size());
+		this->next = 0;
+	}
+
+	bool EEBTPEventTrace::writeRecords(const Record *records, size_t n)
+	{
+		const char *data = (const char *)records;
+		size_t size = n * sizeof(Record);
+		while (size > 0)
+		{
+			ssize_t written = write(this->fd, data, size);
+			if (written < 0 && errno == EINTR)
+				continue;
+			if (written <= 0)
+			{
+				if (this->error.empty())
+					this->error = "Cannot write " + this->fileName + ": " + std::strerror(errno);
+				return false;
+			}
+			data += written;
+			size -= written;
+		}
+		return true;
+	}
+
+	const char *EEBTPEventTrace::getEventName(uint8_t event)
+	{
+		switch (event)
+		{
+		case EEBTPEventTrace::FRAME_SENT:
+			return "FRAME_SENT";
+		case EEBTPEventTrace::FRAME_RECEIVED:
+			return "FRAME_RECEIVED";
+		case EEBTPEventTrace::PARENT_CHANGED:
+			return "PARENT_CHANGED";
+		case EEBTPEventTrace::BLACKLIST_UPDATED:
+			return "BLACKLIST_UPDATED";
+		case EEBTPEventTrace::CYCLE_DETECTED:
+			return "CYCLE_DETECTED";
+		case EEBTPEventTrace::GAME_FINISHED:
+			return "GAME_FINISHED";
+		default:
+			return "UNKNOWN";
+		}
+	}
+}
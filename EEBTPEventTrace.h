@@ -0,0 +1,115 @@
+/*
+ * EEBTPEventTrace.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#ifndef BROADCAST_EEBTPEVENTTRACE_H_
+#define BROADCAST_EEBTPEVENTTRACE_H_
+
+#include "string"
+#include "vector"
+#include "cstdint"
+
+namespace ns3
+{
+	/*
+	 * Binary trace of protocol events with fixed-size records, without ns-3
+	 * dependencies (see tools/EventTraceTool.cc for the decoder).
+	 *
+	 * The records are collected in a ring of 'capacity' records. If the ring
+	 * is full, it is either written as one block (every record is kept) or,
+	 * with 'keepLast', overwritten, so only the last 'capacity' records of the
+	 * run are written by close().
+	 *
+	 * File format (host byte order):
+	 * 	char[8]		magic "EEBTPET1"
+	 * 	uint32		record size in bytes
+	 * 	uint32		number of event types
+	 * 	uint64		number of records overwritten in the ring ('keepLast')
+	 * 	Record[]	until the end of the file, ordered by time
+	 */
+	class EEBTPEventTrace
+	{
+	public:
+		enum EVENT : uint8_t
+		{
+			FRAME_SENT = 0,		   //peer: recipient, txPower: configured power
+			FRAME_RECEIVED = 1,	   //peer: sender, txPower: power in the header, rxPower: signal
+			PARENT_CHANGED = 2,	   //peer: new parent (broadcast: none), txPower: its reach power
+			BLACKLIST_UPDATED = 3, //peer: blacklisted node (broadcast: blacklist cleared)
+			CYCLE_DETECTED = 4,	   //peer: parent, seqNo: number of nodes in the cycle
+			GAME_FINISHED = 5,	   //txPower: highest TX power of the node
+			N_EVENTS = 6
+		};
+
+		struct Record
+		{
+			int64_t time; //Nanoseconds
+			uint32_t node;
+			uint8_t event;
+			uint8_t frameType; //0xff if there is no frame
+			uint16_t seqNo;
+			uint64_t peer; //MAC address in the lower 48 bits
+			float txPower; //dBm
+			float rxPower; //dBm
+		};
+
+		static const uint8_t NO_FRAME = 0xff;
+		static const uint64_t BROADCAST = 0xffffffffffffULL;
+
+		EEBTPEventTrace();
+		virtual ~EEBTPEventTrace();
+
+		bool open(std::string fileName, uint32_t capacity, bool keepLast);
+		bool isOpen();
+		bool close();
+		std::string getError();
+
+		inline void record(int64_t time, uint32_t node, uint8_t event, uint8_t frameType, uint64_t peer, uint16_t seqNo, double txPower, double rxPower)
+		{
+			Record &r = this->ring[this->next];
+			r.time = time;
+			r.node = node;
+			r.event = event;
+			r.frameType = frameType;
+			r.seqNo = seqNo;
+			r.peer = peer;
+			r.txPower = txPower;
+			r.rxPower = rxPower;
+			if (++this->next == this->ring.size())
+				this->wrap();
+		}
+
+		//Any 48 bit address with CopyTo(uint8_t[6]), e.g. Mac48Address
+		template <typename T>
+		static uint64_t getAddress(const T &address)
+		{
+			uint8_t buffer[6];
+			address.CopyTo(buffer);
+
+			uint64_t a = 0;
+			for (int i = 0; i < 6; i++)
+				a = (a << 8) | buffer[i];
+			return a;
+		}
+
+		static const char *getEventName(uint8_t event);
+
+	private:
+		int fd;
+		std::string fileName;
+		std::string error;
+
+		std::vector<Record> ring;
+		uint32_t next;
+		bool keepLast;
+		bool wrapped;
+		uint64_t overwritten;
+
+		void wrap();
+		bool writeRecords(const Record *records, size_t n);
+	};
+}
+
+#endif /* BROADCAST_EEBTPEVENTTRACE_H_ */
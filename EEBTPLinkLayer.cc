@@ -0,0 +1,250 @@
+/*
+ * EEBTPLinkLayer.cc
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include "algorithm"
+#include "ns3/log.h"
+#include "ns3/double.h"
+#include "ns3/simulator.h"
+#include "ns3/wifi-phy.h"
+#include "ns3/mobility-model.h"
+#include "ns3/wifi-remote-station-manager.h"
+
+#include "EEBTPHeader.h"
+#include "EEBTProtocol.h"
+#include "EEBTPLinkLayer.h"
+
+namespace ns3
+{
+	NS_LOG_COMPONENT_DEFINE("EEBTPLinkLayer");
+	NS_OBJECT_ENSURE_REGISTERED(EEBTPLinkLayer);
+
+	//MAC header (24 bytes), LLC/SNAP header (8 bytes) and FCS (4 bytes)
+	const uint32_t EEBTPLinkLayer::MAC_OVERHEAD = 36;
+
+	EEBTPLinkLayer::EEBTPLinkLayer()
+	{
+		this->maxTxPower = 23;
+		this->rxThreshold = -100;
+		this->minSnr = 4;
+		this->noise = -93.97;
+		this->dataRate = DataRate("6Mbps");
+		this->accessDelay = MicroSeconds(100);
+		this->preambleDuration = MicroSeconds(20);
+
+		this->nLinks = 0;
+		this->nFrames = 0;
+		this->nReceptions = 0;
+	}
+
+	EEBTPLinkLayer::~EEBTPLinkLayer()
+	{
+	}
+
+	TypeId EEBTPLinkLayer::GetTypeId()
+	{
+		static TypeId tid = TypeId("ns3::EEBTPLinkLayer")
+								.SetParent<Object>()
+								.AddConstructor<EEBTPLinkLayer>()
+								.AddAttribute("MaxTxPower", "Highest TX power (dBm) used to find the links.",
+											  DoubleValue(23),
+											  MakeDoubleAccessor(&EEBTPLinkLayer::maxTxPower),
+											  MakeDoubleChecker<double>())
+								.AddAttribute("RxThreshold", "Lowest RX power (dBm) at which a frame is received.",
+											  DoubleValue(-100),
+											  MakeDoubleAccessor(&EEBTPLinkLayer::rxThreshold),
+											  MakeDoubleChecker<double>())
+								.AddAttribute("MinSnr", "Lowest SNR (dB) at which a frame is received.",
+											  DoubleValue(4),
+											  MakeDoubleAccessor(&EEBTPLinkLayer::minSnr),
+											  MakeDoubleChecker<double>())
+								.AddAttribute("Noise", "Noise (dBm) at every receiver (thermal noise of 20 MHz and a noise figure of 7 dB).",
+											  DoubleValue(-93.97),
+											  MakeDoubleAccessor(&EEBTPLinkLayer::noise),
+											  MakeDoubleChecker<double>())
+								.AddAttribute("DataRate", "Data rate used for the airtime of a frame.",
+											  DataRateValue(DataRate("6Mbps")),
+											  MakeDataRateAccessor(&EEBTPLinkLayer::dataRate),
+											  MakeDataRateChecker())
+								.AddAttribute("AccessDelay", "Time between handing a frame to the link layer and the start of its transmission.",
+											  TimeValue(MicroSeconds(100)),
+											  MakeTimeAccessor(&EEBTPLinkLayer::accessDelay),
+											  MakeTimeChecker())
+								.AddAttribute("PreambleDuration", "Airtime added to every frame.",
+											  TimeValue(MicroSeconds(20)),
+											  MakeTimeAccessor(&EEBTPLinkLayer::preambleDuration),
+											  MakeTimeChecker());
+		return tid;
+	}
+
+	TypeId EEBTPLinkLayer::GetInstanceTypeId() const
+	{
+		return GetTypeId();
+	}
+
+	void EEBTPLinkLayer::DoDispose()
+	{
+		//The packet managers reference the link layer as well
+		for (Ptr<EEBTPPacketManager> manager : this->managers)
+			manager->setLinkLayer(0);
+
+		this->devices.clear();
+		this->managers.clear();
+		this->links.clear();
+		this->loss = 0;
+		this->delay = 0;
+		Object::DoDispose();
+	}
+
+	void EEBTPLinkLayer::setPropagationLossModel(Ptr<PropagationLossModel> loss)
+	{
+		this->loss = loss;
+	}
+
+	void EEBTPLinkLayer::setPropagationDelayModel(Ptr<PropagationDelayModel> delay)
+	{
+		this->delay = delay;
+	}
+
+	/*
+	 * Calculates the SNR graph of the (static) devices and redirects the
+	 * packet manager of their EEBTProtocol to this link layer
+	 */
+	void EEBTPLinkLayer::install(NetDeviceContainer devices)
+	{
+		NS_ASSERT_MSG(this->loss != 0 && this->delay != 0, "EEBTPLinkLayer needs a propagation loss and delay model");
+
+		for (NetDeviceContainer::Iterator i = devices.Begin(); i != devices.End(); i++)
+		{
+			Ptr<WifiNetDevice> dev = DynamicCast<WifiNetDevice>(*i);
+			Ptr<EEBTProtocol> proto = dev->GetObject<EEBTProtocol>();
+			NS_ASSERT_MSG(proto != 0, "EEBTPLinkLayer needs an EEBTProtocol on every device");
+
+			this->index[Mac48Address::ConvertFrom(dev->GetAddress())] = this->devices.size();
+			this->devices.push_back(dev);
+			this->managers.push_back(proto->getPacketManager());
+			proto->getPacketManager()->setLinkLayer(this);
+		}
+
+		//The mode only determines the minSNR of the packet tags
+		if (this->devices.size() > 0)
+			this->txVector.SetMode(this->devices[0]->GetRemoteStationManager()->GetDefaultMode());
+
+		uint32_t n = this->devices.size();
+		this->links = std::vector<std::vector<Link>>(n);
+		this->busyUntil = std::vector<Time>(n, Seconds(0));
+		this->nLinks = 0;
+
+		double maxLoss = this->maxTxPower - std::max(this->rxThreshold, this->noise + this->minSnr);
+		for (uint32_t i = 0; i < n; i++)
+		{
+			Ptr<MobilityModel> a = this->devices[i]->GetNode()->GetObject<MobilityModel>();
+
+			std::vector<std::pair<double, uint32_t>> sorted;
+			for (uint32_t j = 0; j < n; j++)
+			{
+				if (i == j)
+					continue;
+
+				Ptr<MobilityModel> b = this->devices[j]->GetNode()->GetObject<MobilityModel>();
+				double l = -this->loss->CalcRxPower(0, a, b);
+				if (l <= maxLoss)
+					sorted.push_back(std::pair<double, uint32_t>(l, j));
+			}
+			std::sort(sorted.begin(), sorted.end());
+
+			for (std::pair<double, uint32_t> &s : sorted)
+			{
+				Link link;
+				link.node = s.second;
+				link.loss = s.first;
+				link.delay = this->delay->GetDelay(a, this->devices[s.second]->GetNode()->GetObject<MobilityModel>());
+				this->links[i].push_back(link);
+			}
+			this->nLinks += this->links[i].size();
+		}
+
+		NS_LOG_DEBUG("SNR graph of " << n << " nodes with " << this->nLinks << " links");
+	}
+
+	/*
+	 * Queues a frame at the sender. Frames of one node are sent one after another.
+	 */
+	void EEBTPLinkLayer::send(Ptr<WifiNetDevice> sender, Ptr<Packet> packet, Mac48Address recipient)
+	{
+		std::map<Mac48Address, uint32_t>::iterator it = this->index.find(Mac48Address::ConvertFrom(sender->GetAddress()));
+		NS_ASSERT_MSG(it != this->index.end(), "Device " << sender->GetAddress() << " is not part of the EEBTPLinkLayer");
+		uint32_t i = it->second;
+
+		EEBTPTag tag;
+		packet->PeekPacketTag(tag);
+
+		Time airtime = this->preambleDuration + this->dataRate.CalculateBytesTxTime(packet->GetSize() + EEBTPLinkLayer::MAC_OVERHEAD);
+		Time start = std::max(Now(), this->busyUntil[i]) + this->accessDelay;
+		this->busyUntil[i] = start + airtime;
+
+		Simulator::ScheduleWithContext(sender->GetNode()->GetId(), start - Now(), &EEBTPLinkLayer::startTx, this, i, packet, recipient, tag.getTxPower(), airtime);
+	}
+
+	void EEBTPLinkLayer::startTx(uint32_t sender, Ptr<Packet> packet, Mac48Address recipient, double txPowerDbm, Time airtime)
+	{
+		Mac48Address from = Mac48Address::ConvertFrom(this->devices[sender]->GetAddress());
+		bool unicast = (recipient != Mac48Address::GetBroadcast());
+		bool acked = false;
+
+		this->nFrames++;
+		this->managers[sender]->onLinkTxStart(packet, txPowerDbm, airtime);
+
+		//The links are sorted by their loss, so all following links are out of range as well
+		for (Link &link : this->links[sender])
+		{
+			double rxPowerDbm = txPowerDbm - link.loss;
+			if (rxPowerDbm < this->rxThreshold || (rxPowerDbm - this->noise) < this->minSnr)
+				break;
+
+			Ptr<WifiNetDevice> receiver = this->devices[link.node];
+			if (unicast && receiver->GetAddress() == recipient)
+				acked = true;
+
+			SignalNoiseDbm signalNoise;
+			signalNoise.signal = rxPowerDbm;
+			signalNoise.noise = this->noise;
+			Ptr<Packet> copy = packet->Copy();
+			EEBTPTag rxTag = this->managers[link.node]->createPacketTag(copy, this->txVector, signalNoise);
+
+			uint32_t context = receiver->GetNode()->GetId();
+			Simulator::ScheduleWithContext(context, link.delay, &EEBTPLinkLayer::startRx, this, link.node, copy, airtime);
+			Simulator::ScheduleWithContext(context, link.delay + airtime, &EEBTPLinkLayer::endRx, this, link.node, copy, from, recipient, rxTag);
+			this->nReceptions++;
+		}
+
+		Simulator::Schedule(airtime, &EEBTPPacketManager::onLinkTxEnd, this->managers[sender], packet, unicast, acked);
+	}
+
+	void EEBTPLinkLayer::startRx(uint32_t receiver, Ptr<Packet> packet, Time airtime)
+	{
+		this->managers[receiver]->onLinkRxStart(packet, airtime);
+	}
+
+	void EEBTPLinkLayer::endRx(uint32_t receiver, Ptr<Packet> packet, Mac48Address from, Mac48Address to, EEBTPTag tag)
+	{
+		this->managers[receiver]->onLinkRxEnd(packet, from, to, tag);
+	}
+
+	uint64_t EEBTPLinkLayer::getNLinks()
+	{
+		return this->nLinks;
+	}
+
+	uint64_t EEBTPLinkLayer::getNFrames()
+	{
+		return this->nFrames;
+	}
+
+	uint64_t EEBTPLinkLayer::getNReceptions()
+	{
+		return this->nReceptions;
+	}
+}
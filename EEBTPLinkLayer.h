@@ -0,0 +1,104 @@
+/*
+ * EEBTPLinkLayer.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#ifndef BROADCAST_EEBTPLINKLAYER_H_
+#define BROADCAST_EEBTPLINKLAYER_H_
+
+#include "map"
+#include "vector"
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+#include "ns3/data-rate.h"
+#include "ns3/wifi-tx-vector.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/net-device-container.h"
+#include "ns3/propagation-loss-model.h"
+#include "ns3/propagation-delay-model.h"
+
+#include "EEBTPPacketManager.h"
+
+namespace ns3
+{
+	/*
+	 * Abstract link layer for protocol logic experiments (fast-forward mode).
+	 *
+	 * EEBTP frames are not handed to the Wi-Fi MAC but delivered over an SNR
+	 * graph which is calculated once on install: for every node all links
+	 * with a loss that can be bridged with 'MaxTxPower' are stored, sorted by
+	 * the loss. A frame sent with the power P reaches all nodes with
+	 * P - loss >= 'RxThreshold' and an SNR >= 'MinSnr' (same thresholds as
+	 * the CustomThresholdPreambleDetectionModel).
+	 *
+	 * A frame starts after 'AccessDelay' (or after the previous frame of the
+	 * node) and occupies the sender for its airtime at 'DataRate'. There is
+	 * no collision model: no contention, collision or interference, frames
+	 * that overlap at a receiver are all delivered. Unicast frames count as
+	 * acked if the recipient is reached. The receivers get the same RSSI/
+	 * noise/minSNR tag as with the Wi-Fi PHY, and the TX/RX intervals are fed
+	 * into the energy attribution, which truncates overlapping RX intervals
+	 * (see EEBTPEnergyAttribution). The WifiRadioEnergyModel (and thus the
+	 * energy source) only sees an idle radio.
+	 */
+	class EEBTPLinkLayer : public Object
+	{
+	public:
+		static const uint32_t MAC_OVERHEAD;
+
+		EEBTPLinkLayer();
+		virtual ~EEBTPLinkLayer();
+
+		static TypeId GetTypeId();
+		virtual TypeId GetInstanceTypeId() const;
+
+		void setPropagationLossModel(Ptr<PropagationLossModel> loss);
+		void setPropagationDelayModel(Ptr<PropagationDelayModel> delay);
+
+		void install(NetDeviceContainer devices);
+		void send(Ptr<WifiNetDevice> sender, Ptr<Packet> packet, Mac48Address recipient);
+
+		uint64_t getNLinks();
+		uint64_t getNFrames();
+		uint64_t getNReceptions();
+
+	private:
+		struct Link
+		{
+			uint32_t node;
+			double loss;
+			Time delay;
+		};
+
+		Ptr<PropagationLossModel> loss;
+		Ptr<PropagationDelayModel> delay;
+
+		double maxTxPower;
+		double rxThreshold;
+		double minSnr;
+		double noise;
+		DataRate dataRate;
+		Time accessDelay;
+		Time preambleDuration;
+
+		std::vector<Ptr<WifiNetDevice>> devices;
+		std::vector<Ptr<EEBTPPacketManager>> managers;
+		std::map<Mac48Address, uint32_t> index;
+		std::vector<std::vector<Link>> links;
+		std::vector<Time> busyUntil;
+		WifiTxVector txVector;
+
+		uint64_t nLinks;
+		uint64_t nFrames;
+		uint64_t nReceptions;
+
+		virtual void DoDispose();
+
+		void startTx(uint32_t sender, Ptr<Packet> packet, Mac48Address recipient, double txPowerDbm, Time airtime);
+		void startRx(uint32_t receiver, Ptr<Packet> packet, Time airtime);
+		void endRx(uint32_t receiver, Ptr<Packet> packet, Mac48Address from, Mac48Address to, EEBTPTag tag);
+	};
+}
+
+#endif /* BROADCAST_EEBTPLINKLAYER_H_ */
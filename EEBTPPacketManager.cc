@@ -13,8 +13,11 @@
 
 #include "ns3/EEBTPTag.h"
 #include "EEBTProtocol.h"
+#include "EEBTPLinkLayer.h"
 #include "EEBTPQueueDiscItem.h"
 #include "EEBTPPacketManager.h"
+#include "EEBTPProfiler.h"
+#include "EEBTPCausalGraph.h"
 
 namespace ns3
 {
@@ -27,7 +30,8 @@ namespace ns3
 	EEBTPPacketManager::EEBTPPacketManager()
 	{
 		this->seqNoAtStart = 0;
-		this->energyAtStart = 0;
+		this->linkSeqNo = 0;
+		this->eventTrace = 0;
 	}
 
 	EEBTPPacketManager::~EEBTPPacketManager()
@@ -37,20 +41,19 @@ namespace ns3
 		this->dataSent.clear();
 		this->frameDataRecv.clear();
 		this->frameDataSent.clear();
-		this->frameEnergyRecv.clear();
-		this->frameEnergySent.clear();
 		this->frameTypesRecv.clear();
 		this->frameTypesSent.clear();
 		this->packetTag.clear();
 		this->packets.clear();
 		this->packetsAcked.clear();
 		this->packetsLost.clear();
+		this->controlInFlight.clear();
 		this->receiver.clear();
 	}
 
 	TypeId EEBTPPacketManager::GetTypeId()
 	{
-		static TypeId tid = TypeId("ns3::GameState")
+		static TypeId tid = TypeId("ns3::EEBTPPacketManager")
 								.SetParent<Object>()
 								.AddConstructor<EEBTPPacketManager>();
 		return tid;
@@ -65,16 +68,25 @@ namespace ns3
 	{
 		this->device = device;
 		this->tcl = this->device->GetNode()->GetObject<TrafficControlLayer>();
-		this->energySource = this->device->GetNode()->GetObject<EnergySourceContainer>()->Get(0);
+
+		//The energy of every frame is integrated from the PHY state intervals
+		this->energyAttribution = Create<EEBTPEnergyAttribution>();
+		this->energyAttribution->setDevice(this->device);
 	}
 
 	void EEBTPPacketManager::sendPacket(Ptr<Packet> packet, Mac48Address recipient)
 	{
+		EEBTP_PROFILE_SCOPE("EEBTPPacketManager::sendPacket");
 		EEBTPTag tag;
 		packet->PeekPacketTag(tag);
 
 		NS_LOG_DEBUG("EEBTPPacketManager::sendPacket() => " << tag.getTxPower() << "dBm");
 
+		if (this->eventTrace != 0)
+			this->eventTrace->record(Now().GetNanoSeconds(), this->device->GetNode()->GetId(), EEBTPEventTrace::FRAME_SENT, tag.getFrameType(), EEBTPEventTrace::getAddress(recipient), tag.getSequenceNumber(), tag.getTxPower(), 0);
+		if (EEBTPCausalGraph::isEnabled())
+			EEBTPCausalGraph::onSend(Now().GetNanoSeconds(), this->device->GetNode()->GetId(), EEBTPEventTrace::getAddress(Mac48Address::ConvertFrom(this->device->GetAddress())), tag.getSequenceNumber(), tag.getFrameType());
+
 		for (uint i = 0; i < this->addrSeqCache[recipient].size(); i++)
 		{
 			uint16_t seqNo = this->addrSeqCache[recipient][i];
@@ -86,16 +98,112 @@ namespace ns3
 		}
 		this->addrSeqCache[recipient].push_back(tag.getSequenceNumber());
 
+		if (tag.getFrameType() != APPLICATION_DATA)
+			this->controlInFlight.insert(tag.getSequenceNumber());
+
+		//Fast-forward mode: bypass the Wi-Fi MAC/PHY
+		if (this->linkLayer != 0)
+		{
+			this->linkLayer->send(this->device, packet, recipient);
+			return;
+		}
+
 		Ptr<EEBTPQueueDiscItem> qdi = Create<EEBTPQueueDiscItem>(packet, recipient, EEBTProtocol::PROT_NUMBER);
 		this->tcl->Send(this->device, qdi);
 		//this->device->Send(packet, recipient, EEBTProtocol::PROT_NUMBER);
 	}
 
+	//Every frame handed to the MAC (or the link layer) is recorded if a trace is set
+	void EEBTPPacketManager::setEventTrace(EEBTPEventTrace *eventTrace)
+	{
+		this->eventTrace = eventTrace;
+	}
+
+	/*
+	 * Hooks of the abstract link layer (EEBTPLinkLayer)
+	 * They do the same bookkeeping as the PHY and MAC hooks below. Since
+	 * there is no MAC header, the MAC overhead is added to the frame sizes.
+	 */
+	void EEBTPPacketManager::setLinkLayer(Ptr<EEBTPLinkLayer> linkLayer)
+	{
+		this->linkLayer = linkLayer;
+	}
+
+	void EEBTPPacketManager::onLinkTxStart(Ptr<Packet> packet, double txPowerDbm, Time airtime)
+	{
+		EEBTP_PROFILE_SCOPE("EEBTPPacketManager::onLinkTxStart");
+		EEBTPTag tag;
+		packet->PeekPacketTag(tag);
+
+		this->packets[this->linkSeqNo++] = tag.getSequenceNumber();
+		this->packetsLost[tag.getSequenceNumber()] = false;
+		this->packetsAcked[tag.getSequenceNumber()] = false;
+		if (EEBTPCausalGraph::isEnabled())
+			EEBTPCausalGraph::onTxStart(Now().GetNanoSeconds(), this->device->GetNode()->GetId(), EEBTPEventTrace::getAddress(Mac48Address::ConvertFrom(this->device->GetAddress())), tag.getSequenceNumber(), tag.getFrameType());
+
+		this->energyAttribution->setTxFrame(tag.getGameID(), tag.getFrameType(), txPowerDbm);
+		this->energyAttribution->onPhyStateChanged(Now(), airtime, WifiPhyState::TX);
+	}
+
+	void EEBTPPacketManager::onLinkTxEnd(Ptr<Packet> packet, bool unicast, bool acked)
+	{
+		EEBTP_PROFILE_SCOPE("EEBTPPacketManager::onLinkTxEnd");
+		EEBTPTag tag;
+		packet->PeekPacketTag(tag);
+
+		uint32_t size = packet->GetSize() + EEBTPLinkLayer::MAC_OVERHEAD;
+		this->dataSent[tag.getGameID()] += size;
+		this->frameTypesSent[tag.getGameID()][tag.getFrameType()]++;
+		this->frameDataSent[tag.getGameID()][tag.getFrameType()] += size;
+
+		if (unicast)
+		{
+			this->packetsAcked[tag.getSequenceNumber()] = acked;
+			this->packetsLost[tag.getSequenceNumber()] = !acked;
+		}
+		this->controlInFlight.erase(tag.getSequenceNumber());
+	}
+
+	void EEBTPPacketManager::onLinkRxStart(Ptr<Packet> packet, Time airtime)
+	{
+		EEBTP_PROFILE_SCOPE("EEBTPPacketManager::onLinkRxStart");
+		EEBTPHeader ehdr;
+		ehdr.setShort(true);
+		packet->PeekHeader(ehdr);
+
+		this->energyAttribution->onPhyStateChanged(Now(), airtime, WifiPhyState::RX);
+		this->energyAttribution->setRxFrame(ehdr.GetGameId(), ehdr.GetFrameType());
+	}
+
+	void EEBTPPacketManager::onLinkRxEnd(Ptr<Packet> packet, Mac48Address from, Mac48Address to, EEBTPTag tag)
+	{
+		EEBTP_PROFILE_SCOPE("EEBTPPacketManager::onLinkRxEnd");
+		EEBTPHeader ehdr;
+		ehdr.setShort(true);
+		packet->PeekHeader(ehdr);
+
+		uint32_t size = packet->GetSize() + EEBTPLinkLayer::MAC_OVERHEAD;
+		this->dataRecv[ehdr.GetGameId()] += size;
+		this->frameTypesRecv[ehdr.GetGameId()][ehdr.GetFrameType()]++;
+		this->frameDataRecv[ehdr.GetGameId()][ehdr.GetFrameType()] += size;
+
+		//Like the MAC, only forward frames for this node
+		NetDevice::PacketType type = NetDevice::PACKET_HOST;
+		if (to == Mac48Address::GetBroadcast())
+			type = NetDevice::PACKET_BROADCAST;
+		else if (to != Mac48Address::ConvertFrom(this->device->GetAddress()))
+			return;
+
+		this->packetTag[ehdr.GetSequenceNumber()] = tag;
+		this->tcl->Receive(this->device, packet, EEBTProtocol::PROT_NUMBER, from, to, type);
+	}
+
 	/*
 	 * RX hooks
 	 */
 	void EEBTPPacketManager::onRxStart(Ptr<const Packet> packet)
 	{
+		EEBTP_PROFILE_SCOPE("EEBTPPacketManager::onRxStart");
 		Ptr<Packet> pkt = packet->Copy();
 
 		WifiMacHeader hdr;
@@ -116,16 +224,17 @@ namespace ns3
 				pkt->RemoveHeader(ehdr);
 
 				this->seqNoAtStart = hdr.GetSequenceNumber();
-				this->energyAtStart = this->energySource->GetRemainingEnergy();
+				this->energyAttribution->setRxFrame(ehdr.GetGameId(), ehdr.GetFrameType());
 
 				if (hdr.GetAddr1() == this->device->GetAddress() || hdr.GetAddr1() == Mac48Address::GetBroadcast())
-					NS_LOG_DEBUG("[Node " << this->device->GetNode()->GetId() << "]: On start of RX (" << Now() << "): MACSeqNo = " << this->seqNoAtStart << " / " << ehdr.GetSequenceNumber() << ", energy = " << this->energyAtStart);
+					NS_LOG_DEBUG("[Node " << this->device->GetNode()->GetId() << "]: On start of RX (" << Now() << "): MACSeqNo = " << this->seqNoAtStart << " / " << ehdr.GetSequenceNumber());
 			}
 		}
 	}
 
 	void EEBTPPacketManager::onPacketRx(Ptr<const Packet> packet, uint16_t channelFreqMhz, WifiTxVector txVector, MpduInfo aMpdu, SignalNoiseDbm signalNoise)
 	{
+		EEBTP_PROFILE_SCOPE("EEBTPPacketManager::onPacketRx");
 		//Copy packet
 		Ptr<Packet> pkt = packet->Copy();
 
@@ -161,6 +270,7 @@ namespace ns3
 
 	void EEBTPPacketManager::onRxEnd(Ptr<const Packet> packet)
 	{
+		EEBTP_PROFILE_SCOPE("EEBTPPacketManager::onRxEnd");
 		//Copy packet
 		Ptr<Packet> pkt = packet->Copy();
 
@@ -185,7 +295,6 @@ namespace ns3
 				this->dataRecv[ehdr.GetGameId()] += packet->GetSize();
 				this->frameTypesRecv[ehdr.GetGameId()][ehdr.GetFrameType()]++;
 				this->frameDataRecv[ehdr.GetGameId()][ehdr.GetFrameType()] += packet->GetSize();
-				this->frameEnergyRecv[ehdr.GetGameId()][ehdr.GetFrameType()] += (this->energyAtStart - this->energySource->GetRemainingEnergy());
 
 				if (hdr.GetAddr1() == this->device->GetAddress() || hdr.GetAddr1() == Mac48Address::GetBroadcast())
 					NS_LOG_DEBUG("[Node " << this->device->GetNode()->GetId() << "]: Reception of " << hdr.GetSequenceNumber() << " / " << ehdr.GetSequenceNumber() << " finished. FRAME_TYPE: " << (uint32_t)ehdr.GetFrameType() << " Time: " << Now());
@@ -201,13 +310,14 @@ namespace ns3
 	 */
 	void EEBTPPacketManager::onTxStart(Ptr<const Packet> packet, double txPowerW)
 	{
+		EEBTP_PROFILE_SCOPE("EEBTPPacketManager::onTxStart");
 		WifiMacHeader hdr;
 		packet->PeekHeader(hdr);
 
 		EEBTPTag tag;
 		if (packet->PeekPacketTag(tag))
 		{
-			this->energyAtStart = this->energySource->GetRemainingEnergy();
+			this->energyAttribution->setTxFrame(tag.getGameID(), tag.getFrameType(), WToDbm(txPowerW));
 
 			std::map<uint16_t, uint16_t>::iterator it = this->packets.find(hdr.GetSequenceNumber());
 			if (it == this->packets.end())
@@ -219,15 +329,21 @@ namespace ns3
 			}
 			else
 				NS_LOG_DEBUG("[Node " << this->device->GetNode()->GetId() << "]: Transmission of packet with MACSeqNo = " << hdr.GetSequenceNumber() << " and EEBTPSeqNo = " << tag.getSequenceNumber() << " started at " << Now());
+
+			//New frames and retries are told apart by the causal graph itself
+			if (EEBTPCausalGraph::isEnabled())
+				EEBTPCausalGraph::onTxStart(Now().GetNanoSeconds(), this->device->GetNode()->GetId(), EEBTPEventTrace::getAddress(hdr.GetAddr2()), tag.getSequenceNumber(), tag.getFrameType());
 		}
 		else
 		{
+			this->energyAttribution->setTxUnknown(WToDbm(txPowerW));
 			NS_LOG_DEBUG("[Node " << this->device->GetNode()->GetId() << "]: Transmission of unknown packet with MACSeqNo = " << hdr.GetSequenceNumber() << " started at " << Now());
 		}
 	}
 
 	void EEBTPPacketManager::onTxDrop(Ptr<const Packet> packet)
 	{
+		EEBTP_PROFILE_SCOPE("EEBTPPacketManager::onTxDrop");
 		WifiMacHeader hdr;
 		packet->PeekHeader(hdr);
 
@@ -237,6 +353,7 @@ namespace ns3
 			NS_LOG_DEBUG("[Node " << this->device->GetNode()->GetId() << "]: Packet with MACSeqNo = " << hdr.GetSequenceNumber() << " and EEBTPSeqNo = " << tag.getSequenceNumber() << " has been dropped at " << Now());
 			this->packetsLost[tag.getSequenceNumber()] = true;
 			this->packetsAcked[tag.getSequenceNumber()] = false;
+			this->controlInFlight.erase(tag.getSequenceNumber());
 		}
 		else
 		{
@@ -246,6 +363,7 @@ namespace ns3
 
 	void EEBTPPacketManager::onTxEnd(Ptr<const Packet> packet)
 	{
+		EEBTP_PROFILE_SCOPE("EEBTPPacketManager::onTxEnd");
 		WifiMacHeader hdr;
 		packet->PeekHeader(hdr);
 
@@ -255,12 +373,15 @@ namespace ns3
 			NS_LOG_DEBUG("[Node " << this->device->GetNode()->GetId() << "]: Packet with MACSeqNo = " << hdr.GetSequenceNumber() << " and EEBTPSeqNo = " << tag.getSequenceNumber() << " has been transmitted at " << Now());
 
 			if (tag.getFrameType() == APPLICATION_DATA)
-				NS_LOG_DEBUG("onTxEnd() => packetSize = " << packet->GetSize() << ", energy = " << (this->energyAtStart - this->energySource->GetRemainingEnergy()));
+				NS_LOG_DEBUG("onTxEnd() => packetSize = " << packet->GetSize());
 
 			this->dataSent[tag.getGameID()] += packet->GetSize();
 			this->frameTypesSent[tag.getGameID()][tag.getFrameType()]++;
 			this->frameDataSent[tag.getGameID()][tag.getFrameType()] += packet->GetSize();
-			this->frameEnergySent[tag.getGameID()][tag.getFrameType()] += (this->energyAtStart - this->energySource->GetRemainingEnergy());
+
+			//Broadcasts are done after one transmission, unicasts wait for the ACK (onTxSuccessful/onTxFailed)
+			if (hdr.GetAddr1().IsGroup())
+				this->controlInFlight.erase(tag.getSequenceNumber());
 		}
 		else
 		{
@@ -270,13 +391,14 @@ namespace ns3
 
 	void EEBTPPacketManager::onPacketTx(Ptr<const Packet> packet, uint16_t channelFreqMhz, WifiTxVector txVector, MpduInfo aMpdu)
 	{
+		EEBTP_PROFILE_SCOPE("EEBTPPacketManager::onPacketTx");
 		WifiMacHeader hdr;
 		packet->PeekHeader(hdr);
 
 		EEBTPTag tag;
 		if (packet->PeekPacketTag(tag))
 		{
-			NS_LOG_DEBUG("[Node " << this->device->GetNode()->GetId() << "]: onPacketTx() => MACSeqNo = " << hdr.GetSequenceNumber() << ", EEBTPSeqNo = " << tag.getSequenceNumber() << ", time = " << Now() << ", energy = " << this->energySource->GetRemainingEnergy());
+			NS_LOG_DEBUG("[Node " << this->device->GetNode()->GetId() << "]: onPacketTx() => MACSeqNo = " << hdr.GetSequenceNumber() << ", EEBTPSeqNo = " << tag.getSequenceNumber() << ", time = " << Now());
 		}
 		else
 		{
@@ -286,6 +408,7 @@ namespace ns3
 
 	void EEBTPPacketManager::onTx(Ptr<const Packet> packet)
 	{
+		EEBTP_PROFILE_SCOPE("EEBTPPacketManager::onTx");
 		LlcSnapHeader lhdr;
 		packet->PeekHeader(lhdr);
 
@@ -302,6 +425,7 @@ namespace ns3
 
 	void EEBTPPacketManager::onTxFinalRtsFailed(Mac48Address address)
 	{
+		EEBTP_PROFILE_SCOPE("EEBTPPacketManager::onTxFinalRtsFailed");
 		NS_LOG_DEBUG("[Node " << this->device->GetNode()->GetId() << "]: onTxFinalRtsFailed(" << address << ")");
 		for (uint16_t seqNo : this->addrSeqCache[address])
 		{
@@ -310,12 +434,14 @@ namespace ns3
 				this->packetsLost[seqNo] = true;
 				this->packetsAcked[seqNo] = false;
 			}
+			this->controlInFlight.erase(seqNo);
 		}
 		this->addrSeqCache[address].clear();
 	}
 
 	void EEBTPPacketManager::onTxFinalDataFailed(Mac48Address address)
 	{
+		EEBTP_PROFILE_SCOPE("EEBTPPacketManager::onTxFinalDataFailed");
 		NS_LOG_DEBUG("[Node " << this->device->GetNode()->GetId() << "]: onTxFinalDataFailed(" << address << ")");
 	}
 
@@ -324,6 +450,7 @@ namespace ns3
 	 */
 	void EEBTPPacketManager::onTxFailed(const WifiMacHeader &header)
 	{
+		EEBTP_PROFILE_SCOPE("EEBTPPacketManager::onTxFailed");
 		std::map<uint16_t, uint16_t>::iterator it = this->packets.find(header.GetSequenceNumber());
 		if (it != this->packets.end())
 		{
@@ -331,6 +458,7 @@ namespace ns3
 			NS_LOG_DEBUG("[Node " << this->device->GetNode()->GetId() << "]: Transmission of MacSeqNo = " << header.GetSequenceNumber() << " / " << seqNo << " FAILED. Time: " << Now());
 			this->packetsAcked[seqNo] = false;
 			this->packetsLost[seqNo] = true;
+			this->controlInFlight.erase(seqNo);
 		}
 		else
 			NS_LOG_DEBUG("[Node " << this->device->GetNode()->GetId() << "]: Transmission of MacSeqNo = " << header.GetSequenceNumber() << " FAILED, but is not known. Time: " << Now());
@@ -338,6 +466,7 @@ namespace ns3
 
 	void EEBTPPacketManager::onTxDropped(Ptr<const Packet> packet)
 	{
+		EEBTP_PROFILE_SCOPE("EEBTPPacketManager::onTxDropped");
 		WifiMacHeader hdr;
 		packet->PeekHeader(hdr);
 
@@ -347,6 +476,7 @@ namespace ns3
 			NS_LOG_DEBUG("[Node " << this->device->GetNode()->GetId() << "]: Packet with MACSeqNo = " << hdr.GetSequenceNumber() << " and EEBTPSeqNo = " << tag.getSequenceNumber() << " has been dropped on MAC layer at " << Now());
 			this->packetsLost[tag.getSequenceNumber()] = true;
 			this->packetsAcked[tag.getSequenceNumber()] = false;
+			this->controlInFlight.erase(tag.getSequenceNumber());
 		}
 		else
 		{
@@ -356,6 +486,7 @@ namespace ns3
 
 	void EEBTPPacketManager::onTxSuccessful(const WifiMacHeader &header)
 	{
+		EEBTP_PROFILE_SCOPE("EEBTPPacketManager::onTxSuccessful");
 		std::map<uint16_t, uint16_t>::iterator it = this->packets.find(header.GetSequenceNumber());
 		if (it != this->packets.end())
 		{
@@ -363,6 +494,7 @@ namespace ns3
 			NS_LOG_DEBUG("[Node " << this->device->GetNode()->GetId() << "]: Transmission of MacSeqNo = " << header.GetSequenceNumber() << " / " << seqNo << " successful. Time: " << Now());
 			this->packetsAcked[seqNo] = true;
 			this->packetsLost[seqNo] = false;
+			this->controlInFlight.erase(seqNo);
 		}
 		else
 			NS_LOG_DEBUG("[Node " << this->device->GetNode()->GetId() << "]: Transmission of MacSeqNo = " << header.GetSequenceNumber() << " successful, but is not known. Time: " << Now());
@@ -388,6 +520,25 @@ namespace ns3
 		return false;
 	}
 
+	/*
+	 * Control frames handed to the MAC (or the link layer) which are not done
+	 * yet: queued, on air or, for unicasts, waiting for the ACK
+	 */
+	uint32_t EEBTPPacketManager::getControlFramesInFlight()
+	{
+		return this->controlInFlight.size();
+	}
+
+	void EEBTPPacketManager::getMemoryUsage(MemoryUsage &usage)
+	{
+		uint64_t b = MemoryUsage::getBytes(this->packets) + MemoryUsage::getBytes(this->receiver) + MemoryUsage::getBytes(this->packetsAcked) +
+					 MemoryUsage::getBytes(this->packetsLost) + MemoryUsage::getBytes(this->packetTag) + MemoryUsage::getBytes(this->addrSeqCache) +
+					 MemoryUsage::getBytes(this->controlInFlight);
+		b += MemoryUsage::getBytes(this->dataSent) + MemoryUsage::getBytes(this->dataRecv) + MemoryUsage::getBytes(this->frameDataSent) +
+			 MemoryUsage::getBytes(this->frameDataRecv) + MemoryUsage::getBytes(this->frameTypesSent) + MemoryUsage::getBytes(this->frameTypesRecv);
+		usage.bytes[MemoryUsage::PACKET_MANAGER] += b;
+	}
+
 	void EEBTPPacketManager::deleteSeqNoEntry(uint16_t seqNo)
 	{
 		std::map<uint16_t, uint16_t>::iterator it;
@@ -490,12 +641,29 @@ namespace ns3
 
 	double EEBTPPacketManager::getEnergyByRecvFrame(uint64_t gid, uint8_t ft)
 	{
-		return this->frameEnergyRecv[gid][ft];
+		return this->energyAttribution->getEnergyByRecvFrame(gid, ft);
 	}
 
 	double EEBTPPacketManager::getEnergyBySentFrame(uint64_t gid, uint8_t ft)
 	{
-		return this->frameEnergySent[gid][ft];
+		return this->energyAttribution->getEnergyBySentFrame(gid, ft);
+	}
+
+	//Energy spent while the radio was idle (not including CCA_BUSY)
+	double EEBTPPacketManager::getIdleEnergy()
+	{
+		return this->energyAttribution->getIdleEnergy();
+	}
+
+	//Energy spent for TX/RX of frames which do not belong to the EEBTProtocol (e.g. ACKs)
+	double EEBTPPacketManager::getUnattributedEnergy()
+	{
+		return this->energyAttribution->getUnattributedEnergy();
+	}
+
+	Ptr<EEBTPEnergyAttribution> EEBTPPacketManager::getEnergyAttribution()
+	{
+		return this->energyAttribution;
 	}
 
 	uint32_t EEBTPPacketManager::getDataRecv(uint64_t gid)
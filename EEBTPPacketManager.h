@@ -8,6 +8,8 @@
 #ifndef BROADCAST_EEBTPTXQUEUE_H_
 #define BROADCAST_EEBTPTXQUEUE_H_
 
+#include "set"
+
 #include "ns3/wifi-mac.h"
 #include "ns3/wifi-phy.h"
 #include "ns3/energy-module.h"
@@ -17,9 +19,14 @@
 #include "ns3/wifi-radio-energy-model-helper.h"
 
 #include "ns3/EEBTPTag.h"
+#include "EEBTPEventTrace.h"
+#include "MemoryUsage.h"
+#include "EEBTPEnergyAttribution.h"
 
 namespace ns3
 {
+	class EEBTPLinkLayer;
+
 	class EEBTPPacketManager : public Object
 	{
 	public:
@@ -33,6 +40,14 @@ namespace ns3
 
 		void sendPacket(Ptr<Packet> pkt, Mac48Address recipient);
 
+		void setEventTrace(EEBTPEventTrace *eventTrace);
+
+		void setLinkLayer(Ptr<EEBTPLinkLayer> linkLayer);
+		void onLinkTxStart(Ptr<Packet> packet, double txPowerDbm, Time airtime);
+		void onLinkTxEnd(Ptr<Packet> packet, bool unicast, bool acked);
+		void onLinkRxStart(Ptr<Packet> packet, Time airtime);
+		void onLinkRxEnd(Ptr<Packet> packet, Mac48Address from, Mac48Address to, EEBTPTag tag);
+
 		void onRxStart(Ptr<const Packet> packet);
 		void onRxEnd(Ptr<const Packet> packet);
 
@@ -55,6 +70,10 @@ namespace ns3
 		bool isPacketLost(uint16_t seqNo);
 		void deleteSeqNoEntry(uint16_t seqNo);
 
+		uint32_t getControlFramesInFlight();
+
+		void getMemoryUsage(MemoryUsage &usage);
+
 		uint16_t getSeqNoByMacSeqNo(uint16_t macSeqNo);
 
 		EEBTPTag createPacketTag(Ptr<Packet> packet, WifiTxVector txVector, SignalNoiseDbm signalNoise);
@@ -63,6 +82,10 @@ namespace ns3
 		double getTotalEnergyConsumed(uint64_t gid);
 		double getEnergyByRecvFrame(uint64_t gid, uint8_t ft);
 		double getEnergyBySentFrame(uint64_t gid, uint8_t ft);
+		double getIdleEnergy();
+		double getUnattributedEnergy();
+
+		Ptr<EEBTPEnergyAttribution> getEnergyAttribution();
 
 		uint32_t getDataRecv(uint64_t gid);
 		uint32_t getDataSent(uint64_t gid);
@@ -76,7 +99,10 @@ namespace ns3
 	private:
 		Ptr<WifiNetDevice> device;
 		Ptr<TrafficControlLayer> tcl;
-		Ptr<EnergySource> energySource;
+		Ptr<EEBTPEnergyAttribution> energyAttribution;
+		Ptr<EEBTPLinkLayer> linkLayer;
+		uint16_t linkSeqNo;
+		EEBTPEventTrace *eventTrace;
 
 		std::map<uint16_t, uint16_t> packets;
 		std::map<Mac48Address, uint16_t> receiver;
@@ -84,12 +110,10 @@ namespace ns3
 		std::map<uint16_t, bool> packetsLost;
 		std::map<uint16_t, EEBTPTag> packetTag;
 		std::map<Mac48Address, std::vector<uint16_t>> addrSeqCache;
+		std::set<uint16_t> controlInFlight;
 
-		double energyAtStart;
 		uint16_t seqNoAtStart;
 
-		std::map<uint64_t, std::map<uint8_t, double>> frameEnergySent;
-		std::map<uint64_t, std::map<uint8_t, double>> frameEnergyRecv;
 		std::map<uint64_t, uint32_t> dataSent;
 		std::map<uint64_t, uint32_t> dataRecv;
 		std::map<uint64_t, std::map<uint8_t, uint32_t>> frameDataSent;
@@ -0,0 +1,337 @@
+/*
+ * EEBTPPcapCapture.cc
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include "sstream"
+#include "cstdlib"
+#include "algorithm"
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/trace-helper.h"
+#include "ns3/wifi-net-device.h"
+
+#include "EEBTPTag.h"
+#include "GameState.h"
+#include "EEBTProtocol.h"
+#include "SweepSpec.h"
+#include "EEBTPPcapCapture.h"
+
+namespace ns3
+{
+	NS_LOG_COMPONENT_DEFINE("EEBTPPcapCapture");
+	NS_OBJECT_ENSURE_REGISTERED(EEBTPPcapCapture);
+
+	EEBTPPcapCapture::EEBTPPcapCapture()
+	{
+		this->gid = 0;
+		this->maxDepth = -1;
+		this->frameTypes = EEBTPPcapCapture::ALL_FRAME_TYPES;
+		this->windowStart = Seconds(0);
+		this->windowStop = Time::Max();
+		this->capacity = 0;
+
+		this->nCaptured = 0;
+		this->nWritten = 0;
+		this->nTriggers = 0;
+		this->nFiles = 0;
+	}
+
+	EEBTPPcapCapture::~EEBTPPcapCapture()
+	{
+	}
+
+	TypeId EEBTPPcapCapture::GetTypeId()
+	{
+		static TypeId tid = TypeId("ns3::EEBTPPcapCapture").SetParent<Object>().AddConstructor<EEBTPPcapCapture>();
+		return tid;
+	}
+
+	TypeId EEBTPPcapCapture::GetInstanceTypeId() const
+	{
+		return GetTypeId();
+	}
+
+	//Disconnects from the PHYs and protocols, the devices outlive this capture
+	void EEBTPPcapCapture::DoDispose()
+	{
+		for (uint32_t i = 0; i < this->captures.size(); i++)
+		{
+			NodeCapture &nc = this->captures[i];
+			Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice>(this->devices.Get(i));
+			if (!nc.txCallback.IsNull())
+			{
+				device->GetPhy()->TraceDisconnectWithoutContext("MonitorSnifferTx", nc.txCallback);
+				device->GetPhy()->TraceDisconnectWithoutContext("MonitorSnifferRx", nc.rxCallback);
+			}
+
+			Ptr<EEBTProtocol> proto = device->GetObject<EEBTProtocol>();
+			if (proto != 0 && !nc.cycleCallback.IsNull())
+			{
+				proto->TraceDisconnectWithoutContext("CycleDetected", nc.cycleCallback);
+				proto->TraceDisconnectWithoutContext("ApplicationDataDelivered", nc.dataCallback);
+			}
+		}
+		this->captures.clear();
+		this->indexByAddress.clear();
+		this->devices = NetDeviceContainer();
+		Object::DoDispose();
+	}
+
+	void EEBTPPcapCapture::setup(NetDeviceContainer devices, uint64_t gid, std::string prefix)
+	{
+		this->devices = devices;
+		this->gid = gid;
+		this->prefix = prefix;
+	}
+
+	void EEBTPPcapCapture::setNodes(std::vector<uint32_t> nodes)
+	{
+		this->nodes = nodes;
+	}
+
+	void EEBTPPcapCapture::setMaxDepth(int32_t maxDepth)
+	{
+		this->maxDepth = maxDepth;
+	}
+
+	void EEBTPPcapCapture::setFrameTypes(uint32_t frameTypes)
+	{
+		this->frameTypes = frameTypes;
+	}
+
+	void EEBTPPcapCapture::setWindow(Time start, Time stop)
+	{
+		this->windowStart = start;
+		this->windowStop = stop;
+	}
+
+	void EEBTPPcapCapture::setRingCapacity(uint32_t capacity)
+	{
+		this->capacity = capacity;
+	}
+
+	/*
+	 * Connects to the PHY of every selected node, the triggers are only
+	 * needed for the rings
+	 */
+	void EEBTPPcapCapture::start()
+	{
+		this->captures.assign(this->devices.GetN(), NodeCapture());
+		for (uint32_t i = 0; i < this->devices.GetN(); i++)
+		{
+			Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice>(this->devices.Get(i));
+			NodeCapture &nc = this->captures[i];
+			nc.nodeId = device->GetNode()->GetId();
+			nc.lastDataSeqNo = 0;
+			nc.selected = this->nodes.empty() || std::find(this->nodes.begin(), this->nodes.end(), nc.nodeId) != this->nodes.end();
+			this->indexByAddress[Mac48Address::ConvertFrom(device->GetAddress())] = i;
+
+			if (!nc.selected)
+				continue;
+
+			nc.txCallback = MakeBoundCallback(&EEBTPPcapCapture::onSnifferTx, this, i);
+			nc.rxCallback = MakeBoundCallback(&EEBTPPcapCapture::onSnifferRx, this, i);
+			device->GetPhy()->TraceConnectWithoutContext("MonitorSnifferTx", nc.txCallback);
+			device->GetPhy()->TraceConnectWithoutContext("MonitorSnifferRx", nc.rxCallback);
+
+			Ptr<EEBTProtocol> proto = device->GetObject<EEBTProtocol>();
+			if (this->capacity > 0 && proto != 0)
+			{
+				nc.cycleCallback = MakeBoundCallback(&EEBTPPcapCapture::onCycleDetected, this, i);
+				nc.dataCallback = MakeBoundCallback(&EEBTPPcapCapture::onApplicationData, this, i);
+				proto->TraceConnectWithoutContext("CycleDetected", nc.cycleCallback);
+				proto->TraceConnectWithoutContext("ApplicationDataDelivered", nc.dataCallback);
+			}
+		}
+	}
+
+	//Closes the files, frames left in the rings were never triggered and are dropped
+	void EEBTPPcapCapture::finish()
+	{
+		for (NodeCapture &nc : this->captures)
+		{
+			nc.ring.clear();
+			if (nc.file != 0)
+				nc.file->Close();
+			nc.file = 0;
+		}
+	}
+
+	void EEBTPPcapCapture::onSnifferTx(EEBTPPcapCapture *capture, uint32_t index, Ptr<const Packet> packet, uint16_t channelFreqMhz, WifiTxVector txVector, MpduInfo aMpdu)
+	{
+		capture->capture(index, packet);
+	}
+
+	void EEBTPPcapCapture::onSnifferRx(EEBTPPcapCapture *capture, uint32_t index, Ptr<const Packet> packet, uint16_t channelFreqMhz, WifiTxVector txVector, MpduInfo aMpdu, SignalNoiseDbm signalNoise)
+	{
+		capture->capture(index, packet);
+	}
+
+	void EEBTPPcapCapture::onCycleDetected(EEBTPPcapCapture *capture, uint32_t index, uint64_t gid, uint32_t nodes)
+	{
+		if (gid == capture->gid)
+			capture->trigger(index);
+	}
+
+	/*
+	 * The ApplicationDataHandler delivers the data sequence numbers from 1 on,
+	 * each one once. A number above the next expected one means the ones in
+	 * between were lost on the way, their late copies do not trigger again
+	 */
+	void EEBTPPcapCapture::onApplicationData(EEBTPPcapCapture *capture, uint32_t index, uint64_t gid, uint32_t seqNo, Time latency)
+	{
+		NodeCapture &nc = capture->captures[index];
+		if (gid != capture->gid || seqNo <= nc.lastDataSeqNo)
+			return;
+
+		bool gap = seqNo > nc.lastDataSeqNo + 1;
+		nc.lastDataSeqNo = seqNo;
+
+		Ptr<EEBTProtocol> proto = capture->devices.Get(index)->GetObject<EEBTProtocol>();
+		if (gap && proto->hasGameState(gid) && !proto->getGameState(gid)->hasChilds())
+			capture->trigger(index);
+	}
+
+	//The cheap filters first, the depth walks up the tree
+	void EEBTPPcapCapture::capture(uint32_t index, Ptr<const Packet> packet)
+	{
+		if (Now() < this->windowStart || Now() > this->windowStop)
+			return;
+
+		if (this->frameTypes != EEBTPPcapCapture::ALL_FRAME_TYPES)
+		{
+			EEBTPTag tag;
+			if (!packet->PeekPacketTag(tag) || tag.getFrameType() >= 32 || (this->frameTypes & (1u << tag.getFrameType())) == 0)
+				return;
+		}
+
+		if (this->maxDepth >= 0)
+		{
+			int32_t depth = this->getDepth(index);
+			if (depth < 0 || depth > this->maxDepth)
+				return;
+		}
+
+		this->nCaptured++;
+		NodeCapture &nc = this->captures[index];
+		Frame frame;
+		frame.time = Now();
+		frame.packet = packet;
+
+		if (this->capacity == 0)
+		{
+			this->write(nc, frame);
+			return;
+		}
+
+		if (nc.ring.size() == this->capacity)
+			nc.ring.pop_front();
+		nc.ring.push_back(frame);
+	}
+
+	//Writes and empties the ring of a node
+	void EEBTPPcapCapture::trigger(uint32_t index)
+	{
+		NodeCapture &nc = this->captures[index];
+		this->nTriggers++;
+		NS_LOG_DEBUG("[Node " << nc.nodeId << "]: PCAP trigger at " << Now() << ", writing " << nc.ring.size() << " frames");
+
+		for (const Frame &frame : nc.ring)
+			this->write(nc, frame);
+		nc.ring.clear();
+	}
+
+	void EEBTPPcapCapture::write(NodeCapture &nc, const Frame &frame)
+	{
+		if (nc.file == 0)
+		{
+			std::stringstream fileName;
+			fileName << this->prefix << "-" << nc.nodeId << ".pcap";
+
+			PcapHelper pcapHelper;
+			nc.file = pcapHelper.CreateFile(fileName.str(), std::ios::out, PcapHelper::DLT_IEEE802_11);
+			this->nFiles++;
+		}
+
+		nc.file->Write(frame.time, frame.packet);
+		this->nWritten++;
+	}
+
+	/*
+	 * Hops from a node to the initiator in the current tree, -1 if the node
+	 * has no path to it (no GameState, no parent, cycle)
+	 */
+	int32_t EEBTPPcapCapture::getDepth(uint32_t index)
+	{
+		for (uint32_t depth = 0; depth < this->captures.size(); depth++)
+		{
+			Ptr<EEBTProtocol> proto = this->devices.Get(index)->GetObject<EEBTProtocol>();
+			if (proto == 0 || !proto->hasGameState(this->gid))
+				return -1;
+
+			Ptr<GameState> gs = proto->getGameState(this->gid);
+			if (gs->isInitiator())
+				return depth;
+			if (gs->getParent() == 0)
+				return -1;
+
+			std::map<Mac48Address, uint32_t>::iterator it = this->indexByAddress.find(gs->getParent()->getAddress());
+			if (it == this->indexByAddress.end())
+				return -1;
+			index = it->second;
+		}
+		return -1;
+	}
+
+	uint64_t EEBTPPcapCapture::getNCaptured()
+	{
+		return this->nCaptured;
+	}
+
+	uint64_t EEBTPPcapCapture::getNWritten()
+	{
+		return this->nWritten;
+	}
+
+	uint32_t EEBTPPcapCapture::getNTriggers()
+	{
+		return this->nTriggers;
+	}
+
+	uint32_t EEBTPPcapCapture::getNFiles()
+	{
+		return this->nFiles;
+	}
+
+	bool EEBTPPcapCapture::parseIds(std::string list, std::vector<uint32_t> &ids)
+	{
+		ids.clear();
+		for (std::string value : SweepSpec::split(list))
+		{
+			if (value.empty())
+				continue;
+
+			char *end;
+			std::string::size_type dash = value.find('-');
+			unsigned long first = std::strtoul(value.c_str(), &end, 10);
+			if (end == value.c_str() || end != value.c_str() + std::min(dash, value.size()))
+				return false;
+
+			unsigned long last = first;
+			if (dash != std::string::npos)
+			{
+				const char *lastStr = value.c_str() + dash + 1;
+				last = std::strtoul(lastStr, &end, 10);
+				if (end == lastStr || *end != 0 || last < first)
+					return false;
+			}
+
+			for (unsigned long id = first; id <= last; id++)
+				ids.push_back(id);
+		}
+		return true;
+	}
+}
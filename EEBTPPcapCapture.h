@@ -0,0 +1,131 @@
+/*
+ * EEBTPPcapCapture.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#ifndef BROADCAST_EEBTPPCAPCAPTURE_H_
+#define BROADCAST_EEBTPPCAPCAPTURE_H_
+
+#include "map"
+#include "deque"
+#include "string"
+#include "vector"
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/packet.h"
+#include "ns3/wifi-phy.h"
+#include "ns3/mac48-address.h"
+#include "ns3/pcap-file-wrapper.h"
+#include "ns3/net-device-container.h"
+
+namespace ns3
+{
+	/*
+	 * Selective PCAP capture of the frames sent and received by the PHYs
+	 * (IEEE 802.11 without radiotap, like phy.EnablePcapAll()), one file per
+	 * node: <prefix>-<node>.pcap. A file is only created once the node has a
+	 * frame to write.
+	 *
+	 * Filters (all of them have to match):
+	 * 	- nodes: set of node IDs (empty: all)
+	 * 	- maxDepth: depth of the node in the tree of the game when the frame
+	 * 		is captured, nodes without a path to the initiator are dropped
+	 * 		(negative: disabled)
+	 * 	- frameTypes: bit mask of the EEBTP frame types, frames without an
+	 * 		EEBTPTag (e.g. ACKs) only pass if all types are selected
+	 * 	- start/stop: time window
+	 *
+	 * With a ring capacity > 0 the frames are kept in memory, the last
+	 * 'capacity' ones per node, and only written when the node triggers:
+	 * 	- it detected a cycle (CycleDetected)
+	 * 	- application data was lost while the node is a leaf: a data
+	 * 		sequence number above the next expected one is delivered
+	 * 		(ApplicationDataDelivered without children)
+	 * Otherwise every frame that passes the filters is written right away.
+	 */
+	class EEBTPPcapCapture : public Object
+	{
+	public:
+		static const uint32_t ALL_FRAME_TYPES = 0xffffffff;
+
+		EEBTPPcapCapture();
+		virtual ~EEBTPPcapCapture();
+
+		static TypeId GetTypeId();
+		virtual TypeId GetInstanceTypeId() const;
+
+		void setup(NetDeviceContainer devices, uint64_t gid, std::string prefix);
+		void setNodes(std::vector<uint32_t> nodes);
+		void setMaxDepth(int32_t maxDepth);
+		void setFrameTypes(uint32_t frameTypes);
+		void setWindow(Time start, Time stop);
+		void setRingCapacity(uint32_t capacity);
+
+		void start();
+		void finish();
+
+		uint64_t getNCaptured();
+		uint64_t getNWritten();
+		uint32_t getNTriggers();
+		uint32_t getNFiles();
+
+		//Comma separated IDs and ranges, e.g. "0,4-7"
+		static bool parseIds(std::string list, std::vector<uint32_t> &ids);
+
+	private:
+		struct Frame
+		{
+			Time time;
+			Ptr<const Packet> packet;
+		};
+
+		struct NodeCapture
+		{
+			uint32_t nodeId;
+			bool selected;
+			uint32_t lastDataSeqNo; //Highest data sequence number delivered
+			std::deque<Frame> ring;
+			Ptr<PcapFileWrapper> file;
+			Callback<void, Ptr<const Packet>, uint16_t, WifiTxVector, MpduInfo> txCallback;
+			Callback<void, Ptr<const Packet>, uint16_t, WifiTxVector, MpduInfo, SignalNoiseDbm> rxCallback;
+			Callback<void, uint64_t, uint32_t> cycleCallback;
+			Callback<void, uint64_t, uint32_t, Time> dataCallback;
+		};
+
+		NetDeviceContainer devices;
+		uint64_t gid;
+		std::string prefix;
+
+		std::vector<uint32_t> nodes;
+		int32_t maxDepth;
+		uint32_t frameTypes;
+		Time windowStart;
+		Time windowStop;
+		uint32_t capacity;
+
+		std::vector<NodeCapture> captures;
+		std::map<Mac48Address, uint32_t> indexByAddress;
+
+		uint64_t nCaptured;
+		uint64_t nWritten;
+		uint32_t nTriggers;
+		uint32_t nFiles;
+
+		static void onSnifferTx(EEBTPPcapCapture *capture, uint32_t index, Ptr<const Packet> packet, uint16_t channelFreqMhz, WifiTxVector txVector, MpduInfo aMpdu);
+		static void onSnifferRx(EEBTPPcapCapture *capture, uint32_t index, Ptr<const Packet> packet, uint16_t channelFreqMhz, WifiTxVector txVector, MpduInfo aMpdu, SignalNoiseDbm signalNoise);
+		static void onCycleDetected(EEBTPPcapCapture *capture, uint32_t index, uint64_t gid, uint32_t nodes);
+		static void onApplicationData(EEBTPPcapCapture *capture, uint32_t index, uint64_t gid, uint32_t seqNo, Time latency);
+
+		void capture(uint32_t index, Ptr<const Packet> packet);
+		void trigger(uint32_t index);
+		void write(NodeCapture &nc, const Frame &frame);
+
+		int32_t getDepth(uint32_t index);
+
+		virtual void DoDispose();
+	};
+}
+
+#endif /* BROADCAST_EEBTPPCAPCAPTURE_H_ */
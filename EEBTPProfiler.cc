@@ -0,0 +1,90 @@
+/*
+ * EEBTPProfiler.cc
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include "cstdio"
+#include "algorithm"
+
+#include "EEBTPProfiler.h"
+
+namespace ns3
+{
+	EEBTPProfiler::Scope *EEBTPProfiler::current = 0;
+
+	bool EEBTPProfiler::isEnabled()
+	{
+#ifdef EEBTP_PROFILE
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	//Counters are only added (by the first call of a scope), so the IDs stay valid
+	std::vector<EEBTPProfiler::Counter> &EEBTPProfiler::getCounters()
+	{
+		static std::vector<Counter> counters;
+		return counters;
+	}
+
+	uint32_t EEBTPProfiler::getId(const char *name)
+	{
+		std::vector<Counter> &counters = EEBTPProfiler::getCounters();
+		for (uint32_t i = 0; i < counters.size(); i++)
+		{
+			if (counters[i].name == name)
+				return i;
+		}
+
+		Counter c = Counter();
+		c.name = name;
+		counters.push_back(c);
+		return counters.size() - 1;
+	}
+
+	void EEBTPProfiler::reset()
+	{
+		for (Counter &c : EEBTPProfiler::getCounters())
+		{
+			c.calls = 0;
+			c.totalNs = 0;
+			c.selfNs = 0;
+		}
+	}
+
+	/*
+	 * Prints the counters sorted by self time, counters without time (only
+	 * counted) follow sorted by calls
+	 */
+	void EEBTPProfiler::print(std::ostream &os)
+	{
+		std::vector<Counter> counters = EEBTPProfiler::getCounters();
+		std::sort(counters.begin(), counters.end(), [](const Counter &a, const Counter &b) {
+			if (a.selfNs != b.selfNs)
+				return a.selfNs > b.selfNs;
+			return a.calls > b.calls;
+		});
+
+		int64_t totalSelf = 0;
+		for (const Counter &c : counters)
+			totalSelf += c.selfNs;
+
+		char line[256];
+		std::snprintf(line, sizeof(line), "%-48s %12s %12s %12s %7s %10s\n", "PROFILE", "CALLS", "TOTAL [ms]", "SELF [ms]", "SELF", "NS/CALL");
+		os << line;
+		for (const Counter &c : counters)
+		{
+			if (c.calls == 0)
+				continue;
+
+			if (c.totalNs == 0)
+				std::snprintf(line, sizeof(line), "%-48s %12llu\n", c.name.c_str(), (unsigned long long)c.calls);
+			else
+				std::snprintf(line, sizeof(line), "%-48s %12llu %12.3f %12.3f %6.2f%% %10.0f\n", c.name.c_str(), (unsigned long long)c.calls, c.totalNs / 1e6, c.selfNs / 1e6,
+							  (totalSelf > 0) ? 100.0 * c.selfNs / totalSelf : 0.0, (double)c.totalNs / c.calls);
+			os << line;
+		}
+	}
+}
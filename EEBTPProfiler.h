@@ -0,0 +1,113 @@
+/*
+ * EEBTPProfiler.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#ifndef BROADCAST_EEBTPPROFILER_H_
+#define BROADCAST_EEBTPPROFILER_H_
+
+#include "string"
+#include "vector"
+#include "chrono"
+#include "cstdint"
+#include "ostream"
+
+/*
+ * Profiling counters of the protocol hot paths, only compiled in with
+ * -DEEBTP_PROFILE (e.g. CXXFLAGS="-DEEBTP_PROFILE" ./waf configure).
+ *
+ * 	- EEBTP_PROFILE_SCOPE("name") counts the calls of the enclosing block and
+ * 		measures its wall time, in total and without nested scopes (self)
+ * 	- EEBTP_PROFILE_COUNT("name") only counts, e.g. scheduled events
+ *
+ * Without EEBTP_PROFILE both macros are empty.
+ */
+#ifdef EEBTP_PROFILE
+#define EEBTP_PROFILE_CONCAT2(a, b) a##b
+#define EEBTP_PROFILE_CONCAT(a, b) EEBTP_PROFILE_CONCAT2(a, b)
+#define EEBTP_PROFILE_SCOPE(name)                                                                                    \
+	static const uint32_t EEBTP_PROFILE_CONCAT(eebtpProfileId, __LINE__) = ns3::EEBTPProfiler::getId(name); \
+	ns3::EEBTPProfiler::Scope EEBTP_PROFILE_CONCAT(eebtpProfileScope, __LINE__)(EEBTP_PROFILE_CONCAT(eebtpProfileId, __LINE__))
+#define EEBTP_PROFILE_COUNT(name)                                                 \
+	do                                                                            \
+	{                                                                             \
+		static const uint32_t eebtpProfileId = ns3::EEBTPProfiler::getId(name); \
+		ns3::EEBTPProfiler::count(eebtpProfileId);                                \
+	} while (0)
+#else
+#define EEBTP_PROFILE_SCOPE(name)
+#define EEBTP_PROFILE_COUNT(name) \
+	do                            \
+	{                             \
+	} while (0)
+#endif
+
+namespace ns3
+{
+	/*
+	 * Process wide table of the counters, without ns-3 dependencies. Forked
+	 * workers have their own copy, so every run prints and resets its own
+	 * profile.
+	 */
+	class EEBTPProfiler
+	{
+	public:
+		struct Counter
+		{
+			std::string name;
+			uint64_t calls;
+			int64_t totalNs;
+			int64_t selfNs;
+		};
+
+		class Scope
+		{
+		public:
+			inline Scope(uint32_t id)
+			{
+				this->id = id;
+				this->childNs = 0;
+				this->parent = EEBTPProfiler::current;
+				EEBTPProfiler::current = this;
+				this->start = std::chrono::steady_clock::now();
+			}
+
+			inline ~Scope()
+			{
+				int64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - this->start).count();
+				Counter &c = EEBTPProfiler::getCounters()[this->id];
+				c.calls++;
+				c.totalNs += ns;
+				c.selfNs += ns - this->childNs;
+
+				if (this->parent != 0)
+					this->parent->childNs += ns;
+				EEBTPProfiler::current = this->parent;
+			}
+
+		private:
+			uint32_t id;
+			int64_t childNs;
+			Scope *parent;
+			std::chrono::steady_clock::time_point start;
+		};
+
+		static bool isEnabled();
+
+		static uint32_t getId(const char *name);
+		static inline void count(uint32_t id)
+		{
+			EEBTPProfiler::getCounters()[id].calls++;
+		}
+
+		static std::vector<Counter> &getCounters();
+		static void reset();
+		static void print(std::ostream &os);
+
+	private:
+		static Scope *current;
+	};
+}
+
+#endif /* BROADCAST_EEBTPPROFILER_H_ */
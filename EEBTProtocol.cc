@@ -1,5 +1,5 @@
 /*
- * SimpleBroadcastProtocol.cc
+ * EEBTProtocol.cc
  *
  *  Created on: 02.06.2020
  *      Author: krassus
@@ -15,6 +15,8 @@
 #include "EEBTProtocol.h"
 #include "EEBTPDataHeader.h"
 #include "EEBTPQueueDiscItem.h"
+#include "EEBTPProfiler.h"
+#include "EEBTPCausalGraph.h"
 #include "CustomWifiTxCurrentModel.h"
 
 #include "float.h"
@@ -23,6 +25,8 @@
 #include "ns3/log.h"
 #include "ns3/wifi-utils.h"
 #include "ns3/integer.h"
+#include "ns3/uinteger.h"
+#include "ns3/double.h"
 #include "ns3/callback.h"
 #include "ns3/core-module.h"
 #include "ns3/wifi-mac.h"
@@ -47,8 +51,16 @@ namespace ns3
 		this->dataLength = 1000;
 
 		this->ndInterval = 0;
+		this->maxRetransmissions = 20;
+		this->ackPollFactor = 100;
+		this->ackRetryFactor = 200;
+		this->ndSlots = 2000;
+		this->maxUnchangedRounds = EEBTProtocol::MAX_UNCHANGED_ROUNDS;
+		this->txPowerMargin = 5.0;
+		this->applicationDataInterval = MilliSeconds(10);
 		this->cache = SeqNoCache();
 		this->maxAllowedTxPower = 23;
+		this->eventTrace = 0;
 	}
 
 	EEBTProtocol::~EEBTProtocol()
@@ -63,7 +75,24 @@ namespace ns3
 
 	TypeId EEBTProtocol::GetTypeId()
 	{
-		static TypeId tid = TypeId("ns3::EEBTPProtocol").SetParent<Object>().AddConstructor<EEBTProtocol>();
+		static TypeId tid = TypeId("ns3::EEBTPProtocol")
+								.SetParent<Object>()
+								.AddConstructor<EEBTProtocol>()
+								.AddAttribute("MaxRetransmissions", "Number of ack polls of a frame before it is sent again although the MAC did not report it as lost", UintegerValue(20), MakeUintegerAccessor(&EEBTProtocol::maxRetransmissions), MakeUintegerChecker<uint32_t>(1))
+								.AddAttribute("AckPollFactor", "First ack poll of a sent frame after this many ack timeouts of the MAC", UintegerValue(100), MakeUintegerAccessor(&EEBTProtocol::ackPollFactor), MakeUintegerChecker<uint32_t>(1))
+								.AddAttribute("AckRetryFactor", "Every further ack poll after this many ack timeouts of the MAC", UintegerValue(200), MakeUintegerAccessor(&EEBTProtocol::ackRetryFactor), MakeUintegerChecker<uint32_t>(1))
+								.AddAttribute("NeighborDiscoverySlots", "Interval of the neighbor discovery rounds in slots of the MAC", UintegerValue(2000), MakeUintegerAccessor(&EEBTProtocol::ndSlots), MakeUintegerChecker<uint32_t>(1))
+								.AddAttribute("MaxUnchangedRounds", "Neighbor discovery rounds without a change before a node may finish", UintegerValue(EEBTProtocol::MAX_UNCHANGED_ROUNDS), MakeUintegerAccessor(&EEBTProtocol::maxUnchangedRounds), MakeUintegerChecker<uint32_t>(1))
+								.AddAttribute("TxPowerMargin", "Margin in dB added to the TX power needed to reach a neighbor", DoubleValue(5.0), MakeDoubleAccessor(&EEBTProtocol::txPowerMargin), MakeDoubleChecker<double>(0.0))
+								.AddAttribute("ApplicationDataInterval", "Interval between two application data packets of the initiator", TimeValue(MilliSeconds(10)), MakeTimeAccessor(&EEBTProtocol::applicationDataInterval), MakeTimeChecker(NanoSeconds(1)))
+								.AddTraceSource("ParentChanged", "The parent of a game changed", MakeTraceSourceAccessor(&EEBTProtocol::parentChangedTrace), "ns3::EEBTProtocol::ParentChangedCallback")
+								.AddTraceSource("ChildAdded", "A child joined a game", MakeTraceSourceAccessor(&EEBTProtocol::childAddedTrace), "ns3::EEBTProtocol::ChildCallback")
+								.AddTraceSource("ChildRemoved", "A child left a game", MakeTraceSourceAccessor(&EEBTProtocol::childRemovedTrace), "ns3::EEBTProtocol::ChildCallback")
+								.AddTraceSource("GameFinished", "The node finished a game", MakeTraceSourceAccessor(&EEBTProtocol::gameFinishedTrace), "ns3::EEBTProtocol::GameFinishedCallback")
+								.AddTraceSource("BlacklistUpdated", "A node was blacklisted or the blacklist was reset", MakeTraceSourceAccessor(&EEBTProtocol::blacklistUpdatedTrace), "ns3::EEBTProtocol::BlacklistUpdatedCallback")
+								.AddTraceSource("CycleDetected", "The node detected a cycle it is part of", MakeTraceSourceAccessor(&EEBTProtocol::cycleDetectedTrace), "ns3::EEBTProtocol::CycleDetectedCallback")
+								.AddTraceSource("Retransmission", "A frame is sent again by the protocol", MakeTraceSourceAccessor(&EEBTProtocol::retransmissionTrace), "ns3::EEBTProtocol::RetransmissionCallback")
+								.AddTraceSource("ApplicationDataDelivered", "A new application data packet was accepted", MakeTraceSourceAccessor(&EEBTProtocol::applicationDataDeliveredTrace), "ns3::EEBTProtocol::ApplicationDataDeliveredCallback");
 		return tid;
 	}
 
@@ -189,7 +218,9 @@ namespace ns3
 		os << "\tPARENT_REVOCATION:\t" << this->packetManager->getEnergyByRecvFrame(gid, 5) << "J | " << this->packetManager->getEnergyBySentFrame(gid, 5) << "J\n";
 		os << "\tEND_OF_GAME:\t\t" << this->packetManager->getEnergyByRecvFrame(gid, 6) << "J | " << this->packetManager->getEnergyBySentFrame(gid, 6) << "J\n";
 		os << "\tAPPLICATION_DATA:\t" << this->packetManager->getEnergyByRecvFrame(gid, 7) << "J | " << this->packetManager->getEnergyBySentFrame(gid, 7) << "J\n";
-		os << "TOTAL ENERGY:\t\t\t" << this->packetManager->getTotalEnergyConsumed(gid) << "J\n\n";
+		os << "TOTAL ENERGY:\t\t\t" << this->packetManager->getTotalEnergyConsumed(gid) << "J\n";
+		os << "IDLE ENERGY:\t\t\t" << this->packetManager->getIdleEnergy() << "J\n";
+		os << "UNATTRIBUTED ENERGY:\t" << this->packetManager->getUnattributedEnergy() << "J\n\n";
 
 		uint32_t allFrameTypesSent = 0;
 		for (int i = 0; i < 8; i++)
@@ -261,6 +292,45 @@ namespace ns3
 		return this->packetManager;
 	}
 
+	int EEBTProtocol::getSendCounter()
+	{
+		return this->sendCounter;
+	}
+
+	/*
+	 * Records the frames, parent and blacklist changes and the end of the
+	 * game of this node and the cycles into 'eventTrace' (0: disabled)
+	 */
+	void EEBTProtocol::setEventTrace(EEBTPEventTrace *eventTrace)
+	{
+		this->eventTrace = eventTrace;
+		this->packetManager->setEventTrace(eventTrace);
+		this->cycleWatchDog->setEventTrace(eventTrace);
+		for (Ptr<GameState> gs : this->games)
+			gs->setEventTrace(eventTrace, this->device->GetNode()->GetId());
+	}
+
+	bool EEBTProtocol::startRecording(std::string fileName)
+	{
+		return false;
+	}
+
+	bool EEBTProtocol::stopRecording()
+	{
+		return false;
+	}
+
+	//Adds the estimated memory of all games, caches and the cycles of this node
+	void EEBTProtocol::getMemoryUsage(MemoryUsage &usage)
+	{
+		for (Ptr<GameState> gs : this->games)
+			gs->getMemoryUsage(usage);
+		this->cache.getMemoryUsage(usage);
+		this->packetManager->getMemoryUsage(usage);
+		if (this->cycleWatchDog != 0)
+			this->cycleWatchDog->getMemoryUsage(this->device->GetNode()->GetId(), usage);
+	}
+
 	Ptr<NetDevice> EEBTProtocol::GetDevice()
 	{
 		return this->device;
@@ -282,10 +352,24 @@ namespace ns3
 
 		Ptr<GameState> gs = Create<GameState>(false, gid);
 		gs->setMyAddress(this->myAddress);
+		gs->setProtocol(this);
+		if (this->eventTrace != 0)
+			gs->setEventTrace(this->eventTrace, this->device->GetNode()->GetId());
 		this->games.push_back(gs);
 		return this->games[this->games.size() - 1];
 	}
 
+	//Unlike getGameState() no GameState is created
+	bool EEBTProtocol::hasGameState(uint64_t gid)
+	{
+		for (uint i = 0; i < this->games.size(); i++)
+		{
+			if (this->games[i]->getGameID() == gid)
+				return true;
+		}
+		return false;
+	}
+
 	Ptr<GameState> EEBTProtocol::initGameState(uint64_t gid)
 	{
 		for (uint i = 0; i < this->games.size(); i++)
@@ -297,6 +381,9 @@ namespace ns3
 
 		Ptr<GameState> gs = Create<GameState>(true, gid);
 		gs->setMyAddress(this->myAddress);
+		gs->setProtocol(this);
+		if (this->eventTrace != 0)
+			gs->setEventTrace(this->eventTrace, this->device->GetNode()->GetId());
 		this->games.push_back(gs);
 		return this->games[this->games.size() - 1];
 	}
@@ -363,7 +450,7 @@ namespace ns3
 		this->device->GetMac()->GetWifiRemoteStationManager()->TraceConnectWithoutContext("MacTxFinalRtsFailed", MakeCallback(&EEBTPPacketManager::onTxFinalRtsFailed, this->packetManager));
 		this->device->GetMac()->GetWifiRemoteStationManager()->TraceConnectWithoutContext("MacTxFinalDataFailed", MakeCallback(&EEBTPPacketManager::onTxFinalDataFailed, this->packetManager));
 
-		this->ndInterval = this->device->GetMac()->GetSlot().GetMicroSeconds() * 2000;
+		this->ndInterval = this->device->GetMac()->GetSlot().GetMicroSeconds() * this->ndSlots;
 
 		TrafficControlHelper tch = TrafficControlHelper();
 		tch.Install(this->device);
@@ -388,7 +475,7 @@ namespace ns3
 		double neededPower = (txPower - (snr - minSNR));
 
 		if (neededPower <= this->maxAllowedTxPower)
-			neededPower = std::min(neededPower + 5, this->maxAllowedTxPower);
+			neededPower = std::min(neededPower + this->txPowerMargin, this->maxAllowedTxPower);
 		//NS_LOG_DEBUG("rxPower = " << rxPower << "dBm, txPower = " << txPower << "dBm, noise = " << noise << "dBm, SNR = " << (rxPower - noise) << "dB, minSNR = " << minSNR << "dB, neededPower = " << neededPower);
 		return neededPower;
 	}
@@ -406,6 +493,7 @@ namespace ns3
 	 */
 	void EEBTProtocol::Receive(Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t pID, const Address &sender, const Address &receiver, NetDevice::PacketType pType)
 	{
+		EEBTP_PROFILE_SCOPE("EEBTProtocol::Receive");
 		EEBTPTag tag;
 		EEBTPHeader header;
 		Ptr<WifiNetDevice> dev = DynamicCast<WifiNetDevice>(device);
@@ -418,6 +506,11 @@ namespace ns3
 		//Get packet tag
 		tag = this->packetManager->getPacketTag(header.GetSequenceNumber());
 
+		if (this->eventTrace != 0)
+			this->eventTrace->record(Now().GetNanoSeconds(), this->device->GetNode()->GetId(), EEBTPEventTrace::FRAME_RECEIVED, header.GetFrameType(), EEBTPEventTrace::getAddress(sender_addr), header.GetSequenceNumber(), header.GetTxPower(), tag.getSignal());
+		if (EEBTPCausalGraph::isEnabled())
+			EEBTPCausalGraph::onReceive(Now().GetNanoSeconds(), this->device->GetNode()->GetId(), EEBTPEventTrace::getAddress(sender_addr), header.GetSequenceNumber(), header.GetFrameType());
+
 		NS_LOG_DEBUG("[Node " << dev->GetNode()->GetId() << " / " << Now() << "]: [" << this->myAddress << "] received packet from " << sender_addr << " / SeqNo: " << header.GetSequenceNumber() << " / FRAME_TYPE: " << (int)header.GetFrameType() << " / txPower: " << header.GetTxPower() << "dBm / noise: " << tag.getNoise() << "dBm");
 		NS_LOG_DEBUG("\thTx: " << header.GetHighestMaxTxPower() << ", shTx: " << header.GetSecondHighestMaxTxPower());
 
@@ -619,9 +712,9 @@ namespace ns3
 				this->packetManager->deleteSeqNoEntry(seqNo);
 				return;
 			}
-			else if (this->packetManager->isPacketLost(seqNo) || event->getNTimes() > 20)
+			else if (this->packetManager->isPacketLost(seqNo) || event->getNTimes() > this->maxRetransmissions)
 			{
-				if (event->getNTimes() > 20)
+				if (event->getNTimes() > this->maxRetransmissions)
 				{
 					if (ft == CHILD_REQUEST && txPower >= this->maxAllowedTxPower)
 					{
@@ -642,7 +735,9 @@ namespace ns3
 			}
 			else
 			{
-				Time ttw = this->device->GetMac()->GetAckTimeout() * 200;
+				Time ttw = this->device->GetMac()->GetAckTimeout() * this->ackRetryFactor;
+				EEBTP_PROFILE_COUNT("schedule SendEvent");
+				EEBTPCausalGraph::onTimerSet(PeekPointer(event));
 				Simulator::Schedule(ttw, event);
 				NS_LOG_DEBUG("[Node " << this->device->GetNode()->GetId() << "]: Rescheduled SendEvent(" << seqNo << ") for " << (Now() + ttw) << ", now = " << Now());
 			}
@@ -687,9 +782,9 @@ namespace ns3
 			this->packetManager->deleteSeqNoEntry(seqNo);
 			return;
 		}
-		else if (this->packetManager->isPacketLost(seqNo) || event->getNTimes() > 20)
+		else if (this->packetManager->isPacketLost(seqNo) || event->getNTimes() > this->maxRetransmissions)
 		{
-			if (event->getNTimes() > 20)
+			if (event->getNTimes() > this->maxRetransmissions)
 				NS_LOG_DEBUG("[Node " << this->device->GetNode()->GetId() << "]: Packet with seqNo " << seqNo << " has not been acked yet. Retransmitting..., time = " << Now());
 			else
 				NS_LOG_DEBUG("[Node " << this->device->GetNode()->GetId() << "]: Packet with seqNo " << seqNo << " has been lost. Retransmitting..., time = " << Now());
@@ -712,8 +807,10 @@ namespace ns3
 		}
 		else
 		{
-			Time ttw = this->device->GetMac()->GetAckTimeout() * 200;
+			Time ttw = this->device->GetMac()->GetAckTimeout() * this->ackRetryFactor;
 			//Simulator::Schedule(ttw, Create<CCSendEvent>(gs, this, originator, newParent, oldParent, txPower, seqNo));
+			EEBTP_PROFILE_COUNT("schedule CCSendEvent");
+			EEBTPCausalGraph::onTimerSet(PeekPointer(event));
 			Simulator::Schedule(ttw, event);
 			NS_LOG_DEBUG("[Node " << this->device->GetNode()->GetId() << "]: Rescheduled CCSendEvent(" << seqNo << ") for " << (Now() + ttw) << ", now = " << Now());
 		}
@@ -727,6 +824,7 @@ namespace ns3
 	//Final send method
 	void EEBTProtocol::Send(Ptr<GameState> gs, EEBTPHeader header, Mac48Address recipient, double txPower, bool isRetransmission)
 	{
+		EEBTP_PROFILE_SCOPE("EEBTProtocol::Send");
 		//Adjust the transmission power
 		header.setReceivingProblems(false);
 		if (txPower > this->maxAllowedTxPower)
@@ -739,6 +837,8 @@ namespace ns3
 		//Set sequence number
 		if (!isRetransmission)
 			this->cache.injectSeqNo(&header);
+		else
+			this->retransmissionTrace(gs->getGameID(), header.GetFrameType(), header.GetSequenceNumber(), recipient, txPower);
 
 		if (header.GetFrameType() == NEIGHBOR_DISCOVERY) //Check the neighbor discovery event handler (SendEvent)
 		{
@@ -767,14 +867,20 @@ namespace ns3
 
 		if (header.GetFrameType() == CYCLE_CHECK)
 		{
-			Time ttw = this->device->GetMac()->GetAckTimeout() * 100;
-			Simulator::Schedule(ttw, Create<CCSendEvent>(gs, this, header.GetOriginator(), header.GetNewParent(), header.GetOldParent(), txPower, header.GetSequenceNumber()));
+			Time ttw = this->device->GetMac()->GetAckTimeout() * this->ackPollFactor;
+			EEBTP_PROFILE_COUNT("schedule CCSendEvent");
+			Ptr<CCSendEvent> event = Create<CCSendEvent>(gs, this, header.GetOriginator(), header.GetNewParent(), header.GetOldParent(), txPower, header.GetSequenceNumber());
+			EEBTPCausalGraph::onTimerSet(PeekPointer(event));
+			Simulator::Schedule(ttw, event);
 			NS_LOG_DEBUG("[Node " << this->device->GetNode()->GetId() << "]: Scheduled CCSendEvent(" << header.GetSequenceNumber() << ") for " << (Now() + ttw));
 		}
 		else if (header.GetFrameType() == CHILD_REQUEST || header.GetFrameType() == CHILD_CONFIRMATION || header.GetFrameType() == CHILD_REJECTION || header.GetFrameType() == PARENT_REVOCATION || header.GetFrameType() == END_OF_GAME)
 		{
-			Time ttw = this->device->GetMac()->GetAckTimeout() * 100;
-			EventId id = Simulator::Schedule(ttw, Create<SendEvent>(gs, this, (FRAME_TYPE)header.GetFrameType(), recipient, txPower, header.GetSequenceNumber()));
+			Time ttw = this->device->GetMac()->GetAckTimeout() * this->ackPollFactor;
+			EEBTP_PROFILE_COUNT("schedule SendEvent");
+			Ptr<SendEvent> event = Create<SendEvent>(gs, this, (FRAME_TYPE)header.GetFrameType(), recipient, txPower, header.GetSequenceNumber());
+			EEBTPCausalGraph::onTimerSet(PeekPointer(event));
+			EventId id = Simulator::Schedule(ttw, event);
 			NS_LOG_DEBUG("[Node " << this->device->GetNode()->GetId() << "]: Scheduled SendEvent(" << (uint)header.GetFrameType() << ") for " << (Now() + ttw) << ". EventID = " << id.GetUid());
 		}
 
@@ -799,6 +905,7 @@ namespace ns3
 	 */
 	void EEBTProtocol::handleCycleCheck(Ptr<GameState> gs, Ptr<EEBTPNode> node, Ptr<EEBTPNode> originator, Ptr<EEBTPNode> newParent, Ptr<EEBTPNode> oldParent)
 	{
+		EEBTP_PROFILE_SCOPE("EEBTProtocol::handleCycleCheck");
 		NS_ASSERT_MSG(originator != 0, "originator is null");
 		NS_ASSERT_MSG(newParent != 0, "newParent is null");
 		NS_ASSERT_MSG(oldParent != 0, "oldParent is null");
@@ -879,6 +986,7 @@ namespace ns3
 	 */
 	void EEBTProtocol::handleNeighborDiscovery(Ptr<GameState> gs, Ptr<EEBTPNode> node)
 	{
+		EEBTP_PROFILE_SCOPE("EEBTProtocol::handleNeighborDiscovery");
 		NS_LOG_DEBUG("[Node " << this->device->GetNode()->GetId() << "]: EEBTProtocol::handleNeighborDiscovery()");
 
 		if (gs->isInitiator()) //Check if I am the initiator. If yes, we can ignore this packet
@@ -936,7 +1044,7 @@ namespace ns3
 					//If we are actually saving tx power, switch
 					if (costOfNewConn <= saving)
 					{
-						if (costOfNewConn < saving + 0.0001 && costOfNewConn > saving - 0.0001 && (gs->gameFinished() || gs->getUnchangedCounter() >= EEBTProtocol::MAX_UNCHANGED_ROUNDS))
+						if (costOfNewConn < saving + 0.0001 && costOfNewConn > saving - 0.0001 && (gs->gameFinished() || gs->getUnchangedCounter() >= this->maxUnchangedRounds))
 							NS_LOG_DEBUG("[Node " << this->device->GetNode()->GetId() << "]: Ignoring neighbor discovery from [" << node->getAddress() << "] since we cannot realy save energy an we had too many unchanged roundes");
 						else
 						{
@@ -988,6 +1096,7 @@ namespace ns3
 	 */
 	void EEBTProtocol::handleChildRequest(Ptr<GameState> gs, Ptr<EEBTPNode> node)
 	{
+		EEBTP_PROFILE_SCOPE("EEBTProtocol::handleChildRequest");
 		//NS_LOG_DEBUG(this->device->GetNode()->GetId() << " => EEBTProtocol::handleChildRequest()");
 
 		//Check if we received a parent revocation after this child request
@@ -1069,6 +1178,7 @@ namespace ns3
 	 */
 	void EEBTProtocol::handleChildConfirmation(Ptr<GameState> gs, Ptr<EEBTPNode> node)
 	{
+		EEBTP_PROFILE_SCOPE("EEBTProtocol::handleChildConfirmation");
 		if (gs->checkLastFrameType(node->getAddress(), CHILD_CONFIRMATION, gs->getLastSeqNo(node->getAddress(), CHILD_REJECTION)))
 		{
 			NS_LOG_DEBUG("[Node " << this->device->GetNode()->GetId() << "]: Child confirmation from [" << node->getAddress() << "] dismissed because we received a CHILD_REJECTION with a higher sequence number earlier.");
@@ -1123,7 +1233,7 @@ namespace ns3
 			gs->incrementUnchangedCounter();
 		}
 
-		if (gs->getUnchangedCounter() < EEBTProtocol::MAX_UNCHANGED_ROUNDS)
+		if (gs->getUnchangedCounter() < this->maxUnchangedRounds)
 		{
 			//Check if we note a possible better parent in the past
 			this->contactCheapestNeighbor(gs);
@@ -1152,7 +1262,7 @@ namespace ns3
 				this->Send(gs, END_OF_GAME, gs->getParent()->getAddress(), gs->getParent()->getReachPower());
 
 			//Reset the unchanged counter, since our topology changed
-			if (!gs->doIncrAfterConfirm() && gs->getUnchangedCounter() < EEBTProtocol::MAX_UNCHANGED_ROUNDS)
+			if (!gs->doIncrAfterConfirm() && gs->getUnchangedCounter() < this->maxUnchangedRounds)
 			{
 				NS_LOG_DEBUG("[Node " << this->device->GetNode()->GetId() << "]: Resetting unchanged counter");
 				gs->resetUnchangedCounter();
@@ -1176,6 +1286,7 @@ namespace ns3
 	 */
 	void EEBTProtocol::handleChildRejection(Ptr<GameState> gs, Ptr<EEBTPNode> node)
 	{
+		EEBTP_PROFILE_SCOPE("EEBTProtocol::handleChildRejection");
 		if (gs->checkLastFrameType(node->getAddress(), CHILD_REJECTION, gs->getLastSeqNo(node->getAddress(), CHILD_CONFIRMATION)))
 		{
 			NS_LOG_DEBUG("[Node " << this->device->GetNode()->GetId() << "]: Child rejection from [" << node->getAddress() << "] dismissed because we received a CHILD_CONFIRMATION with a higher sequence number earlier.");
@@ -1305,6 +1416,7 @@ namespace ns3
 	 */
 	void EEBTProtocol::handleParentRevocation(Ptr<GameState> gs, Ptr<EEBTPNode> node)
 	{
+		EEBTP_PROFILE_SCOPE("EEBTProtocol::handleParentRevocation");
 		//NS_LOG_DEBUG(this->device->GetNode()->GetId() << " => EEBTProtocol::handleParentRevocation()");
 
 		if (gs->checkLastFrameType(node->getAddress(), PARENT_REVOCATION, gs->getLastSeqNo(node->getAddress(), CHILD_REQUEST)))
@@ -1342,6 +1454,7 @@ namespace ns3
 	 */
 	void EEBTProtocol::handleEndOfGame(Ptr<GameState> gs, Ptr<EEBTPNode> node)
 	{
+		EEBTP_PROFILE_SCOPE("EEBTProtocol::handleEndOfGame");
 		//NS_LOG_DEBUG(this->device->GetNode()->GetId() << " => EEBTProtocol::handleEndOfGame()");
 
 		if (node == gs->getParent() && gs->getContactedParent() == 0)
@@ -1375,13 +1488,18 @@ namespace ns3
 	 */
 	void EEBTProtocol::handleApplicationData(Ptr<GameState> gs, Ptr<EEBTPNode> node, Ptr<Packet> packet)
 	{
+		EEBTP_PROFILE_SCOPE("EEBTProtocol::handleApplicationData");
 		//NS_LOG_DEBUG("[Node " << this->device->GetNode()->GetId() << "]: EEBTProtocol::handleApplicationData()");
 
 		EEBTPHeader hdr;
 		packet->RemoveHeader(hdr);
 
 		//Store data
-		if (gs->getApplicationDataHandler()->handleApplicationData(packet) && gs->hasChilds())
+		if (!gs->getApplicationDataHandler()->handleApplicationData(packet))
+			return;
+
+		this->notifyApplicationData(gs, packet);
+		if (gs->hasChilds())
 		{
 			this->sendApplicationData(gs, packet);
 		}
@@ -1391,6 +1509,17 @@ namespace ns3
 	 * Helper methods
 	 */
 
+	//Fires ApplicationDataDelivered for a packet the ApplicationDataHandler accepted (starts with the EEBTPDataHeader)
+	void EEBTProtocol::notifyApplicationData(Ptr<GameState> gs, Ptr<const Packet> packet)
+	{
+		if (this->applicationDataDeliveredTrace.IsEmpty())
+			return;
+
+		EEBTPDataHeader header;
+		packet->PeekHeader(header);
+		this->applicationDataDeliveredTrace(gs->getGameID(), header.GetSequenceNumber(), NanoSeconds(Now().GetNanoSeconds() - header.GetOriginTime()));
+	}
+
 	/*
 	 * Searches the cheapest neighbor and contacts it (CHILD_REQUEST)
 	 * if it is not already our parent
@@ -1541,9 +1670,9 @@ namespace ns3
 		if (gs->getNeighborDiscoveryEvent() == 0)
 			gs->setNeighborDiscoveryEvent(Create<SendEvent>(gs, this, NEIGHBOR_DISCOVERY, Mac48Address::GetBroadcast(), this->maxAllowedTxPower, 0));
 
-		//If we sent more than MAX_UNCHANGED_ROUNDS times a neighbor discovery...
+		//If we sent more than 'MaxUnchangedRounds' times a neighbor discovery...
 		//uint32_t maxUnchangedCounter = ((gs->getNNeighbors() * 0.5) + 2);
-		if ((gs->getUnchangedCounter() >= EEBTProtocol::MAX_UNCHANGED_ROUNDS && gs->allChildsFinished()) && (!gs->isInitiator() || gs->getNChilds() > 0))
+		if ((gs->getUnchangedCounter() >= this->maxUnchangedRounds && gs->allChildsFinished()) && (!gs->isInitiator() || gs->getNChilds() > 0))
 		{
 			//Check for the cheapest neighbor, if we are not the initiator
 			if (!gs->isInitiator())
@@ -1558,9 +1687,10 @@ namespace ns3
 		}
 		else
 		{
-			//The event should fire every 500 slots (4500 microseconds)
-			Time slotTime = this->device->GetMac()->GetSlot();
-			Simulator::Schedule(MicroSeconds(slotTime.GetMicroSeconds() * 2000), gs->getNeighborDiscoveryEvent());
+			//The event fires every 'NeighborDiscoverySlots' slots (2000 slots = 18ms with 802.11a)
+			EEBTP_PROFILE_COUNT("schedule SendEvent");
+			EEBTPCausalGraph::onTimerSet(PeekPointer(gs->getNeighborDiscoveryEvent()));
+			Simulator::Schedule(MicroSeconds(this->ndInterval), gs->getNeighborDiscoveryEvent());
 
 			gs->incrementUnchangedCounter();
 		}
@@ -1629,7 +1759,12 @@ namespace ns3
 		this->cache.injectSeqNo(&header);
 
 		if (gs->isInitiator())
-			Simulator::Schedule(MilliSeconds(10), Create<ADSendEvent>(gs, this, header.GetSequenceNumber()));
+		{
+			EEBTP_PROFILE_COUNT("schedule ADSendEvent");
+			Ptr<ADSendEvent> event = Create<ADSendEvent>(gs, this, header.GetSequenceNumber());
+			EEBTPCausalGraph::onTimerSet(PeekPointer(event));
+			Simulator::Schedule(this->applicationDataInterval, event);
+		}
 
 		header.SetFrameType(APPLICATION_DATA);
 		header.SetGameId(gs->getGameID());
@@ -1672,17 +1807,23 @@ namespace ns3
 					EEBTPDataHeader dataHeader;
 					dataHeader.SetDataLength(this->dataLength);
 					dataHeader.SetSequenceNumber(gs->getApplicationDataHandler()->getLastSeqNo());
+					dataHeader.SetOriginTime(Now().GetNanoSeconds());
 					gs->getApplicationDataHandler()->incrementSeqNo();
 					uint8_t *data = new uint8_t[dataHeader.GetDataLength()];
 
-					Ptr<Packet> packet = Create<Packet>(data, dataHeader.GetDataLength());
+					Ptr<Packet> packet = Create<Packet>(data, EEBTPDataHeader::GetPayloadSize(dataHeader.GetDataLength()));
 					packet->AddHeader(dataHeader);
 					this->sendApplicationData(gs, packet);
 
 					this->sendCounter++;
 				}
 				else
-					Simulator::Schedule(MilliSeconds(10), Create<ADSendEvent>(gs, this, seqNo));
+				{
+					EEBTP_PROFILE_COUNT("schedule ADSendEvent");
+					Ptr<ADSendEvent> event = Create<ADSendEvent>(gs, this, seqNo);
+					EEBTPCausalGraph::onTimerSet(PeekPointer(event));
+					Simulator::Schedule(this->applicationDataInterval, event);
+				}
 			}
 		}
 	}
@@ -13,6 +13,7 @@
 #include "ns3/wifi-phy.h"
 #include "ns3/energy-module.h"
 #include "ns3/node-container.h"
+#include "ns3/traced-callback.h"
 #include "ns3/wifi-net-device.h"
 #include "ns3/traffic-control-layer.h"
 #include "ns3/wifi-radio-energy-model-helper.h"
@@ -21,6 +22,7 @@
 #include "SeqNoCache.h"
 #include "EEBTPHeader.h"
 #include "CycleWatchDog.h"
+#include "EEBTPEventTrace.h"
 #include "EEBTPPacketManager.h"
 
 namespace ns3
@@ -43,10 +45,27 @@ namespace ns3
 
 	class EEBTProtocol : public Object
 	{
+		friend class GameState;
+		friend class CycleWatchDog;
+
 	public:
 		EEBTProtocol();
 		virtual ~EEBTProtocol();
 
+		/*
+		 * Signatures of the trace sources (see GetTypeId()), e.g.
+		 * /NodeList/<i>/DeviceList/<j>/$ns3::EEBTPProtocol/ParentChanged
+		 * 	- Missing parents and a reset blacklist are the broadcast address
+		 * 	- GameFinished is only fired the first time, with the highest TX power in dBm
+		 */
+		typedef void (*ParentChangedCallback)(uint64_t gid, Mac48Address oldParent, Mac48Address newParent);
+		typedef void (*ChildCallback)(uint64_t gid, Mac48Address child);
+		typedef void (*GameFinishedCallback)(uint64_t gid, double highestTxPower);
+		typedef void (*BlacklistUpdatedCallback)(uint64_t gid, Mac48Address node);
+		typedef void (*CycleDetectedCallback)(uint64_t gid, uint32_t nodes);
+		typedef void (*RetransmissionCallback)(uint64_t gid, uint8_t frameType, uint16_t seqNo, Mac48Address recipient, double txPower);
+		typedef void (*ApplicationDataDeliveredCallback)(uint64_t gid, uint32_t seqNo, Time latency);
+
 		static TypeId GetTypeId();
 		static const uint16_t PROT_NUMBER;
 		static const uint32_t MAX_UNCHANGED_ROUNDS;
@@ -66,11 +85,12 @@ namespace ns3
 		virtual void Send(Ptr<GameState> gs, FRAME_TYPE ft, Mac48Address recipient, uint16_t seqNo, double txPower, Ptr<SendEvent> event);
 		virtual void Send(Ptr<GameState> gs, Mac48Address originator, Mac48Address newParent, Mac48Address oldParent, uint16_t seqNo, double txPower, Ptr<CCSendEvent> event);
 
-		void Receive(Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t pID, const Address &sender, const Address &receiver, NetDevice::PacketType pType);
+		virtual void Receive(Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t pID, const Address &sender, const Address &receiver, NetDevice::PacketType pType);
 
 		virtual void Install(Ptr<WifiNetDevice> netDevice, Ptr<CycleWatchDog> cwd);
 
 		Ptr<GameState> getGameState(uint64_t gid);
+		bool hasGameState(uint64_t gid);
 		virtual void removeGameState(uint64_t gid);
 		virtual Ptr<GameState> initGameState(uint64_t gid);
 
@@ -89,6 +109,17 @@ namespace ns3
 		void sendApplicationData(Ptr<GameState> gs, uint16_t seqNo);
 		void sendApplicationData(Ptr<GameState> gs, Ptr<Packet> packet);
 
+		//Number of application data packets sent by the initiator
+		virtual int getSendCounter();
+
+		void setEventTrace(EEBTPEventTrace *eventTrace);
+
+		//Records the inputs of the protocol for tools/EEBTPCoreReplay.cc, only the protocol core supports it
+		virtual bool startRecording(std::string fileName);
+		virtual bool stopRecording();
+
+		void getMemoryUsage(MemoryUsage &usage);
+
 	protected:
 		double maxAllowedTxPower;
 
@@ -97,10 +128,20 @@ namespace ns3
 
 		int64_t ndInterval;
 
+		//Timings, see the attributes
+		uint32_t maxRetransmissions;
+		uint32_t ackPollFactor;
+		uint32_t ackRetryFactor;
+		uint32_t ndSlots;
+		uint32_t maxUnchangedRounds;
+		double txPowerMargin;
+		Time applicationDataInterval;
+
 		Ptr<WifiPhy> wifiPhy;
 		Ptr<WifiNetDevice> device;
 		Ptr<TrafficControlLayer> tcl;
 		Ptr<CycleWatchDog> cycleWatchDog;
+		EEBTPEventTrace *eventTrace;
 
 		SeqNoCache cache;
 
@@ -133,6 +174,20 @@ namespace ns3
 		virtual void contactNode(Ptr<GameState> gs, Ptr<EEBTPNode> node);
 
 		double calculateTxPower(double rxPower, double txPower, double noise, double minSNR);
+
+		void notifyApplicationData(Ptr<GameState> gs, Ptr<const Packet> packet);
+
+		/*
+		 * Trace sources
+		 */
+		TracedCallback<uint64_t, Mac48Address, Mac48Address> parentChangedTrace;
+		TracedCallback<uint64_t, Mac48Address> childAddedTrace;
+		TracedCallback<uint64_t, Mac48Address> childRemovedTrace;
+		TracedCallback<uint64_t, double> gameFinishedTrace;
+		TracedCallback<uint64_t, Mac48Address> blacklistUpdatedTrace;
+		TracedCallback<uint64_t, uint32_t> cycleDetectedTrace;
+		TracedCallback<uint64_t, uint8_t, uint16_t, Mac48Address, double> retransmissionTrace;
+		TracedCallback<uint64_t, uint32_t, Time> applicationDataDeliveredTrace;
 	};
 }
 
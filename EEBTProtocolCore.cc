@@ -0,0 +1,412 @@
+/*
+ * EEBTProtocolCore.cc
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include "ns3/EEBTPTag.h"
+#include "EEBTPHeader.h"
+#include "CycleWatchDog.h"
+#include "EEBTPDataHeader.h"
+#include "EEBTProtocolCore.h"
+#include "EEBTPProfiler.h"
+#include "EEBTPCausalGraph.h"
+
+#include "ns3/log.h"
+#include "ns3/nstime.h"
+#include "ns3/wifi-mac.h"
+#include "ns3/simulator.h"
+
+namespace ns3
+{
+	NS_LOG_COMPONENT_DEFINE("EEBTProtocolCore");
+	NS_OBJECT_ENSURE_REGISTERED(EEBTProtocolCore);
+
+	EEBTProtocolCore::EEBTProtocolCore() : EEBTProtocol()
+	{
+		this->core = 0;
+	}
+
+	EEBTProtocolCore::~EEBTProtocolCore()
+	{
+		delete this->core;
+		this->core = 0;
+	}
+
+	TypeId EEBTProtocolCore::GetTypeId()
+	{
+		static TypeId tid = TypeId("ns3::EEBTProtocolCore").SetParent<EEBTProtocol>().AddConstructor<EEBTProtocolCore>();
+		return tid;
+	}
+
+	TypeId EEBTProtocolCore::GetInstanceTypeId() const
+	{
+		return GetTypeId();
+	}
+
+	/*
+	 * Install method to install this protocol on the stack of a node
+	 * The core gets the same timings as EEBTProtocol
+	 */
+	void EEBTProtocolCore::Install(Ptr<WifiNetDevice> netDevice, Ptr<CycleWatchDog> cwd)
+	{
+		EEBTProtocol::Install(netDevice, cwd);
+
+		eebtp::Config config;
+		config.maxAllowedTxPower = this->maxAllowedTxPower;
+		config.ackTimeout = this->device->GetMac()->GetAckTimeout().GetNanoSeconds();
+		config.neighborDiscoveryInterval = MicroSeconds(this->ndInterval).GetNanoSeconds();
+		config.applicationDataInterval = this->applicationDataInterval.GetNanoSeconds();
+		config.maxPackets = this->maxPackets;
+		config.dataLength = this->dataLength;
+		config.maxRetransmissions = this->maxRetransmissions;
+		config.ackPollFactor = this->ackPollFactor;
+		config.ackRetryFactor = this->ackRetryFactor;
+		config.maxUnchangedRounds = this->maxUnchangedRounds;
+		config.txPowerMargin = this->txPowerMargin;
+
+		delete this->core;
+		this->core = new eebtp::Core(EEBTProtocolCore::toAddress(this->myAddress), this, config);
+		this->core->setListener(this);
+	}
+
+	/*
+	 * Address conversion, the most significant byte is the first byte of the MAC address
+	 */
+	eebtp::Address EEBTProtocolCore::toAddress(Mac48Address address)
+	{
+		uint8_t buffer[6];
+		address.CopyTo(buffer);
+
+		eebtp::Address a = 0;
+		for (int i = 0; i < 6; i++)
+			a = (a << 8) | buffer[i];
+		return a;
+	}
+
+	Mac48Address EEBTProtocolCore::toMac48Address(eebtp::Address address)
+	{
+		uint8_t buffer[6];
+		for (int i = 5; i >= 0; i--)
+		{
+			buffer[i] = address & 0xff;
+			address >>= 8;
+		}
+
+		Mac48Address a;
+		a.CopyFrom(buffer);
+		return a;
+	}
+
+	/*
+	 * Receive method, translates the frame for the core
+	 */
+	void EEBTProtocolCore::Receive(Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t pID, const Address &sender, const Address &receiver, NetDevice::PacketType pType)
+	{
+		EEBTP_PROFILE_SCOPE("EEBTProtocolCore::Receive");
+		EEBTPHeader header;
+		packet->PeekHeader(header);
+
+		EEBTPTag tag = this->packetManager->getPacketTag(header.GetSequenceNumber());
+
+		if (this->eventTrace != 0)
+			this->eventTrace->record(Now().GetNanoSeconds(), this->device->GetNode()->GetId(), EEBTPEventTrace::FRAME_RECEIVED, header.GetFrameType(), EEBTPEventTrace::getAddress(Mac48Address::ConvertFrom(sender)), header.GetSequenceNumber(), header.GetTxPower(), tag.getSignal());
+		if (EEBTPCausalGraph::isEnabled())
+			EEBTPCausalGraph::onReceive(Now().GetNanoSeconds(), this->device->GetNode()->GetId(), EEBTPEventTrace::getAddress(Mac48Address::ConvertFrom(sender)), header.GetSequenceNumber(), header.GetFrameType());
+
+		eebtp::Frame frame = eebtp::Frame();
+		frame.frameType = header.GetFrameType();
+		frame.seqNo = header.GetSequenceNumber();
+		frame.gameId = header.GetGameId();
+		frame.sender = EEBTProtocolCore::toAddress(Mac48Address::ConvertFrom(sender));
+		frame.recipient = EEBTProtocolCore::toAddress(Mac48Address::ConvertFrom(receiver));
+		frame.parent = EEBTProtocolCore::toAddress(header.GetParent());
+		frame.txPower = header.GetTxPower();
+		frame.highestMaxTxPower = header.GetHighestMaxTxPower();
+		frame.secondHighestMaxTxPower = header.GetSecondHighestMaxTxPower();
+		frame.gameFinished = header.getGameFinishedFlag();
+		frame.receivingProblems = header.hadReceivingProblems();
+
+		if (frame.frameType == CYCLE_CHECK)
+		{
+			frame.originator = EEBTProtocolCore::toAddress(header.GetOriginator());
+			frame.newParent = EEBTProtocolCore::toAddress(header.GetNewParent());
+			frame.oldParent = EEBTProtocolCore::toAddress(header.GetOldParent());
+		}
+
+		Ptr<Packet> data = 0;
+		if (frame.frameType == APPLICATION_DATA)
+		{
+			data = packet->Copy();
+			data->RemoveHeader(header);
+
+			EEBTPDataHeader dataHeader;
+			data->PeekHeader(dataHeader);
+			frame.dataSeqNo = dataHeader.GetSequenceNumber();
+			frame.dataLength = dataHeader.GetDataLength();
+			frame.dataOriginTime = dataHeader.GetOriginTime();
+		}
+
+		eebtp::RxInfo rx;
+		rx.signal = tag.getSignal();
+		rx.noise = tag.getNoise();
+		rx.minSnr = tag.getMinSNR();
+
+		eebtp::Game *game = this->core->getGame(frame.gameId);
+		uint32_t packetCount = game->packetCount;
+
+		if (this->recorder.isOpen())
+			this->recorder.onReceive(this->now(), frame, rx);
+		this->core->receive(frame, rx);
+
+		//The core accepted new application data, store it in the ApplicationDataHandler as well
+		if (data != 0 && game->packetCount != packetCount)
+		{
+			Ptr<GameState> gs = this->getGameState(frame.gameId);
+			if (gs->getApplicationDataHandler()->handleApplicationData(data))
+				this->notifyApplicationData(gs, data);
+		}
+
+		this->sync(game);
+	}
+
+	Ptr<GameState> EEBTProtocolCore::initGameState(uint64_t gid)
+	{
+		Ptr<GameState> gs = EEBTProtocol::initGameState(gid);
+		if (this->recorder.isOpen())
+			this->recorder.onInitGame(this->now(), gid);
+		this->core->initGame(gid);
+		return gs;
+	}
+
+	void EEBTProtocolCore::Send(Ptr<GameState> gs, FRAME_TYPE ft, double txPower)
+	{
+		this->Send(gs, ft, Mac48Address::GetBroadcast(), txPower);
+	}
+
+	void EEBTProtocolCore::Send(Ptr<GameState> gs, FRAME_TYPE ft, Mac48Address recipient, double txPower)
+	{
+		eebtp::Game *game = this->core->getGame(gs->getGameID());
+		if (this->recorder.isOpen())
+			this->recorder.onSend(this->now(), gs->getGameID(), ft, EEBTProtocolCore::toAddress(recipient), txPower);
+		this->core->send(game, ft, EEBTProtocolCore::toAddress(recipient), txPower);
+		this->sync(game);
+	}
+
+	int EEBTProtocolCore::getSendCounter()
+	{
+		return this->core->getSendCounter();
+	}
+
+	bool EEBTProtocolCore::startRecording(std::string fileName)
+	{
+		if (!this->recorder.open(fileName, this->core->getVariant(), this->core->getAddress(), this->core->getConfig()))
+		{
+			NS_LOG_ERROR("[Node " << this->device->GetNode()->GetId() << "]: " << this->recorder.getError());
+			return false;
+		}
+		return true;
+	}
+
+	//Returns false if the record could not be written completely
+	bool EEBTProtocolCore::stopRecording()
+	{
+		NS_LOG_INFO("[Node " << this->device->GetNode()->GetId() << "]: " << this->recorder.getNRecords() << " records");
+		if (!this->recorder.close())
+		{
+			NS_LOG_ERROR("[Node " << this->device->GetNode()->GetId() << "]: " << this->recorder.getError());
+			return false;
+		}
+		return true;
+	}
+
+	/*
+	 * eebtp::Transport
+	 */
+	void EEBTProtocolCore::send(const eebtp::Frame &frame)
+	{
+		EEBTP_PROFILE_SCOPE("EEBTProtocolCore::send");
+		if (this->recorder.isOpen())
+			this->recorder.onSent(this->now(), frame);
+		if (frame.retransmission)
+			this->retransmissionTrace(frame.gameId, frame.frameType, frame.seqNo, EEBTProtocolCore::toMac48Address(frame.recipient), frame.txPower);
+
+		EEBTPHeader header;
+		header.SetFrameType(frame.frameType);
+		header.SetSequenceNumber(frame.seqNo);
+		header.SetGameId(frame.gameId);
+		header.SetTxPower(frame.txPower);
+		header.SetParent(EEBTProtocolCore::toMac48Address(frame.parent));
+		header.SetHighestMaxTxPower(frame.highestMaxTxPower);
+		header.SetSecondHighestMaxTxPower(frame.secondHighestMaxTxPower);
+		header.setGameFinishedFlag(frame.gameFinished);
+		header.setReceivingProblems(frame.receivingProblems);
+
+		if (frame.frameType == CYCLE_CHECK)
+		{
+			header.SetOriginator(EEBTProtocolCore::toMac48Address(frame.originator));
+			header.SetNewParent(EEBTProtocolCore::toMac48Address(frame.newParent));
+			header.SetOldParent(EEBTProtocolCore::toMac48Address(frame.oldParent));
+		}
+
+		//Packet size must be greater than 0, see EEBTProtocol::Send()
+		Ptr<Packet> packet;
+		if (frame.frameType == APPLICATION_DATA)
+		{
+			EEBTPDataHeader dataHeader;
+			dataHeader.SetSequenceNumber(frame.dataSeqNo);
+			dataHeader.SetDataLength(frame.dataLength);
+			dataHeader.SetOriginTime(frame.dataOriginTime);
+
+			packet = Create<Packet>(EEBTPDataHeader::GetPayloadSize(frame.dataLength));
+			packet->AddHeader(dataHeader);
+		}
+		else
+			packet = Create<Packet>(1);
+		packet->AddHeader(header);
+
+		EEBTPTag tag;
+		tag.setGameID(frame.gameId);
+		tag.setFrameType(frame.frameType);
+		tag.setSequenceNumber(frame.seqNo);
+		tag.setTxPower(frame.txPower);
+		packet->AddPacketTag(tag);
+
+		this->packetManager->sendPacket(packet, EEBTProtocolCore::toMac48Address(frame.recipient));
+	}
+
+	void EEBTProtocolCore::schedule(int64_t delay, eebtp::Transport::Callback callback)
+	{
+		EEBTP_PROFILE_COUNT("schedule EEBTProtocolCore::fire");
+		Simulator::Schedule(NanoSeconds(delay), &EEBTProtocolCore::fire, this, callback, EEBTPCausalGraph::getCurrent());
+	}
+
+	int64_t EEBTProtocolCore::now()
+	{
+		return Simulator::Now().GetNanoSeconds();
+	}
+
+	eebtp::TxStatus EEBTProtocolCore::getTxStatus(uint16_t seqNo)
+	{
+		eebtp::TxStatus status = eebtp::TX_PENDING;
+		if (this->packetManager->isPacketAcked(seqNo))
+			status = eebtp::TX_ACKED;
+		else if (this->packetManager->isPacketLost(seqNo))
+			status = eebtp::TX_LOST;
+
+		if (this->recorder.isOpen())
+			this->recorder.onTxStatus(this->now(), seqNo, status);
+		return status;
+	}
+
+	void EEBTProtocolCore::releaseTxStatus(uint16_t seqNo)
+	{
+		this->packetManager->deleteSeqNoEntry(seqNo);
+	}
+
+	/*
+	 * eebtp::Listener, the GameState records the change and fires BlacklistUpdated
+	 */
+	void EEBTProtocolCore::blacklistUpdated(uint64_t gid, eebtp::Address node, eebtp::Address parent)
+	{
+		this->getGameState(gid)->updateBlacklist(EEBTProtocolCore::toMac48Address(node), EEBTProtocolCore::toMac48Address(parent));
+	}
+
+	void EEBTProtocolCore::blacklistReset(uint64_t gid)
+	{
+		this->getGameState(gid)->resetBlacklist();
+	}
+
+	//The cause is the action that was current when the timer was scheduled
+	void EEBTProtocolCore::fire(eebtp::Transport::Callback callback, uint32_t cause)
+	{
+		if (EEBTPCausalGraph::isEnabled())
+			EEBTPCausalGraph::onTimerFired(Now().GetNanoSeconds(), this->device->GetNode()->GetId(), cause);
+		if (this->recorder.isOpen())
+			this->recorder.onTimer(this->now());
+		callback();
+		this->sync();
+	}
+
+	/*
+	 * Mirrors the state of the core into the GameStates
+	 */
+	void EEBTProtocolCore::sync()
+	{
+		for (uint32_t i = 0; i < this->core->getNGames(); i++)
+			this->sync(this->core->getGameByIndex(i));
+	}
+
+	void EEBTProtocolCore::sync(eebtp::Game *game)
+	{
+		Ptr<GameState> gs = this->getGameState(game->gameId);
+
+		//Neighbors
+		for (uint32_t i = 0; i < game->getNNeighbors(); i++)
+		{
+			eebtp::Neighbor *neighbor = game->getNeighbor(i);
+			Mac48Address address = EEBTProtocolCore::toMac48Address(neighbor->address);
+			if (!gs->isNeighbor(address))
+				gs->addNeighbor(address);
+
+			Ptr<EEBTPNode> node = gs->getNeighbor(address);
+			node->setParentAddress(EEBTProtocolCore::toMac48Address(neighbor->parent));
+			node->setReachPower(neighbor->reachPower);
+			node->updateRxInfo(neighbor->rxPower, neighbor->noise);
+			node->setHighestMaxTxPower(neighbor->highestMaxTxPower);
+			node->setSecondHighestMaxTxPower(neighbor->secondMaxTxPower);
+			node->setFinished(neighbor->finished);
+			node->hasReachPowerProblem(neighbor->reachPowerProblem);
+		}
+
+		//Children
+		for (int i = gs->getNChilds() - 1; i >= 0; i--)
+		{
+			Ptr<EEBTPNode> child = gs->getChild(i);
+			if (!game->isChild(EEBTProtocolCore::toAddress(child->getAddress())))
+				gs->removeChild(child);
+		}
+		for (uint32_t i = 0; i < game->getNChilds(); i++)
+		{
+			Mac48Address address = EEBTProtocolCore::toMac48Address(game->getChild(i)->address);
+			if (!gs->isChild(address))
+				gs->addChild(gs->getNeighbor(address));
+		}
+
+		//Parent, a new parent is checked for cycles like in EEBTProtocol::handleChildConfirmation()
+		Ptr<EEBTPNode> parent = 0;
+		if (game->parent != 0)
+			parent = gs->getNeighbor(EEBTProtocolCore::toMac48Address(game->parent->address));
+
+		Ptr<EEBTPNode> contactedParent = 0;
+		if (game->contactedParent != 0)
+			contactedParent = gs->getNeighbor(EEBTProtocolCore::toMac48Address(game->contactedParent->address));
+
+		if (parent != gs->getParent())
+		{
+			if (gs->getParent() != 0)
+				this->endLastCycle(gs);
+
+			gs->setParent(parent);
+			if (parent != 0)
+				this->cycleWatchDog->checkForCycles(gs->getGameID(), this->device);
+		}
+		gs->setContactedParent(contactedParent);
+		gs->findHighestTxPowers();
+
+		if (game->finished && !gs->gameFinished())
+			gs->finishGame();
+	}
+
+	//Sets the end time of our last cycle when we leave our parent
+	void EEBTProtocolCore::endLastCycle(Ptr<GameState> gs)
+	{
+		std::vector<Ptr<CycleInfo>> cycles = this->cycleWatchDog->getCycles(gs->getGameID(), this->device->GetNode()->GetId());
+		if (cycles.size() > 0)
+		{
+			Ptr<CycleInfo> ci = *(cycles.end() - 1);
+			if (ci->getEndTime().GetNanoSeconds() == 0)
+				ci->setEndTime(Now());
+		}
+	}
+}
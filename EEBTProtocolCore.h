@@ -0,0 +1,84 @@
+/*
+ * EEBTProtocolCore.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#ifndef BROADCAST_EEBTPROTOCOLCORE_H_
+#define BROADCAST_EEBTPROTOCOLCORE_H_
+
+#include "ns3/wifi-net-device.h"
+
+#include "EEBTPCore.h"
+#include "EEBTPCoreRecord.h"
+#include "GameState.h"
+#include "EEBTProtocol.h"
+
+namespace ns3
+{
+	/*
+	 * EEBTP (CYCLE_TEST_ASYNC) running on the ns-3 free protocol core.
+	 *
+	 * The adapter only translates between the core and ns-3:
+	 * 	- Frames are sent and received as EEBTPHeader/EEBTPDataHeader via the
+	 * 		EEBTPPacketManager, like in EEBTProtocol
+	 * 	- Timers of the core are ns-3 events, the ack state comes from the
+	 * 		packet manager
+	 * 	- After every event the state of the core is mirrored into the
+	 * 		GameState, so the statistics and the CycleWatchDog work unchanged
+	 * 	- Blacklist changes are passed on by the core (eebtp::Listener) and
+	 * 		fire BlacklistUpdated
+	 */
+	class EEBTProtocolCore : public EEBTProtocol, public eebtp::Transport, public eebtp::Listener
+	{
+	public:
+		EEBTProtocolCore();
+		virtual ~EEBTProtocolCore();
+
+		static TypeId GetTypeId();
+		virtual TypeId GetInstanceTypeId() const;
+
+		virtual void Install(Ptr<WifiNetDevice> netDevice, Ptr<CycleWatchDog> cwd);
+		virtual void Receive(Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t pID, const Address &sender, const Address &receiver, NetDevice::PacketType pType);
+
+		virtual Ptr<GameState> initGameState(uint64_t gid);
+
+		using EEBTProtocol::Send;
+		virtual void Send(Ptr<GameState> gs, FRAME_TYPE ft, double txPower);
+		virtual void Send(Ptr<GameState> gs, FRAME_TYPE ft, Mac48Address recipient, double txPower);
+
+		virtual int getSendCounter();
+
+		virtual bool startRecording(std::string fileName);
+		virtual bool stopRecording();
+
+		/*
+		 * eebtp::Transport
+		 */
+		virtual void send(const eebtp::Frame &frame);
+		virtual void schedule(int64_t delay, eebtp::Transport::Callback callback);
+		virtual int64_t now();
+		virtual eebtp::TxStatus getTxStatus(uint16_t seqNo);
+		virtual void releaseTxStatus(uint16_t seqNo);
+
+		/*
+		 * eebtp::Listener
+		 */
+		virtual void blacklistUpdated(uint64_t gid, eebtp::Address node, eebtp::Address parent);
+		virtual void blacklistReset(uint64_t gid);
+
+		static eebtp::Address toAddress(Mac48Address address);
+		static Mac48Address toMac48Address(eebtp::Address address);
+
+	private:
+		eebtp::Core *core;
+		eebtp::Recorder recorder;
+
+		void fire(eebtp::Transport::Callback callback, uint32_t cause);
+		void sync();
+		void sync(eebtp::Game *game);
+		void endLastCycle(Ptr<GameState> gs);
+	};
+}
+
+#endif /* BROADCAST_EEBTPROTOCOLCORE_H_ */
@@ -1,5 +1,5 @@
 /*
- * SimpleBroadcastProtocolHelper.cc
+ * EEBTProtocolHelper.cc
  *
  *  Created on: 07.05.2020
  *      Author: krassus
@@ -7,6 +7,7 @@
 
 #include "EEBTProtocol.h"
 #include "EEBTProtocol_Mutex.h"
+#include "EEBTProtocolCore.h"
 #include "EEBTProtocolHelper.h"
 #include "EEBTProtocol_SrcPath.h"
 
@@ -35,6 +36,9 @@ namespace ns3
 		case PATH_TO_SRC:
 			factory.SetTypeId("ns3::EEBTProtocolSrcPath");
 			break;
+		case CYCLE_TEST_ASYNC_CORE:
+			factory.SetTypeId("ns3::EEBTProtocolCore");
+			break;
 		case CYCLE_TEST_ASYNC:
 		default:
 			factory.SetTypeId("ns3::EEBTPProtocol");
@@ -1,5 +1,5 @@
 /*
- * SimpleBroadcastProtocolHelper.h
+ * EEBTProtocolHelper.h
  *
  *  Created on: 07.05.2020
  *      Author: krassus
@@ -21,7 +21,8 @@ namespace ns3
 	{
 		CYCLE_TEST_ASYNC,
 		MUTEX,
-		PATH_TO_SRC
+		PATH_TO_SRC,
+		CYCLE_TEST_ASYNC_CORE
 	} CYCLE_PREV_METHOD;
 
 	class EEBTProtocolHelper
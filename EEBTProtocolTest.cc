@@ -0,0 +1,159 @@
+/*
+ * EEBTProtocolTest.cc
+ *
+ *  Created on: 19.10.2026
+ *
+ *  Test suite "eebtp-protocol", run with 'brdcstTest --test'
+ *  	- Every cycle prevention method of the helper installs an EEBTProtocol
+ *  	- A small game on it connects all nodes to the tree
+ *  	- The energy of the received frames is attributed (EEBTPEnergyAttribution)
+ */
+
+#include "ns3/test.h"
+#include "ns3/double.h"
+#include "ns3/simulator.h"
+#include "ns3/energy-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/yans-wifi-helper.h"
+#include "ns3/fifo-queue-disc.h"
+#include "ns3/traffic-control-layer.h"
+#include "ns3/wifi-radio-energy-model-helper.h"
+
+#include "GameState.h"
+#include "CycleWatchDog.h"
+#include "EEBTProtocol.h"
+#include "EEBTProtocolHelper.h"
+#include "EEBTPPacketManager.h"
+
+namespace ns3
+{
+	//Starts the game like the initiator in brdcstTest
+	static void StartGame(Ptr<EEBTProtocol> proto, uint64_t gid)
+	{
+		Ptr<GameState> gs = proto->initGameState(gid);
+		proto->Send(gs, NEIGHBOR_DISCOVERY, 20.0);
+	}
+
+	class EEBTProtocolInstallTestCase : public TestCase
+	{
+	public:
+		EEBTProtocolInstallTestCase(CYCLE_PREV_METHOD cpm, std::string name, std::string typeName);
+		virtual ~EEBTProtocolInstallTestCase();
+
+	private:
+		virtual void DoRun();
+
+		CYCLE_PREV_METHOD cpm;
+		std::string typeName;
+	};
+
+	EEBTProtocolInstallTestCase::EEBTProtocolInstallTestCase(CYCLE_PREV_METHOD cpm, std::string name, std::string typeName) : TestCase("Install " + name)
+	{
+		this->cpm = cpm;
+		this->typeName = typeName;
+	}
+
+	EEBTProtocolInstallTestCase::~EEBTProtocolInstallTestCase()
+	{
+	}
+
+	void EEBTProtocolInstallTestCase::DoRun()
+	{
+		const uint32_t nNodes = 4;
+		const uint64_t gid = 1;
+
+		//Nodes in a line, 10 m apart
+		NodeContainer nodes;
+		nodes.Create(nNodes);
+
+		MobilityHelper mobility;
+		Ptr<ListPositionAllocator> positions = CreateObject<ListPositionAllocator>();
+		for (uint32_t i = 0; i < nNodes; i++)
+			positions->Add(Vector(10.0 * i, 0, 0));
+		mobility.SetPositionAllocator(positions);
+		mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+		mobility.Install(nodes);
+
+		//Same PHY and MAC as brdcstTest
+		YansWifiChannelHelper channel = YansWifiChannelHelper::Default();
+		YansWifiPhyHelper phy = YansWifiPhyHelper::Default();
+		phy.SetChannel(channel.Create());
+
+		WifiHelper wifi;
+		wifi.SetRemoteStationManager("ns3::ConstantRateWifiManager");
+		wifi.SetStandard(WIFI_PHY_STANDARD_80211a);
+
+		WifiMacHelper mac;
+		mac.SetType("ns3::AdhocWifiMac");
+		NetDeviceContainer devices = wifi.Install(phy, mac, nodes);
+
+		for (NetDeviceContainer::Iterator i = devices.Begin(); i != devices.End(); i++)
+		{
+			Ptr<TrafficControlLayer> tcl = Create<TrafficControlLayer>();
+			tcl->SetRootQueueDiscOnDevice((*i), Create<FifoQueueDisc>());
+			(*i)->GetNode()->AggregateObject(tcl);
+		}
+
+		//The packet manager attributes the energy of the frames
+		BasicEnergySourceHelper energySource;
+		EnergySourceContainer sources = energySource.Install(nodes);
+		WifiRadioEnergyModelHelper radioEnergyModel;
+		radioEnergyModel.Install(devices, sources);
+
+		Ptr<CycleWatchDog> cwd = Create<CycleWatchDog>();
+		cwd->setNetDeviceContainer(devices);
+
+		EEBTProtocolHelper helper;
+		helper.setCycleWatchDogCallback(cwd);
+		helper.setCyclePreventionMethod(this->cpm);
+		helper.Install(devices);
+
+		for (uint32_t i = 0; i < nNodes; i++)
+		{
+			Ptr<EEBTProtocol> proto = devices.Get(i)->GetObject<EEBTProtocol>();
+			NS_TEST_ASSERT_MSG_EQ((proto != 0), true, "No EEBTProtocol on node " << i);
+			NS_TEST_ASSERT_MSG_EQ(proto->GetInstanceTypeId().GetName(), this->typeName, "Wrong protocol on node " << i);
+		}
+
+		//Node 0 starts a game
+		Simulator::Schedule(Seconds(1), &StartGame, devices.Get(0)->GetObject<EEBTProtocol>(), gid);
+		Simulator::Stop(Seconds(30));
+		Simulator::Run();
+
+		for (uint32_t i = 1; i < nNodes; i++)
+		{
+			Ptr<EEBTProtocol> proto = devices.Get(i)->GetObject<EEBTProtocol>();
+			NS_TEST_EXPECT_MSG_EQ(proto->getGameState(gid)->getParent() != 0, true, "Node " << i << " has no parent");
+
+			//The received frames occupied the radio in RX, so they have energy
+			Ptr<EEBTPPacketManager> pm = proto->getPacketManager();
+			uint32_t framesRecv = 0;
+			double energyRecv = 0.0;
+			for (uint8_t ft = 0; ft < 8; ft++)
+			{
+				framesRecv += pm->getFrameTypeRecv(gid, ft);
+				energyRecv += pm->getEnergyByRecvFrame(gid, ft);
+			}
+			NS_TEST_EXPECT_MSG_GT(framesRecv, 0, "Node " << i << " received no frames");
+			NS_TEST_EXPECT_MSG_GT(energyRecv, 0.0, "No RX energy attributed to the frames of node " << i);
+		}
+
+		Simulator::Destroy();
+	}
+
+	class EEBTProtocolTestSuite : public TestSuite
+	{
+	public:
+		EEBTProtocolTestSuite();
+	};
+
+	EEBTProtocolTestSuite::EEBTProtocolTestSuite() : TestSuite("eebtp-protocol", UNIT)
+	{
+		AddTestCase(new EEBTProtocolInstallTestCase(CYCLE_TEST_ASYNC, "CYCLE_TEST_ASYNC", "ns3::EEBTPProtocol"), TestCase::QUICK);
+		AddTestCase(new EEBTProtocolInstallTestCase(MUTEX, "MUTEX", "ns3::EEBTProtocolMutex"), TestCase::QUICK);
+		AddTestCase(new EEBTProtocolInstallTestCase(PATH_TO_SRC, "PATH_TO_SRC", "ns3::EEBTProtocolSrcPath"), TestCase::QUICK);
+		AddTestCase(new EEBTProtocolInstallTestCase(CYCLE_TEST_ASYNC_CORE, "CORE", "ns3::EEBTProtocolCore"), TestCase::QUICK);
+	}
+
+	static EEBTProtocolTestSuite eebtpProtocolTestSuite;
+}
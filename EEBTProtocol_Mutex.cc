@@ -1,5 +1,5 @@
 /*
- * SimpleBroadcastProtocol.cc
+ * EEBTProtocol_Mutex.cc
  *
  *  Created on: 02.06.2020
  *      Author: krassus
@@ -13,6 +13,8 @@
 #include "Mutex_SendEvent.h"
 #include "EEBTProtocol_Mutex.h"
 #include "EEBTPQueueDiscItem.h"
+#include "EEBTPProfiler.h"
+#include "EEBTPCausalGraph.h"
 
 #include "float.h"
 #include "ns3/nstime.h"
@@ -100,7 +102,7 @@ namespace ns3
 		this->device->GetMac()->GetWifiRemoteStationManager()->TraceConnectWithoutContext("MacTxFinalRtsFailed", MakeCallback(&EEBTPPacketManager::onTxFinalRtsFailed, this->packetManager));
 		this->device->GetMac()->GetWifiRemoteStationManager()->TraceConnectWithoutContext("MacTxFinalDataFailed", MakeCallback(&EEBTPPacketManager::onTxFinalDataFailed, this->packetManager));
 
-		this->ndInterval = this->device->GetMac()->GetSlot().GetMicroSeconds() * 2000;
+		this->ndInterval = this->device->GetMac()->GetSlot().GetMicroSeconds() * this->ndSlots;
 
 		TrafficControlHelper tch = TrafficControlHelper();
 		tch.Install(this->device);
@@ -114,6 +116,7 @@ namespace ns3
 
 	void EEBTProtocolMutex::Receive(Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t pID, const Address &sender, const Address &receiver, NetDevice::PacketType pType)
 	{
+		EEBTP_PROFILE_SCOPE("EEBTProtocolMutex::Receive");
 		EEBTPTag tag;
 		EEBTPHeader header;
 		Ptr<WifiNetDevice> dev = DynamicCast<WifiNetDevice>(device);
@@ -126,6 +129,11 @@ namespace ns3
 		//Get packet tag
 		tag = this->packetManager->getPacketTag(header.GetSequenceNumber());
 
+		if (this->eventTrace != 0)
+			this->eventTrace->record(Now().GetNanoSeconds(), this->device->GetNode()->GetId(), EEBTPEventTrace::FRAME_RECEIVED, header.GetFrameType(), EEBTPEventTrace::getAddress(sender_addr), header.GetSequenceNumber(), header.GetTxPower(), tag.getSignal());
+		if (EEBTPCausalGraph::isEnabled())
+			EEBTPCausalGraph::onReceive(Now().GetNanoSeconds(), this->device->GetNode()->GetId(), EEBTPEventTrace::getAddress(sender_addr), header.GetSequenceNumber(), header.GetFrameType());
+
 		NS_LOG_DEBUG("[Node " << dev->GetNode()->GetId() << " / " << Now() << "]: [" << this->myAddress << "] received packet from " << sender_addr << " / SeqNo: " << header.GetSequenceNumber() << " / FRAME_TYPE: " << (int)header.GetFrameType() << " / txPower: " << header.GetTxPower() << "dBm / noise: " << tag.getNoise() << "dBm");
 		NS_LOG_DEBUG("\thTx: " << header.GetHighestMaxTxPower() << ", shTx: " << header.GetSecondHighestMaxTxPower());
 
@@ -306,11 +314,11 @@ namespace ns3
 			this->packetManager->deleteSeqNoEntry(seqNo);
 			return;
 		}
-		else if (this->packetManager->isPacketLost(seqNo) || event->getNTimes() > 20)
+		else if (this->packetManager->isPacketLost(seqNo) || event->getNTimes() > this->maxRetransmissions)
 		{
 			if (gs->isChild(receiver) || (gs->getParent() != 0 && receiver->getAddress() == gs->getParent()->getAddress()))
 			{
-				if (event->getNTimes() > 20)
+				if (event->getNTimes() > this->maxRetransmissions)
 					NS_LOG_DEBUG("[Node " << this->device->GetNode()->GetId() << "]: Packet with seqNo " << seqNo << " has not been acked yet. Retransmitting..., time = " << Now());
 				else
 					NS_LOG_DEBUG("[Node " << this->device->GetNode()->GetId() << "]: Packet with seqNo " << seqNo << " has been lost. Retransmitting..., time = " << Now());
@@ -331,7 +339,9 @@ namespace ns3
 		}
 		else
 		{
-			Time ttw = this->device->GetMac()->GetAckTimeout() * 200;
+			Time ttw = this->device->GetMac()->GetAckTimeout() * this->ackRetryFactor;
+			EEBTP_PROFILE_COUNT("schedule MutexSendEvent");
+			EEBTPCausalGraph::onTimerSet(PeekPointer(event));
 			Simulator::Schedule(ttw, event);
 			NS_LOG_DEBUG("[Node " << this->device->GetNode()->GetId() << "]: Rescheduled MutexSendEvent(" << seqNo << ") for " << (Now() + ttw) << ", now = " << Now());
 		}
@@ -339,6 +349,7 @@ namespace ns3
 
 	void EEBTProtocolMutex::Send(Ptr<GameState> gs, EEBTPHeader header, Mac48Address recipient, double txPower, bool isRetransmission)
 	{
+		EEBTP_PROFILE_SCOPE("EEBTProtocolMutex::Send");
 		//If we send out a child confirmation...
 		if (header.GetFrameType() == CHILD_CONFIRMATION && gs->isLocked())
 		{
@@ -359,6 +370,8 @@ namespace ns3
 		//Set sequence number
 		if (!isRetransmission)
 			this->cache.injectSeqNo(&header);
+		else
+			this->retransmissionTrace(gs->getGameID(), header.GetFrameType(), header.GetSequenceNumber(), recipient, txPower);
 
 		if (header.GetFrameType() == NEIGHBOR_DISCOVERY) //Check the neighbor discovery event handler (SendEvent)
 		{
@@ -368,15 +381,21 @@ namespace ns3
 
 		if (header.GetFrameType() == CYCLE_CHECK)
 		{
-			Time ttw = this->device->GetMac()->GetAckTimeout() * 100;
-			Simulator::Schedule(ttw, Create<MutexSendEvent>(gs, this, gs->getNeighbor(recipient), header.GetOriginator(), header.GetNewParent(), header.GetOldParent(), txPower, header.GetSequenceNumber()));
+			Time ttw = this->device->GetMac()->GetAckTimeout() * this->ackPollFactor;
+			EEBTP_PROFILE_COUNT("schedule MutexSendEvent");
+			Ptr<MutexSendEvent> event = Create<MutexSendEvent>(gs, this, gs->getNeighbor(recipient), header.GetOriginator(), header.GetNewParent(), header.GetOldParent(), txPower, header.GetSequenceNumber());
+			EEBTPCausalGraph::onTimerSet(PeekPointer(event));
+			Simulator::Schedule(ttw, event);
 			NS_LOG_DEBUG("[Node " << this->device->GetNode()->GetId() << "]: Scheduled MutexSendEvent(" << header.GetSequenceNumber() << ") for " << (Now() + ttw));
 		}
 		else if (header.GetFrameType() == CHILD_REQUEST || header.GetFrameType() == CHILD_CONFIRMATION || header.GetFrameType() == CHILD_REJECTION ||
 				 header.GetFrameType() == PARENT_REVOCATION || header.GetFrameType() == END_OF_GAME)
 		{
-			Time ttw = this->device->GetMac()->GetAckTimeout() * 100;
-			EventId id = Simulator::Schedule(ttw, Create<SendEvent>(gs, this, (FRAME_TYPE)header.GetFrameType(), recipient, txPower, header.GetSequenceNumber()));
+			Time ttw = this->device->GetMac()->GetAckTimeout() * this->ackPollFactor;
+			EEBTP_PROFILE_COUNT("schedule SendEvent");
+			Ptr<SendEvent> event = Create<SendEvent>(gs, this, (FRAME_TYPE)header.GetFrameType(), recipient, txPower, header.GetSequenceNumber());
+			EEBTPCausalGraph::onTimerSet(PeekPointer(event));
+			EventId id = Simulator::Schedule(ttw, event);
 			NS_LOG_DEBUG("[Node " << this->device->GetNode()->GetId() << "]: Scheduled SendEvent(" << (uint)header.GetFrameType() << ") for " << (Now() + ttw) << ". EventID = " << id.GetUid());
 		}
 
@@ -421,6 +440,7 @@ namespace ns3
 	 */
 	void EEBTProtocolMutex::handleCycleCheck(Ptr<GameState> gs, Ptr<EEBTPNode> node, Ptr<EEBTPNode> originator, Ptr<EEBTPNode> newOriginator, Ptr<EEBTPNode> childLockFinishedOrg)
 	{
+		EEBTP_PROFILE_SCOPE("EEBTProtocolMutex::handleCycleCheck");
 		NS_ASSERT_MSG(originator != 0, "[Node " << this->device->GetNode()->GetId() << "]: originator is null");
 
 		//!Assertion
@@ -540,6 +560,7 @@ namespace ns3
 	 */
 	void EEBTProtocolMutex::handleNeighborDiscovery(Ptr<GameState> gs, Ptr<EEBTPNode> node)
 	{
+		EEBTP_PROFILE_SCOPE("EEBTProtocolMutex::handleNeighborDiscovery");
 		NS_LOG_DEBUG("[Node " << this->device->GetNode()->GetId() << "]: EEBTProtocolMutex::handleNeighborDiscovery()");
 		if (!gs->isLocked())
 		{
@@ -564,6 +585,7 @@ namespace ns3
 	 */
 	void EEBTProtocolMutex::handleChildRequest(Ptr<GameState> gs, Ptr<EEBTPNode> node)
 	{
+		EEBTP_PROFILE_SCOPE("EEBTProtocolMutex::handleChildRequest");
 		if (gs->checkLastFrameType(node->getAddress(), CHILD_REQUEST, gs->getLastSeqNo(node->getAddress(), PARENT_REVOCATION)))
 		{
 			NS_LOG_DEBUG("[Node " << this->device->GetNode()->GetId() << "]: Child request from [" << node->getAddress() << "] dismissed because we received a PARENT_REVOCATION with a higher sequence number earlier.");
@@ -623,6 +645,7 @@ namespace ns3
 	 */
 	void EEBTProtocolMutex::handleChildConfirmation(Ptr<GameState> gs, Ptr<EEBTPNode> node)
 	{
+		EEBTP_PROFILE_SCOPE("EEBTProtocolMutex::handleChildConfirmation");
 		if (gs->checkLastFrameType(node->getAddress(), CHILD_CONFIRMATION, gs->getLastSeqNo(node->getAddress(), CHILD_REJECTION)))
 		{
 			NS_LOG_DEBUG("[Node " << this->device->GetNode()->GetId() << "]: Child confirmation from [" << node->getAddress() << "] dismissed because we received a CHILD_REJECTION with a higher sequence number earlier.");
@@ -676,7 +699,7 @@ namespace ns3
 			gs->incrementUnchangedCounter();
 		}
 
-		if (gs->getUnchangedCounter() < EEBTProtocol::MAX_UNCHANGED_ROUNDS)
+		if (gs->getUnchangedCounter() < this->maxUnchangedRounds)
 		{
 			//Check if we note a possible better parent in the past
 			if (!gs->isNewParentWaitingForLock())
@@ -711,7 +734,7 @@ namespace ns3
 				this->unlockChildNodes(gs);
 
 				//Reset the unchanged counter, since our topology changed
-				if (!gs->doIncrAfterConfirm() && gs->getUnchangedCounter() < EEBTProtocol::MAX_UNCHANGED_ROUNDS)
+				if (!gs->doIncrAfterConfirm() && gs->getUnchangedCounter() < this->maxUnchangedRounds)
 				{
 					NS_LOG_DEBUG("[Node " << this->device->GetNode()->GetId() << "]: Resetting unchanged counter");
 					gs->resetUnchangedCounter();
@@ -742,6 +765,7 @@ namespace ns3
 	 */
 	void EEBTProtocolMutex::handleChildRejection(Ptr<GameState> gs, Ptr<EEBTPNode> node)
 	{
+		EEBTP_PROFILE_SCOPE("EEBTProtocolMutex::handleChildRejection");
 		if (gs->checkLastFrameType(node->getAddress(), CHILD_REJECTION, gs->getLastSeqNo(node->getAddress(), CHILD_CONFIRMATION)))
 		{
 			NS_LOG_DEBUG("[Node " << this->device->GetNode()->GetId() << "]: Child rejection from [" << node->getAddress() << "] dismissed because we received a CHILD_CONFIRMATION with a higher sequence number earlier.");
@@ -878,6 +902,7 @@ namespace ns3
 	 */
 	void EEBTProtocolMutex::handleParentRevocation(Ptr<GameState> gs, Ptr<EEBTPNode> node)
 	{
+		EEBTP_PROFILE_SCOPE("EEBTProtocolMutex::handleParentRevocation");
 		//NS_LOG_DEBUG(this->device->GetNode()->GetId() << " => EEBTProtocolMutex::handleParentRevocation()");
 
 		if (gs->checkLastFrameType(node->getAddress(), PARENT_REVOCATION, gs->getLastSeqNo(node->getAddress(), CHILD_REQUEST)))
@@ -1,5 +1,5 @@
 /*
- * SimpleBroadcastProtocol.cc
+ * EEBTProtocol_SrcPath.cc
  *
  *  Created on: 02.06.2020
  *      Author: krassus
@@ -11,6 +11,8 @@
 #include "SeqNoCache.h"
 #include "SendEvent.h"
 #include "EEBTPQueueDiscItem.h"
+#include "EEBTPProfiler.h"
+#include "EEBTPCausalGraph.h"
 #include "EEBTPHeader_SrcPath.h"
 #include "ParentPathCheckEvent.h"
 #include "EEBTProtocol_SrcPath.h"
@@ -45,7 +47,7 @@ namespace ns3
 
 	TypeId EEBTProtocolSrcPath::GetTypeId()
 	{
-		static TypeId tid = TypeId("ns3::EEBTProtocolSrcPath").SetParent<Object>().AddConstructor<EEBTProtocolSrcPath>();
+		static TypeId tid = TypeId("ns3::EEBTProtocolSrcPath").SetParent<EEBTProtocol>().AddConstructor<EEBTProtocolSrcPath>();
 		return tid;
 	}
 
@@ -101,8 +103,8 @@ namespace ns3
 		this->device->GetMac()->TraceConnectWithoutContext("MacTx", MakeCallback(&EEBTPPacketManager::onTx, this->packetManager));
 		this->device->GetMac()->TraceConnectWithoutContext("TxErrHeader", MakeCallback(&EEBTPPacketManager::onTxFailed, this->packetManager));
 
-		this->ndInterval = this->device->GetMac()->GetSlot().GetMicroSeconds() * 2000;
-		this->timeToWait = this->device->GetMac()->GetAckTimeout().GetMicroSeconds() * 100 * 1.5;
+		this->ndInterval = this->device->GetMac()->GetSlot().GetMicroSeconds() * this->ndSlots;
+		this->timeToWait = this->device->GetMac()->GetAckTimeout().GetMicroSeconds() * this->ackPollFactor * 1.5;
 
 		TrafficControlHelper tch = TrafficControlHelper();
 		tch.Install(this->device);
@@ -119,6 +121,7 @@ namespace ns3
 	 */
 	void EEBTProtocolSrcPath::Receive(Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t pID, const Address &sender, const Address &receiver, NetDevice::PacketType pType)
 	{
+		EEBTP_PROFILE_SCOPE("EEBTProtocolSrcPath::Receive");
 		EEBTPTag tag;
 		EEBTPHeaderSrcPath header;
 		Ptr<WifiNetDevice> dev = DynamicCast<WifiNetDevice>(device);
@@ -130,6 +133,11 @@ namespace ns3
 		//Get packet tag
 		tag = this->packetManager->getPacketTag(header.GetSequenceNumber());
 
+		if (this->eventTrace != 0)
+			this->eventTrace->record(Now().GetNanoSeconds(), this->device->GetNode()->GetId(), EEBTPEventTrace::FRAME_RECEIVED, header.GetFrameType(), EEBTPEventTrace::getAddress(sender_addr), header.GetSequenceNumber(), header.GetTxPower(), tag.getSignal());
+		if (EEBTPCausalGraph::isEnabled())
+			EEBTPCausalGraph::onReceive(Now().GetNanoSeconds(), this->device->GetNode()->GetId(), EEBTPEventTrace::getAddress(sender_addr), header.GetSequenceNumber(), header.GetFrameType());
+
 		NS_LOG_DEBUG("[Node " << dev->GetNode()->GetId() << " / " << Now() << "]: [" << this->myAddress << "] received packet from " << sender_addr << " / SeqNo: " << header.GetSequenceNumber() << " / FRAME_TYPE: " << (int)header.GetFrameType() << " / txPower: " << header.GetTxPower() << "dBm / noise: " << tag.getNoise() << "dBm");
 		NS_LOG_DEBUG("[Node " << dev->GetNode()->GetId() << "]: hTx: " << header.GetHighestMaxTxPower() << ", shTx: " << header.GetSecondHighestMaxTxPower());
 
@@ -313,9 +321,9 @@ namespace ns3
 				this->packetManager->deleteSeqNoEntry(seqNo);
 				return;
 			}
-			else if (this->packetManager->isPacketLost(seqNo) || event->getNTimes() > 20)
+			else if (this->packetManager->isPacketLost(seqNo) || event->getNTimes() > this->maxRetransmissions)
 			{
-				if (event->getNTimes() > 20)
+				if (event->getNTimes() > this->maxRetransmissions)
 				{
 					if (ft == CHILD_REQUEST && txPower >= this->maxAllowedTxPower)
 					{
@@ -336,7 +344,9 @@ namespace ns3
 			}
 			else
 			{
-				Time ttw = this->device->GetMac()->GetAckTimeout() * 200;
+				Time ttw = this->device->GetMac()->GetAckTimeout() * this->ackRetryFactor;
+				EEBTP_PROFILE_COUNT("schedule SendEvent");
+				EEBTPCausalGraph::onTimerSet(PeekPointer(event));
 				Simulator::Schedule(ttw, event);
 				NS_LOG_DEBUG("[Node " << this->device->GetNode()->GetId() << "]: Rescheduled SendEvent(" << seqNo << ") for " << (Now() + ttw) << ", now = " << Now());
 			}
@@ -350,6 +360,7 @@ namespace ns3
 
 	void EEBTProtocolSrcPath::Send(Ptr<GameState> gs, EEBTPHeaderSrcPath header, Mac48Address recipient, double txPower, bool isRetransmission)
 	{
+		EEBTP_PROFILE_SCOPE("EEBTProtocolSrcPath::Send");
 		//Adjust the transmission power
 		header.setReceivingProblems(false);
 		if (txPower > this->maxAllowedTxPower)
@@ -362,6 +373,8 @@ namespace ns3
 		//Set sequence number
 		if (!isRetransmission)
 			this->cache.injectSeqNo(&header);
+		else
+			this->retransmissionTrace(gs->getGameID(), header.GetFrameType(), header.GetSequenceNumber(), recipient, txPower);
 
 		if (header.GetFrameType() == CYCLE_CHECK || header.GetFrameType() == NEIGHBOR_DISCOVERY || header.GetFrameType() == CHILD_CONFIRMATION)
 		{
@@ -392,8 +405,11 @@ namespace ns3
 		if (header.GetFrameType() == CYCLE_CHECK || header.GetFrameType() == CHILD_REQUEST || header.GetFrameType() == CHILD_CONFIRMATION ||
 			header.GetFrameType() == CHILD_REJECTION || header.GetFrameType() == PARENT_REVOCATION || header.GetFrameType() == END_OF_GAME)
 		{
-			Time ttw = this->device->GetMac()->GetAckTimeout() * 100;
-			EventId id = Simulator::Schedule(ttw, Create<SendEvent>(gs, this, (FRAME_TYPE)header.GetFrameType(), recipient, txPower, header.GetSequenceNumber()));
+			Time ttw = this->device->GetMac()->GetAckTimeout() * this->ackPollFactor;
+			EEBTP_PROFILE_COUNT("schedule SendEvent");
+			Ptr<SendEvent> event = Create<SendEvent>(gs, this, (FRAME_TYPE)header.GetFrameType(), recipient, txPower, header.GetSequenceNumber());
+			EEBTPCausalGraph::onTimerSet(PeekPointer(event));
+			EventId id = Simulator::Schedule(ttw, event);
 			NS_LOG_DEBUG("[Node " << this->device->GetNode()->GetId() << "]: Scheduled SendEvent(" << (uint)header.GetFrameType() << ") for " << (Now() + ttw) << ". EventID = " << id.GetUid());
 		}
 
@@ -446,6 +462,7 @@ namespace ns3
 	 */
 	void EEBTProtocolSrcPath::handleCycleCheck(Ptr<GameState> gs, Ptr<EEBTPNode> node)
 	{
+		EEBTP_PROFILE_SCOPE("EEBTProtocolSrcPath::handleCycleCheck");
 		if (gs->isChild(node))
 		{
 			this->Send(gs, CYCLE_CHECK, node->getAddress(), node->getReachPower());
@@ -467,6 +484,8 @@ namespace ns3
 			if (gs->getPPCEvent() != 0)
 				gs->getPPCEvent()->Cancel();
 			gs->setPPCEvent(Create<ParentPathCheckEvent>(gs, this));
+			EEBTP_PROFILE_COUNT("schedule ParentPathCheckEvent");
+			EEBTPCausalGraph::onTimerSet(PeekPointer(gs->getPPCEvent()));
 			Simulator::Schedule((Now() + MilliSeconds(this->timeToWait)), gs->getPPCEvent());
 		}
 	}
@@ -476,6 +495,7 @@ namespace ns3
 	 */
 	void EEBTProtocolSrcPath::handleNeighborDiscovery(Ptr<GameState> gs, Ptr<EEBTPNode> node)
 	{
+		EEBTP_PROFILE_SCOPE("EEBTProtocolSrcPath::handleNeighborDiscovery");
 		//NS_LOG_DEBUG(this->device->GetNode()->GetId() << " => EEBTProtocolSrcPath::handleNeighborDiscovery()");
 
 		if (!gs->isInitiator() && this->checkParentPath(gs))
@@ -495,7 +515,11 @@ namespace ns3
 						if (gs->getPPCEvent() == 0)
 							gs->setPPCEvent(Create<ParentPathCheckEvent>(gs, this));
 						else if (!gs->getPPCEvent()->IsCancelled())
+						{
+							EEBTP_PROFILE_COUNT("schedule ParentPathCheckEvent");
+							EEBTPCausalGraph::onTimerSet(PeekPointer(gs->getPPCEvent()));
 							Simulator::Schedule((Now() + MilliSeconds(this->timeToWait)), gs->getPPCEvent());
+						}
 					}
 					else
 						gs->incrementParentUnchangedCounter();
@@ -506,6 +530,7 @@ namespace ns3
 
 	void EEBTProtocolSrcPath::handleChildRequest(Ptr<GameState> gs, Ptr<EEBTPNode> node)
 	{
+		EEBTP_PROFILE_SCOPE("EEBTProtocolSrcPath::handleChildRequest");
 		Ptr<EEBTPNode> me = Create<EEBTPNode>(this->myAddress, 0);
 		if (gs->getParent() != 0)
 			me->setSrcPath(gs->getParent()->getSrcPath());
@@ -527,6 +552,7 @@ namespace ns3
 	 */
 	void EEBTProtocolSrcPath::handleChildConfirmation(Ptr<GameState> gs, Ptr<EEBTPNode> node)
 	{
+		EEBTP_PROFILE_SCOPE("EEBTProtocolSrcPath::handleChildConfirmation");
 		//NS_LOG_DEBUG(this->device->GetNode()->GetId() << " => EEBTProtocolSrcPath::handleChildConfirmation()");
 
 		if (gs->checkLastFrameType(node->getAddress(), CHILD_CONFIRMATION, gs->getLastSeqNo(node->getAddress(), CHILD_REJECTION)))
@@ -582,7 +608,7 @@ namespace ns3
 			gs->incrementUnchangedCounter();
 		}
 
-		if (gs->getUnchangedCounter() < EEBTProtocol::MAX_UNCHANGED_ROUNDS)
+		if (gs->getUnchangedCounter() < this->maxUnchangedRounds)
 		{
 			//Check if we note a possible better parent in the past
 			this->contactCheapestNeighbor(gs);
@@ -605,10 +631,12 @@ namespace ns3
 			gs->resetParentUnchangedCounter();
 			if (gs->getPPCEvent() == 0)
 				gs->setPPCEvent(Create<ParentPathCheckEvent>(gs, this));
+			EEBTP_PROFILE_COUNT("schedule ParentPathCheckEvent");
+			EEBTPCausalGraph::onTimerSet(PeekPointer(gs->getPPCEvent()));
 			Simulator::Schedule((Now() + MilliSeconds(this->timeToWait)), gs->getPPCEvent());
 
 			//Reset the unchanged counter, since our topology changed
-			if (!gs->doIncrAfterConfirm() && gs->getUnchangedCounter() < EEBTProtocol::MAX_UNCHANGED_ROUNDS)
+			if (!gs->doIncrAfterConfirm() && gs->getUnchangedCounter() < this->maxUnchangedRounds)
 			{
 				NS_LOG_DEBUG("[Node " << this->device->GetNode()->GetId() << "]: Resetting unchanged counter");
 				gs->resetUnchangedCounter();
@@ -721,7 +749,11 @@ namespace ns3
 					this->Send(gs, CYCLE_CHECK, parent->getAddress(), parent->getReachPower());
 				}
 				else if (gs->getPPCEvent() != 0)
+				{
+					EEBTP_PROFILE_COUNT("schedule ParentPathCheckEvent");
+					EEBTPCausalGraph::onTimerSet(PeekPointer(gs->getPPCEvent()));
 					Simulator::Schedule((Now() + MilliSeconds(this->timeToWait)), gs->getPPCEvent());
+				}
 			}
 		}
 	}
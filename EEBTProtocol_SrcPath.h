@@ -1,5 +1,5 @@
 /*
- * SimpleBroadcastProtocol.h
+ * EEBTProtocol_SrcPath.h
  *
  *  Created on: 17.06.2020
  *      Author: Kevin Küchler
@@ -59,12 +59,15 @@
 #include "float.h"
 #include "ns3/integer.h"
 #include "GameState.h"
+#include "EEBTPProfiler.h"
+#include "EEBTPCausalGraph.h"
 #include "ns3/core-module.h"
 #include "ns3/wifi-utils.h"
 
 #include "SendEvent.h"
 #include "LockEvent.h"
 #include "ParentPathCheckEvent.h"
+#include "EEBTProtocol.h"
 
 namespace ns3
 {
@@ -262,6 +265,7 @@ namespace ns3
 
 		this->rejectionCounter = 0;
 		this->parentUnchangedCounter = 0;
+		this->parentChanges = 0;
 
 		this->needCycleCheck = false;
 
@@ -280,6 +284,10 @@ namespace ns3
 
 		this->emptyPathOnConnect = false;
 
+		this->eventTrace = 0;
+		this->nodeId = 0;
+		this->protocol = 0;
+
 		this->adh = Create<ApplicationDataHandler>();
 	}
 
@@ -362,6 +370,14 @@ namespace ns3
 	 */
 	void GameState::finishGame()
 	{
+		if (this->eventTrace != 0 && !this->endOfGame)
+			this->eventTrace->record(Now().GetNanoSeconds(), this->nodeId, EEBTPEventTrace::GAME_FINISHED, EEBTPEventTrace::NO_FRAME, EEBTPEventTrace::BROADCAST, 0, this->highestTxPower, 0);
+		if (this->protocol != 0 && !this->endOfGame)
+			this->protocol->gameFinishedTrace(this->gameID, this->highestTxPower);
+
+		//Like the finish time, the last call counts
+		EEBTPCausalGraph::onGameFinished(Now().GetNanoSeconds(), this->nodeId);
+
 		this->endOfGame = true;
 		this->finishTime = Now();
 	}
@@ -442,7 +458,15 @@ namespace ns3
 	{
 		//For mutex mode: If we changed our parent (p != this->parent), our old parent is not waiting for us anymore
 		if (p != this->parent)
+		{
 			this->parentIsWaitingForLock = false;
+			this->parentChanges++;
+
+			if (this->eventTrace != 0)
+				this->eventTrace->record(Now().GetNanoSeconds(), this->nodeId, EEBTPEventTrace::PARENT_CHANGED, EEBTPEventTrace::NO_FRAME, (p != 0) ? EEBTPEventTrace::getAddress(p->getAddress()) : EEBTPEventTrace::BROADCAST, 0, (p != 0) ? p->getReachPower() : 0, 0);
+			if (this->protocol != 0)
+				this->protocol->parentChangedTrace(this->gameID, (this->parent != 0) ? this->parent->getAddress() : Mac48Address::GetBroadcast(), (p != 0) ? p->getAddress() : Mac48Address::GetBroadcast());
+		}
 		this->parent = p;
 	}
 
@@ -535,6 +559,7 @@ namespace ns3
 
 	void GameState::findHighestTxPowers()
 	{
+		EEBTP_PROFILE_SCOPE("GameState::findHighestTxPowers");
 		double maxTx = WToDbm(0);
 		double sMaxTx = WToDbm(0);
 		for (uint i = 0; i < this->childList.size(); i++)
@@ -619,6 +644,7 @@ namespace ns3
 	 */
 	Ptr<EEBTPNode> GameState::getCheapestNeighbor()
 	{
+		EEBTP_PROFILE_SCOPE("GameState::getCheapestNeighbor");
 		double cost = FLT_MAX;
 		double threshold = DbmToW(1.0);
 		Ptr<EEBTPNode> neighbor = this->parent;
@@ -709,7 +735,11 @@ namespace ns3
 	void GameState::addChild(Ptr<EEBTPNode> c)
 	{
 		if (!this->isChild(c))
+		{
 			this->childList.push_back(c);
+			if (this->protocol != 0)
+				this->protocol->childAddedTrace(this->gameID, c->getAddress());
+		}
 		this->findHighestTxPowers();
 	}
 
@@ -723,7 +753,11 @@ namespace ns3
 		}
 
 		if (i < this->childList.size())
+		{
 			childList.erase(this->childList.begin() + i, this->childList.begin() + (i + 1));
+			if (this->protocol != 0)
+				this->protocol->childRemovedTrace(this->gameID, c->getAddress());
+		}
 
 		this->findHighestTxPowers();
 	}
@@ -768,13 +802,28 @@ namespace ns3
 
 	void GameState::updateBlacklist(Ptr<EEBTPNode> node)
 	{
-		this->blacklist[node->getAddress()] = node->getParentAddress();
+		this->updateBlacklist(node->getAddress(), node->getParentAddress());
+	}
+
+	void GameState::updateBlacklist(Mac48Address node, Mac48Address parent)
+	{
+		this->blacklist[node] = parent;
+
+		if (this->eventTrace != 0)
+			this->eventTrace->record(Now().GetNanoSeconds(), this->nodeId, EEBTPEventTrace::BLACKLIST_UPDATED, EEBTPEventTrace::NO_FRAME, EEBTPEventTrace::getAddress(node), 0, 0, 0);
+		if (this->protocol != 0)
+			this->protocol->blacklistUpdatedTrace(this->gameID, node);
 	}
 
 	void GameState::resetBlacklist()
 	{
 		this->blacklist.clear();
 
+		if (this->eventTrace != 0)
+			this->eventTrace->record(Now().GetNanoSeconds(), this->nodeId, EEBTPEventTrace::BLACKLIST_UPDATED, EEBTPEventTrace::NO_FRAME, EEBTPEventTrace::BROADCAST, 0, 0, 0);
+		if (this->protocol != 0)
+			this->protocol->blacklistUpdatedTrace(this->gameID, Mac48Address::GetBroadcast());
+
 		for (Ptr<EEBTPNode> node : this->neighbors)
 			node->resetConnCounter();
 	}
@@ -976,6 +1025,12 @@ namespace ns3
 		this->parentUnchangedCounter++;
 	}
 
+	//Number of parent changes (including losing the parent) since the game started
+	uint32_t GameState::getParentChanges()
+	{
+		return this->parentChanges;
+	}
+
 	Ptr<ParentPathCheckEvent> GameState::getPPCEvent()
 	{
 		return this->ppcEvent;
@@ -995,4 +1050,30 @@ namespace ns3
 	{
 		this->emptyPathOnConnect = b;
 	}
+
+	//The changes of the parent, the blacklist and the end of the game are recorded if a trace is set
+	void GameState::setEventTrace(EEBTPEventTrace *eventTrace, uint32_t nodeId)
+	{
+		this->eventTrace = eventTrace;
+		this->nodeId = nodeId;
+	}
+
+	//Parent, child, blacklist and end of game changes are passed to the trace sources of the protocol
+	void GameState::setProtocol(EEBTProtocol *protocol)
+	{
+		this->protocol = protocol;
+	}
+
+	//The neighbors own their EEBTPNodes, the children are neighbors too
+	void GameState::getMemoryUsage(MemoryUsage &usage)
+	{
+		usage.bytes[MemoryUsage::NEIGHBORS] += MemoryUsage::getBytes(this->neighbors) + this->neighbors.size() * sizeof(EEBTPNode);
+		for (Ptr<EEBTPNode> n : this->neighbors)
+			usage.bytes[MemoryUsage::NEIGHBORS] += n->getSrcPath().size() * sizeof(Mac48Address);
+
+		usage.bytes[MemoryUsage::CHILDREN] += MemoryUsage::getBytes(this->childList);
+		usage.bytes[MemoryUsage::BLACKLIST] += MemoryUsage::getBytes(this->blacklist);
+		usage.bytes[MemoryUsage::FRAME_TYPE_CACHE] += MemoryUsage::getBytes(this->frameTypeCache);
+		this->adh->getMemoryUsage(usage);
+	}
 }
@@ -16,6 +16,8 @@
 #include "ns3/traffic-control-layer.h"
 
 #include "EEBTPHeader.h"
+#include "EEBTPEventTrace.h"
+#include "MemoryUsage.h"
 #include "ApplicationDataHandler.h"
 
 namespace ns3
@@ -24,6 +26,7 @@ namespace ns3
 	class CCSendEvent;
 	class MutexSendEvent;
 	class ParentPathCheckEvent;
+	class EEBTProtocol;
 
 	/*
 	 * A Node holds information about a particular (other)
@@ -170,6 +173,7 @@ namespace ns3
 
 		bool isBlacklisted(Ptr<EEBTPNode> node);
 		void updateBlacklist(Ptr<EEBTPNode> node);
+		void updateBlacklist(Mac48Address node, Mac48Address parent);
 		void resetBlacklist();
 		bool isBlacklisted(Mac48Address node, Mac48Address parent);
 
@@ -218,12 +222,19 @@ namespace ns3
 		uint32_t getParentUnchangedCounter();
 		void incrementParentUnchangedCounter();
 
+		uint32_t getParentChanges();
+
 		Ptr<ParentPathCheckEvent> getPPCEvent();
 		void setPPCEvent(Ptr<ParentPathCheckEvent>);
 
 		bool hadEmptyPathOnConnect();
 		void setEmptyPathOnConnect(bool b);
 
+		void setEventTrace(EEBTPEventTrace *eventTrace, uint32_t nodeId);
+		void setProtocol(EEBTProtocol *protocol);
+
+		void getMemoryUsage(MemoryUsage &usage);
+
 	private:
 		bool initiator;
 		bool endOfGame;
@@ -237,6 +248,7 @@ namespace ns3
 		Time lastParentUpdate;
 		bool emptyPathOnConnect;
 		uint32_t parentUnchangedCounter;
+		uint32_t parentChanges;
 		Ptr<ParentPathCheckEvent> ppcEvent;
 
 		Time finishTime;
@@ -274,6 +286,12 @@ namespace ns3
 		std::vector<Mac48Address> srcPath;
 
 		Ptr<ApplicationDataHandler> adh;
+
+		EEBTPEventTrace *eventTrace;
+		uint32_t nodeId;
+
+		//Owner of this GameState, fires the trace sources (not a Ptr, the protocol holds the GameState)
+		EEBTProtocol *protocol;
 	};
 }
 #endif /* BROADCAST_GAMESTATE_H_ */
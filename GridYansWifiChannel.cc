@@ -0,0 +1,426 @@
+/*
+ * GridYansWifiChannel.cc
+ *
+ *  Created on: 19.10.2026
+ *
+ *  Send and Receive follow yans-wifi-channel.cc
+ */
+
+#include "cmath"
+#include "float.h"
+#include "algorithm"
+#include "ns3/log.h"
+#include "ns3/double.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include "ns3/simulator.h"
+#include "ns3/wifi-utils.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/constant-position-mobility-model.h"
+
+#include "GridYansWifiChannel.h"
+
+namespace ns3
+{
+	NS_LOG_COMPONENT_DEFINE("GridYansWifiChannel");
+	NS_OBJECT_ENSURE_REGISTERED(GridYansWifiChannel);
+
+	GridYansWifiChannel::GridYansWifiChannel()
+	{
+		this->cellSize = 0;
+		this->verify = false;
+		this->nThreads = 1;
+		this->parallelThreshold = 64;
+		this->pool = 0;
+
+		this->gridCellSize = 0;
+		this->gridValid = false;
+		this->courseChangeConnected = false;
+		this->minX = 0;
+		this->minY = 0;
+		this->nX = 0;
+		this->nY = 0;
+		this->minRxPowerDbm = 0;
+
+		this->rangeTx = CreateObject<ConstantPositionMobilityModel>();
+		this->rangeRx = CreateObject<ConstantPositionMobilityModel>();
+
+		this->nTransmissions = 0;
+		this->nCandidates = 0;
+		this->nReceptions = 0;
+	}
+
+	GridYansWifiChannel::~GridYansWifiChannel()
+	{
+	}
+
+	TypeId GridYansWifiChannel::GetTypeId()
+	{
+		static TypeId tid = TypeId("ns3::GridYansWifiChannel")
+								.SetParent<YansWifiChannel>()
+								.SetGroupName("Wifi")
+								.AddConstructor<GridYansWifiChannel>()
+								.AddAttribute("CellSize",
+											  "Edge length (m) of a grid cell. With 0 the range at the highest TX power of all PHYs is used.",
+											  DoubleValue(0),
+											  MakeDoubleAccessor(&GridYansWifiChannel::cellSize),
+											  MakeDoubleChecker<double>(0))
+								.AddAttribute("Verify",
+											  "Check every transmission against all PHYs and abort if a skipped PHY would have received the signal.",
+											  BooleanValue(false),
+											  MakeBooleanAccessor(&GridYansWifiChannel::verify),
+											  MakeBooleanChecker())
+								.AddAttribute("Threads",
+											  "Number of threads calculating the loss and delay of the receivers (including the simulator thread).",
+											  UintegerValue(1),
+											  MakeUintegerAccessor(&GridYansWifiChannel::nThreads),
+											  MakeUintegerChecker<uint32_t>(1))
+								.AddAttribute("ParallelThreshold",
+											  "Minimum number of receivers within range to use the worker threads.",
+											  UintegerValue(64),
+											  MakeUintegerAccessor(&GridYansWifiChannel::parallelThreshold),
+											  MakeUintegerChecker<uint32_t>());
+		return tid;
+	}
+
+	TypeId GridYansWifiChannel::GetInstanceTypeId() const
+	{
+		return GetTypeId();
+	}
+
+	void GridYansWifiChannel::DoDispose()
+	{
+		if (this->pool != 0)
+			delete this->pool;
+		this->pool = 0;
+		this->senderCopies.clear();
+
+		this->phys.clear();
+		this->mobilities.clear();
+		this->cells.clear();
+		this->loss = 0;
+		this->cachedLoss = 0;
+		this->delay = 0;
+		this->rangeTx = 0;
+		this->rangeRx = 0;
+		YansWifiChannel::DoDispose();
+	}
+
+	/*
+	 * The models of the YansWifiChannel are private, so they are kept here as well
+	 */
+	void GridYansWifiChannel::setPropagationLossModel(Ptr<PropagationLossModel> loss)
+	{
+		this->loss = loss;
+		this->cachedLoss = DynamicCast<CachedPropagationLossModel>(loss);
+		this->gridValid = false;
+		YansWifiChannel::SetPropagationLossModel(loss);
+	}
+
+	void GridYansWifiChannel::setPropagationDelayModel(Ptr<PropagationDelayModel> delay)
+	{
+		this->delay = delay;
+		YansWifiChannel::SetPropagationDelayModel(delay);
+	}
+
+	/*
+	 * Collects all PHYs (in the order of the YansWifiChannel) and sorts them into the grid
+	 */
+	void GridYansWifiChannel::buildGrid()
+	{
+		NS_ASSERT_MSG(this->loss != 0 && this->delay != 0, "GridYansWifiChannel needs a propagation loss and delay model");
+
+		this->phys.clear();
+		this->mobilities.clear();
+		this->positions.clear();
+		this->rangeCache.clear();
+
+		double maxTxPowerDbm = -DBL_MAX;
+		this->minRxPowerDbm = DBL_MAX;
+		for (std::size_t i = 0; i < this->GetNDevices(); i++)
+		{
+			Ptr<WifiNetDevice> dev = DynamicCast<WifiNetDevice>(this->GetDevice(i));
+			NS_ASSERT_MSG(dev != 0, "PHY " << i << " of the GridYansWifiChannel has no WifiNetDevice");
+			Ptr<YansWifiPhy> phy = DynamicCast<YansWifiPhy>(dev->GetPhy());
+
+			this->phys.push_back(phy);
+			this->mobilities.push_back(phy->GetMobility());
+			this->positions.push_back(phy->GetMobility()->GetPosition());
+			this->minRxPowerDbm = std::min(this->minRxPowerDbm, phy->GetRxSensitivity() - phy->GetRxGain());
+			maxTxPowerDbm = std::max(maxTxPowerDbm, phy->GetTxPowerEnd() + phy->GetTxGain());
+
+			if (!this->courseChangeConnected)
+				phy->GetMobility()->TraceConnectWithoutContext("CourseChange", MakeCallback(&GridYansWifiChannel::onCourseChange, this));
+		}
+		this->courseChangeConnected = true;
+
+		if (this->nThreads > 1 && this->pool == 0)
+		{
+			this->pool = new WorkerPool(this->nThreads);
+			for (uint32_t i = 0; i < this->nThreads; i++)
+				this->senderCopies.push_back(CreateObject<ConstantPositionMobilityModel>());
+		}
+
+		double maxX = 0, maxY = 0;
+		this->minX = 0;
+		this->minY = 0;
+		for (std::size_t i = 0; i < this->positions.size(); i++)
+		{
+			if (i == 0 || this->positions[i].x < this->minX)
+				this->minX = this->positions[i].x;
+			if (i == 0 || this->positions[i].y < this->minY)
+				this->minY = this->positions[i].y;
+			if (i == 0 || this->positions[i].x > maxX)
+				maxX = this->positions[i].x;
+			if (i == 0 || this->positions[i].y > maxY)
+				maxY = this->positions[i].y;
+		}
+
+		double size = this->cellSize;
+		if (size <= 0)
+			size = std::min(this->calculateRange(maxTxPowerDbm), std::max(maxX - this->minX, maxY - this->minY) + 1.0);
+
+		//Do not use (much) more cells than PHYs
+		double area = (maxX - this->minX + 1.0) * (maxY - this->minY + 1.0);
+		size = std::max(size, std::sqrt(area / (4.0 * this->phys.size() + 1.0)));
+		this->gridCellSize = size;
+
+		this->nX = (int64_t)((maxX - this->minX) / size) + 1;
+		this->nY = (int64_t)((maxY - this->minY) / size) + 1;
+		this->cells = std::vector<std::vector<uint32_t>>(this->nX * this->nY);
+		for (uint32_t i = 0; i < this->positions.size(); i++)
+		{
+			int64_t x = (int64_t)((this->positions[i].x - this->minX) / size);
+			int64_t y = (int64_t)((this->positions[i].y - this->minY) / size);
+			this->cells[y * this->nX + x].push_back(i);
+		}
+
+		NS_LOG_DEBUG("Grid of " << this->nX << "x" << this->nY << " cells with " << size << "m for " << this->phys.size() << " PHYs, RX threshold " << this->minRxPowerDbm << "dBm");
+		this->gridValid = true;
+	}
+
+	void GridYansWifiChannel::onCourseChange(Ptr<const MobilityModel> mobility)
+	{
+		this->gridValid = false;
+	}
+
+	/*
+	 * Range calculation
+	 * 	- getRange: Cached range for a TX power
+	 * 	- calculateRange: Bisection of the distance at which the RX power drops below the threshold
+	 */
+	double GridYansWifiChannel::getRange(double txPowerDbm)
+	{
+		if (!this->gridValid)
+			this->buildGrid();
+
+		std::map<double, double>::iterator it = this->rangeCache.find(txPowerDbm);
+		if (it != this->rangeCache.end())
+			return it->second;
+
+		if (this->rangeCache.size() > 4096)
+			this->rangeCache.clear();
+
+		double range = this->calculateRange(txPowerDbm);
+		this->rangeCache[txPowerDbm] = range;
+		return range;
+	}
+
+	double GridYansWifiChannel::calculateRange(double txPowerDbm)
+	{
+		double upper = 1;
+		while (this->getRxPowerAt(txPowerDbm, upper) >= this->minRxPowerDbm)
+		{
+			upper *= 2;
+			if (upper > 1e9)
+				return DBL_MAX;
+		}
+
+		double lower = 0;
+		for (int i = 0; i < 48; i++)
+		{
+			double mid = (lower + upper) / 2;
+			if (this->getRxPowerAt(txPowerDbm, mid) >= this->minRxPowerDbm)
+				lower = mid;
+			else
+				upper = mid;
+		}
+
+		return upper;
+	}
+
+	double GridYansWifiChannel::getRxPowerAt(double txPowerDbm, double distance)
+	{
+		this->rangeRx->SetPosition(Vector(distance, 0, 0));
+		return this->loss->CalcRxPower(txPowerDbm, this->rangeTx, this->rangeRx);
+	}
+
+	/*
+	 * Send a PPDU to all PHYs within range
+	 */
+	void GridYansWifiChannel::Send(Ptr<YansWifiPhy> sender, Ptr<const WifiPpdu> ppdu, double txPowerDbm)
+	{
+		NS_LOG_FUNCTION(this << sender << ppdu << txPowerDbm);
+
+		double range = this->getRange(txPowerDbm);
+		Ptr<MobilityModel> senderMobility = sender->GetMobility();
+		NS_ASSERT(senderMobility != 0);
+		Vector pos = senderMobility->GetPosition();
+
+		this->candidates.clear();
+		if (range == DBL_MAX)
+		{
+			for (uint32_t i = 0; i < this->phys.size(); i++)
+				this->candidates.push_back(i);
+		}
+		else
+		{
+			int64_t x0 = std::max((int64_t)0, (int64_t)std::floor((pos.x - range - this->minX) / this->gridCellSize));
+			int64_t x1 = std::min(this->nX - 1, (int64_t)std::floor((pos.x + range - this->minX) / this->gridCellSize));
+			int64_t y0 = std::max((int64_t)0, (int64_t)std::floor((pos.y - range - this->minY) / this->gridCellSize));
+			int64_t y1 = std::min(this->nY - 1, (int64_t)std::floor((pos.y + range - this->minY) / this->gridCellSize));
+			for (int64_t y = y0; y <= y1; y++)
+			{
+				for (int64_t x = x0; x <= x1; x++)
+				{
+					std::vector<uint32_t> &cell = this->cells[y * this->nX + x];
+					this->candidates.insert(this->candidates.end(), cell.begin(), cell.end());
+				}
+			}
+
+			//Keep the order of the YansWifiChannel, so simultaneous events are scheduled in the same order
+			std::sort(this->candidates.begin(), this->candidates.end());
+		}
+
+		this->nTransmissions++;
+		this->nCandidates += this->candidates.size();
+
+		//Loss and delay of all candidates (in parallel for many candidates)
+		uint32_t n = this->candidates.size();
+		this->rxPowers.resize(n);
+		this->delays.resize(n);
+		if (this->pool != 0 && n >= this->parallelThreshold)
+		{
+			for (Ptr<MobilityModel> &senderCopy : this->senderCopies)
+				senderCopy->SetPosition(pos);
+
+			const YansWifiPhy *senderPhy = PeekPointer(sender);
+			int64_t senderIndex = this->getCacheIndex(senderMobility);
+			this->pool->run(n, [this, senderIndex, senderPhy, txPowerDbm](uint32_t worker, uint32_t begin, uint32_t end) {
+				this->calculateLinks(this->senderCopies[worker], senderIndex, senderPhy, txPowerDbm, begin, end);
+			});
+		}
+		else
+			this->calculateLinks(senderMobility, -1, PeekPointer(sender), txPowerDbm, 0, n);
+
+		std::vector<bool> checked;
+		if (this->verify)
+			checked = std::vector<bool>(this->phys.size(), false);
+
+		for (uint32_t c = 0; c < n; c++)
+		{
+			uint32_t i = this->candidates[c];
+			const Ptr<YansWifiPhy> &receiver = this->phys[i];
+			if (this->verify)
+				checked[i] = true;
+
+			//For now don't account for inter channel interference nor channel bonding
+			if (receiver == sender || receiver->GetChannelNumber() != sender->GetChannelNumber())
+				continue;
+
+			//The YansWifiChannel drops such a signal on reception
+			double rxPowerDbm = this->rxPowers[c];
+			if ((rxPowerDbm + receiver->GetRxGain()) < receiver->GetRxSensitivity())
+				continue;
+
+			Time delay = this->delays[c];
+			NS_LOG_DEBUG("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, "
+												 << "distance=" << senderMobility->GetDistanceFrom(this->mobilities[i]) << "m, delay=" << delay);
+
+			Ptr<WifiPpdu> copy = Copy(ppdu);
+			Ptr<NetDevice> dstNetDevice = receiver->GetDevice();
+			uint32_t dstNode = (dstNetDevice == 0) ? 0xffffffff : dstNetDevice->GetNode()->GetId();
+
+			this->nReceptions++;
+			Simulator::ScheduleWithContext(dstNode, delay, &GridYansWifiChannel::Receive, receiver, copy, rxPowerDbm);
+		}
+
+		if (this->verify)
+			this->verifyTransmission(sender, txPowerDbm, checked);
+	}
+
+	/*
+	 * Calculates the loss and delay of the candidates [begin, end). Runs on
+	 * the worker threads, so only the given sender mobility model and the
+	 * mobility models of these candidates are touched. With a senderIndex
+	 * >= 0 the CachedPropagationLossModel is asked with it.
+	 */
+	void GridYansWifiChannel::calculateLinks(Ptr<MobilityModel> sender, int64_t senderIndex, const YansWifiPhy *senderPhy, double txPowerDbm, uint32_t begin, uint32_t end)
+	{
+		for (uint32_t c = begin; c < end; c++)
+		{
+			uint32_t i = this->candidates[c];
+			if (PeekPointer(this->phys[i]) == senderPhy)
+			{
+				this->rxPowers[c] = -DBL_MAX;
+				continue;
+			}
+
+			if (senderIndex >= 0)
+				this->rxPowers[c] = this->cachedLoss->calcRxPower(txPowerDbm, senderIndex, sender, this->mobilities[i]);
+			else
+				this->rxPowers[c] = this->loss->CalcRxPower(txPowerDbm, sender, this->mobilities[i]);
+			this->delays[c] = this->delay->GetDelay(sender, this->mobilities[i]);
+		}
+	}
+
+	/*
+	 * Index of the sender in the CachedPropagationLossModel, -1 if there is
+	 * none, it does not know the sender or it has a next model in the chain
+	 * (which calcRxPower() does not apply)
+	 */
+	int64_t GridYansWifiChannel::getCacheIndex(Ptr<MobilityModel> sender)
+	{
+		if (this->cachedLoss == 0 || this->cachedLoss->GetNext() != 0)
+			return -1;
+		return this->cachedLoss->getIndex(sender);
+	}
+
+	//Every PHY that was not looked at must drop the signal
+	void GridYansWifiChannel::verifyTransmission(Ptr<YansWifiPhy> sender, double txPowerDbm, std::vector<bool> &checked)
+	{
+		Ptr<MobilityModel> senderMobility = sender->GetMobility();
+		for (uint32_t i = 0; i < this->phys.size(); i++)
+		{
+			Ptr<YansWifiPhy> receiver = this->phys[i];
+			if (checked[i] || receiver == sender || receiver->GetChannelNumber() != sender->GetChannelNumber())
+				continue;
+
+			double rxPowerDbm = this->loss->CalcRxPower(txPowerDbm, senderMobility, receiver->GetMobility());
+			if ((rxPowerDbm + receiver->GetRxGain()) >= receiver->GetRxSensitivity())
+				NS_FATAL_ERROR("GridYansWifiChannel skipped PHY " << i << " at " << senderMobility->GetDistanceFrom(receiver->GetMobility()) << "m with "
+																  << rxPowerDbm << "dBm (range " << this->getRange(txPowerDbm) << "m for " << txPowerDbm << "dBm)");
+		}
+	}
+
+	void GridYansWifiChannel::Receive(Ptr<YansWifiPhy> receiver, Ptr<WifiPpdu> ppdu, double rxPowerDbm)
+	{
+		NS_LOG_FUNCTION(receiver << ppdu << rxPowerDbm);
+		receiver->StartReceivePreamble(ppdu, DbmToW(rxPowerDbm + receiver->GetRxGain()));
+	}
+
+	uint64_t GridYansWifiChannel::getNTransmissions()
+	{
+		return this->nTransmissions;
+	}
+
+	uint64_t GridYansWifiChannel::getNCandidates()
+	{
+		return this->nCandidates;
+	}
+
+	uint64_t GridYansWifiChannel::getNReceptions()
+	{
+		return this->nReceptions;
+	}
+}
@@ -0,0 +1,123 @@
+/*
+ * GridYansWifiChannel.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#ifndef BROADCAST_GRIDYANSWIFICHANNEL_H_
+#define BROADCAST_GRIDYANSWIFICHANNEL_H_
+
+#include "map"
+#include "vector"
+#include "ns3/wifi-ppdu.h"
+#include "ns3/yans-wifi-phy.h"
+#include "ns3/yans-wifi-channel.h"
+#include "ns3/mobility-model.h"
+#include "ns3/propagation-loss-model.h"
+#include "ns3/propagation-delay-model.h"
+
+#include "WorkerPool.h"
+#include "CachedPropagationLossModel.h"
+
+namespace ns3
+{
+	/*
+	 * Range limited variant of the YansWifiChannel for static topologies.
+	 *
+	 * The YansWifiChannel schedules a receive event for every other PHY on
+	 * every transmission, even if the signal is far below the RX sensitivity
+	 * of the receiver and dropped right away. This channel sorts the PHYs
+	 * into a uniform grid (built on the first transmission) and only looks at
+	 * the cells within the range of the current TX power. The range is the
+	 * largest distance at which the propagation loss model still delivers
+	 * the lowest RX sensitivity of all PHYs.
+	 *
+	 * Receive events are only scheduled for PHYs that would not drop the
+	 * signal and in the same order as the YansWifiChannel, so the results are
+	 * identical as long as the loss model is deterministic and decreases
+	 * with the distance (e.g. LogDistance, Friis). With 'Verify' every
+	 * transmission is checked against all PHYs. The grid is rebuilt if a
+	 * mobility model reports a course change.
+	 *
+	 * With 'Threads' > 1 the loss and delay of the receivers within range are
+	 * calculated by a worker pool, each worker with its own copy of the
+	 * sender position (Ptr reference counts are not thread safe). A
+	 * CachedPropagationLossModel is asked with the index of the real sender,
+	 * the copies are not registered there. The receive events are scheduled
+	 * afterwards by the simulator thread in the same order, so the results do
+	 * not depend on the number of threads.
+	 * The loss and delay models must not keep state (no random variables).
+	 *
+	 * Only GridYansWifiPhy sends on this channel (see GridYansWifiPhyHelper).
+	 */
+	class GridYansWifiChannel : public YansWifiChannel
+	{
+	public:
+		GridYansWifiChannel();
+		virtual ~GridYansWifiChannel();
+
+		static TypeId GetTypeId();
+		virtual TypeId GetInstanceTypeId() const;
+
+		void setPropagationLossModel(Ptr<PropagationLossModel> loss);
+		void setPropagationDelayModel(Ptr<PropagationDelayModel> delay);
+
+		void Send(Ptr<YansWifiPhy> sender, Ptr<const WifiPpdu> ppdu, double txPowerDbm);
+
+		double getRange(double txPowerDbm);
+		uint64_t getNTransmissions();
+		uint64_t getNCandidates();
+		uint64_t getNReceptions();
+
+		void onCourseChange(Ptr<const MobilityModel> mobility);
+
+	private:
+		Ptr<PropagationLossModel> loss;
+		Ptr<CachedPropagationLossModel> cachedLoss;
+		Ptr<PropagationDelayModel> delay;
+
+		double cellSize;
+		bool verify;
+		uint32_t nThreads;
+		uint32_t parallelThreshold;
+
+		bool gridValid;
+		double gridCellSize;
+		bool courseChangeConnected;
+		double minX;
+		double minY;
+		int64_t nX;
+		int64_t nY;
+		double minRxPowerDbm;
+		std::vector<Ptr<YansWifiPhy>> phys;
+		std::vector<Ptr<MobilityModel>> mobilities;
+		std::vector<Vector> positions;
+		std::vector<std::vector<uint32_t>> cells;
+		std::map<double, double> rangeCache;
+
+		Ptr<MobilityModel> rangeTx;
+		Ptr<MobilityModel> rangeRx;
+		std::vector<uint32_t> candidates;
+		std::vector<double> rxPowers;
+		std::vector<Time> delays;
+
+		WorkerPool *pool;
+		std::vector<Ptr<MobilityModel>> senderCopies;
+
+		uint64_t nTransmissions;
+		uint64_t nCandidates;
+		uint64_t nReceptions;
+
+		virtual void DoDispose();
+
+		void buildGrid();
+		double calculateRange(double txPowerDbm);
+		double getRxPowerAt(double txPowerDbm, double distance);
+		void calculateLinks(Ptr<MobilityModel> sender, int64_t senderIndex, const YansWifiPhy *senderPhy, double txPowerDbm, uint32_t begin, uint32_t end);
+		int64_t getCacheIndex(Ptr<MobilityModel> sender);
+		void verifyTransmission(Ptr<YansWifiPhy> sender, double txPowerDbm, std::vector<bool> &delivered);
+		static void Receive(Ptr<YansWifiPhy> receiver, Ptr<WifiPpdu> ppdu, double rxPowerDbm);
+	};
+}
+
+#endif /* BROADCAST_GRIDYANSWIFICHANNEL_H_ */
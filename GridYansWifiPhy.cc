@@ -0,0 +1,60 @@
+/*
+ * GridYansWifiPhy.cc
+ *
+ *  Created on: 19.10.2026
+ *
+ *  StartTx follows yans-wifi-phy.cc
+ */
+
+#include "ns3/log.h"
+
+#include "GridYansWifiPhy.h"
+
+namespace ns3
+{
+	NS_LOG_COMPONENT_DEFINE("GridYansWifiPhy");
+	NS_OBJECT_ENSURE_REGISTERED(GridYansWifiPhy);
+
+	GridYansWifiPhy::GridYansWifiPhy()
+	{
+	}
+
+	GridYansWifiPhy::~GridYansWifiPhy()
+	{
+	}
+
+	TypeId GridYansWifiPhy::GetTypeId()
+	{
+		static TypeId tid = TypeId("ns3::GridYansWifiPhy")
+								.SetParent<YansWifiPhy>()
+								.SetGroupName("Wifi")
+								.AddConstructor<GridYansWifiPhy>();
+		return tid;
+	}
+
+	TypeId GridYansWifiPhy::GetInstanceTypeId() const
+	{
+		return GetTypeId();
+	}
+
+	void GridYansWifiPhy::DoDispose()
+	{
+		this->gridChannel = 0;
+		YansWifiPhy::DoDispose();
+	}
+
+	void GridYansWifiPhy::StartTx(Ptr<WifiPpdu> ppdu)
+	{
+		NS_LOG_FUNCTION(this << ppdu);
+
+		if (this->gridChannel == 0)
+		{
+			this->gridChannel = DynamicCast<GridYansWifiChannel>(this->GetChannel());
+			NS_ASSERT_MSG(this->gridChannel != 0, "GridYansWifiPhy needs a GridYansWifiChannel");
+		}
+
+		WifiTxVector txVector = ppdu->GetTxVector();
+		NS_LOG_DEBUG("Start transmission: signal power before antenna gain=" << this->GetPowerDbm(txVector.GetTxPowerLevel()) << "dBm");
+		this->gridChannel->Send(this, ppdu, this->GetPowerDbm(txVector.GetTxPowerLevel()) + this->GetTxGain());
+	}
+}
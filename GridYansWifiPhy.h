@@ -0,0 +1,41 @@
+/*
+ * GridYansWifiPhy.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#ifndef BROADCAST_GRIDYANSWIFIPHY_H_
+#define BROADCAST_GRIDYANSWIFIPHY_H_
+
+#include "ns3/wifi-ppdu.h"
+#include "ns3/yans-wifi-phy.h"
+
+#include "GridYansWifiChannel.h"
+
+namespace ns3
+{
+	/*
+	 * YansWifiPhy which sends on a GridYansWifiChannel.
+	 *
+	 * YansWifiChannel::Send is not virtual, so the PHY has to call the
+	 * range limited channel itself. Everything else is the YansWifiPhy.
+	 */
+	class GridYansWifiPhy : public YansWifiPhy
+	{
+	public:
+		GridYansWifiPhy();
+		virtual ~GridYansWifiPhy();
+
+		static TypeId GetTypeId();
+		virtual TypeId GetInstanceTypeId() const;
+
+		virtual void StartTx(Ptr<WifiPpdu> ppdu);
+
+	private:
+		Ptr<GridYansWifiChannel> gridChannel;
+
+		virtual void DoDispose();
+	};
+}
+
+#endif /* BROADCAST_GRIDYANSWIFIPHY_H_ */
@@ -0,0 +1,39 @@
+/*
+ * GridYansWifiPhyHelper.cc
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include "ns3/propagation-loss-model.h"
+#include "ns3/propagation-delay-model.h"
+
+#include "GridYansWifiPhyHelper.h"
+
+namespace ns3
+{
+	GridYansWifiPhyHelper::GridYansWifiPhyHelper()
+	{
+		this->m_phy.SetTypeId("ns3::GridYansWifiPhy");
+	}
+
+	GridYansWifiPhyHelper::~GridYansWifiPhyHelper()
+	{
+	}
+
+	//Same defaults as YansWifiPhyHelper::Default()
+	GridYansWifiPhyHelper GridYansWifiPhyHelper::Default()
+	{
+		GridYansWifiPhyHelper helper;
+		helper.SetErrorRateModel("ns3::NistErrorRateModel");
+		return helper;
+	}
+
+	//Same models as YansWifiChannelHelper::Default()
+	Ptr<GridYansWifiChannel> GridYansWifiPhyHelper::CreateChannel()
+	{
+		Ptr<GridYansWifiChannel> channel = CreateObject<GridYansWifiChannel>();
+		channel->setPropagationLossModel(CreateObject<LogDistancePropagationLossModel>());
+		channel->setPropagationDelayModel(CreateObject<ConstantSpeedPropagationDelayModel>());
+		return channel;
+	}
+}
@@ -0,0 +1,31 @@
+/*
+ * GridYansWifiPhyHelper.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#ifndef BROADCAST_GRIDYANSWIFIPHYHELPER_H_
+#define BROADCAST_GRIDYANSWIFIPHYHELPER_H_
+
+#include "ns3/yans-wifi-helper.h"
+
+#include "GridYansWifiChannel.h"
+
+namespace ns3
+{
+	/*
+	 * YansWifiPhyHelper which creates GridYansWifiPhys. The channel set with
+	 * SetChannel() has to be a GridYansWifiChannel.
+	 */
+	class GridYansWifiPhyHelper : public YansWifiPhyHelper
+	{
+	public:
+		GridYansWifiPhyHelper();
+		virtual ~GridYansWifiPhyHelper();
+
+		static GridYansWifiPhyHelper Default();
+		static Ptr<GridYansWifiChannel> CreateChannel();
+	};
+}
+
+#endif /* BROADCAST_GRIDYANSWIFIPHYHELPER_H_ */
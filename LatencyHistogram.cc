@@ -0,0 +1,137 @@
+/*
+ * LatencyHistogram.cc
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include "algorithm"
+#include "cmath"
+
+#include "LatencyHistogram.h"
+
+namespace ns3
+{
+	static const uint64_t SUB_BUCKETS = 1ULL << LatencyHistogram::SUB_BUCKET_BITS;
+	static const uint64_t HALF_SUB_BUCKETS = SUB_BUCKETS >> 1;
+
+	LatencyHistogram::LatencyHistogram()
+	{
+		this->reset();
+	}
+
+	LatencyHistogram::~LatencyHistogram()
+	{
+	}
+
+	void LatencyHistogram::reset()
+	{
+		this->counts.clear();
+		this->count = 0;
+		this->min = 0;
+		this->max = 0;
+		this->sum = 0;
+	}
+
+	//Negative values are recorded as 0
+	void LatencyHistogram::record(int64_t value)
+	{
+		value = std::max(value, (int64_t)0);
+		uint32_t bucket = LatencyHistogram::getBucket(value);
+		if (bucket >= this->counts.size())
+			this->counts.resize(bucket + 1, 0);
+		this->counts[bucket]++;
+
+		this->min = (this->count == 0) ? value : std::min(this->min, value);
+		this->max = (this->count == 0) ? value : std::max(this->max, value);
+		this->sum += value;
+		this->count++;
+	}
+
+	void LatencyHistogram::add(const LatencyHistogram &other)
+	{
+		if (other.count == 0)
+			return;
+
+		if (other.counts.size() > this->counts.size())
+			this->counts.resize(other.counts.size(), 0);
+		for (uint32_t b = 0; b < other.counts.size(); b++)
+			this->counts[b] += other.counts[b];
+
+		this->min = (this->count == 0) ? other.min : std::min(this->min, other.min);
+		this->max = (this->count == 0) ? other.max : std::max(this->max, other.max);
+		this->sum += other.sum;
+		this->count += other.count;
+	}
+
+	uint64_t LatencyHistogram::getCount() const
+	{
+		return this->count;
+	}
+
+	int64_t LatencyHistogram::getMin() const
+	{
+		return this->min;
+	}
+
+	int64_t LatencyHistogram::getMax() const
+	{
+		return this->max;
+	}
+
+	double LatencyHistogram::getMean() const
+	{
+		return (this->count > 0) ? this->sum / this->count : 0.0;
+	}
+
+	/*
+	 * Smallest bucket with at least p% of the values at or below it, its
+	 * highest value is limited to the maximum. 0 if there are no values
+	 */
+	int64_t LatencyHistogram::getPercentile(double p) const
+	{
+		if (this->count == 0)
+			return 0;
+
+		uint64_t rank = (uint64_t)std::ceil(std::min(std::max(p, 0.0), 100.0) / 100.0 * this->count);
+		rank = std::max(rank, (uint64_t)1);
+
+		uint64_t seen = 0;
+		for (uint32_t b = 0; b < this->counts.size(); b++)
+		{
+			seen += this->counts[b];
+			if (seen >= rank)
+				return std::min(LatencyHistogram::getBucketHigh(b), this->max);
+		}
+		return this->max;
+	}
+
+	/*
+	 * Values below SUB_BUCKETS are their own bucket. Above, the value is
+	 * shifted right until it is below SUB_BUCKETS, the shift selects a group
+	 * of HALF_SUB_BUCKETS buckets and the shifted value (>= HALF_SUB_BUCKETS)
+	 * the bucket within the group
+	 */
+	uint32_t LatencyHistogram::getBucket(int64_t value)
+	{
+		uint64_t v = (uint64_t)value;
+		uint32_t shift = 0;
+		while ((v >> shift) >= SUB_BUCKETS)
+			shift++;
+		return shift * HALF_SUB_BUCKETS + (v >> shift);
+	}
+
+	int64_t LatencyHistogram::getBucketLow(uint32_t bucket)
+	{
+		if (bucket < SUB_BUCKETS)
+			return bucket;
+
+		uint32_t shift = (bucket - HALF_SUB_BUCKETS) / HALF_SUB_BUCKETS;
+		uint64_t sub = bucket - shift * HALF_SUB_BUCKETS;
+		return (int64_t)(sub << shift);
+	}
+
+	int64_t LatencyHistogram::getBucketHigh(uint32_t bucket)
+	{
+		return LatencyHistogram::getBucketLow(bucket + 1) - 1;
+	}
+}
@@ -0,0 +1,59 @@
+/*
+ * LatencyHistogram.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#ifndef BROADCAST_LATENCYHISTOGRAM_H_
+#define BROADCAST_LATENCYHISTOGRAM_H_
+
+#include "vector"
+#include "cstdint"
+
+namespace ns3
+{
+	/*
+	 * Histogram of non-negative values (latencies in ns) with logarithmic
+	 * buckets like the HdrHistogram, without ns-3 dependencies.
+	 *
+	 * Values below 2^SUB_BUCKET_BITS have their own bucket. Above, every power
+	 * of two is split into 2^(SUB_BUCKET_BITS - 1) buckets, so a value is
+	 * stored with a relative error below 2^-(SUB_BUCKET_BITS - 1) (1.6%) in
+	 * O(1) and the buckets grow with the largest value (about 2000 buckets
+	 * for 20s). Percentiles return the highest value of their bucket, the
+	 * minimum, maximum and mean are exact.
+	 */
+	class LatencyHistogram
+	{
+	public:
+		static const uint32_t SUB_BUCKET_BITS = 7;
+
+		LatencyHistogram();
+		virtual ~LatencyHistogram();
+
+		void record(int64_t value);
+		void add(const LatencyHistogram &other);
+		void reset();
+
+		uint64_t getCount() const;
+		int64_t getMin() const;
+		int64_t getMax() const;
+		double getMean() const;
+
+		//'p' in percent, e.g. 99.9
+		int64_t getPercentile(double p) const;
+
+		static uint32_t getBucket(int64_t value);
+		static int64_t getBucketLow(uint32_t bucket);
+		static int64_t getBucketHigh(uint32_t bucket);
+
+	private:
+		std::vector<uint64_t> counts;
+		uint64_t count;
+		int64_t min;
+		int64_t max;
+		double sum;
+	};
+}
+
+#endif /* BROADCAST_LATENCYHISTOGRAM_H_ */
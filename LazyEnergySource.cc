@@ -0,0 +1,159 @@
+/*
+ * LazyEnergySource.cc
+ *
+ *  Created on: 19.10.2026
+ *
+ *  The attributes and the threshold handling have been adopted from basic-energy-source.cc
+ */
+
+#include "ns3/log.h"
+#include "ns3/double.h"
+#include "ns3/simulator.h"
+#include "ns3/trace-source-accessor.h"
+
+#include "LazyEnergySource.h"
+
+namespace ns3
+{
+	NS_LOG_COMPONENT_DEFINE("LazyEnergySource");
+	NS_OBJECT_ENSURE_REGISTERED(LazyEnergySource);
+
+	LazyEnergySource::LazyEnergySource()
+	{
+		this->depleted = false;
+		this->initialEnergyJ = 0;
+		this->supplyVoltageV = 0;
+		this->lowBatteryTh = 0;
+		this->highBatteryTh = 0;
+		this->remainingEnergyJ = 0;
+		this->nUpdates = 0;
+	}
+
+	LazyEnergySource::~LazyEnergySource()
+	{
+	}
+
+	TypeId LazyEnergySource::GetTypeId()
+	{
+		static TypeId tid = TypeId("ns3::LazyEnergySource")
+								.SetParent<EnergySource>()
+								.SetGroupName("Energy")
+								.AddConstructor<LazyEnergySource>()
+								.AddAttribute("LazyEnergySourceInitialEnergyJ", "Initial energy stored in the energy source.",
+											  DoubleValue(10),
+											  MakeDoubleAccessor(&LazyEnergySource::SetInitialEnergy, &LazyEnergySource::GetInitialEnergy),
+											  MakeDoubleChecker<double>())
+								.AddAttribute("LazyEnergySupplyVoltageV", "Initial supply voltage for the energy source.",
+											  DoubleValue(3.0),
+											  MakeDoubleAccessor(&LazyEnergySource::SetSupplyVoltage, &LazyEnergySource::GetSupplyVoltage),
+											  MakeDoubleChecker<double>())
+								.AddAttribute("LazyEnergyLowBatteryThreshold", "Low battery threshold for the energy source.",
+											  DoubleValue(0.10),
+											  MakeDoubleAccessor(&LazyEnergySource::lowBatteryTh),
+											  MakeDoubleChecker<double>())
+								.AddAttribute("LazyEnergyHighBatteryThreshold", "High battery threshold for the energy source.",
+											  DoubleValue(0.15),
+											  MakeDoubleAccessor(&LazyEnergySource::highBatteryTh),
+											  MakeDoubleChecker<double>())
+								.AddTraceSource("RemainingEnergy", "Remaining energy at LazyEnergySource.",
+												MakeTraceSourceAccessor(&LazyEnergySource::remainingEnergyJ),
+												"ns3::TracedValueCallback::Double");
+		return tid;
+	}
+
+	TypeId LazyEnergySource::GetInstanceTypeId() const
+	{
+		return GetTypeId();
+	}
+
+	void LazyEnergySource::SetInitialEnergy(double initialEnergyJ)
+	{
+		NS_ASSERT(initialEnergyJ >= 0);
+		this->initialEnergyJ = initialEnergyJ;
+		this->remainingEnergyJ = initialEnergyJ;
+	}
+
+	void LazyEnergySource::SetSupplyVoltage(double supplyVoltageV)
+	{
+		this->supplyVoltageV = supplyVoltageV;
+	}
+
+	double LazyEnergySource::GetInitialEnergy() const
+	{
+		return this->initialEnergyJ;
+	}
+
+	double LazyEnergySource::GetSupplyVoltage() const
+	{
+		return this->supplyVoltageV;
+	}
+
+	double LazyEnergySource::GetRemainingEnergy()
+	{
+		this->UpdateEnergySource();
+		return this->remainingEnergyJ;
+	}
+
+	double LazyEnergySource::GetEnergyFraction()
+	{
+		this->UpdateEnergySource();
+		return this->remainingEnergyJ / this->initialEnergyJ;
+	}
+
+	uint64_t LazyEnergySource::getNUpdates()
+	{
+		return this->nUpdates;
+	}
+
+	/*
+	 * Integrates the current of all device energy models since the last update.
+	 * Unlike the BasicEnergySource no event is (re)scheduled here.
+	 */
+	void LazyEnergySource::UpdateEnergySource()
+	{
+		//Nothing to integrate if we have already been updated at this point in time
+		if (Simulator::Now() == this->lastUpdateTime)
+			return;
+
+		this->calculateRemainingEnergy();
+		this->lastUpdateTime = Simulator::Now();
+		this->nUpdates++;
+
+		if (!this->depleted && this->remainingEnergyJ <= this->lowBatteryTh * this->initialEnergyJ)
+		{
+			NS_LOG_DEBUG("LazyEnergySource: Energy depleted at " << Simulator::Now());
+			this->depleted = true;
+			this->NotifyEnergyDrained();
+		}
+		else if (this->depleted && this->remainingEnergyJ > this->highBatteryTh * this->initialEnergyJ)
+		{
+			NS_LOG_DEBUG("LazyEnergySource: Energy recharged at " << Simulator::Now());
+			this->depleted = false;
+			this->NotifyEnergyRecharged();
+		}
+	}
+
+	void LazyEnergySource::DoInitialize()
+	{
+		this->lastUpdateTime = Simulator::Now();
+	}
+
+	void LazyEnergySource::DoDispose()
+	{
+		this->BreakDeviceEnergyModelRefCycle();
+	}
+
+	//Same formula as BasicEnergySource::CalculateRemainingEnergy
+	void LazyEnergySource::calculateRemainingEnergy()
+	{
+		double totalCurrentA = this->CalculateTotalCurrent();
+		Time duration = Simulator::Now() - this->lastUpdateTime;
+		NS_ASSERT(duration.IsPositive());
+
+		double energyToDecreaseJ = (totalCurrentA * this->supplyVoltageV * duration.GetNanoSeconds()) / 1e9;
+		NS_ASSERT(this->remainingEnergyJ >= energyToDecreaseJ);
+		this->remainingEnergyJ -= energyToDecreaseJ;
+
+		NS_LOG_DEBUG("LazyEnergySource: Remaining energy = " << this->remainingEnergyJ << "J");
+	}
+}
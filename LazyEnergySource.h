@@ -0,0 +1,66 @@
+/*
+ * LazyEnergySource.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#ifndef BROADCAST_LAZYENERGYSOURCE_H_
+#define BROADCAST_LAZYENERGYSOURCE_H_
+
+#include "ns3/nstime.h"
+#include "ns3/traced-value.h"
+#include "ns3/energy-source.h"
+
+namespace ns3
+{
+	/*
+	 * Energy source without a periodic update event.
+	 *
+	 * The BasicEnergySource reschedules its update event on every query of
+	 * the remaining energy. This source only integrates the drawn current
+	 * if a device energy model reports a state change (UpdateEnergySource)
+	 * or if the remaining energy is queried. Since the total current is
+	 * constant between two state changes, the consumed energy is the same.
+	 *
+	 * Depletion and recharge are detected on the next update instead of the
+	 * next periodic event.
+	 */
+	class LazyEnergySource : public EnergySource
+	{
+	public:
+		LazyEnergySource();
+		virtual ~LazyEnergySource();
+
+		static TypeId GetTypeId();
+		virtual TypeId GetInstanceTypeId() const;
+
+		virtual double GetInitialEnergy() const;
+		virtual double GetSupplyVoltage() const;
+		virtual double GetRemainingEnergy();
+		virtual double GetEnergyFraction();
+		virtual void UpdateEnergySource();
+
+		void SetInitialEnergy(double initialEnergyJ);
+		void SetSupplyVoltage(double supplyVoltageV);
+
+		uint64_t getNUpdates();
+
+	private:
+		virtual void DoInitialize();
+		virtual void DoDispose();
+
+		void calculateRemainingEnergy();
+
+		bool depleted;
+		double initialEnergyJ;
+		double supplyVoltageV;
+		double lowBatteryTh;
+		double highBatteryTh;
+		TracedValue<double> remainingEnergyJ;
+
+		Time lastUpdateTime;
+		uint64_t nUpdates;
+	};
+}
+
+#endif /* BROADCAST_LAZYENERGYSOURCE_H_ */
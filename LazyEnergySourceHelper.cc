@@ -0,0 +1,34 @@
+/*
+ * LazyEnergySourceHelper.cc
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include "LazyEnergySource.h"
+#include "LazyEnergySourceHelper.h"
+
+namespace ns3
+{
+	LazyEnergySourceHelper::LazyEnergySourceHelper()
+	{
+		this->factory.SetTypeId("ns3::LazyEnergySource");
+	}
+
+	LazyEnergySourceHelper::~LazyEnergySourceHelper()
+	{
+	}
+
+	void LazyEnergySourceHelper::Set(std::string name, const AttributeValue &v)
+	{
+		this->factory.Set(name, v);
+	}
+
+	Ptr<EnergySource> LazyEnergySourceHelper::DoInstall(Ptr<Node> node) const
+	{
+		NS_ASSERT(node != 0);
+		Ptr<EnergySource> energySource = this->factory.Create<EnergySource>();
+		NS_ASSERT(energySource != 0);
+		energySource->SetNode(node);
+		return energySource;
+	}
+}
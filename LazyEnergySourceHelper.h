@@ -0,0 +1,31 @@
+/*
+ * LazyEnergySourceHelper.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#ifndef BROADCAST_LAZYENERGYSOURCEHELPER_H_
+#define BROADCAST_LAZYENERGYSOURCEHELPER_H_
+
+#include "ns3/node.h"
+#include "ns3/object-factory.h"
+#include "ns3/energy-model-helper.h"
+
+namespace ns3
+{
+	class LazyEnergySourceHelper : public EnergySourceHelper
+	{
+	public:
+		LazyEnergySourceHelper();
+		virtual ~LazyEnergySourceHelper();
+
+		void Set(std::string name, const AttributeValue &v);
+
+	private:
+		virtual Ptr<EnergySource> DoInstall(Ptr<Node> node) const;
+
+		ObjectFactory factory;
+	};
+}
+
+#endif /* BROADCAST_LAZYENERGYSOURCEHELPER_H_ */
@@ -6,6 +6,7 @@
  */
 
 #include "LockEvent.h"
+#include "EEBTPProfiler.h"
 #include "ns3/log.h"
 
 namespace ns3
@@ -25,6 +26,7 @@ namespace ns3
 
 	void LockEvent::Notify()
 	{
+		EEBTP_PROFILE_SCOPE("LockEvent::Notify");
 		this->prot->Send(this->gs, this->recipient, this->originator, this->newOriginator, this->unused);
 		this->counter++;
 	}
@@ -0,0 +1,175 @@
+/*
+ * MemoryMonitor.cc
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include "algorithm"
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+#include "EEBTProtocol.h"
+#include "MemoryMonitor.h"
+
+namespace ns3
+{
+	NS_LOG_COMPONENT_DEFINE("MemoryMonitor");
+	NS_OBJECT_ENSURE_REGISTERED(MemoryMonitor);
+
+	MemoryMonitor::MemoryMonitor()
+	{
+		this->peakTotal = 0;
+	}
+
+	MemoryMonitor::~MemoryMonitor()
+	{
+	}
+
+	TypeId MemoryMonitor::GetTypeId()
+	{
+		static TypeId tid = TypeId("ns3::MemoryMonitor").SetParent<Object>().AddConstructor<MemoryMonitor>();
+		return tid;
+	}
+
+	TypeId MemoryMonitor::GetInstanceTypeId() const
+	{
+		return GetTypeId();
+	}
+
+	void MemoryMonitor::DoDispose()
+	{
+		Simulator::Cancel(this->sampleEvent);
+		this->devices = NetDeviceContainer();
+		Object::DoDispose();
+	}
+
+	//An interval of 0 only collects at the end of the run
+	void MemoryMonitor::setup(NetDeviceContainer devices, Time interval)
+	{
+		this->devices = devices;
+		this->interval = interval;
+
+		this->nodeIds.clear();
+		for (NetDeviceContainer::Iterator i = this->devices.Begin(); i != this->devices.End(); i++)
+			this->nodeIds.push_back((*i)->GetNode()->GetId());
+	}
+
+	/*
+	 * Starts the sampling, 'limit' is the time limit of the simulation
+	 */
+	void MemoryMonitor::start(Time limit)
+	{
+		this->limit = limit;
+		this->nodeUsage.assign(this->nodeIds.size(), MemoryUsage());
+		this->nodePeak.assign(this->nodeIds.size(), MemoryUsage());
+		this->peak = MemoryUsage();
+		this->peakTotal = 0;
+		this->samples.clear();
+
+		if (this->interval.IsStrictlyPositive())
+			this->sampleEvent = Simulator::Schedule(this->interval, &MemoryMonitor::sample, this);
+	}
+
+	/*
+	 * Collects the memory at the end of the run
+	 */
+	void MemoryMonitor::finish()
+	{
+		Simulator::Cancel(this->sampleEvent);
+		MemoryUsage total = this->collect();
+		if (this->interval.IsStrictlyPositive() && (this->samples.empty() || this->samples.back().time < Now()))
+		{
+			Sample s;
+			s.time = Now();
+			s.usage = total;
+			this->samples.push_back(s);
+		}
+	}
+
+	void MemoryMonitor::sample()
+	{
+		Sample s;
+		s.time = Now();
+		s.usage = this->collect();
+		this->samples.push_back(s);
+
+		if (Now() + this->interval < this->limit)
+			this->sampleEvent = Simulator::Schedule(this->interval, &MemoryMonitor::sample, this);
+	}
+
+	//Collects the current memory of every node, updates the peaks and returns the sum
+	MemoryUsage MemoryMonitor::collect()
+	{
+		MemoryUsage total;
+		uint32_t n = 0;
+		for (NetDeviceContainer::Iterator i = this->devices.Begin(); i != this->devices.End(); i++, n++)
+		{
+			MemoryUsage usage;
+			Ptr<EEBTProtocol> proto = (*i)->GetObject<EEBTProtocol>();
+			if (proto != 0)
+				proto->getMemoryUsage(usage);
+
+			this->nodeUsage[n] = usage;
+			for (uint32_t m = 0; m < MemoryUsage::N_MODULES; m++)
+			{
+				this->nodePeak[n].bytes[m] = std::max(this->nodePeak[n].bytes[m], usage.bytes[m]);
+				total.bytes[m] += usage.bytes[m];
+			}
+		}
+
+		for (uint32_t m = 0; m < MemoryUsage::N_MODULES; m++)
+			this->peak.bytes[m] = std::max(this->peak.bytes[m], total.bytes[m]);
+		this->peakTotal = std::max(this->peakTotal, total.getTotal());
+		return total;
+	}
+
+	uint32_t MemoryMonitor::getNNodes()
+	{
+		return this->nodeIds.size();
+	}
+
+	uint32_t MemoryMonitor::getNodeId(uint32_t i)
+	{
+		return this->nodeIds[i];
+	}
+
+	MemoryUsage MemoryMonitor::getNodeUsage(uint32_t i)
+	{
+		return this->nodeUsage[i];
+	}
+
+	MemoryUsage MemoryMonitor::getNodePeak(uint32_t i)
+	{
+		return this->nodePeak[i];
+	}
+
+	//Sum over all nodes at the end of the run
+	MemoryUsage MemoryMonitor::getUsage()
+	{
+		MemoryUsage total;
+		for (const MemoryUsage &usage : this->nodeUsage)
+		{
+			for (uint32_t m = 0; m < MemoryUsage::N_MODULES; m++)
+				total.bytes[m] += usage.bytes[m];
+		}
+		return total;
+	}
+
+	//Peak of the sum over all nodes, per module
+	MemoryUsage MemoryMonitor::getPeak()
+	{
+		return this->peak;
+	}
+
+	//Peak of the sum over all nodes and modules, the modules may peak at different times
+	uint64_t MemoryMonitor::getPeakTotal()
+	{
+		return this->peakTotal;
+	}
+
+	std::vector<MemoryMonitor::Sample> MemoryMonitor::getSamples()
+	{
+		return this->samples;
+	}
+}
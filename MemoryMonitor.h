@@ -0,0 +1,81 @@
+/*
+ * MemoryMonitor.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#ifndef BROADCAST_MEMORYMONITOR_H_
+#define BROADCAST_MEMORYMONITOR_H_
+
+#include "vector"
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/net-device-container.h"
+
+#include "MemoryUsage.h"
+
+namespace ns3
+{
+	/*
+	 * Collects the estimated memory of the EEBTP state of every node (see
+	 * MemoryUsage.h), per node and summed over the simulation.
+	 *
+	 * Without an interval the memory is only collected by finish() at the end
+	 * of the run. With an interval it is also collected every 'interval': the
+	 * sums are kept as a series and the peaks are the maximum of all
+	 * collections, so a peak between two samples is missed.
+	 */
+	class MemoryMonitor : public Object
+	{
+	public:
+		struct Sample
+		{
+			Time time;
+			MemoryUsage usage;
+		};
+
+		MemoryMonitor();
+		virtual ~MemoryMonitor();
+
+		static TypeId GetTypeId();
+		virtual TypeId GetInstanceTypeId() const;
+
+		void setup(NetDeviceContainer devices, Time interval);
+		void start(Time limit);
+		void finish();
+
+		uint32_t getNNodes();
+		uint32_t getNodeId(uint32_t i);
+		MemoryUsage getNodeUsage(uint32_t i);
+		MemoryUsage getNodePeak(uint32_t i);
+
+		MemoryUsage getUsage();
+		MemoryUsage getPeak();
+		uint64_t getPeakTotal();
+
+		std::vector<Sample> getSamples();
+
+	private:
+		NetDeviceContainer devices;
+		Time interval;
+		Time limit;
+
+		std::vector<uint32_t> nodeIds;
+		std::vector<MemoryUsage> nodeUsage;
+		std::vector<MemoryUsage> nodePeak;
+		MemoryUsage peak;
+		uint64_t peakTotal;
+
+		std::vector<Sample> samples;
+		EventId sampleEvent;
+
+		void sample();
+		MemoryUsage collect();
+
+		virtual void DoDispose();
+	};
+}
+
+#endif /* BROADCAST_MEMORYMONITOR_H_ */
@@ -0,0 +1,49 @@
+/*
+ * MemoryUsage.cc
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include "MemoryUsage.h"
+
+namespace ns3
+{
+	MemoryUsage::MemoryUsage()
+	{
+		for (uint32_t m = 0; m < MemoryUsage::N_MODULES; m++)
+			this->bytes[m] = 0;
+	}
+
+	uint64_t MemoryUsage::getTotal() const
+	{
+		uint64_t total = 0;
+		for (uint32_t m = 0; m < MemoryUsage::N_MODULES; m++)
+			total += this->bytes[m];
+		return total;
+	}
+
+	const char *MemoryUsage::getModuleName(uint32_t module)
+	{
+		switch (module)
+		{
+		case MemoryUsage::NEIGHBORS:
+			return "neighbors";
+		case MemoryUsage::CHILDREN:
+			return "children";
+		case MemoryUsage::BLACKLIST:
+			return "blacklist";
+		case MemoryUsage::FRAME_TYPE_CACHE:
+			return "frame_type_cache";
+		case MemoryUsage::SEQ_NO_CACHE:
+			return "seq_no_cache";
+		case MemoryUsage::PACKET_MANAGER:
+			return "packet_manager";
+		case MemoryUsage::CYCLES:
+			return "cycles";
+		case MemoryUsage::APPLICATION_DATA:
+			return "application_data";
+		default:
+			return "unknown";
+		}
+	}
+}
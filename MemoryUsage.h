@@ -0,0 +1,88 @@
+/*
+ * MemoryUsage.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#ifndef BROADCAST_MEMORYUSAGE_H_
+#define BROADCAST_MEMORYUSAGE_H_
+
+#include "map"
+#include "set"
+#include "vector"
+#include "cstdint"
+
+namespace ns3
+{
+	/*
+	 * Estimated memory of the protocol state of one node, split by module,
+	 * without ns-3 dependencies. The modules add their bytes with
+	 * getMemoryUsage(MemoryUsage &usage).
+	 *
+	 * The bytes are estimated from the containers: the elements of a vector
+	 * (capacity), a node header plus the element of a map or set, and what
+	 * the elements own themselves. Allocator overhead is not included.
+	 */
+	class MemoryUsage
+	{
+	public:
+		enum MODULE
+		{
+			NEIGHBORS = 0,		  //GameState: neighbor list and the EEBTPNodes
+			CHILDREN = 1,		  //GameState: child list (the nodes are neighbors)
+			BLACKLIST = 2,		  //GameState
+			FRAME_TYPE_CACHE = 3, //GameState
+			SEQ_NO_CACHE = 4,	  //SeqNoCache
+			PACKET_MANAGER = 5,	  //EEBTPPacketManager: per frame and per game maps
+			CYCLES = 6,			  //CycleWatchDog: cycle lists of the node
+			APPLICATION_DATA = 7, //ApplicationDataHandler
+			N_MODULES = 8
+		};
+
+		//libstdc++: color and three pointers per node of a map or set
+		static const uint64_t TREE_NODE_SIZE = 32;
+
+		MemoryUsage();
+
+		uint64_t bytes[N_MODULES];
+
+		uint64_t getTotal() const;
+		static const char *getModuleName(uint32_t module);
+
+		//Elements without own memory
+		template <typename T>
+		static uint64_t getBytes(const T &)
+		{
+			return 0;
+		}
+
+		template <typename T>
+		static uint64_t getBytes(const std::vector<T> &v)
+		{
+			uint64_t b = v.capacity() * sizeof(T);
+			for (const T &e : v)
+				b += MemoryUsage::getBytes(e);
+			return b;
+		}
+
+		template <typename T>
+		static uint64_t getBytes(const std::set<T> &s)
+		{
+			uint64_t b = s.size() * (TREE_NODE_SIZE + sizeof(T));
+			for (const T &e : s)
+				b += MemoryUsage::getBytes(e);
+			return b;
+		}
+
+		template <typename K, typename V>
+		static uint64_t getBytes(const std::map<K, V> &m)
+		{
+			uint64_t b = m.size() * (TREE_NODE_SIZE + sizeof(typename std::map<K, V>::value_type));
+			for (const typename std::map<K, V>::value_type &e : m)
+				b += MemoryUsage::getBytes(e.first) + MemoryUsage::getBytes(e.second);
+			return b;
+		}
+	};
+}
+
+#endif /* BROADCAST_MEMORYUSAGE_H_ */
@@ -9,6 +9,8 @@
 #include "ns3/core-module.h"
 
 #include "Mutex_SendEvent.h"
+#include "EEBTPProfiler.h"
+#include "EEBTPCausalGraph.h"
 
 namespace ns3
 {
@@ -32,6 +34,9 @@ namespace ns3
 
 	void MutexSendEvent::Notify()
 	{
+		EEBTP_PROFILE_SCOPE("MutexSendEvent::Notify");
+		if (EEBTPCausalGraph::isEnabled())
+			EEBTPCausalGraph::onTimerFired(Now().GetNanoSeconds(), this->prot->GetDevice()->GetNode()->GetId(), this);
 		this->prot->Send(this->gs, this->recipient, this->originator, this->newOriginator, this->unused, this->seqNo, this->txPower, this);
 		this->counter++;
 	}
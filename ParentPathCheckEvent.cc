@@ -7,6 +7,8 @@
 
 #include "ns3/log.h"
 #include "ParentPathCheckEvent.h"
+#include "EEBTPProfiler.h"
+#include "EEBTPCausalGraph.h"
 
 namespace ns3
 {
@@ -22,6 +24,9 @@ namespace ns3
 
 	void ParentPathCheckEvent::Notify()
 	{
+		EEBTP_PROFILE_SCOPE("ParentPathCheckEvent::Notify");
+		if (EEBTPCausalGraph::isEnabled())
+			EEBTPCausalGraph::onTimerFired(Now().GetNanoSeconds(), this->prot->GetDevice()->GetNode()->GetId(), this);
 		this->prot->checkParentPathStatus(this->gs);
 	}
 }
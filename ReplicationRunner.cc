@@ -0,0 +1,175 @@
+/*
+ * ReplicationRunner.cc
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include "fstream"
+#include "cstdio"
+#include "cstdlib"
+#include "iostream"
+#include "cerrno"
+
+#include "fcntl.h"
+#include "unistd.h"
+#include "sys/wait.h"
+
+#include "ReplicationRunner.h"
+
+namespace ns3
+{
+	ReplicationRunner::ReplicationRunner(uint32_t nJobs)
+	{
+		this->nJobs = (nJobs == 0) ? 1 : nJobs;
+	}
+
+	ReplicationRunner::~ReplicationRunner()
+	{
+	}
+
+	uint32_t ReplicationRunner::getNJobs()
+	{
+		return this->nJobs;
+	}
+
+	/*
+	 * Runs the job for all indices and returns false if a worker failed
+	 * (exit code != 0 or killed by a signal). The output of a failed worker is
+	 * copied as well, the remaining replications are still run. Any child of
+	 * the process is waited for, other children than the workers are
+	 * reported and skipped.
+	 */
+	bool ReplicationRunner::run(std::vector<int> indices, Job job)
+	{
+		std::vector<Worker> workers(indices.size());
+		for (uint32_t i = 0; i < indices.size(); i++)
+		{
+			workers[i].index = indices[i];
+			workers[i].pid = -1;
+			workers[i].done = false;
+			workers[i].failed = false;
+		}
+
+		uint32_t next = 0, printed = 0, running = 0;
+		bool ok = true;
+		while (printed < workers.size())
+		{
+			while (running < this->nJobs && next < workers.size())
+			{
+				this->start(workers[next++], job);
+				running++;
+			}
+
+			int status = 0;
+			pid_t pid = waitpid(-1, &status, 0);
+			if (pid < 0)
+			{
+				if (errno == EINTR)
+					continue;
+				std::perror("waitpid");
+				std::exit(1);
+			}
+
+			Worker *finished = 0;
+			for (Worker &worker : workers)
+			{
+				if (worker.pid == pid && !worker.done)
+				{
+					finished = &worker;
+					break;
+				}
+			}
+
+			//A child the caller started before, its status is lost to it now
+			if (finished == 0)
+			{
+				std::cerr << "ReplicationRunner: reaped process " << pid << " which is not a worker" << std::endl;
+				continue;
+			}
+
+			finished->done = true;
+			finished->failed = !WIFEXITED(status) || WEXITSTATUS(status) != 0;
+			running--;
+
+			//Copy the output in the order of the replications
+			while (printed < workers.size() && workers[printed].done)
+			{
+				this->finish(workers[printed]);
+				ok = ok && !workers[printed].failed;
+				printed++;
+			}
+		}
+		return ok;
+	}
+
+	void ReplicationRunner::start(Worker &worker, Job job)
+	{
+		worker.out = ReplicationRunner::createTempFile();
+		worker.err = ReplicationRunner::createTempFile();
+
+		//Do not write buffered output twice
+		std::cout.flush();
+		std::clog.flush();
+		std::fflush(0);
+
+		worker.pid = fork();
+		if (worker.pid < 0)
+		{
+			std::perror("fork");
+			std::exit(1);
+		}
+		if (worker.pid > 0)
+			return;
+
+		//Child: redirect stdout and stderr, run the job and leave without running the destructors of the parent
+		int out = open(worker.out.c_str(), O_WRONLY | O_TRUNC);
+		int err = open(worker.err.c_str(), O_WRONLY | O_TRUNC);
+		if (out < 0 || err < 0 || dup2(out, STDOUT_FILENO) < 0 || dup2(err, STDERR_FILENO) < 0)
+			_exit(2);
+		close(out);
+		close(err);
+
+		job(worker.index);
+
+		std::cout.flush();
+		std::clog.flush();
+		std::fflush(0);
+		_exit(0);
+	}
+
+	void ReplicationRunner::finish(Worker &worker)
+	{
+		std::ifstream out(worker.out.c_str());
+		if (out.peek() != std::ifstream::traits_type::eof())
+			std::cout << out.rdbuf();
+		std::cout.flush();
+
+		std::ifstream err(worker.err.c_str());
+		if (err.peek() != std::ifstream::traits_type::eof())
+			std::clog << err.rdbuf();
+		std::clog.flush();
+
+		if (worker.failed)
+			std::cerr << "Replication " << worker.index << " failed" << std::endl;
+
+		std::remove(worker.out.c_str());
+		std::remove(worker.err.c_str());
+	}
+
+	std::string ReplicationRunner::createTempFile()
+	{
+		const char *dir = std::getenv("TMPDIR");
+		std::string path = std::string((dir != 0) ? dir : "/tmp") + "/brdcst-XXXXXX";
+
+		std::vector<char> name(path.begin(), path.end());
+		name.push_back('\0');
+		int fd = mkstemp(name.data());
+		if (fd < 0)
+		{
+			std::perror("mkstemp");
+			std::exit(1);
+		}
+		close(fd);
+		return std::string(name.data());
+	}
+}
@@ -0,0 +1,62 @@
+/*
+ * ReplicationRunner.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#ifndef BROADCAST_REPLICATIONRUNNER_H_
+#define BROADCAST_REPLICATIONRUNNER_H_
+
+#include "string"
+#include "vector"
+#include "cstdint"
+#include "functional"
+#include "sys/types.h"
+
+namespace ns3
+{
+	/*
+	 * Runs replications in forked worker processes.
+	 *
+	 * run() forks one process per replication, at most 'nJobs' at a time. The
+	 * stdout and stderr of a worker are written to temporary files which are
+	 * copied to our stdout and stderr in the order of the replications, as soon
+	 * as all earlier replications are done. So the output looks like the one of
+	 * a serial run.
+	 *
+	 * The job is called in the child process, nothing it changes is visible in
+	 * the parent. Fork before the first simulation: the parent must not have
+	 * started threads (e.g. the WorkerPool of the GridYansWifiChannel).
+	 */
+	class ReplicationRunner
+	{
+	public:
+		typedef std::function<void(int index)> Job;
+
+		ReplicationRunner(uint32_t nJobs);
+		virtual ~ReplicationRunner();
+
+		uint32_t getNJobs();
+		bool run(std::vector<int> indices, Job job);
+
+	private:
+		struct Worker
+		{
+			int index;
+			pid_t pid;
+			std::string out;
+			std::string err;
+			bool done;
+			bool failed;
+		};
+
+		uint32_t nJobs;
+
+		void start(Worker &worker, Job job);
+		void finish(Worker &worker);
+
+		static std::string createTempFile();
+	};
+}
+
+#endif /* BROADCAST_REPLICATIONRUNNER_H_ */
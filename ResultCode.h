@@ -0,0 +1,48 @@
+/*
+ * ResultCode.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#ifndef BROADCAST_RESULTCODE_H_
+#define BROADCAST_RESULTCODE_H_
+
+#include "cstdint"
+
+namespace ns3
+{
+	/*
+	 * Fields of the result code printed by brdcstTest (PrintResult(), "CODE:")
+	 * and kept in the sweep result stores, separated by ';'. The per frame
+	 * type fields hold N_FRAME_TYPES values each, the loss ratios follow at
+	 * the end, one for every depth from 1 on.
+	 */
+	class ResultCode
+	{
+	public:
+		static const uint32_t N_FRAME_TYPES = 8;
+
+		enum FIELD
+		{
+			TOTAL_ENERGY = 0,			 //J
+			CONSTRUCTION_ENERGY = 1,	 //J
+			APPLICATION_ENERGY = 2,		 //J
+			TX_POWER = 3,				 //W, configured TX power of all nodes
+			TIME_TO_BUILD_INITIATOR = 4, //ns, until the initiator finished
+			MAX_TIME_TO_BUILD = 5,		 //ns, until the last node finished
+			TREE_DEPTH = 6,
+			UNCONNECTED_NODES = 7,
+			CYCLES = 8,
+			CYCLES_LASTED = 9,
+			ENERGY_PER_FRAME_RECV = 10,
+			ENERGY_PER_FRAME_SENT = ENERGY_PER_FRAME_RECV + N_FRAME_TYPES,
+			DATA_PER_FRAME_RECV = ENERGY_PER_FRAME_SENT + N_FRAME_TYPES,
+			DATA_PER_FRAME_SENT = DATA_PER_FRAME_RECV + N_FRAME_TYPES,
+			PACKETS_PER_FRAME_RECV = DATA_PER_FRAME_SENT + N_FRAME_TYPES,
+			PACKETS_PER_FRAME_SENT = PACKETS_PER_FRAME_RECV + N_FRAME_TYPES,
+			LOSS_PER_DEPTH = PACKETS_PER_FRAME_SENT + N_FRAME_TYPES
+		};
+	};
+}
+
+#endif /* BROADCAST_RESULTCODE_H_ */
@@ -0,0 +1,176 @@
+/*
+ * ResultWriter.cc
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include "cstdio"
+#include "cstdlib"
+#include "fstream"
+
+#include "fcntl.h"
+#include "unistd.h"
+
+#include "ResultWriter.h"
+
+namespace ns3
+{
+	//Rows are written once the buffer is larger, independent of flush()
+	static const size_t FLUSH_SIZE = 1 << 20;
+
+	ResultWriter::ResultWriter()
+	{
+		this->nColumns = 0;
+		this->column = 0;
+	}
+
+	ResultWriter::~ResultWriter()
+	{
+		this->close();
+	}
+
+	/*
+	 * Opens the table for appending, returns false if it can not be opened or
+	 * has another header
+	 */
+	bool ResultWriter::open(std::string fileName, std::vector<std::string> columns)
+	{
+		this->close();
+
+		std::string header;
+		for (uint32_t i = 0; i < columns.size(); i++)
+			header += (i > 0 ? "," : "") + columns[i];
+		header += "\n";
+
+		std::string existing;
+		std::ifstream in(fileName.c_str());
+		if (in.is_open())
+			std::getline(in, existing);
+		in.close();
+
+		if (existing.empty())
+		{
+			int fd = ::open(fileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+			if (fd < 0)
+				return false;
+			bool ok = write(fd, header.data(), header.size()) == (ssize_t)header.size();
+			ok = (::close(fd) == 0) && ok;
+			if (!ok)
+				return false;
+		}
+		else if (existing + "\n" != header)
+			return false;
+
+		this->fileName = fileName;
+		this->nColumns = columns.size();
+		this->column = 0;
+		this->row.clear();
+		this->buffer.clear();
+		return true;
+	}
+
+	bool ResultWriter::isOpen()
+	{
+		return !this->fileName.empty();
+	}
+
+	void ResultWriter::close()
+	{
+		if (!this->isOpen())
+			return;
+
+		this->flush();
+		this->fileName.clear();
+	}
+
+	void ResultWriter::addField(const std::string &field)
+	{
+		if (this->column > 0)
+			this->row += ",";
+		this->row += field;
+		this->column++;
+	}
+
+	//Strings are quoted if needed
+	void ResultWriter::add(std::string value)
+	{
+		if (value.find_first_of(",\"\n") == std::string::npos)
+		{
+			this->addField(value);
+			return;
+		}
+
+		std::string quoted = "\"";
+		for (char c : value)
+		{
+			if (c == '"')
+				quoted += '"';
+			quoted += c;
+		}
+		this->addField(quoted + "\"");
+	}
+
+	void ResultWriter::add(double value)
+	{
+		char str[32];
+		std::snprintf(str, sizeof(str), "%.12g", value);
+		this->addField(str);
+	}
+
+	void ResultWriter::add(uint64_t value)
+	{
+		this->addField(std::to_string(value));
+	}
+
+	void ResultWriter::add(int64_t value)
+	{
+		this->addField(std::to_string(value));
+	}
+
+	void ResultWriter::add(uint32_t value)
+	{
+		this->addField(std::to_string(value));
+	}
+
+	void ResultWriter::add(int32_t value)
+	{
+		this->addField(std::to_string(value));
+	}
+
+	/*
+	 * Missing columns are left empty, a row with too many columns is a bug
+	 */
+	void ResultWriter::endRow()
+	{
+		if (this->column > this->nColumns)
+		{
+			std::fprintf(stderr, "ResultWriter: row with %u of %u columns in %s\n", this->column, this->nColumns, this->fileName.c_str());
+			std::abort();
+		}
+		for (; this->column < this->nColumns; this->column++)
+			this->row += ",";
+
+		this->buffer += this->row;
+		this->buffer += "\n";
+		this->row.clear();
+		this->column = 0;
+
+		if (this->buffer.size() >= FLUSH_SIZE)
+			this->flush();
+	}
+
+	bool ResultWriter::flush()
+	{
+		if (!this->isOpen() || this->buffer.empty())
+			return true;
+
+		int fd = ::open(this->fileName.c_str(), O_WRONLY | O_APPEND);
+		if (fd < 0)
+			return false;
+
+		bool ok = write(fd, this->buffer.data(), this->buffer.size()) == (ssize_t)this->buffer.size();
+		ok = (::close(fd) == 0) && ok;
+		this->buffer.clear();
+		return ok;
+	}
+}
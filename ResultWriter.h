@@ -0,0 +1,58 @@
+/*
+ * ResultWriter.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#ifndef BROADCAST_RESULTWRITER_H_
+#define BROADCAST_RESULTWRITER_H_
+
+#include "string"
+#include "vector"
+#include "cstdint"
+
+namespace ns3
+{
+	/*
+	 * Buffered CSV table with a header line.
+	 *
+	 * open() appends to the file and writes the header only if the file is
+	 * empty; a file with another header is rejected, so the columns of a file
+	 * never change. Rows are collected in a buffer which is written with one
+	 * write() (O_APPEND) per flush() and only contains complete rows, so forked
+	 * workers can share a table opened before the fork. Workers leave with
+	 * _exit(), hence flush() after every run.
+	 */
+	class ResultWriter
+	{
+	public:
+		ResultWriter();
+		virtual ~ResultWriter();
+
+		bool open(std::string fileName, std::vector<std::string> columns);
+		bool isOpen();
+		void close();
+
+		void add(std::string value);
+		void add(double value);
+		void add(uint64_t value);
+		void add(int64_t value);
+		void add(uint32_t value);
+		void add(int32_t value);
+		void endRow();
+
+		bool flush();
+
+	private:
+		std::string fileName;
+		uint32_t nColumns;
+		uint32_t column;
+
+		std::string row;
+		std::string buffer;
+
+		void addField(const std::string &field);
+	};
+}
+
+#endif /* BROADCAST_RESULTWRITER_H_ */
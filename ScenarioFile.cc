@@ -0,0 +1,346 @@
+/*
+ * ScenarioFile.cc
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include "cstdio"
+#include "cstring"
+#include "fstream"
+#include "sstream"
+#include "algorithm"
+
+#include "fcntl.h"
+#include "unistd.h"
+#include "sys/mman.h"
+#include "sys/stat.h"
+
+#include "ScenarioFile.h"
+
+namespace ns3
+{
+	const uint32_t ScenarioFile::VERSION = 1;
+
+	static_assert(sizeof(ScenarioFile::Node) == 32, "ScenarioFile::Node must not be padded");
+	static_assert(sizeof(ScenarioFile::Link) == 16, "ScenarioFile::Link must not be padded");
+
+	ScenarioFile::ScenarioFile()
+	{
+		this->mapping = 0;
+		this->mappingSize = 0;
+		this->clear();
+	}
+
+	ScenarioFile::~ScenarioFile()
+	{
+		this->clear();
+	}
+
+	void ScenarioFile::clear()
+	{
+		if (this->mapping != 0)
+			munmap(this->mapping, this->mappingSize);
+		this->mapping = 0;
+		this->mappingSize = 0;
+
+		std::memset(&this->header, 0, sizeof(Header));
+		std::memcpy(this->header.magic, "EEBS", 4);
+		this->header.version = ScenarioFile::VERSION;
+
+		this->nodeVector.clear();
+		this->linkVector.clear();
+		this->nodes = 0;
+		this->links = 0;
+	}
+
+	/*
+	 * Loads a binary (mapped) or a text scenario, returns false on an error
+	 * (see getError())
+	 */
+	bool ScenarioFile::load(std::string fileName)
+	{
+		this->clear();
+		this->error = "";
+
+		char magic[4] = {0, 0, 0, 0};
+		std::ifstream in(fileName.c_str(), std::ios::in | std::ios::binary);
+		if (!in.is_open())
+		{
+			this->error = "Cannot open scenario " + fileName;
+			return false;
+		}
+		in.read(magic, 4);
+		in.close();
+
+		bool ok = (std::memcmp(magic, "EEBS", 4) == 0) ? this->map(fileName) : this->parse(fileName);
+		if (!ok)
+			this->clear();
+		return ok;
+	}
+
+	bool ScenarioFile::map(std::string fileName)
+	{
+		int fd = open(fileName.c_str(), O_RDONLY);
+		struct stat st;
+		if (fd < 0 || fstat(fd, &st) != 0)
+		{
+			this->error = "Cannot open scenario " + fileName;
+			if (fd >= 0)
+				close(fd);
+			return false;
+		}
+
+		if ((size_t)st.st_size < sizeof(Header))
+		{
+			close(fd);
+			this->error = "Scenario " + fileName + " is truncated";
+			return false;
+		}
+
+		void *mapping = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		close(fd);
+		if (mapping == MAP_FAILED)
+		{
+			this->error = "Cannot map scenario " + fileName;
+			return false;
+		}
+		this->mapping = mapping;
+		this->mappingSize = st.st_size;
+
+		std::memcpy(&this->header, mapping, sizeof(Header));
+		if (this->header.version != ScenarioFile::VERSION)
+		{
+			this->error = "Scenario " + fileName + " has an unknown version";
+			return false;
+		}
+
+		uint64_t size = sizeof(Header) + (uint64_t)this->header.nNodes * sizeof(Node) + this->header.nLinks * sizeof(Link);
+		if (size != this->mappingSize)
+		{
+			this->error = "Scenario " + fileName + " is truncated";
+			return false;
+		}
+		if (this->header.nNodes > 0 && this->header.initiator >= this->header.nNodes)
+		{
+			this->error = "Scenario " + fileName + " has an invalid initiator";
+			return false;
+		}
+
+		madvise(mapping, this->mappingSize, MADV_WILLNEED);
+
+		this->nodes = reinterpret_cast<const Node *>(static_cast<const char *>(mapping) + sizeof(Header));
+		this->links = reinterpret_cast<const Link *>(this->nodes + this->header.nNodes);
+
+		//Same check as parse(), the users index their node arrays with the links
+		for (uint64_t i = 0; i < this->header.nLinks; i++)
+		{
+			if (this->links[i].sender >= this->header.nNodes || this->links[i].receiver >= this->header.nNodes)
+			{
+				this->error = "Scenario " + fileName + " has a link to an unknown node";
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool ScenarioFile::parse(std::string fileName)
+	{
+		std::ifstream in(fileName.c_str());
+		std::string line;
+		for (uint32_t n = 1; std::getline(in, line); n++)
+		{
+			size_t comment = line.find('#');
+			if (comment != std::string::npos)
+				line.erase(comment);
+
+			std::stringstream str(line);
+			std::string key;
+			if (!(str >> key))
+				continue;
+
+			bool ok = true;
+			if (key == "size")
+			{
+				double width, height;
+				ok = (str >> width >> height) ? true : false;
+				if (ok)
+					this->setSize(width, height);
+			}
+			else if (key == "initiator")
+			{
+				uint32_t initiator;
+				ok = (str >> initiator) ? true : false;
+				if (ok)
+					this->setInitiator(initiator);
+			}
+			else if (key == "node")
+			{
+				double x, y, z = 0, energy = 0;
+				ok = (str >> x >> y) ? true : false;
+				if (ok && (str >> z))
+					str >> energy;
+				if (ok)
+					this->addNode(x, y, z, energy);
+			}
+			else if (key == "link")
+			{
+				uint32_t sender, receiver;
+				double loss;
+				ok = (str >> sender >> receiver >> loss) ? true : false;
+				if (ok)
+					this->addLink(sender, receiver, loss);
+			}
+			else
+				ok = false;
+
+			if (!ok)
+			{
+				std::stringstream msg;
+				msg << fileName << ":" << n << ": invalid line '" << line << "'";
+				this->error = msg.str();
+				return false;
+			}
+		}
+
+		for (const Link &link : this->linkVector)
+		{
+			if (link.sender >= this->header.nNodes || link.receiver >= this->header.nNodes)
+			{
+				this->error = "Scenario " + fileName + " has a link to an unknown node";
+				return false;
+			}
+		}
+		if (this->header.nNodes > 0 && this->header.initiator >= this->header.nNodes)
+		{
+			this->error = "Scenario " + fileName + " has an invalid initiator";
+			return false;
+		}
+
+		this->sortLinks();
+		return true;
+	}
+
+	bool ScenarioFile::save(std::string fileName)
+	{
+		this->sortLinks();
+
+		std::ofstream out(fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!out.is_open())
+		{
+			this->error = "Cannot open scenario " + fileName;
+			return false;
+		}
+
+		out.write(reinterpret_cast<const char *>(&this->header), sizeof(Header));
+		out.write(reinterpret_cast<const char *>(this->nodes), this->header.nNodes * sizeof(Node));
+		out.write(reinterpret_cast<const char *>(this->links), this->header.nLinks * sizeof(Link));
+		out.close();
+
+		if (out.fail())
+			this->error = "Cannot write scenario " + fileName;
+		return !out.fail();
+	}
+
+	void ScenarioFile::setSize(double width, double height)
+	{
+		this->header.width = width;
+		this->header.height = height;
+	}
+
+	void ScenarioFile::setInitiator(uint32_t initiator)
+	{
+		this->header.initiator = initiator;
+	}
+
+	/*
+	 * A mapped scenario is copied before it is changed
+	 */
+	void ScenarioFile::addNode(double x, double y, double z, double energy)
+	{
+		if (this->mapping != 0)
+			this->copyMapping();
+
+		Node node = {x, y, z, energy};
+		this->nodeVector.push_back(node);
+		this->nodes = this->nodeVector.data();
+		this->header.nNodes = this->nodeVector.size();
+	}
+
+	void ScenarioFile::addLink(uint32_t sender, uint32_t receiver, double loss)
+	{
+		if (this->mapping != 0)
+			this->copyMapping();
+
+		Link link = {sender, receiver, (float)loss, 0};
+		this->linkVector.push_back(link);
+		this->links = this->linkVector.data();
+		this->header.nLinks = this->linkVector.size();
+	}
+
+	void ScenarioFile::copyMapping()
+	{
+		this->nodeVector.assign(this->nodes, this->nodes + this->header.nNodes);
+		this->linkVector.assign(this->links, this->links + this->header.nLinks);
+		munmap(this->mapping, this->mappingSize);
+		this->mapping = 0;
+		this->mappingSize = 0;
+		this->nodes = this->nodeVector.data();
+		this->links = this->linkVector.data();
+	}
+
+	void ScenarioFile::sortLinks()
+	{
+		if (this->mapping != 0)
+			return;
+
+		std::sort(this->linkVector.begin(), this->linkVector.end(), [](const Link &a, const Link &b) {
+			return (a.sender != b.sender) ? a.sender < b.sender : a.receiver < b.receiver;
+		});
+		this->links = this->linkVector.data();
+	}
+
+	uint32_t ScenarioFile::getNNodes() const
+	{
+		return this->header.nNodes;
+	}
+
+	const ScenarioFile::Node &ScenarioFile::getNode(uint32_t i) const
+	{
+		return this->nodes[i];
+	}
+
+	uint32_t ScenarioFile::getInitiator() const
+	{
+		return this->header.initiator;
+	}
+
+	double ScenarioFile::getWidth() const
+	{
+		return this->header.width;
+	}
+
+	double ScenarioFile::getHeight() const
+	{
+		return this->header.height;
+	}
+
+	uint64_t ScenarioFile::getNLinks() const
+	{
+		return this->header.nLinks;
+	}
+
+	const ScenarioFile::Link &ScenarioFile::getLink(uint64_t i) const
+	{
+		return this->links[i];
+	}
+
+	bool ScenarioFile::isMapped() const
+	{
+		return this->mapping != 0;
+	}
+
+	std::string ScenarioFile::getError() const
+	{
+		return this->error;
+	}
+}
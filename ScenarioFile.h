@@ -0,0 +1,116 @@
+/*
+ * ScenarioFile.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#ifndef BROADCAST_SCENARIOFILE_H_
+#define BROADCAST_SCENARIOFILE_H_
+
+#include "string"
+#include "vector"
+#include "cstdint"
+#include "cstddef"
+
+namespace ns3
+{
+	/*
+	 * Node placement of a simulation, without ns-3 dependencies.
+	 *
+	 * Binary format (native byte order, all sections 8 byte aligned):
+	 * 	- Header (40 bytes): magic "EEBS", version, number of nodes, initiator,
+	 * 		width and height of the area, number of links
+	 * 	- Node[nNodes] (32 bytes): x, y, z in meters and the initial energy in J
+	 * 		(<= 0: the default of the simulation)
+	 * 	- Link[nLinks] (16 bytes): sender, receiver and the propagation loss in
+	 * 		dB, sorted by sender and receiver. Optional, pairs without a link are
+	 * 		out of range
+	 *
+	 * Binary files are memory-mapped, nothing is copied: getNode() and
+	 * getLink() point into the mapping.
+	 *
+	 * The text format is meant for small hand-written scenarios, one entry per
+	 * line ('#' starts a comment), the nodes are numbered in file order:
+	 * 	size <width> <height>
+	 * 	initiator <node>
+	 * 	node <x> <y> [<z> [<energy>]]
+	 * 	link <sender> <receiver> <loss>
+	 */
+	class ScenarioFile
+	{
+	public:
+		static const uint32_t VERSION;
+
+		struct Node
+		{
+			double x;
+			double y;
+			double z;
+			double energy;
+		};
+
+		struct Link
+		{
+			uint32_t sender;
+			uint32_t receiver;
+			float loss;
+			uint32_t reserved;
+		};
+
+		ScenarioFile();
+		virtual ~ScenarioFile();
+
+		bool load(std::string fileName);
+		bool save(std::string fileName);
+
+		//Building a scenario, e.g. for the text import or a generator
+		void setSize(double width, double height);
+		void setInitiator(uint32_t initiator);
+		void addNode(double x, double y, double z, double energy);
+		void addLink(uint32_t sender, uint32_t receiver, double loss);
+
+		uint32_t getNNodes() const;
+		const Node &getNode(uint32_t i) const;
+		uint32_t getInitiator() const;
+		double getWidth() const;
+		double getHeight() const;
+
+		uint64_t getNLinks() const;
+		const Link &getLink(uint64_t i) const;
+
+		bool isMapped() const;
+		std::string getError() const;
+
+	private:
+		struct Header
+		{
+			char magic[4];
+			uint32_t version;
+			uint32_t nNodes;
+			uint32_t initiator;
+			double width;
+			double height;
+			uint64_t nLinks;
+		};
+
+		Header header;
+		const Node *nodes;
+		const Link *links;
+
+		//Either the mapping or the vectors hold the data
+		void *mapping;
+		size_t mappingSize;
+		std::vector<Node> nodeVector;
+		std::vector<Link> linkVector;
+
+		std::string error;
+
+		void clear();
+		bool map(std::string fileName);
+		bool parse(std::string fileName);
+		void copyMapping();
+		void sortLinks();
+	};
+}
+
+#endif /* BROADCAST_SCENARIOFILE_H_ */
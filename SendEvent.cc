@@ -9,6 +9,8 @@
 #include "ns3/core-module.h"
 
 #include "SendEvent.h"
+#include "EEBTPProfiler.h"
+#include "EEBTPCausalGraph.h"
 
 namespace ns3
 {
@@ -27,6 +29,9 @@ namespace ns3
 
 	void SendEvent::Notify()
 	{
+		EEBTP_PROFILE_SCOPE("SendEvent::Notify");
+		if (EEBTPCausalGraph::isEnabled())
+			EEBTPCausalGraph::onTimerFired(Now().GetNanoSeconds(), this->prot->GetDevice()->GetNode()->GetId(), this);
 		//NS_LOG_UNCOND("[" << Now() << "]: SendEvent fired!");
 		this->prot->Send(this->gs, this->ft, this->recipient, seqNo, this->txPower, this);
 		this->counter++;
@@ -39,4 +39,9 @@ namespace ns3
 	{
 		header->SetSequenceNumber(++this->seqNo);
 	}
+
+	void SeqNoCache::getMemoryUsage(MemoryUsage &usage)
+	{
+		usage.bytes[MemoryUsage::SEQ_NO_CACHE] += MemoryUsage::getBytes(this->cache) + MemoryUsage::getBytes(this->cacheX);
+	}
 }
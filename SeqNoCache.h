@@ -12,6 +12,7 @@
 #include "ns3/mac48-address.h"
 
 #include "EEBTPHeader.h"
+#include "MemoryUsage.h"
 
 namespace ns3
 {
@@ -25,6 +26,8 @@ namespace ns3
 
 		void injectSeqNo(EEBTPHeader *header);
 
+		void getMemoryUsage(MemoryUsage &usage);
+
 	private:
 		uint16_t seqNo;
 		//std::map<Mac48Address,std::pair<std::map<uint16_t, bool>, std::pair<uint16_t, uint16_t>>> cache;
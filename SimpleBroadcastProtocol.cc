@@ -29,11 +29,6 @@ namespace ns3
 	{
 		this->maxTxPower = 23.0;
 
-		this->energyAtStart = 0;
-
-		this->energyRecv = 0;
-		this->energySent = 0;
-
 		this->dataRecv = 0;
 		this->dataSent = 0;
 
@@ -155,14 +150,27 @@ namespace ns3
 		this->packetsSent++;
 	}
 
+	/*
+	 * All frames of this protocol are accounted with game ID 0 and frame type 0
+	 */
 	double SimpleBroadcastProtocol::getRecvEnergy()
 	{
-		return this->energyRecv;
+		return this->energyAttribution->getEnergyByRecvFrame(0, 0);
 	}
 
 	double SimpleBroadcastProtocol::getSentEnergy()
 	{
-		return this->energySent;
+		return this->energyAttribution->getEnergyBySentFrame(0, 0);
+	}
+
+	double SimpleBroadcastProtocol::getIdleEnergy()
+	{
+		return this->energyAttribution->getIdleEnergy();
+	}
+
+	Ptr<EEBTPEnergyAttribution> SimpleBroadcastProtocol::getEnergyAttribution()
+	{
+		return this->energyAttribution;
 	}
 
 	uint32_t SimpleBroadcastProtocol::getRecvPackets()
@@ -198,6 +206,9 @@ namespace ns3
 		this->device = netDevice;
 		this->energySource = this->device->GetNode()->GetObject<EnergySourceContainer>()->Get(0);
 
+		this->energyAttribution = Create<EEBTPEnergyAttribution>();
+		this->energyAttribution->setDevice(this->device);
+
 		Ptr<WifiPhy> wifiPhy = this->device->GetMac()->GetWifiPhy();
 
 		wifiPhy->SetNTxPower(1);
@@ -249,7 +260,7 @@ namespace ns3
 			//If this packet contains EEBTProtocol data
 			if (lhdr.GetType() == SimpleBroadcastProtocol::PROT_NUMBER)
 			{
-				this->energyAtStart = this->energySource->GetRemainingEnergy();
+				this->energyAttribution->setRxFrame(0, 0);
 			}
 		}
 	}
@@ -271,7 +282,6 @@ namespace ns3
 			//If this packet contains EEBTProtocol data
 			if (lhdr.GetType() == SimpleBroadcastProtocol::PROT_NUMBER)
 			{
-				this->energyRecv += (this->energyAtStart - this->energySource->GetRemainingEnergy());
 				this->dataRecv += pkt->GetSize();
 			}
 		}
@@ -282,14 +292,16 @@ namespace ns3
 		EEBTPTag tag;
 		if (packet->PeekPacketTag(tag))
 		{
-			NS_LOG_DEBUG("[Node " << this->device->GetNode()->GetId() << "]: onTxStart() => packetSize = " << packet->GetSize() << ", energy = " << this->energySource->GetRemainingEnergy());
-			this->energyAtStart = this->energySource->GetRemainingEnergy();
+			NS_LOG_DEBUG("[Node " << this->device->GetNode()->GetId() << "]: onTxStart() => packetSize = " << packet->GetSize());
+			this->energyAttribution->setTxFrame(0, 0, WToDbm(txPowerW));
 		}
+		else
+			this->energyAttribution->setTxUnknown(WToDbm(txPowerW));
 	}
 
 	void SimpleBroadcastProtocol::onTxDrop(Ptr<const Packet> packet)
 	{
-		NS_LOG_DEBUG("[Node " << this->device->GetNode()->GetId() << "]: onTxDrop() => packetSize = " << packet->GetSize() << ", energy = " << this->energySource->GetRemainingEnergy());
+		NS_LOG_DEBUG("[Node " << this->device->GetNode()->GetId() << "]: onTxDrop() => packetSize = " << packet->GetSize());
 	}
 
 	void SimpleBroadcastProtocol::onTxEnd(Ptr<const Packet> packet)
@@ -297,9 +309,8 @@ namespace ns3
 		EEBTPTag tag;
 		if (packet->PeekPacketTag(tag))
 		{
-			NS_LOG_DEBUG("[Node " << this->device->GetNode()->GetId() << "]: onTxEnd() => packetSize = " << packet->GetSize() << ", energy = " << (this->energyAtStart - this->energySource->GetRemainingEnergy()) << ", tx = " << this->device->GetPhy()->GetTxPowerEnd() << "dBm");
+			NS_LOG_DEBUG("[Node " << this->device->GetNode()->GetId() << "]: onTxEnd() => packetSize = " << packet->GetSize() << ", tx = " << this->device->GetPhy()->GetTxPowerEnd() << "dBm");
 			this->dataSent += packet->GetSize();
-			this->energySent += (this->energyAtStart - this->energySource->GetRemainingEnergy());
 		}
 	}
 
@@ -17,6 +17,7 @@
 #include "ns3/traffic-control-layer.h"
 
 #include "SimpleBroadcastHeader.h"
+#include "EEBTPEnergyAttribution.h"
 
 namespace ns3
 {
@@ -35,6 +36,8 @@ namespace ns3
 
 		double getRecvEnergy();
 		double getSentEnergy();
+		double getIdleEnergy();
+		Ptr<EEBTPEnergyAttribution> getEnergyAttribution();
 		uint32_t getRecvPackets();
 		uint32_t getSentPackets();
 		uint32_t getUniquePackets();
@@ -64,10 +67,7 @@ namespace ns3
 		double maxTxPower;
 
 		Ptr<EnergySource> energySource;
-		double energyAtStart;
-
-		double energyRecv;
-		double energySent;
+		Ptr<EEBTPEnergyAttribution> energyAttribution;
 
 		uint32_t uniquePackets;
 		uint32_t packetsRecv;
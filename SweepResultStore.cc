@@ -0,0 +1,116 @@
+/*
+ * SweepResultStore.cc
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include "cstdio"
+#include "fstream"
+#include "sstream"
+#include "iomanip"
+#include "iterator"
+
+#include "fcntl.h"
+#include "unistd.h"
+
+#include "ns3/log.h"
+
+#include "SweepResultStore.h"
+
+namespace ns3
+{
+	NS_LOG_COMPONENT_DEFINE("SweepResultStore");
+
+	SweepResultStore::SweepResultStore(std::string fileName)
+	{
+		this->fileName = fileName;
+	}
+
+	SweepResultStore::~SweepResultStore()
+	{
+	}
+
+	/*
+	 * Reads the results of all complete lines and cuts off a torn last line
+	 */
+	void SweepResultStore::load()
+	{
+		this->results.clear();
+
+		std::ifstream in(this->fileName.c_str(), std::ios::in | std::ios::binary);
+		if (!in.is_open())
+			return;
+
+		std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+		in.close();
+
+		size_t begin = 0, end;
+		while ((end = content.find('\n', begin)) != std::string::npos)
+		{
+			std::string line = content.substr(begin, end - begin);
+			begin = end + 1;
+
+			size_t tab = line.find('\t');
+			size_t resultTab = (tab != std::string::npos) ? line.find('\t', tab + 1) : std::string::npos;
+			if (tab != 16 || resultTab == std::string::npos)
+			{
+				NS_LOG_WARN("Skipping invalid line in " << this->fileName << ": " << line);
+				continue;
+			}
+			this->results[std::stoull(line.substr(0, tab), 0, 16)] = line.substr(resultTab + 1);
+		}
+
+		if (begin < content.size())
+		{
+			NS_LOG_WARN("Cutting off " << (content.size() - begin) << " bytes of an incomplete result in " << this->fileName);
+			if (truncate(this->fileName.c_str(), begin) != 0)
+				std::perror("truncate");
+		}
+		NS_LOG_DEBUG("Loaded " << this->results.size() << " results from " << this->fileName);
+	}
+
+	bool SweepResultStore::contains(const SweepPoint &point) const
+	{
+		return this->results.find(point.getHash()) != this->results.end();
+	}
+
+	bool SweepResultStore::get(const SweepPoint &point, std::string &result) const
+	{
+		std::unordered_map<uint64_t, std::string>::const_iterator it = this->results.find(point.getHash());
+		if (it == this->results.end())
+			return false;
+		result = it->second;
+		return true;
+	}
+
+	/*
+	 * Appends the result with a single write(), the result must not contain '\n'
+	 */
+	bool SweepResultStore::append(const SweepPoint &point, std::string result)
+	{
+		std::stringstream str;
+		str << std::hex << std::setw(16) << std::setfill('0') << point.getHash() << std::dec << "\t" << point.getConfig() << "\t" << result << "\n";
+		std::string line = str.str();
+
+		int fd = open(this->fileName.c_str(), O_WRONLY | O_APPEND | O_CREAT, 0644);
+		if (fd < 0)
+		{
+			NS_LOG_ERROR("Cannot open result store " << this->fileName);
+			return false;
+		}
+
+		bool ok = write(fd, line.data(), line.size()) == (ssize_t)line.size();
+		ok = (fsync(fd) == 0) && ok;
+		ok = (close(fd) == 0) && ok;
+		if (ok)
+			this->results[point.getHash()] = result;
+		else
+			NS_LOG_ERROR("Cannot append to result store " << this->fileName);
+		return ok;
+	}
+
+	uint32_t SweepResultStore::getNResults() const
+	{
+		return this->results.size();
+	}
+}
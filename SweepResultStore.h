@@ -0,0 +1,46 @@
+/*
+ * SweepResultStore.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#ifndef BROADCAST_SWEEPRESULTSTORE_H_
+#define BROADCAST_SWEEPRESULTSTORE_H_
+
+#include "string"
+#include "cstdint"
+#include "unordered_map"
+
+#include "SweepSpec.h"
+
+namespace ns3
+{
+	/*
+	 * Append only result file of a sweep, one line per finished point:
+	 *
+	 * 	<hash (16 hex digits)>\t<configuration>\t<result>\n
+	 *
+	 * append() writes a line with a single write() on a file opened with
+	 * O_APPEND, so workers can append concurrently. A line torn by a crash has
+	 * no '\n', load() cuts it off and the point is run again.
+	 */
+	class SweepResultStore
+	{
+	public:
+		SweepResultStore(std::string fileName);
+		virtual ~SweepResultStore();
+
+		void load();
+		bool contains(const SweepPoint &point) const;
+		bool get(const SweepPoint &point, std::string &result) const;
+		bool append(const SweepPoint &point, std::string result);
+
+		uint32_t getNResults() const;
+
+	private:
+		std::string fileName;
+		std::unordered_map<uint64_t, std::string> results;
+	};
+}
+
+#endif /* BROADCAST_SWEEPRESULTSTORE_H_ */
@@ -0,0 +1,176 @@
+/*
+ * SweepSpec.cc
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include "fstream"
+#include "sstream"
+#include "algorithm"
+
+#include "ns3/log.h"
+#include "ns3/fatal-error.h"
+
+#include "SweepSpec.h"
+
+namespace ns3
+{
+	NS_LOG_COMPONENT_DEFINE("SweepSpec");
+
+	/*
+	 * Canonical form of the configuration, the arguments are sorted by name
+	 */
+	std::string SweepPoint::getConfig() const
+	{
+		std::stringstream str;
+		for (std::map<std::string, std::string>::const_iterator it = this->args.begin(); it != this->args.end(); it++)
+			str << it->first << "=" << it->second << " ";
+		str << "run=" << this->run;
+		return str.str();
+	}
+
+	/*
+	 * 64 bit FNV-1a of the canonical configuration
+	 */
+	uint64_t SweepPoint::getHash() const
+	{
+		std::string config = this->getConfig();
+
+		uint64_t hash = 14695981039346656037ULL;
+		for (char c : config)
+		{
+			hash ^= (uint8_t)c;
+			hash *= 1099511628211ULL;
+		}
+		return hash;
+	}
+
+	SweepSpec::SweepSpec()
+	{
+		this->runs = 1;
+	}
+
+	SweepSpec::~SweepSpec()
+	{
+	}
+
+	void SweepSpec::load(std::string fileName)
+	{
+		std::ifstream in(fileName.c_str());
+		if (!in.is_open())
+			NS_FATAL_ERROR("Cannot open sweep file " << fileName);
+
+		this->grid.clear();
+		this->seeds.clear();
+		this->runs = 1;
+		this->store = fileName + ".results";
+
+		std::string line;
+		for (uint32_t n = 1; std::getline(in, line); n++)
+		{
+			size_t comment = line.find('#');
+			if (comment != std::string::npos)
+				line.erase(comment);
+			line = SweepSpec::trim(line);
+			if (line.empty())
+				continue;
+
+			size_t eq = line.find('=');
+			if (eq == std::string::npos)
+				NS_FATAL_ERROR(fileName << ":" << n << ": expected '<key> = <value>[, <value>...]'");
+
+			std::string key = SweepSpec::trim(line.substr(0, eq));
+			std::vector<std::string> values = SweepSpec::split(line.substr(eq + 1));
+			if (key.empty() || values.empty())
+				NS_FATAL_ERROR(fileName << ":" << n << ": empty key or value");
+
+			if (key == "seeds")
+				this->seeds = values;
+			else if (key == "runs")
+				this->runs = std::stoul(values[0]);
+			else if (key == "store")
+				this->store = values[0];
+			else if (key == "rndSeed" || key == "iMax" || key == "skipTo" || key == "jobs" || key == "sweep")
+				NS_FATAL_ERROR(fileName << ":" << n << ": '" << key << "' can not be swept, use 'seeds' and 'runs'");
+			else
+				this->grid.push_back(std::make_pair(key, values));
+		}
+		NS_LOG_DEBUG("Loaded sweep " << fileName << " with " << this->grid.size() << " parameters, " << this->seeds.size() << " seeds and " << this->runs << " runs");
+	}
+
+	void SweepSpec::setBaseArgs(std::map<std::string, std::string> args)
+	{
+		this->baseArgs = args;
+	}
+
+	std::vector<SweepPoint> SweepSpec::expand() const
+	{
+		//Cartesian product, the last parameter changes fastest
+		std::vector<std::map<std::string, std::string>> configs(1, this->baseArgs);
+		for (const std::pair<std::string, std::vector<std::string>> &parameter : this->grid)
+		{
+			std::vector<std::map<std::string, std::string>> next;
+			for (const std::map<std::string, std::string> &config : configs)
+			{
+				for (const std::string &value : parameter.second)
+				{
+					next.push_back(config);
+					next.back()[parameter.first] = value;
+				}
+			}
+			configs.swap(next);
+		}
+
+		std::vector<SweepPoint> points;
+		for (const std::map<std::string, std::string> &config : configs)
+		{
+			//Without 'seeds' the seed of the base arguments is used
+			for (uint32_t seed = 0; seed < std::max<size_t>(this->seeds.size(), 1); seed++)
+			{
+				for (uint32_t run = 0; run < this->runs; run++)
+				{
+					SweepPoint point;
+					point.args = config;
+					if (seed < this->seeds.size())
+						point.args["rndSeed"] = this->seeds[seed];
+					point.run = run;
+					points.push_back(point);
+				}
+			}
+		}
+		return points;
+	}
+
+	std::string SweepSpec::getStore() const
+	{
+		return this->store;
+	}
+
+	uint32_t SweepSpec::getNRuns() const
+	{
+		return this->runs;
+	}
+
+	std::string SweepSpec::trim(std::string str)
+	{
+		size_t begin = str.find_first_not_of(" \t\r");
+		if (begin == std::string::npos)
+			return "";
+		size_t end = str.find_last_not_of(" \t\r");
+		return str.substr(begin, end - begin + 1);
+	}
+
+	std::vector<std::string> SweepSpec::split(std::string str)
+	{
+		std::vector<std::string> values;
+		std::stringstream in(str);
+		std::string value;
+		while (std::getline(in, value, ','))
+		{
+			value = SweepSpec::trim(value);
+			if (!value.empty())
+				values.push_back(value);
+		}
+		return values;
+	}
+}
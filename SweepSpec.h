@@ -0,0 +1,76 @@
+/*
+ * SweepSpec.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#ifndef BROADCAST_SWEEPSPEC_H_
+#define BROADCAST_SWEEPSPEC_H_
+
+#include "map"
+#include "string"
+#include "vector"
+#include "cstdint"
+
+namespace ns3
+{
+	/*
+	 * One simulation of a sweep: the command line arguments and the run index
+	 */
+	struct SweepPoint
+	{
+		std::map<std::string, std::string> args;
+		int run;
+
+		std::string getConfig() const;
+		uint64_t getHash() const;
+	};
+
+	/*
+	 * Parameter sweep read from a text file, e.g.
+	 *
+	 * 	# comment
+	 * 	cpm = CYCLE_TEST_ASYNC, MUTEX
+	 * 	nWifi = 50, 100, 200
+	 * 	rtsCts = false, true
+	 * 	seeds = 1001, 1002
+	 * 	runs = 10
+	 * 	store = results.sweep
+	 *
+	 * Every other key is a command line argument of the simulation with a list
+	 * of values. expand() returns the cartesian product of all lists (in the
+	 * order of the file, the last key changes fastest), for every seed
+	 * ('rndSeed') and the run indices 0..runs-1.
+	 */
+	class SweepSpec
+	{
+	public:
+		SweepSpec();
+		virtual ~SweepSpec();
+
+		void load(std::string fileName);
+
+		/*
+		 * Arguments which are the same for all points (e.g. from the command line),
+		 * the grid of the file overrides them
+		 */
+		void setBaseArgs(std::map<std::string, std::string> args);
+
+		std::vector<SweepPoint> expand() const;
+
+		std::string getStore() const;
+		uint32_t getNRuns() const;
+
+		static std::string trim(std::string str);
+		static std::vector<std::string> split(std::string str);
+
+	private:
+		std::vector<std::pair<std::string, std::vector<std::string>>> grid;
+		std::map<std::string, std::string> baseArgs;
+		std::vector<std::string> seeds;
+		uint32_t runs;
+		std::string store;
+	};
+}
+
+#endif /* BROADCAST_SWEEPSPEC_H_ */
@@ -0,0 +1,618 @@
+/*
+ * TimingTuner.cc
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include "cmath"
+#include "cstdio"
+#include "cstdlib"
+#include "fstream"
+#include "sstream"
+#include "algorithm"
+
+#include "ns3/log.h"
+#include "ns3/fatal-error.h"
+
+#include "ResultCode.h"
+#include "ResultWriter.h"
+#include "TimingTuner.h"
+
+namespace ns3
+{
+	NS_LOG_COMPONENT_DEFINE("TimingTuner");
+
+	//Gaussian process on x in [0, 1]^d: length scale of the kernel and noise of the standardized objective
+	static const double LENGTH_SCALE = 0.3;
+	static const double NOISE = 0.01;
+	static const uint32_t N_CANDIDATES = 2000;
+
+	std::string TuneParameter::getValue(double x) const
+	{
+		std::stringstream str;
+		if (this->type == CHOICE)
+			return this->choices[std::min<size_t>(this->choices.size() - 1, (size_t)(x * this->choices.size()))];
+		else if (this->type == INTEGER)
+			str << (int64_t)std::llround(this->low + x * (this->high - this->low));
+		else
+			str << (this->low + x * (this->high - this->low));
+		str << this->unit;
+		return str.str();
+	}
+
+	//Moves x onto the value it stands for, so the model sees what was simulated
+	double TuneParameter::snap(double x) const
+	{
+		if (this->type == CHOICE)
+			return (std::min<size_t>(this->choices.size() - 1, (size_t)(x * this->choices.size())) + 0.5) / this->choices.size();
+		if (this->type == INTEGER && this->high > this->low)
+			return (std::llround(this->low + x * (this->high - this->low)) - this->low) / (this->high - this->low);
+		return x;
+	}
+
+	TuneSample::TuneSample()
+	{
+		this->index = 0;
+		this->nResults = 0;
+		this->timeToBuild = 0;
+		this->constructionEnergy = 0;
+		this->dataLoss = 0;
+		this->unconnectedNodes = 0;
+		this->objective = 0;
+	}
+
+	bool TuneSample::isFeasible() const
+	{
+		return this->nResults > 0 && this->unconnectedNodes == 0;
+	}
+
+	TimingTuner::TimingTuner()
+	{
+		this->runs = 1;
+		this->method = "random";
+		this->nSamples = 20;
+		this->nInitial = 0;
+		this->batch = 0;
+		this->weights[0] = this->weights[1] = this->weights[2] = 1.0;
+	}
+
+	TimingTuner::~TimingTuner()
+	{
+	}
+
+	void TimingTuner::load(std::string fileName)
+	{
+		std::ifstream in(fileName.c_str());
+		if (!in.is_open())
+			NS_FATAL_ERROR("Cannot open tune file " << fileName);
+
+		this->parameters.clear();
+		this->samples.clear();
+		this->store = fileName + ".results";
+		this->out = fileName;
+		uint64_t seed = 1;
+
+		std::string line;
+		for (uint32_t n = 1; std::getline(in, line); n++)
+		{
+			size_t comment = line.find('#');
+			if (comment != std::string::npos)
+				line.erase(comment);
+			line = SweepSpec::trim(line);
+			if (line.empty())
+				continue;
+
+			size_t eq = line.find('=');
+			if (eq == std::string::npos)
+				NS_FATAL_ERROR(fileName << ":" << n << ": expected '<key> = <low> .. <high>' or '<key> = <value>[, <value>...]'");
+
+			std::string key = SweepSpec::trim(line.substr(0, eq));
+			std::string value = SweepSpec::trim(line.substr(eq + 1));
+			std::vector<std::string> values = SweepSpec::split(value);
+			if (key.empty() || values.empty())
+				NS_FATAL_ERROR(fileName << ":" << n << ": empty key or value");
+
+			if (key == "method")
+				this->method = values[0];
+			else if (key == "samples")
+				this->nSamples = std::stoul(values[0]);
+			else if (key == "initial")
+				this->nInitial = std::stoul(values[0]);
+			else if (key == "batch")
+				this->batch = std::stoul(values[0]);
+			else if (key == "seed")
+				seed = std::stoull(values[0]);
+			else if (key == "weights")
+			{
+				if (values.size() != 3)
+					NS_FATAL_ERROR(fileName << ":" << n << ": expected the weights of time to build, construction energy and data loss");
+				for (uint32_t i = 0; i < 3; i++)
+					this->weights[i] = std::stod(values[i]);
+			}
+			else if (key == "seeds")
+				this->seeds = values;
+			else if (key == "runs")
+				this->runs = std::stoul(values[0]);
+			else if (key == "store")
+				this->store = values[0];
+			else if (key == "out")
+				this->out = values[0];
+			else if (key == "rndSeed" || key == "iMax" || key == "skipTo" || key == "jobs" || key == "sweep" || key == "tune")
+				NS_FATAL_ERROR(fileName << ":" << n << ": '" << key << "' can not be tuned, use 'seeds' and 'runs'");
+			else
+			{
+				TuneParameter parameter;
+				parameter.name = key;
+				parameter.low = parameter.high = 0;
+
+				size_t dots = value.find("..");
+				if (dots != std::string::npos)
+				{
+					//Range, the unit is what follows the numbers
+					std::string lowStr = SweepSpec::trim(value.substr(0, dots));
+					std::string highStr = SweepSpec::trim(value.substr(dots + 2));
+					char *lowEnd, *highEnd;
+					parameter.low = std::strtod(lowStr.c_str(), &lowEnd);
+					parameter.high = std::strtod(highStr.c_str(), &highEnd);
+					std::string lowNumber = lowStr.substr(0, lowEnd - lowStr.c_str());
+					std::string highNumber = highStr.substr(0, highEnd - highStr.c_str());
+					parameter.unit = SweepSpec::trim(lowEnd);
+
+					if (lowNumber.empty() || highNumber.empty() || parameter.unit != SweepSpec::trim(highEnd) || parameter.high < parameter.low)
+						NS_FATAL_ERROR(fileName << ":" << n << ": invalid range '" << value << "'");
+					parameter.type = (lowNumber.find_first_of(".eE") == std::string::npos && highNumber.find_first_of(".eE") == std::string::npos) ? TuneParameter::INTEGER : TuneParameter::REAL;
+				}
+				else
+				{
+					parameter.type = TuneParameter::CHOICE;
+					parameter.choices = values;
+				}
+				this->parameters.push_back(parameter);
+			}
+		}
+
+		if (this->parameters.empty())
+			NS_FATAL_ERROR(fileName << ": nothing to tune");
+		if (this->method != "random" && this->method != "bayes")
+			NS_FATAL_ERROR(fileName << ": unknown method '" << this->method << "' (random, bayes)");
+		if (this->nInitial == 0)
+			this->nInitial = std::max<uint32_t>(5, 2 * this->parameters.size());
+		this->random.seed(seed);
+		NS_LOG_DEBUG("Loaded tune file " << fileName << " with " << this->parameters.size() << " parameters, " << this->nSamples << " samples (" << this->method << ")");
+	}
+
+	void TimingTuner::setBaseArgs(std::map<std::string, std::string> args)
+	{
+		this->baseArgs = args;
+	}
+
+	TuneSample TimingTuner::createSample(std::string origin, std::vector<double> x)
+	{
+		TuneSample sample;
+		sample.index = this->samples.size();
+		sample.origin = origin;
+		sample.x = x;
+		for (uint32_t i = 0; i < x.size(); i++)
+			sample.args[this->parameters[i].name] = this->parameters[i].getValue(x[i]);
+		return sample;
+	}
+
+	bool TimingTuner::hasSample(const std::map<std::string, std::string> &args) const
+	{
+		for (const TuneSample &sample : this->samples)
+		{
+			if (sample.args == args)
+				return true;
+		}
+		return false;
+	}
+
+	/*
+	 * The first call adds the default (no tuned argument). With 'bayes' the
+	 * model takes over after 'initial' random samples, until then a batch
+	 * ends with the last random sample so the model has results.
+	 */
+	std::vector<uint32_t> TimingTuner::propose(uint32_t n)
+	{
+		std::vector<uint32_t> indices;
+		if (this->samples.empty())
+		{
+			this->samples.push_back(TuneSample());
+			this->samples.back().origin = "default";
+			indices.push_back(0);
+		}
+
+		//Training data of the model: the evaluated samples, infeasible ones count as the worst feasible one
+		std::vector<std::vector<double>> xs;
+		std::vector<double> ys;
+		double worst = -HUGE_VAL;
+		for (const TuneSample &sample : this->samples)
+		{
+			if (sample.isFeasible())
+				worst = std::max(worst, sample.objective);
+		}
+		for (const TuneSample &sample : this->samples)
+		{
+			if (sample.index == 0 || sample.nResults == 0)
+				continue;
+			xs.push_back(sample.x);
+			ys.push_back(sample.isFeasible() ? sample.objective : worst);
+		}
+		if (worst == -HUGE_VAL)
+		{
+			xs.clear();
+			ys.clear();
+		}
+
+		uint32_t nNew = 0;
+		while (nNew < n && !this->isComplete())
+		{
+			bool useModel = this->method == "bayes" && this->samples.size() - 1 >= this->nInitial;
+			if (useModel && xs.empty())
+				break;
+
+			std::vector<double> x = useModel ? this->drawFromModel(xs, ys) : this->drawRandom();
+			if (x.empty())
+			{
+				NS_LOG_DEBUG("No new sample found, the parameter space is exhausted");
+				this->nSamples = this->samples.size() - 1;
+				break;
+			}
+
+			this->samples.push_back(this->createSample(useModel ? "bayes" : "random", x));
+			indices.push_back(this->samples.size() - 1);
+			nNew++;
+		}
+		return indices;
+	}
+
+	bool TimingTuner::isComplete() const
+	{
+		return this->samples.size() > this->nSamples;
+	}
+
+	std::vector<double> TimingTuner::drawRandom()
+	{
+		std::uniform_real_distribution<double> uniform(0.0, 1.0);
+		for (uint32_t attempt = 0; attempt < 1000; attempt++)
+		{
+			std::vector<double> x;
+			for (const TuneParameter &parameter : this->parameters)
+				x.push_back(parameter.snap(uniform(this->random)));
+			if (!this->hasSample(this->createSample("", x).args))
+				return x;
+		}
+		return std::vector<double>();
+	}
+
+	/*
+	 * Fits the Gaussian process (squared exponential kernel, standardized
+	 * objective) and returns the new candidate with the highest expected
+	 * improvement. The candidate is added to the training data with its
+	 * predicted objective, so the next one of the batch goes elsewhere.
+	 */
+	std::vector<double> TimingTuner::drawFromModel(std::vector<std::vector<double>> &xs, std::vector<double> &ys)
+	{
+		uint32_t n = xs.size();
+		uint32_t d = this->parameters.size();
+
+		double mean = 0, var = 0;
+		for (double y : ys)
+			mean += y;
+		mean /= n;
+		for (double y : ys)
+			var += (y - mean) * (y - mean);
+		double scale = (n > 1 && var > 0) ? std::sqrt(var / (n - 1)) : 1.0;
+
+		std::vector<double> y(n);
+		double best = HUGE_VAL;
+		for (uint32_t i = 0; i < n; i++)
+		{
+			y[i] = (ys[i] - mean) / scale;
+			best = std::min(best, y[i]);
+		}
+
+		auto kernel = [d](const std::vector<double> &a, const std::vector<double> &b) {
+			double dist = 0;
+			for (uint32_t k = 0; k < d; k++)
+				dist += (a[k] - b[k]) * (a[k] - b[k]);
+			return std::exp(-dist / (2 * LENGTH_SCALE * LENGTH_SCALE));
+		};
+
+		//Cholesky decomposition K = L * L^T
+		std::vector<double> l(n * n, 0.0);
+		for (uint32_t i = 0; i < n; i++)
+		{
+			for (uint32_t j = 0; j <= i; j++)
+			{
+				double sum = kernel(xs[i], xs[j]) + ((i == j) ? NOISE : 0.0);
+				for (uint32_t k = 0; k < j; k++)
+					sum -= l[i * n + k] * l[j * n + k];
+				l[i * n + j] = (i == j) ? std::sqrt(std::max(sum, 1e-12)) : sum / l[j * n + j];
+			}
+		}
+
+		//alpha = K^-1 * y
+		std::vector<double> alpha(y);
+		for (uint32_t i = 0; i < n; i++)
+		{
+			for (uint32_t k = 0; k < i; k++)
+				alpha[i] -= l[i * n + k] * alpha[k];
+			alpha[i] /= l[i * n + i];
+		}
+		for (int32_t i = n - 1; i >= 0; i--)
+		{
+			for (uint32_t k = i + 1; k < n; k++)
+				alpha[i] -= l[k * n + i] * alpha[k];
+			alpha[i] /= l[i * n + i];
+		}
+
+		//Candidates: uniform ones and some around the best samples
+		std::uniform_real_distribution<double> uniform(0.0, 1.0);
+		std::normal_distribution<double> normal(0.0, 0.05);
+		std::vector<uint32_t> order(n);
+		for (uint32_t i = 0; i < n; i++)
+			order[i] = i;
+		std::sort(order.begin(), order.end(), [&y](uint32_t a, uint32_t b) { return y[a] < y[b]; });
+
+		std::vector<double> bestX;
+		double bestEi = -1, bestMu = 0;
+		for (uint32_t c = 0; c < N_CANDIDATES; c++)
+		{
+			std::vector<double> x(d);
+			for (uint32_t k = 0; k < d; k++)
+			{
+				if (c % 4 == 0)
+					x[k] = uniform(this->random);
+				else
+					x[k] = std::min(1.0, std::max(0.0, xs[order[c % std::min<uint32_t>(n, 3)]][k] + normal(this->random)));
+				x[k] = this->parameters[k].snap(x[k]);
+			}
+
+			std::vector<double> ks(n);
+			double mu = 0;
+			for (uint32_t i = 0; i < n; i++)
+			{
+				ks[i] = kernel(x, xs[i]);
+				mu += ks[i] * alpha[i];
+			}
+			for (uint32_t i = 0; i < n; i++)
+			{
+				for (uint32_t k = 0; k < i; k++)
+					ks[i] -= l[i * n + k] * ks[k];
+				ks[i] /= l[i * n + i];
+			}
+			double sigma2 = 1.0;
+			for (uint32_t i = 0; i < n; i++)
+				sigma2 -= ks[i] * ks[i];
+			double sigma = std::sqrt(std::max(sigma2, 1e-12));
+
+			double z = (best - mu) / sigma;
+			double ei = (best - mu) * 0.5 * std::erfc(-z / std::sqrt(2.0)) + sigma * std::exp(-0.5 * z * z) / std::sqrt(2.0 * M_PI);
+			if (ei > bestEi && !this->hasSample(this->createSample("", x).args))
+			{
+				bestEi = ei;
+				bestMu = mu;
+				bestX = x;
+			}
+		}
+
+		if (!bestX.empty())
+		{
+			xs.push_back(bestX);
+			ys.push_back(bestMu * scale + mean);
+		}
+		return bestX;
+	}
+
+	//Every seed and run of the sample, the tuned arguments override the base arguments
+	std::vector<SweepPoint> TimingTuner::getPoints(uint32_t sample) const
+	{
+		std::map<std::string, std::string> args = this->baseArgs;
+		for (const std::pair<const std::string, std::string> &arg : this->samples[sample].args)
+			args[arg.first] = arg.second;
+
+		std::vector<SweepPoint> points;
+		for (uint32_t seed = 0; seed < std::max<size_t>(this->seeds.size(), 1); seed++)
+		{
+			for (uint32_t run = 0; run < this->runs; run++)
+			{
+				SweepPoint point;
+				point.args = args;
+				if (seed < this->seeds.size())
+					point.args["rndSeed"] = this->seeds[seed];
+				point.run = run;
+				points.push_back(point);
+			}
+		}
+		return points;
+	}
+
+	//Fields of the result code of brdcstTest, see ResultCode.h
+	bool TimingTuner::parseResult(std::string result, double &time, double &energy, double &loss, double &unconnected)
+	{
+		std::vector<std::string> fields;
+		std::stringstream in(result);
+		std::string field;
+		while (std::getline(in, field, ';'))
+			fields.push_back(field);
+		if (fields.size() < ResultCode::LOSS_PER_DEPTH)
+			return false;
+
+		energy = std::atof(fields[ResultCode::CONSTRUCTION_ENERGY].c_str());
+		time = std::atof(fields[ResultCode::MAX_TIME_TO_BUILD].c_str());
+		unconnected = std::atof(fields[ResultCode::UNCONNECTED_NODES].c_str());
+
+		//Without application data the ratios are NaN
+		loss = 0;
+		uint32_t depths = 0;
+		for (uint32_t i = ResultCode::LOSS_PER_DEPTH; i < fields.size(); i++)
+		{
+			double ratio = std::atof(fields[i].c_str());
+			if (std::isfinite(ratio))
+			{
+				loss += ratio;
+				depths++;
+			}
+		}
+		if (depths > 0)
+			loss /= depths;
+		return true;
+	}
+
+	void TimingTuner::evaluate(uint32_t sample, const std::vector<std::string> &results)
+	{
+		TuneSample &s = this->samples[sample];
+		s.nResults = 0;
+		s.timeToBuild = s.constructionEnergy = s.dataLoss = s.unconnectedNodes = 0;
+
+		for (const std::string &result : results)
+		{
+			double time, energy, loss, unconnected;
+			if (!TimingTuner::parseResult(result, time, energy, loss, unconnected))
+			{
+				NS_LOG_WARN("Skipping invalid result of sample " << sample << ": " << result);
+				continue;
+			}
+			s.timeToBuild += time;
+			s.constructionEnergy += energy;
+			s.dataLoss += loss;
+			s.unconnectedNodes += unconnected;
+			s.nResults++;
+		}
+
+		if (s.nResults > 0)
+		{
+			s.timeToBuild /= s.nResults;
+			s.constructionEnergy /= s.nResults;
+			s.dataLoss /= s.nResults;
+			s.unconnectedNodes /= s.nResults;
+		}
+		this->updateObjectives();
+	}
+
+	//Time and energy are relative to the default, the loss ratio is used as it is
+	void TimingTuner::updateObjectives()
+	{
+		const TuneSample &reference = this->samples[0];
+		double time = (reference.nResults > 0 && reference.timeToBuild > 0) ? reference.timeToBuild : 1.0;
+		double energy = (reference.nResults > 0 && reference.constructionEnergy > 0) ? reference.constructionEnergy : 1.0;
+
+		for (TuneSample &sample : this->samples)
+			sample.objective = this->weights[0] * sample.timeToBuild / time + this->weights[1] * sample.constructionEnergy / energy + this->weights[2] * sample.dataLoss;
+	}
+
+	const TuneSample &TimingTuner::getSample(uint32_t sample) const
+	{
+		return this->samples[sample];
+	}
+
+	uint32_t TimingTuner::getNSamples() const
+	{
+		return this->samples.size();
+	}
+
+	//Feasible sample with the lowest objective, -1 if there is none
+	int32_t TimingTuner::getBest() const
+	{
+		int32_t best = -1;
+		for (const TuneSample &sample : this->samples)
+		{
+			if (sample.isFeasible() && (best < 0 || sample.objective < this->samples[best].objective))
+				best = sample.index;
+		}
+		return best;
+	}
+
+	std::vector<uint32_t> TimingTuner::getParetoSet() const
+	{
+		std::vector<uint32_t> set;
+		for (const TuneSample &a : this->samples)
+		{
+			if (!a.isFeasible())
+				continue;
+
+			bool dominated = false;
+			for (const TuneSample &b : this->samples)
+			{
+				if (!b.isFeasible())
+					continue;
+				if (b.timeToBuild <= a.timeToBuild && b.constructionEnergy <= a.constructionEnergy && b.dataLoss <= a.dataLoss &&
+					(b.timeToBuild < a.timeToBuild || b.constructionEnergy < a.constructionEnergy || b.dataLoss < a.dataLoss))
+				{
+					dominated = true;
+					break;
+				}
+			}
+			if (!dominated)
+				set.push_back(a.index);
+		}
+		return set;
+	}
+
+	/*
+	 * Rewrites <out>-samples.csv with the evaluated samples and <out>-pareto.csv,
+	 * the default has empty parameter values
+	 */
+	bool TimingTuner::write() const
+	{
+		std::vector<uint32_t> evaluated;
+		for (const TuneSample &sample : this->samples)
+		{
+			if (sample.nResults > 0)
+				evaluated.push_back(sample.index);
+		}
+
+		bool ok = this->writeTable(this->out + "-samples.csv", evaluated);
+		return this->writeTable(this->out + "-pareto.csv", this->getParetoSet()) && ok;
+	}
+
+	bool TimingTuner::writeTable(std::string fileName, const std::vector<uint32_t> &indices) const
+	{
+		std::vector<std::string> columns = {"sample", "origin"};
+		for (const TuneParameter &parameter : this->parameters)
+			columns.push_back(parameter.name);
+		for (const char *column : {"results", "time_to_build_ns", "construction_energy", "data_loss", "unconnected_nodes", "objective"})
+			columns.push_back(column);
+
+		std::remove(fileName.c_str());
+		ResultWriter writer;
+		if (!writer.open(fileName, columns))
+			return false;
+
+		for (uint32_t index : indices)
+		{
+			const TuneSample &sample = this->samples[index];
+			writer.add(sample.index);
+			writer.add(sample.origin);
+			for (const TuneParameter &parameter : this->parameters)
+			{
+				std::map<std::string, std::string>::const_iterator it = sample.args.find(parameter.name);
+				writer.add((it != sample.args.end()) ? it->second : std::string(""));
+			}
+			writer.add(sample.nResults);
+			writer.add(sample.timeToBuild);
+			writer.add(sample.constructionEnergy);
+			writer.add(sample.dataLoss);
+			writer.add(sample.unconnectedNodes);
+			writer.add(sample.objective);
+			writer.endRow();
+		}
+		bool ok = writer.flush();
+		writer.close();
+		return ok;
+	}
+
+	std::string TimingTuner::getStore() const
+	{
+		return this->store;
+	}
+
+	//Samples proposed at once, 0 if not set; random search proposes all of them
+	uint32_t TimingTuner::getBatch() const
+	{
+		if (this->method == "random")
+			return this->nSamples + 1;
+		return this->batch;
+	}
+}
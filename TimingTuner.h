@@ -0,0 +1,157 @@
+/*
+ * TimingTuner.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#ifndef BROADCAST_TIMINGTUNER_H_
+#define BROADCAST_TIMINGTUNER_H_
+
+#include "map"
+#include "random"
+#include "string"
+#include "vector"
+#include "cstdint"
+
+#include "SweepSpec.h"
+
+namespace ns3
+{
+	/*
+	 * One tuned argument, e.g. an attribute of EEBTProtocol. The search works
+	 * on x in [0, 1], getValue() maps it onto the range or the choices.
+	 */
+	struct TuneParameter
+	{
+		enum Type
+		{
+			INTEGER,
+			REAL,
+			CHOICE
+		};
+
+		std::string name;
+		Type type;
+		double low;
+		double high;
+		std::string unit;
+		std::vector<std::string> choices;
+
+		std::string getValue(double x) const;
+		double snap(double x) const;
+	};
+
+	/*
+	 * A configuration of the tuned parameters and the mean of its results
+	 */
+	struct TuneSample
+	{
+		uint32_t index;
+		std::string origin; //default, random or bayes
+		std::vector<double> x;
+		std::map<std::string, std::string> args;
+
+		uint32_t nResults;
+		double timeToBuild;		   //ns, until the last node finished
+		double constructionEnergy; //J
+		double dataLoss;		   //Mean loss ratio of the depths
+		double unconnectedNodes;
+		double objective;
+
+		TuneSample();
+		bool isFeasible() const;
+	};
+
+	/*
+	 * Search over protocol parameters, read from a text file, e.g.
+	 *
+	 * 	# The scenario class is the rest of the command line
+	 * 	ns3::EEBTPProtocol::MaxRetransmissions = 5 .. 40
+	 * 	ns3::EEBTPProtocol::TxPowerMargin = 0.0 .. 8.0
+	 * 	ns3::EEBTPProtocol::ApplicationDataInterval = 2ms .. 20ms
+	 * 	cpm = CYCLE_TEST_ASYNC, CORE
+	 * 	method = bayes
+	 * 	samples = 40
+	 * 	initial = 10
+	 * 	weights = 1, 1, 10
+	 * 	seeds = 1001, 1002
+	 * 	runs = 2
+	 * 	store = tune.results
+	 * 	out = tune
+	 *
+	 * A range 'a .. b' is searched as integers if both bounds are integers,
+	 * otherwise as reals; a unit (e.g. 'ms') is kept for the values. A list
+	 * is a choice. Sample 0 is the default of all parameters.
+	 *
+	 * 'method = random' draws all samples at once. 'method = bayes' draws
+	 * 'initial' random samples and then fits a Gaussian process to the
+	 * objective of the evaluated ones and proposes the samples with the
+	 * highest expected improvement, 'batch' at a time (kriging believer).
+	 *
+	 * Every sample is simulated for all seeds and runs, the points go to the
+	 * result store like the ones of a sweep, so an aborted search resumes
+	 * where it stopped. The objective of a sample is
+	 *
+	 * 	w0 * time / time(default) + w1 * energy / energy(default) + w2 * loss
+	 *
+	 * with the time until the last node finished the game, the construction
+	 * energy and the mean data loss ratio of the depths. Samples with
+	 * unconnected nodes are not feasible. write() puts all samples into
+	 * <out>-samples.csv and the feasible ones no other feasible sample is
+	 * better than in all three values into <out>-pareto.csv.
+	 */
+	class TimingTuner
+	{
+	public:
+		TimingTuner();
+		virtual ~TimingTuner();
+
+		void load(std::string fileName);
+		void setBaseArgs(std::map<std::string, std::string> args);
+
+		//Adds up to n new samples and returns their indices
+		std::vector<uint32_t> propose(uint32_t n);
+		bool isComplete() const;
+
+		std::vector<SweepPoint> getPoints(uint32_t sample) const;
+		void evaluate(uint32_t sample, const std::vector<std::string> &results);
+
+		const TuneSample &getSample(uint32_t sample) const;
+		uint32_t getNSamples() const;
+		int32_t getBest() const;
+		std::vector<uint32_t> getParetoSet() const;
+
+		bool write() const;
+
+		std::string getStore() const;
+		uint32_t getBatch() const;
+
+	private:
+		std::vector<TuneParameter> parameters;
+		std::map<std::string, std::string> baseArgs;
+		std::vector<std::string> seeds;
+		uint32_t runs;
+		std::string store;
+		std::string out;
+
+		std::string method;
+		uint32_t nSamples;
+		uint32_t nInitial;
+		uint32_t batch;
+		double weights[3];
+		std::mt19937_64 random;
+
+		std::vector<TuneSample> samples;
+
+		TuneSample createSample(std::string origin, std::vector<double> x);
+		bool hasSample(const std::map<std::string, std::string> &args) const;
+		void updateObjectives();
+		bool writeTable(std::string fileName, const std::vector<uint32_t> &indices) const;
+		std::vector<double> drawRandom();
+		std::vector<double> drawFromModel(std::vector<std::vector<double>> &xs, std::vector<double> &ys);
+
+		static bool parseResult(std::string result, double &time, double &energy, double &loss, double &unconnected);
+	};
+}
+
+#endif /* BROADCAST_TIMINGTUNER_H_ */
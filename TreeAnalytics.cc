@@ -0,0 +1,192 @@
+/*
+ * TreeAnalytics.cc
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include "algorithm"
+
+#include "TreeAnalytics.h"
+
+namespace ns3
+{
+	TreeAnalytics::TreeAnalytics()
+	{
+		this->nReached = 0;
+		this->treeDepth = -1;
+		this->deepestNode = 0;
+	}
+
+	TreeAnalytics::~TreeAnalytics()
+	{
+	}
+
+	void TreeAnalytics::analyze(const std::vector<int32_t> &parent, uint32_t root)
+	{
+		uint32_t n = parent.size();
+		this->parent = parent;
+		this->depth.assign(n, -1);
+		this->subtreeSize.assign(n, 0);
+		this->order.clear();
+		this->nodesPerDepth.clear();
+		this->lossPerDepth.clear();
+		this->txPowerPerDepth.clear();
+		this->fanOut.clear();
+		this->nReached = 0;
+		this->treeDepth = -1;
+		this->deepestNode = root;
+		if (root >= n)
+			return;
+
+		//Child lists as one array, the children of i are children[childOffset[i]..childOffset[i+1])
+		this->childOffset.assign(n + 1, 0);
+		for (uint32_t i = 0; i < n; i++)
+		{
+			if (parent[i] >= 0 && (uint32_t)parent[i] < n && i != root)
+				this->childOffset[parent[i] + 1]++;
+		}
+		for (uint32_t i = 0; i < n; i++)
+			this->childOffset[i + 1] += this->childOffset[i];
+
+		std::vector<uint32_t> next(this->childOffset.begin(), this->childOffset.end() - 1);
+		this->children.assign(this->childOffset[n], 0);
+		for (uint32_t i = 0; i < n; i++)
+		{
+			if (parent[i] >= 0 && (uint32_t)parent[i] < n && i != root)
+				this->children[next[parent[i]]++] = i;
+		}
+
+		//Breadth first from the root, nodes in cycles are never reached
+		this->order.reserve(n);
+		this->order.push_back(root);
+		this->depth[root] = 0;
+		for (uint32_t k = 0; k < this->order.size(); k++)
+		{
+			uint32_t node = this->order[k];
+			for (uint32_t c = this->childOffset[node]; c < this->childOffset[node + 1]; c++)
+			{
+				uint32_t child = this->children[c];
+				this->depth[child] = this->depth[node] + 1;
+				this->order.push_back(child);
+			}
+
+			if (this->depth[node] > this->treeDepth)
+			{
+				this->treeDepth = this->depth[node];
+				this->deepestNode = node;
+			}
+		}
+		this->nReached = this->order.size();
+
+		//Subtree sizes bottom up
+		for (uint32_t k = this->order.size(); k-- > 0;)
+		{
+			uint32_t node = this->order[k];
+			this->subtreeSize[node] += 1;
+			if (node != root)
+				this->subtreeSize[this->parent[node]] += this->subtreeSize[node];
+		}
+
+		this->nodesPerDepth.assign(this->treeDepth + 1, 0);
+		for (uint32_t node : this->order)
+		{
+			this->nodesPerDepth[this->depth[node]]++;
+
+			uint32_t nChildren = this->getNChildren(node);
+			if (nChildren >= this->fanOut.size())
+				this->fanOut.resize(nChildren + 1, 0);
+			this->fanOut[nChildren]++;
+		}
+	}
+
+	void TreeAnalytics::setLoss(const std::vector<int64_t> &loss)
+	{
+		this->lossPerDepth.assign(this->treeDepth + 1, 0);
+		for (uint32_t node : this->order)
+		{
+			if (node < loss.size())
+				this->lossPerDepth[this->depth[node]] += loss[node];
+		}
+	}
+
+	void TreeAnalytics::setTxPower(const std::vector<double> &txPower)
+	{
+		this->txPowerPerDepth.assign(this->treeDepth + 1, 0);
+		for (uint32_t node : this->order)
+		{
+			if (node < txPower.size())
+				this->txPowerPerDepth[this->depth[node]] += txPower[node];
+		}
+	}
+
+	uint32_t TreeAnalytics::getNNodes() const
+	{
+		return this->depth.size();
+	}
+
+	uint32_t TreeAnalytics::getNReached() const
+	{
+		return this->nReached;
+	}
+
+	int32_t TreeAnalytics::getDepth(uint32_t node) const
+	{
+		return this->depth[node];
+	}
+
+	uint32_t TreeAnalytics::getSubtreeSize(uint32_t node) const
+	{
+		return this->subtreeSize[node];
+	}
+
+	uint32_t TreeAnalytics::getNChildren(uint32_t node) const
+	{
+		if (this->depth[node] < 0)
+			return 0;
+		return this->childOffset[node + 1] - this->childOffset[node];
+	}
+
+	int32_t TreeAnalytics::getTreeDepth() const
+	{
+		return this->treeDepth;
+	}
+
+	uint32_t TreeAnalytics::getDeepestNode() const
+	{
+		return this->deepestNode;
+	}
+
+	//Root first
+	std::vector<uint32_t> TreeAnalytics::getCriticalPath() const
+	{
+		std::vector<uint32_t> path;
+		if (this->treeDepth < 0)
+			return path;
+
+		for (int32_t node = this->deepestNode; this->depth[node] > 0; node = this->parent[node])
+			path.push_back(node);
+		path.push_back(this->order[0]);
+		std::reverse(path.begin(), path.end());
+		return path;
+	}
+
+	const std::vector<uint32_t> &TreeAnalytics::getNodesPerDepth() const
+	{
+		return this->nodesPerDepth;
+	}
+
+	const std::vector<int64_t> &TreeAnalytics::getLossPerDepth() const
+	{
+		return this->lossPerDepth;
+	}
+
+	const std::vector<double> &TreeAnalytics::getTxPowerPerDepth() const
+	{
+		return this->txPowerPerDepth;
+	}
+
+	const std::vector<uint32_t> &TreeAnalytics::getFanOutHistogram() const
+	{
+		return this->fanOut;
+	}
+}
@@ -0,0 +1,77 @@
+/*
+ * TreeAnalytics.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#ifndef BROADCAST_TREEANALYTICS_H_
+#define BROADCAST_TREEANALYTICS_H_
+
+#include "vector"
+#include "cstdint"
+
+namespace ns3
+{
+	/*
+	 * Statistics of a broadcast tree given as flat parent array, without ns-3
+	 * dependencies.
+	 *
+	 * The nodes are numbered 0..n-1, parent[i] is the index of the parent of
+	 * node i or -1. analyze() builds the child lists once (counting sort by
+	 * parent) and walks the tree breadth first from the root, everything is
+	 * O(n) and iterative. Nodes which are not reachable from the root (no
+	 * parent, in a cycle or below a cycle) have depth -1 and are not part of
+	 * the per depth statistics.
+	 */
+	class TreeAnalytics
+	{
+	public:
+		TreeAnalytics();
+		virtual ~TreeAnalytics();
+
+		void analyze(const std::vector<int32_t> &parent, uint32_t root);
+
+		//Optional per node values, summed up per depth (after analyze())
+		void setLoss(const std::vector<int64_t> &loss);
+		void setTxPower(const std::vector<double> &txPower);
+
+		uint32_t getNNodes() const;
+		uint32_t getNReached() const;
+
+		int32_t getDepth(uint32_t node) const;
+		uint32_t getSubtreeSize(uint32_t node) const;
+		uint32_t getNChildren(uint32_t node) const;
+
+		//Longest path from the root in hops and the node at its end
+		int32_t getTreeDepth() const;
+		uint32_t getDeepestNode() const;
+		std::vector<uint32_t> getCriticalPath() const;
+
+		//Indexed by depth (0 = root) and by number of children
+		const std::vector<uint32_t> &getNodesPerDepth() const;
+		const std::vector<int64_t> &getLossPerDepth() const;
+		const std::vector<double> &getTxPowerPerDepth() const;
+		const std::vector<uint32_t> &getFanOutHistogram() const;
+
+	private:
+		std::vector<int32_t> parent;
+		std::vector<int32_t> depth;
+		std::vector<uint32_t> subtreeSize;
+		std::vector<uint32_t> childOffset;
+		std::vector<uint32_t> children;
+
+		uint32_t nReached;
+		int32_t treeDepth;
+		uint32_t deepestNode;
+
+		std::vector<uint32_t> nodesPerDepth;
+		std::vector<int64_t> lossPerDepth;
+		std::vector<double> txPowerPerDepth;
+		std::vector<uint32_t> fanOut;
+
+		//Order of the breadth first walk, parents before children
+		std::vector<uint32_t> order;
+	};
+}
+
+#endif /* BROADCAST_TREEANALYTICS_H_ */
@@ -0,0 +1,88 @@
+/*
+ * WorkerPool.cc
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include "WorkerPool.h"
+
+namespace ns3
+{
+	WorkerPool::WorkerPool(uint32_t nThreads)
+	{
+		this->nItems = 0;
+		this->generation = 0;
+		this->pending = 0;
+		this->stop = false;
+
+		//The calling thread is worker 0
+		for (uint32_t i = 1; i < nThreads; i++)
+			this->threads.push_back(std::thread(&WorkerPool::work, this, i));
+	}
+
+	WorkerPool::~WorkerPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			this->stop = true;
+		}
+		this->startCondition.notify_all();
+
+		for (std::thread &t : this->threads)
+			t.join();
+	}
+
+	uint32_t WorkerPool::getNThreads()
+	{
+		return this->threads.size() + 1;
+	}
+
+	void WorkerPool::run(uint32_t nItems, Job job)
+	{
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			this->job = job;
+			this->nItems = nItems;
+			this->pending = this->threads.size();
+			this->generation++;
+		}
+		this->startCondition.notify_all();
+
+		this->runSlice(0);
+
+		std::unique_lock<std::mutex> lock(this->mutex);
+		this->doneCondition.wait(lock, [this] { return this->pending == 0; });
+	}
+
+	void WorkerPool::work(uint32_t worker)
+	{
+		uint64_t seen = 0;
+		while (true)
+		{
+			{
+				std::unique_lock<std::mutex> lock(this->mutex);
+				this->startCondition.wait(lock, [this, seen] { return this->stop || this->generation != seen; });
+				if (this->stop)
+					return;
+				seen = this->generation;
+			}
+
+			this->runSlice(worker);
+
+			{
+				std::lock_guard<std::mutex> lock(this->mutex);
+				this->pending--;
+			}
+			this->doneCondition.notify_one();
+		}
+	}
+
+	void WorkerPool::runSlice(uint32_t worker)
+	{
+		uint64_t n = this->getNThreads();
+		uint32_t begin = (this->nItems * (uint64_t)worker) / n;
+		uint32_t end = (this->nItems * (uint64_t)(worker + 1)) / n;
+		if (begin < end)
+			this->job(worker, begin, end);
+	}
+}
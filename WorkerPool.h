@@ -0,0 +1,55 @@
+/*
+ * WorkerPool.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#ifndef BROADCAST_WORKERPOOL_H_
+#define BROADCAST_WORKERPOOL_H_
+
+#include "mutex"
+#include "cstdint"
+#include "thread"
+#include "vector"
+#include "functional"
+#include "condition_variable"
+
+namespace ns3
+{
+	/*
+	 * Fixed set of threads which split a range of work items.
+	 *
+	 * run() blocks until all items are processed; the calling thread takes
+	 * the first slice. Items are split into contiguous slices by the worker
+	 * index, so the same item always ends up at the same worker. The job must
+	 * not schedule events, log or touch ns-3 objects shared between slices.
+	 */
+	class WorkerPool
+	{
+	public:
+		typedef std::function<void(uint32_t worker, uint32_t begin, uint32_t end)> Job;
+
+		WorkerPool(uint32_t nThreads);
+		virtual ~WorkerPool();
+
+		uint32_t getNThreads();
+		void run(uint32_t nItems, Job job);
+
+	private:
+		std::vector<std::thread> threads;
+		std::mutex mutex;
+		std::condition_variable startCondition;
+		std::condition_variable doneCondition;
+
+		Job job;
+		uint32_t nItems;
+		uint64_t generation;
+		uint32_t pending;
+		bool stop;
+
+		void work(uint32_t worker);
+		void runSlice(uint32_t worker);
+	};
+}
+
+#endif /* BROADCAST_WORKERPOOL_H_ */
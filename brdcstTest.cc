@@ -5,6 +5,7 @@
  *      Author: Kevin Küchler
  */
 
+#include "ns3/test.h"
 #include "ns3/config.h"
 #include "ns3/core-module.h"
 #include "ns3/network-module.h"
@@ -20,6 +21,8 @@
 
 #include "ns3/csma-helper.h"
 
+#include <chrono>
+
 #include "GameState.h"
 #include "EEBTPHeader.h"
 #include "EEBTProtocol.h"
@@ -29,6 +32,28 @@
 #include "SimpleBroadcastProtocol.h"
 #include "SimpleBroadcastProtocolHelper.h"
 
+#include "LazyEnergySourceHelper.h"
+#include "GridYansWifiPhyHelper.h"
+#include "CachedPropagationLossModel.h"
+#include "EEBTPLinkLayer.h"
+#include "EEBTPEnergyRecorder.h"
+#include "ReplicationRunner.h"
+#include "SweepSpec.h"
+#include "SweepResultStore.h"
+#include "TimingTuner.h"
+#include "ResultCode.h"
+#include "CompletionMonitor.h"
+#include "ScenarioFile.h"
+#include "ResultWriter.h"
+#include "EEBTPEventTrace.h"
+#include "EEBTPProfiler.h"
+#include "EEBTPCausalGraph.h"
+#include "EEBTPPcapCapture.h"
+#include "TreeAnalytics.h"
+#include "LatencyHistogram.h"
+#include "ConvergenceSampler.h"
+#include "MemoryMonitor.h"
+
 #include "ns3/ptr.h"
 #include "float.h"
 
@@ -37,18 +62,67 @@ using namespace ns3;
 NS_LOG_COMPONENT_DEFINE("BroadcastTest");
 
 int iMax = 1, skipTo = 0;
+uint32_t jobs = 1;
+std::string sweep = "";
+std::string tune = "";
+bool run_tests = false;
 int wifi_stations = 100;
 bool eebtp = true;
 bool enable_logging = false;
 bool enable_logging_verbose = false;
 bool enable_pcap = false;
+std::string pcap_prefix = "";
+std::string pcap_nodes = "";
+std::string pcap_frame_types = "";
+int32_t pcap_max_depth = -1;
+uint32_t pcap_start = 0, pcap_stop = 0;
+uint32_t pcap_ring = 0;
+std::vector<uint32_t> pcapNodeList, pcapFrameTypeList;
 bool use_rts_cts = false;
 bool udp_test_brdcst = false;
 bool use_linear_energy_model = false;
+bool use_lazy_energy_source = false;
+bool use_grid_channel = false;
+bool grid_channel_verify = false;
+uint32_t channel_threads = 1;
+bool use_loss_cache = false;
+bool use_link_layer = false;
+bool early_stop = false;
+std::string variants = "";
+std::string scenario_file = "";
+ScenarioFile scenario;
+std::string results_prefix = "";
+ResultWriter runResults, nodeResults, depthResults, fanOutResults, latencyResults;
+std::string convergence_file = "";
+uint32_t convergence_interval = 10;
+ResultWriter convergenceResults;
+std::string memory_prefix = "";
+uint32_t memory_interval = 0;
+ResultWriter memoryRunResults, memoryNodeResults, memorySeries;
+std::string causal_path = "";
+ResultWriter causalPathResults, causalRunResults;
+std::string record_prefix = "";
+uint32_t record_node = 0;
+Ptr<EEBTProtocol> recordedProtocol;
+uint32_t early_stop_quiet = 1000;
 uint64_t rndSeed = 1001;
 uint16_t maxHopCount = 3;
 uint64_t gameID = 0;
 std::string c_cpm = "CYCLE_TEST_ASYNC";
+std::string energy_series = "";
+uint32_t energy_series_bucket = 100;
+Ptr<EEBTPEnergyRecorder> energyRecorder;
+std::string event_trace = "";
+uint32_t event_trace_records = 65536;
+bool event_trace_last = false;
+EEBTPEventTrace eventTrace;
+Ptr<GridYansWifiChannel> gridChannel;
+Ptr<CachedPropagationLossModel> lossCache;
+Ptr<EEBTPLinkLayer> linkLayer;
+Ptr<EEBTPPcapCapture> pcapCapture;
+Ptr<CompletionMonitor> completionMonitor;
+Ptr<ConvergenceSampler> convergenceSampler;
+Ptr<MemoryMonitor> memoryMonitor;
 CYCLE_PREV_METHOD cpm = CYCLE_TEST_ASYNC;
 
 double sizeX = 501.0;
@@ -78,6 +152,7 @@ void initEEBroadcast(Ptr<NetDevice> initiator)
 			gid |= addr[i];
 		}
 
+		EEBTPCausalGraph::onStart(Now().GetNanoSeconds(), initiator->GetNode()->GetId());
 		Ptr<GameState> gs = eebtp->initGameState(gid);
 		eebtp->Send(gs, FRAME_TYPE::NEIGHBOR_DISCOVERY, 20.0);
 	}
@@ -91,6 +166,159 @@ void SetupSimpleBroadcast(NetDeviceContainer wifiStations, SimpleBroadcastProtoc
 	sbph.Install(wifiStations);
 }
 
+Ptr<EEBTPEnergyAttribution> getEnergyAttribution(Ptr<NetDevice> dev)
+{
+	Ptr<EEBTProtocol> eebtp = dev->GetObject<EEBTProtocol>();
+	if (eebtp != 0)
+		return eebtp->getPacketManager()->getEnergyAttribution();
+
+	Ptr<SimpleBroadcastProtocol> sbp = dev->GetObject<SimpleBroadcastProtocol>();
+	if (sbp != 0)
+		return sbp->getEnergyAttribution();
+
+	return 0;
+}
+
+//Attach one recorder to the energy attribution of every node
+void SetupEnergyRecorder(NetDeviceContainer wifiStations)
+{
+	energyRecorder = 0;
+	if (energy_series.empty())
+		return;
+
+	energyRecorder = CreateObject<EEBTPEnergyRecorder>();
+	energyRecorder->setup(NodeList::GetNNodes(), MilliSeconds(energy_series_bucket));
+	for (NetDeviceContainer::Iterator i = wifiStations.Begin(); i != wifiStations.End(); i++)
+	{
+		Ptr<EEBTPEnergyAttribution> ea = getEnergyAttribution(*i);
+		if (ea != 0)
+			ea->setRecorder(energyRecorder);
+	}
+}
+
+void WriteEnergySeries(NetDeviceContainer wifiStations, int run)
+{
+	if (energyRecorder == 0)
+		return;
+
+	for (NetDeviceContainer::Iterator i = wifiStations.Begin(); i != wifiStations.End(); i++)
+	{
+		Ptr<EEBTPEnergyAttribution> ea = getEnergyAttribution(*i);
+		if (ea != 0)
+			ea->flushRecorder();
+	}
+
+	std::stringstream fileName;
+	fileName << energy_series << "-" << rndSeed << "-" << run << ".eer";
+	if (energyRecorder->write(fileName.str()))
+		NS_LOG_INFO("ENERGY SERIES: " << fileName.str());
+	else
+		NS_LOG_UNCOND("Could not write energy series to " << fileName.str());
+}
+
+//Open the event trace of a run and attach it to the protocol of every node
+void SetupEventTrace(NetDeviceContainer wifiStations, int run)
+{
+	if (event_trace.empty() || !eebtp)
+		return;
+
+	std::stringstream fileName;
+	fileName << event_trace << "-" << rndSeed << "-" << run << ".eet";
+	if (!eventTrace.open(fileName.str(), event_trace_records, event_trace_last))
+	{
+		NS_LOG_UNCOND("Could not open event trace: " << eventTrace.getError());
+		return;
+	}
+	NS_LOG_INFO("EVENT TRACE: " << fileName.str());
+
+	for (NetDeviceContainer::Iterator i = wifiStations.Begin(); i != wifiStations.End(); i++)
+	{
+		Ptr<EEBTProtocol> proto = (*i)->GetObject<EEBTProtocol>();
+		if (proto != 0)
+			proto->setEventTrace(&eventTrace);
+	}
+}
+
+void CloseEventTrace(NetDeviceContainer wifiStations)
+{
+	if (!eventTrace.isOpen())
+		return;
+
+	for (NetDeviceContainer::Iterator i = wifiStations.Begin(); i != wifiStations.End(); i++)
+	{
+		Ptr<EEBTProtocol> proto = (*i)->GetObject<EEBTProtocol>();
+		if (proto != 0)
+			proto->setEventTrace(0);
+	}
+	if (!eventTrace.close())
+		NS_LOG_UNCOND("Could not write event trace: " << eventTrace.getError());
+}
+
+//Attach the selective PCAP capture of a run to the PHYs, see EEBTPPcapCapture.h
+void SetupPcapCapture(NetDeviceContainer wifiStations, int run)
+{
+	pcapCapture = 0;
+	if (pcap_prefix.empty() || linkLayer != 0)
+		return;
+
+	uint32_t frameTypes = pcapFrameTypeList.empty() ? EEBTPPcapCapture::ALL_FRAME_TYPES : 0;
+	for (uint32_t ft : pcapFrameTypeList)
+		frameTypes |= 1u << ft;
+
+	std::stringstream prefix;
+	prefix << pcap_prefix << "-" << rndSeed << "-" << run;
+	pcapCapture = CreateObject<EEBTPPcapCapture>();
+	pcapCapture->setup(wifiStations, gameID, prefix.str());
+	pcapCapture->setNodes(pcapNodeList);
+	pcapCapture->setMaxDepth(pcap_max_depth);
+	pcapCapture->setFrameTypes(frameTypes);
+	pcapCapture->setWindow(MilliSeconds(pcap_start), (pcap_stop > 0) ? MilliSeconds(pcap_stop) : Time::Max());
+	pcapCapture->setRingCapacity(pcap_ring);
+	pcapCapture->start();
+}
+
+void ClosePcapCapture()
+{
+	if (pcapCapture == 0)
+		return;
+
+	pcapCapture->finish();
+	NS_LOG_INFO("PCAP: " << pcapCapture->getNCaptured() << " frames captured, " << pcapCapture->getNWritten() << " written to " << pcapCapture->getNFiles() << " files, "
+						 << pcapCapture->getNTriggers() << " triggers");
+}
+
+//Record the inputs of the protocol core of one node for tools/EEBTPCoreReplay.cc, see EEBTPCoreRecord.h
+void SetupCoreRecord(NetDeviceContainer wifiStations, int run)
+{
+	recordedProtocol = 0;
+	if (record_prefix.empty() || !eebtp)
+		return;
+
+	std::stringstream fileName;
+	fileName << record_prefix << "-" << rndSeed << "-" << run << ".ecr";
+	for (uint32_t i = 0; i < wifiStations.GetN(); i++)
+	{
+		if (wifiStations.Get(i)->GetNode()->GetId() != record_node)
+			continue;
+
+		Ptr<EEBTProtocol> proto = wifiStations.Get(i)->GetObject<EEBTProtocol>();
+		if (proto->startRecording(fileName.str()))
+			recordedProtocol = proto;
+		else
+			NS_LOG_UNCOND("Could not record node " << record_node << " into " << fileName.str() << " (only the protocol core, cpm=CORE, can be recorded)");
+	}
+}
+
+void CloseCoreRecord()
+{
+	if (recordedProtocol == 0)
+		return;
+
+	if (!recordedProtocol->stopRecording())
+		NS_LOG_UNCOND("Could not write the record of node " << record_node);
+	recordedProtocol = 0;
+}
+
 void SetupEEBroadcast(NetDeviceContainer wifiStations, EEBTProtocolHelper eebtph)
 {
 	Ptr<CycleWatchDog> cwd = Create<CycleWatchDog>();
@@ -100,7 +328,24 @@ void SetupEEBroadcast(NetDeviceContainer wifiStations, EEBTProtocolHelper eebtph
 	eebtph.Install(wifiStations);
 }
 
-std::pair<NetDeviceContainer, EnergySourceContainer> SetupSimulation()
+/*
+ * The initiator is always node 0, so the initiator of the scenario swaps its
+ * place with the first node of the file (the mapping is its own inverse)
+ */
+uint32_t getScenarioIndex(uint32_t node)
+{
+	if (node == 0)
+		return scenario.getInitiator();
+	if (node == scenario.getInitiator())
+		return 0;
+	return node;
+}
+
+/*
+ * Everything below the protocols: nodes, mobility, energy sources, PHY, MAC
+ * and the radio energy model
+ */
+std::pair<NetDeviceContainer, EnergySourceContainer> SetupTopology()
 {
 	//Create nodes
 	NodeContainer nodes;
@@ -115,27 +360,89 @@ std::pair<NetDeviceContainer, EnergySourceContainer> SetupSimulation()
 	mobility.Install(nodes);
 
 	EnergySourceContainer esc;
+
+	/*
+	 * The random variables of a run get fixed streams (the run selects the
+	 * substream), the automatic ones would depend on the runs set up before
+	 * in the same process. So a run gets the same numbers in the serial
+	 * loop, with 'skipTo', in a 'jobs' worker and in a 'variants' copy. The
+	 * protocols draw no random numbers
+	 */
 	Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable>();
+	random->SetStream(0);
 	for (NodeContainer::Iterator i = nodes.Begin(); i != nodes.End(); i++)
 	{
+		//With a scenario the energy budget and the position come from the file
+		const ScenarioFile::Node *sn = 0;
+		if (scenario.getNNodes() > 0)
+			sn = &scenario.getNode(getScenarioIndex(i - nodes.Begin()));
+
+		double initialEnergy = 10000000.0; // => J = Ws = V*As
+		if (sn != 0 && sn->energy > 0)
+			initialEnergy = sn->energy;
+
 		//Create one energy source for every node
-		BasicEnergySourceHelper energySource;
-		energySource.Set("BasicEnergySourceInitialEnergyJ", DoubleValue(10000000.0)); // => J = Ws = V*As
-		esc.Add(energySource.Install(*i));
+		if (use_lazy_energy_source)
+		{
+			LazyEnergySourceHelper energySource;
+			energySource.Set("LazyEnergySourceInitialEnergyJ", DoubleValue(initialEnergy));
+			esc.Add(energySource.Install(*i));
+		}
+		else
+		{
+			BasicEnergySourceHelper energySource;
+			energySource.Set("BasicEnergySourceInitialEnergyJ", DoubleValue(initialEnergy));
+			esc.Add(energySource.Install(*i));
+		}
 
-		//Set random position
-		Vector3D pos = Vector3D(random->GetInteger(0, sizeX - 1), random->GetInteger(0, sizeY - 1), 0);
+		//Set the position of the scenario or a random one
+		Vector3D pos = (sn != 0) ? Vector3D(sn->x, sn->y, sn->z) : Vector3D(random->GetInteger(0, sizeX - 1), random->GetInteger(0, sizeY - 1), 0);
 		(*i)->GetObject<MobilityModel>()->SetPosition(pos);
 	}
 
 	/*
 	 * PHY Layer
 	 */
-	YansWifiPhyHelper phy = YansWifiPhyHelper::Default();
-	YansWifiChannelHelper channel = YansWifiChannelHelper::Default();
+	//Cache the loss between all (static) nodes, calculated when the simulation starts
+	lossCache = 0;
+	if (use_loss_cache)
+	{
+		lossCache = CreateObject<CachedPropagationLossModel>();
+		lossCache->setModel(CreateObject<LogDistancePropagationLossModel>());
+		for (NodeContainer::Iterator i = nodes.Begin(); i != nodes.End(); i++)
+			lossCache->addMobilityModel((*i)->GetObject<MobilityModel>());
+
+		//Precomputed link gains of the scenario replace the calculation
+		for (uint64_t l = 0; l < scenario.getNLinks(); l++)
+		{
+			const ScenarioFile::Link &link = scenario.getLink(l);
+			lossCache->addLink(getScenarioIndex(link.sender), getScenarioIndex(link.receiver), link.loss);
+		}
+		Simulator::Schedule(Seconds(0), &CachedPropagationLossModel::precompute, lossCache);
+	}
 
-	channel.SetPropagationDelay("ns3::ConstantSpeedPropagationDelayModel");
-	phy.SetChannel(channel.Create());
+	//Both helpers only differ in the type of the created PHY
+	YansWifiPhyHelper phy = use_grid_channel ? GridYansWifiPhyHelper::Default() : YansWifiPhyHelper::Default();
+	gridChannel = 0;
+	if (use_grid_channel)
+	{
+		//Only deliver to nodes within range (same propagation models as below)
+		gridChannel = GridYansWifiPhyHelper::CreateChannel();
+		gridChannel->SetAttribute("Verify", BooleanValue(grid_channel_verify));
+		gridChannel->SetAttribute("Threads", UintegerValue(channel_threads));
+		if (lossCache != 0)
+			gridChannel->setPropagationLossModel(lossCache);
+		phy.SetChannel(gridChannel);
+	}
+	else
+	{
+		YansWifiChannelHelper channel = YansWifiChannelHelper::Default();
+		channel.SetPropagationDelay("ns3::ConstantSpeedPropagationDelayModel");
+		Ptr<YansWifiChannel> yansChannel = channel.Create();
+		if (lossCache != 0)
+			yansChannel->SetPropagationLossModel(lossCache);
+		phy.SetChannel(yansChannel);
+	}
 	phy.SetPreambleDetectionModel("ns3::CustomThresholdPreambleDetectionModel");
 
 	//Enable PCAP-Logging
@@ -156,6 +463,7 @@ std::pair<NetDeviceContainer, EnergySourceContainer> SetupSimulation()
 
 	//Install WiFi on all nodes
 	NetDeviceContainer wifiStations = wifi.Install(phy, mac, nodes);
+	wifi.AssignStreams(wifiStations, 1); //PHY, MAC and remote station managers
 
 	for (NetDeviceContainer::Iterator i = wifiStations.Begin(); i != wifiStations.End(); i++)
 	{
@@ -181,6 +489,14 @@ std::pair<NetDeviceContainer, EnergySourceContainer> SetupSimulation()
 	radioEnergyModel.Install(wifiStations, esc);
 
 	NS_LOG_UNCOND("Energy: " << esc.Get(0)->GetRemainingEnergy() << "J");
+	return std::pair<NetDeviceContainer, EnergySourceContainer>(wifiStations, esc);
+}
+
+/*
+ * Installs the protocol selected by 'eebtp' and 'cpm' on the topology
+ */
+void SetupProtocol(NetDeviceContainer wifiStations)
+{
 	if (eebtp)
 	{
 		EEBTProtocolHelper eebtph;
@@ -195,6 +511,11 @@ std::pair<NetDeviceContainer, EnergySourceContainer> SetupSimulation()
 			cpm = PATH_TO_SRC;
 			NS_LOG_UNCOND("Using cycle prevention method PATH_TO_SRC with" << (!use_rts_cts ? "out" : "") << " RTS/CTS");
 		}
+		else if (c_cpm == "3" || c_cpm == "CORE")
+		{
+			cpm = CYCLE_TEST_ASYNC_CORE;
+			NS_LOG_UNCOND("Using cycle prevention method CYCLE_TEST_ASYNC (protocol core) with" << (!use_rts_cts ? "out" : "") << " RTS/CTS");
+		}
 		else if (!(c_cpm == "0" || c_cpm == "CYCLE_TEST_ASYNC"))
 		{
 			NS_LOG_UNCOND("Unknown cycle prevention method: " << c_cpm << ". Using CYCLE_TEST_ASYNC with" << (!use_rts_cts ? "out" : "") << " RTS/CTS");
@@ -202,45 +523,160 @@ std::pair<NetDeviceContainer, EnergySourceContainer> SetupSimulation()
 		else
 			NS_LOG_UNCOND("Using cycle prevention method CYCLE_TEST_ASYNC with" << (!use_rts_cts ? "out" : "") << " RTS/CTS");
 		SetupEEBroadcast(wifiStations, eebtph);
+
+		//Deliver the EEBTP frames over an SNR graph instead of the Wi-Fi MAC/PHY
+		linkLayer = 0;
+		if (use_link_layer)
+		{
+			linkLayer = CreateObject<EEBTPLinkLayer>();
+			linkLayer->setPropagationLossModel(CreateObject<LogDistancePropagationLossModel>());
+			linkLayer->setPropagationDelayModel(CreateObject<ConstantSpeedPropagationDelayModel>());
+			linkLayer->install(wifiStations);
+		}
 	}
 	else
 	{
 		SimpleBroadcastProtocolHelper sbph;
 		SetupSimpleBroadcast(wifiStations, sbph);
 	}
+	SetupEnergyRecorder(wifiStations);
+}
 
-	return std::pair<NetDeviceContainer, EnergySourceContainer>(wifiStations, esc);
+std::pair<NetDeviceContainer, EnergySourceContainer> SetupSimulation()
+{
+	std::pair<NetDeviceContainer, EnergySourceContainer> pair = SetupTopology();
+	SetupProtocol(pair.first);
+	return pair;
 }
 
 /*
- * Helper methods
+ * Structured results, see OpenResultWriters() for the columns
  */
-int getTreeDepth(Mac48Address node, std::map<Mac48Address, std::vector<Mac48Address>> tree, std::map<Mac48Address, int> *nodeDepth, int depth)
+const char *FRAME_TYPE_NAMES[8] = {"cycle_check", "neighbor_discovery", "child_request", "child_confirmation", "child_rejection", "parent_revocation", "end_of_game", "application_data"};
+
+struct NodeResult
+{
+	uint32_t id;
+	std::string address;
+	std::string parent;
+	double txPower;
+	int64_t timeFinished;
+	int64_t missingPackets;
+	int depth;
+	uint32_t subtreeSize;
+	uint32_t children;
+	double energyRecv[8];
+	double energySent[8];
+};
+
+std::string GetProtocolName()
 {
-	int d = depth;
-	(*nodeDepth)[node] = d;
+	if (!eebtp)
+		return "SIMPLE";
+	switch (cpm)
+	{
+	case MUTEX:
+		return "MUTEX";
+	case PATH_TO_SRC:
+		return "PATH_TO_SRC";
+	case CYCLE_TEST_ASYNC_CORE:
+		return "CORE";
+	case CYCLE_TEST_ASYNC:
+	default:
+		return "CYCLE_TEST_ASYNC";
+	}
+}
 
-	for (Mac48Address n : tree[node])
+void OpenResultWriters()
+{
+	std::vector<std::string> convergenceColumns = {"seed", "run", "protocol", "time_ns", "tx_power_w", "connected_nodes", "parent_changes", "live_cycles", "frames_in_flight"};
+	if (!convergence_file.empty() && !convergenceResults.open(convergence_file, convergenceColumns))
+		NS_FATAL_ERROR("Cannot open the convergence series " << convergence_file << " (or it has other columns)");
+
+	if (!memory_prefix.empty())
 	{
-		int x = getTreeDepth(n, tree, nodeDepth, depth + 1);
-		if (x > d)
-			d = x;
+		//Current and peak bytes per module, the total first
+		std::vector<std::string> usageColumns = {"total_bytes", "total_peak_bytes"};
+		for (uint32_t m = 0; m < MemoryUsage::N_MODULES; m++)
+		{
+			usageColumns.push_back(std::string(MemoryUsage::getModuleName(m)) + "_bytes");
+			usageColumns.push_back(std::string(MemoryUsage::getModuleName(m)) + "_peak_bytes");
+		}
+		std::vector<std::string> memoryRunColumns = {"seed", "run", "protocol", "nodes"};
+		std::vector<std::string> memoryNodeColumns = {"seed", "run", "protocol", "node"};
+		memoryRunColumns.insert(memoryRunColumns.end(), usageColumns.begin(), usageColumns.end());
+		memoryNodeColumns.insert(memoryNodeColumns.end(), usageColumns.begin(), usageColumns.end());
+
+		std::vector<std::string> memorySeriesColumns = {"seed", "run", "protocol", "time_ns", "total_bytes"};
+		for (uint32_t m = 0; m < MemoryUsage::N_MODULES; m++)
+			memorySeriesColumns.push_back(std::string(MemoryUsage::getModuleName(m)) + "_bytes");
+
+		if (!memoryRunResults.open(memory_prefix + "-runs.csv", memoryRunColumns) || !memoryNodeResults.open(memory_prefix + "-nodes.csv", memoryNodeColumns) ||
+			(memory_interval > 0 && !memorySeries.open(memory_prefix + "-series.csv", memorySeriesColumns)))
+			NS_FATAL_ERROR("Cannot open the memory files " << memory_prefix << "-*.csv (or they have other columns)");
 	}
 
-	return d;
+	if (!causal_path.empty())
+	{
+		std::vector<std::string> causalPathColumns = {"seed", "run", "protocol", "step", "time_ns", "node", "action", "frame_type", "wait_ns", "category"};
+		std::vector<std::string> causalRunColumns = {"seed", "run", "protocol", "actions", "steps", "time_ns"};
+		for (uint32_t c = 0; c < EEBTPCausalGraph::N_CATEGORIES; c++)
+		{
+			causalRunColumns.push_back(std::string(EEBTPCausalGraph::getCategoryName(c)) + "_ns");
+			causalRunColumns.push_back(std::string(EEBTPCausalGraph::getCategoryName(c)) + "_steps");
+		}
+
+		if (!causalPathResults.open(causal_path + "-paths.csv", causalPathColumns) || !causalRunResults.open(causal_path + "-runs.csv", causalRunColumns))
+			NS_FATAL_ERROR("Cannot open the causal path files " << causal_path << "-*.csv (or they have other columns)");
+	}
+
+	if (results_prefix.empty())
+		return;
+
+	std::vector<std::string> runColumns = {"seed", "run", "protocol", "nodes", "total_energy", "construction_energy", "application_energy", "idle_energy", "unattributed_energy",
+										   "total_tx_power", "time_to_build_initiator_ns", "max_time_to_build_ns", "tree_depth", "unconnected_nodes", "cycles", "cycles_lasted",
+										   "deepest_node", "critical_path"};
+	const char *perFrame[6] = {"energy_recv_", "energy_sent_", "data_recv_", "data_sent_", "packets_recv_", "packets_sent_"};
+	for (const char *prefix : perFrame)
+		for (const char *ft : FRAME_TYPE_NAMES)
+			runColumns.push_back(std::string(prefix) + ft);
+
+	std::vector<std::string> nodeColumns = {"seed", "run", "protocol", "node", "address", "parent", "depth", "subtree_size", "children", "tx_power_dbm", "time_finished_ns", "missing_packets"};
+	for (const char *prefix : {"energy_recv_", "energy_sent_"})
+		for (const char *ft : FRAME_TYPE_NAMES)
+			nodeColumns.push_back(std::string(prefix) + ft);
+
+	std::vector<std::string> depthColumns = {"seed", "run", "protocol", "depth", "nodes", "lost_packets", "loss_ratio", "tx_power_w"};
+	std::vector<std::string> fanOutColumns = {"seed", "run", "protocol", "children", "nodes"};
+	std::vector<std::string> latencyColumns = {"seed", "run", "protocol", "depth", "packets", "min_ns", "mean_ns", "p50_ns", "p99_ns", "p999_ns", "max_ns"};
+
+	if (!runResults.open(results_prefix + "-runs.csv", runColumns) || !nodeResults.open(results_prefix + "-nodes.csv", nodeColumns) ||
+		!depthResults.open(results_prefix + "-depths.csv", depthColumns) || !fanOutResults.open(results_prefix + "-fanout.csv", fanOutColumns) ||
+		!latencyResults.open(results_prefix + "-latency.csv", latencyColumns))
+		NS_FATAL_ERROR("Cannot open the result files " << results_prefix << "-*.csv (or they have other columns)");
+}
+
+template <typename T>
+void SetResultField(std::vector<std::string> &fields, uint32_t field, T value)
+{
+	std::stringstream str;
+	str << value;
+	fields[field] = str.str();
 }
 
 /*
- * Print method to print simulation results
+ * Print method to print simulation results, returns the result code
  */
-void PrintResult(NetDeviceContainer wifiStations, EnergySourceContainer esc)
+std::string PrintResult(NetDeviceContainer wifiStations, EnergySourceContainer esc, int run)
 {
+	std::vector<NodeResult> nodeResultList;
 	int treeDepth = 0;
 	uint32_t unconNodes = 0;
 	uint32_t cycles = 0, cyclesLasted = 0;
 	Time timeToBuildInitiator, maxTimeToBuild;
 	double totalTxPower = 0.0, totalEnergy = 0.0;
 	double totalConstructionEnergy = 0.0, totalApplicationEnergy = 0.0;
+	double totalIdleEnergy = 0.0, totalUnattributedEnergy = 0.0;
 
 	double energyPerFrameRecv[8]{0, 0, 0, 0, 0, 0, 0, 0};
 	double energyPerFrameSent[8]{0, 0, 0, 0, 0, 0, 0, 0};
@@ -252,6 +688,11 @@ void PrintResult(NetDeviceContainer wifiStations, EnergySourceContainer esc)
 	int maxPackets;
 	std::map<int, int> packetLostPerDepth;
 	std::map<int, int> maxPacketsPerDepth;
+	std::map<int, double> txPowerPerDepth;
+	std::map<int, LatencyHistogram> latencyPerDepth;
+	TreeAnalytics analytics;
+	std::vector<uint32_t> nodeIds;
+	std::string deepestNode, criticalPath;
 
 	if (eebtp)
 	{
@@ -263,20 +704,27 @@ void PrintResult(NetDeviceContainer wifiStations, EnergySourceContainer esc)
 		case PATH_TO_SRC:
 			NS_LOG_INFO("CYCLE PREVENTION METHOD: PATH_TO_SRC");
 			break;
+		case CYCLE_TEST_ASYNC_CORE:
+			NS_LOG_INFO("CYCLE PREVENTION METHOD: CYCLE_TEST_ASYNC (protocol core)");
+			break;
 		case CYCLE_TEST_ASYNC:
 		default:
 			NS_LOG_INFO("CYCLE PREVENTION METHOD: CYCLE_TEST_ASYNC");
 			break;
 		}
-		NS_LOG_INFO("MAX_UNCHANGED_ROUNDS: " << EEBTProtocol::MAX_UNCHANGED_ROUNDS << "\n");
-
-		Mac48Address source;
-		std::vector<Mac48Address> nodeList;
+		//The attribute can be changed on the command line or by the tuner
+		UintegerValue maxUnchangedRounds;
+		wifiStations.Get(0)->GetObject<EEBTProtocol>()->GetAttribute("MaxUnchangedRounds", maxUnchangedRounds);
+		NS_LOG_INFO("MAX_UNCHANGED_ROUNDS: " << maxUnchangedRounds.Get() << "\n");
+
+		//Index of every node in the flat tree arrays, the source is 0
+		std::map<Mac48Address, uint32_t> nodeIndex;
+		std::vector<Mac48Address> nodeList, parentList;
 		std::vector<Mac48Address> cycledNodes;
 
-		std::map<Mac48Address, int> nodeDepth;
-		std::map<Mac48Address, int> packetLossPerNode;
-		std::map<Mac48Address, std::vector<Mac48Address>> tree;
+		std::vector<int64_t> packetLossPerNode;
+		std::vector<double> txPowerPerNode;
+		std::vector<LatencyHistogram> latencyPerNode;
 		for (NetDeviceContainer::Iterator i = wifiStations.Begin(); i != wifiStations.End(); i++)
 		{
 			Ptr<WifiNetDevice> dev = DynamicCast<WifiNetDevice>(*i);
@@ -289,28 +737,30 @@ void PrintResult(NetDeviceContainer wifiStations, EnergySourceContainer esc)
 				Ptr<CycleWatchDog> cwd = proto->getCycleWatchDog();
 
 				if (i == wifiStations.Begin())
-				{
-					source = gs->getMyAddress();
 					maxPackets = proto->maxPackets;
-				}
+				nodeIndex[gs->getMyAddress()] = nodeList.size();
 				nodeList.push_back(gs->getMyAddress());
+				nodeIds.push_back(node->GetId());
 
 				if (gs->getParent() != 0)
 				{
 					NS_LOG_INFO("The parent of node [" << gs->getMyAddress() << "] is [" << gs->getParent()->getAddress() << "]");
-					tree[gs->getParent()->getAddress()].push_back(gs->getMyAddress());
+					parentList.push_back(gs->getParent()->getAddress());
 				}
 				else
 				{
 					unconNodes++;
+					parentList.push_back(Mac48Address::GetBroadcast());
 					NS_LOG_INFO("The parent of node [" << Mac48Address::ConvertFrom(dev->GetAddress()) << "] is [" << Mac48Address::GetBroadcast() << "]");
 				}
 
 				totalConstructionEnergy += proto->getEnergyForConstruction(gameID);
 				totalApplicationEnergy += proto->getEnergyByFrameType(gameID, APPLICATION_DATA);
+				totalIdleEnergy += pm->getIdleEnergy();
+				totalUnattributedEnergy += pm->getUnattributedEnergy();
 
-				if (gs->getHighestTxPower() > -FLT_MAX)
-					totalTxPower += DbmToW(gs->getHighestTxPower());
+				txPowerPerNode.push_back(gs->getHighestTxPower() > -FLT_MAX ? DbmToW(gs->getHighestTxPower()) : 0.0);
+				totalTxPower += txPowerPerNode.back();
 
 				if (gs->isInitiator())
 					timeToBuildInitiator = gs->getTimeFinished();
@@ -343,7 +793,30 @@ void PrintResult(NetDeviceContainer wifiStations, EnergySourceContainer esc)
 					packetsPerFrameSent[i] += pm->getFrameTypeSent(gameID, i);
 				}
 
-				packetLossPerNode[gs->getMyAddress()] = proto->maxPackets - gs->getApplicationDataHandler()->getPacketCount();
+				packetLossPerNode.push_back(proto->maxPackets - gs->getApplicationDataHandler()->getPacketCount());
+				latencyPerNode.push_back(gs->getApplicationDataHandler()->getLatency());
+
+				if (nodeResults.isOpen())
+				{
+					std::stringstream address, parent;
+					address << gs->getMyAddress();
+					if (gs->getParent() != 0)
+						parent << gs->getParent()->getAddress();
+
+					NodeResult nr;
+					nr.id = node->GetId();
+					nr.address = address.str();
+					nr.parent = parent.str();
+					nr.txPower = gs->getHighestTxPower();
+					nr.timeFinished = gs->getTimeFinished().GetNanoSeconds();
+					nr.missingPackets = packetLossPerNode.back();
+					for (uint8_t i = 0; i < 8; i++)
+					{
+						nr.energyRecv[i] = pm->getEnergyByRecvFrame(gameID, i);
+						nr.energySent[i] = pm->getEnergyBySentFrame(gameID, i);
+					}
+					nodeResultList.push_back(nr);
+				}
 			}
 			else
 				NS_LOG_INFO("Node " << node->GetId() << " has no EEBTProtocol installed!");
@@ -352,20 +825,59 @@ void PrintResult(NetDeviceContainer wifiStations, EnergySourceContainer esc)
 		//Subtract on since the source node is seen as unconnected
 		unconNodes--;
 
-		//Remove cycled node from tree
+		//Flat parent array, the children of cycled nodes are cut off the tree
+		std::vector<bool> cycled(nodeList.size(), false);
 		for (Mac48Address addr : cycledNodes)
-			tree[addr].clear();
+			if (nodeIndex.find(addr) != nodeIndex.end())
+				cycled[nodeIndex[addr]] = true;
+
+		std::vector<int32_t> parent(nodeList.size(), -1);
+		for (uint32_t i = 0; i < nodeList.size(); i++)
+		{
+			std::map<Mac48Address, uint32_t>::iterator it = nodeIndex.find(parentList[i]);
+			if (it != nodeIndex.end() && !cycled[it->second])
+				parent[i] = it->second;
+		}
 
-		//Calculate tree depth
-		treeDepth = getTreeDepth(source, tree, &nodeDepth, 0);
+		analytics.analyze(parent, 0);
+		analytics.setLoss(packetLossPerNode);
+		analytics.setTxPower(txPowerPerNode);
+		treeDepth = analytics.getTreeDepth();
 
-		//Calculate packetloss on every tree depth level and the total amount of to expect packets on these levels
-		for (Mac48Address node : nodeList)
+		//Node IDs from the source to the deepest node
+		for (uint32_t i : analytics.getCriticalPath())
+			criticalPath += (criticalPath.empty() ? "" : " ") + std::to_string(nodeIds[i]);
+		deepestNode = std::to_string(nodeIds[analytics.getDeepestNode()]);
+		NS_LOG_INFO("Critical path (" << treeDepth << " hops): " << criticalPath);
+
+		//Nodes which are not in the tree have no depth
+		for (uint32_t i = 0; i < nodeResultList.size(); i++)
+		{
+			nodeResultList[i].depth = analytics.getDepth(i);
+			nodeResultList[i].subtreeSize = analytics.getSubtreeSize(i);
+			nodeResultList[i].children = analytics.getNChildren(i);
+		}
+
+		for (uint32_t i = 0; i < nodeList.size(); i++)
+			NS_LOG_UNCOND("Node " << nodeList[i] << " is " << std::max(analytics.getDepth(i), 0) << " deep");
+
+		//Packetloss, the total amount of to expect packets and the TX power on every tree depth level
+		for (int d = 0; d <= treeDepth; d++)
 		{
-			NS_LOG_UNCOND("Node " << node << " is " << nodeDepth[node] << " deep");
-			packetLostPerDepth[nodeDepth[node]] += packetLossPerNode[node];
-			maxPacketsPerDepth[nodeDepth[node]]++;
+			packetLostPerDepth[d] = analytics.getLossPerDepth()[d];
+			maxPacketsPerDepth[d] = analytics.getNodesPerDepth()[d];
+			txPowerPerDepth[d] = analytics.getTxPowerPerDepth()[d];
 		}
+
+		//Latency of the application data from the source, per depth
+		for (uint32_t i = 0; i < latencyPerNode.size(); i++)
+		{
+			if (analytics.getDepth(i) > 0)
+				latencyPerDepth[analytics.getDepth(i)].add(latencyPerNode[i]);
+		}
+		for (std::pair<const int, LatencyHistogram> &l : latencyPerDepth)
+			NS_LOG_INFO("Latency[" << l.first << "]: " << l.second.getCount() << " packets; p50: " << l.second.getPercentile(50) << "ns; p99: " << l.second.getPercentile(99)
+								   << "ns; p999: " << l.second.getPercentile(99.9) << "ns; max: " << l.second.getMax() << "ns");
 	} //end if(eebtp)
 	else
 	{
@@ -380,12 +892,27 @@ void PrintResult(NetDeviceContainer wifiStations, EnergySourceContainer esc)
 			{
 				totalEnergy += proto->getSentEnergy();
 				totalApplicationEnergy += proto->getSentEnergy();
+				totalIdleEnergy += proto->getIdleEnergy();
 				energyPerFrameRecv[7] += proto->getRecvEnergy();
 				energyPerFrameSent[7] += proto->getSentEnergy();
 				dataPerFrameRecv[7] += proto->getRecvData();
 				dataPerFrameSent[7] += proto->getSentData();
 				packetsPerFrameRecv[7] += proto->getRecvPackets();
 				packetsPerFrameSent[7] += proto->getSentPackets();
+
+				if (nodeResults.isOpen())
+				{
+					NodeResult nr = NodeResult();
+					nr.id = node->GetId();
+					nr.address = "";
+					nr.txPower = 23.0;
+					nr.missingPackets = -1;
+					nr.depth = 1;
+					nr.subtreeSize = 1;
+					nr.energyRecv[7] = proto->getRecvEnergy();
+					nr.energySent[7] = proto->getSentEnergy();
+					nodeResultList.push_back(nr);
+				}
 				NS_LOG_UNCOND("Node " << node->GetId() << " has sent " << proto->getSentPackets() << " packets and used " << proto->getSentEnergy() << "J");
 			}
 			else
@@ -396,12 +923,39 @@ void PrintResult(NetDeviceContainer wifiStations, EnergySourceContainer esc)
 		maxPackets = 1000;
 		maxPacketsPerDepth[1] = wifi_stations;
 		packetLostPerDepth[1] = (maxPacketsPerDepth[1] * maxPackets) - packetsPerFrameSent[7];
+		txPowerPerDepth[1] = totalTxPower;
 	}
 
 	for (EnergySourceContainer::Iterator i = esc.Begin(); i != esc.End(); i++)
 		totalEnergy += ((*i)->GetInitialEnergy() - (*i)->GetRemainingEnergy());
 
 	NS_LOG_INFO("Total energy consumed: " << totalEnergy << "J");
+	NS_LOG_INFO("Total idle energy: " << totalIdleEnergy << "J");
+
+	//Idle energy of the time cut off by the early stop, not part of the other results
+	if (completionMonitor != 0 && completionMonitor->isComplete())
+	{
+		double skippedIdleEnergy = 0.0;
+		for (NetDeviceContainer::Iterator i = wifiStations.Begin(); i != wifiStations.End(); i++)
+		{
+			Ptr<EEBTPEnergyAttribution> ea = getEnergyAttribution(*i);
+			if (ea != 0)
+				skippedIdleEnergy += ea->getIdleEnergy(completionMonitor->getIdleTime());
+		}
+		NS_LOG_INFO("Idle energy until the time limit (not simulated): " << skippedIdleEnergy << "J for " << completionMonitor->getIdleTime());
+	}
+	NS_LOG_INFO("Total unattributed TX/RX energy: " << totalUnattributedEnergy << "J");
+
+	//Every received frame occupied a radio in RX, no energy for them means the RX intervals were not matched (setRxFrame())
+	uint32_t totalPacketsRecv = 0;
+	double totalEnergyRecv = 0.0;
+	for (uint8_t i = 0; i < 8; i++)
+	{
+		totalPacketsRecv += packetsPerFrameRecv[i];
+		totalEnergyRecv += energyPerFrameRecv[i];
+	}
+	if (totalPacketsRecv > 0 && totalEnergyRecv <= 0 && totalUnattributedEnergy > 0)
+		NS_FATAL_ERROR("No RX energy attributed to the " << totalPacketsRecv << " received frames, " << totalUnattributedEnergy << "J unattributed");
 	NS_LOG_INFO("Total configured TX power: " << WToDbm(totalTxPower) << "dBm / " << totalTxPower << "W");
 
 	std::stringstream str;
@@ -415,15 +969,135 @@ void PrintResult(NetDeviceContainer wifiStations, EnergySourceContainer esc)
 	if (s.length() > 0)
 		s.erase(s.end() - 1);
 
-	NS_LOG_INFO("CODE: " << totalEnergy << ";" << totalConstructionEnergy << ";" << totalApplicationEnergy << ";" << totalTxPower << ";" << timeToBuildInitiator.GetNanoSeconds() << ";"
-						 << maxTimeToBuild.GetNanoSeconds() << ";" << treeDepth << ";" << unconNodes << ";" << cycles << ";" << cyclesLasted << ";"
-						 << energyPerFrameRecv[0] << ";" << energyPerFrameRecv[1] << ";" << energyPerFrameRecv[2] << ";" << energyPerFrameRecv[3] << ";" << energyPerFrameRecv[4] << ";" << energyPerFrameRecv[5] << ";" << energyPerFrameRecv[6] << ";" << energyPerFrameRecv[7] << ";"
-						 << energyPerFrameSent[0] << ";" << energyPerFrameSent[1] << ";" << energyPerFrameSent[2] << ";" << energyPerFrameSent[3] << ";" << energyPerFrameSent[4] << ";" << energyPerFrameSent[5] << ";" << energyPerFrameSent[6] << ";" << energyPerFrameSent[7] << ";"
-						 << dataPerFrameRecv[0] << ";" << dataPerFrameRecv[1] << ";" << dataPerFrameRecv[2] << ";" << dataPerFrameRecv[3] << ";" << dataPerFrameRecv[4] << ";" << dataPerFrameRecv[5] << ";" << dataPerFrameRecv[6] << ";" << dataPerFrameRecv[7] << ";"
-						 << dataPerFrameSent[0] << ";" << dataPerFrameSent[1] << ";" << dataPerFrameSent[2] << ";" << dataPerFrameSent[3] << ";" << dataPerFrameSent[4] << ";" << dataPerFrameSent[5] << ";" << dataPerFrameSent[6] << ";" << dataPerFrameSent[7] << ";"
-						 << packetsPerFrameRecv[0] << ";" << packetsPerFrameRecv[1] << ";" << packetsPerFrameRecv[2] << ";" << packetsPerFrameRecv[3] << ";" << packetsPerFrameRecv[4] << ";" << packetsPerFrameRecv[5] << ";" << packetsPerFrameRecv[6] << ";" << packetsPerFrameRecv[7] << ";"
-						 << packetsPerFrameSent[0] << ";" << packetsPerFrameSent[1] << ";" << packetsPerFrameSent[2] << ";" << packetsPerFrameSent[3] << ";" << packetsPerFrameSent[4] << ";" << packetsPerFrameSent[5] << ";" << packetsPerFrameSent[6] << ";" << packetsPerFrameSent[7] << ";"
-						 << s);
+	//Fields in the order of ResultCode.h
+	std::vector<std::string> fields(ResultCode::LOSS_PER_DEPTH);
+	SetResultField(fields, ResultCode::TOTAL_ENERGY, totalEnergy);
+	SetResultField(fields, ResultCode::CONSTRUCTION_ENERGY, totalConstructionEnergy);
+	SetResultField(fields, ResultCode::APPLICATION_ENERGY, totalApplicationEnergy);
+	SetResultField(fields, ResultCode::TX_POWER, totalTxPower);
+	SetResultField(fields, ResultCode::TIME_TO_BUILD_INITIATOR, timeToBuildInitiator.GetNanoSeconds());
+	SetResultField(fields, ResultCode::MAX_TIME_TO_BUILD, maxTimeToBuild.GetNanoSeconds());
+	SetResultField(fields, ResultCode::TREE_DEPTH, treeDepth);
+	SetResultField(fields, ResultCode::UNCONNECTED_NODES, unconNodes);
+	SetResultField(fields, ResultCode::CYCLES, cycles);
+	SetResultField(fields, ResultCode::CYCLES_LASTED, cyclesLasted);
+	for (uint32_t i = 0; i < ResultCode::N_FRAME_TYPES; i++)
+	{
+		SetResultField(fields, ResultCode::ENERGY_PER_FRAME_RECV + i, energyPerFrameRecv[i]);
+		SetResultField(fields, ResultCode::ENERGY_PER_FRAME_SENT + i, energyPerFrameSent[i]);
+		SetResultField(fields, ResultCode::DATA_PER_FRAME_RECV + i, dataPerFrameRecv[i]);
+		SetResultField(fields, ResultCode::DATA_PER_FRAME_SENT + i, dataPerFrameSent[i]);
+		SetResultField(fields, ResultCode::PACKETS_PER_FRAME_RECV + i, packetsPerFrameRecv[i]);
+		SetResultField(fields, ResultCode::PACKETS_PER_FRAME_SENT + i, packetsPerFrameSent[i]);
+	}
+
+	std::stringstream code;
+	for (const std::string &field : fields)
+		code << field << ";";
+	code << s;
+	NS_LOG_INFO("CODE: " << code.str());
+
+	if (runResults.isOpen())
+	{
+		std::string protocol = GetProtocolName();
+
+		runResults.add(rndSeed);
+		runResults.add(run);
+		runResults.add(protocol);
+		runResults.add((uint32_t)wifiStations.GetN());
+		runResults.add(totalEnergy);
+		runResults.add(totalConstructionEnergy);
+		runResults.add(totalApplicationEnergy);
+		runResults.add(totalIdleEnergy);
+		runResults.add(totalUnattributedEnergy);
+		runResults.add(totalTxPower);
+		runResults.add(timeToBuildInitiator.GetNanoSeconds());
+		runResults.add(maxTimeToBuild.GetNanoSeconds());
+		runResults.add(treeDepth);
+		runResults.add(unconNodes);
+		runResults.add(cycles);
+		runResults.add(cyclesLasted);
+		runResults.add(deepestNode);
+		runResults.add(criticalPath);
+		for (uint8_t i = 0; i < 8; i++)
+			runResults.add(energyPerFrameRecv[i]);
+		for (uint8_t i = 0; i < 8; i++)
+			runResults.add(energyPerFrameSent[i]);
+		for (uint8_t i = 0; i < 8; i++)
+			runResults.add(dataPerFrameRecv[i]);
+		for (uint8_t i = 0; i < 8; i++)
+			runResults.add(dataPerFrameSent[i]);
+		for (uint8_t i = 0; i < 8; i++)
+			runResults.add(packetsPerFrameRecv[i]);
+		for (uint8_t i = 0; i < 8; i++)
+			runResults.add(packetsPerFrameSent[i]);
+		runResults.endRow();
+		runResults.flush();
+
+		for (const NodeResult &nr : nodeResultList)
+		{
+			nodeResults.add(rndSeed);
+			nodeResults.add(run);
+			nodeResults.add(protocol);
+			nodeResults.add(nr.id);
+			nodeResults.add(nr.address);
+			nodeResults.add(nr.parent);
+			nodeResults.add(nr.depth);
+			nodeResults.add(nr.subtreeSize);
+			nodeResults.add(nr.children);
+			nodeResults.add(nr.txPower);
+			nodeResults.add(nr.timeFinished);
+			nodeResults.add(nr.missingPackets);
+			for (uint8_t i = 0; i < 8; i++)
+				nodeResults.add(nr.energyRecv[i]);
+			for (uint8_t i = 0; i < 8; i++)
+				nodeResults.add(nr.energySent[i]);
+			nodeResults.endRow();
+		}
+		nodeResults.flush();
+
+		for (int i = 1; i <= treeDepth; i++)
+		{
+			depthResults.add(rndSeed);
+			depthResults.add(run);
+			depthResults.add(protocol);
+			depthResults.add(i);
+			depthResults.add(maxPacketsPerDepth[i]);
+			depthResults.add(packetLostPerDepth[i]);
+			depthResults.add((double)packetLostPerDepth[i] / (double)(maxPacketsPerDepth[i] * maxPackets));
+			depthResults.add(txPowerPerDepth[i]);
+			depthResults.endRow();
+		}
+		depthResults.flush();
+
+		for (std::pair<const int, LatencyHistogram> &l : latencyPerDepth)
+		{
+			latencyResults.add(rndSeed);
+			latencyResults.add(run);
+			latencyResults.add(protocol);
+			latencyResults.add(l.first);
+			latencyResults.add(l.second.getCount());
+			latencyResults.add(l.second.getMin());
+			latencyResults.add(l.second.getMean());
+			latencyResults.add(l.second.getPercentile(50));
+			latencyResults.add(l.second.getPercentile(99));
+			latencyResults.add(l.second.getPercentile(99.9));
+			latencyResults.add(l.second.getMax());
+			latencyResults.endRow();
+		}
+		latencyResults.flush();
+
+		for (uint32_t i = 0; i < analytics.getFanOutHistogram().size(); i++)
+		{
+			fanOutResults.add(rndSeed);
+			fanOutResults.add(run);
+			fanOutResults.add(protocol);
+			fanOutResults.add(i);
+			fanOutResults.add(analytics.getFanOutHistogram()[i]);
+			fanOutResults.endRow();
+		}
+		fanOutResults.flush();
+	}
 
 	if (eebtp)
 	{
@@ -436,12 +1110,38 @@ void PrintResult(NetDeviceContainer wifiStations, EnergySourceContainer esc)
 				NS_LOG_INFO(*proto);
 		}
 	}
+	return code.str();
 }
 
 void DoSimulation(NetDeviceContainer wifiStations)
 {
-	//Set time limit for simulation (20 seconds)
-	Simulator::Stop(Seconds(20));
+	//Set time limit for simulation (20 seconds), with 'earlyStop' it is the backstop of the CompletionMonitor
+	Time limit = Seconds(20);
+	Simulator::Stop(limit);
+
+	completionMonitor = 0;
+	if (early_stop && eebtp)
+	{
+		completionMonitor = CreateObject<CompletionMonitor>();
+		completionMonitor->setup(wifiStations, gameID, MilliSeconds(100), MilliSeconds(early_stop_quiet));
+		completionMonitor->start(limit);
+	}
+
+	convergenceSampler = 0;
+	if (convergenceResults.isOpen() && eebtp)
+	{
+		convergenceSampler = CreateObject<ConvergenceSampler>();
+		convergenceSampler->setup(wifiStations, gameID, MilliSeconds(convergence_interval));
+		convergenceSampler->start(limit);
+	}
+
+	memoryMonitor = 0;
+	if (memoryRunResults.isOpen() && eebtp)
+	{
+		memoryMonitor = CreateObject<MemoryMonitor>();
+		memoryMonitor->setup(wifiStations, MilliSeconds(memory_interval));
+		memoryMonitor->start(limit);
+	}
 
 	Ptr<NetDevice> sourceNode = wifiStations.Get(0);
 
@@ -453,10 +1153,311 @@ void DoSimulation(NetDeviceContainer wifiStations)
 			Simulator::ScheduleWithContext(sourceNode->GetNode()->GetId(), MilliSeconds(i * 10), &initSimpleBroadcast, sourceNode, maxHopCount, i);
 	}
 
-	//Start simulation
+	//Start simulation, the self time of this scope is spent outside of the profiled code
+	EEBTP_PROFILE_SCOPE("Simulator::Run");
 	Simulator::Run();
 }
 
+//Appends the convergence series of a run (one row per sample)
+void WriteConvergence(int run)
+{
+	if (convergenceSampler == 0)
+		return;
+
+	convergenceSampler->finish();
+	for (const ConvergenceSampler::Sample &s : convergenceSampler->getSamples())
+	{
+		convergenceResults.add(rndSeed);
+		convergenceResults.add(run);
+		convergenceResults.add(GetProtocolName());
+		convergenceResults.add(s.time.GetNanoSeconds());
+		convergenceResults.add(s.txPower);
+		convergenceResults.add(s.connected);
+		convergenceResults.add(s.parentChanges);
+		convergenceResults.add(s.liveCycles);
+		convergenceResults.add(s.framesInFlight);
+		convergenceResults.endRow();
+	}
+	convergenceResults.flush();
+}
+
+//Adds the current and the peak bytes of every module, the total first
+void AddMemoryUsage(ResultWriter &writer, const MemoryUsage &usage, const MemoryUsage &peak, uint64_t peakTotal)
+{
+	writer.add(usage.getTotal());
+	writer.add(peakTotal);
+	for (uint32_t m = 0; m < MemoryUsage::N_MODULES; m++)
+	{
+		writer.add(usage.bytes[m]);
+		writer.add(peak.bytes[m]);
+	}
+}
+
+//Appends the memory of a run: the sums, every node and the series (with 'memoryInterval')
+void WriteMemoryUsage(int run)
+{
+	if (memoryMonitor == 0)
+		return;
+
+	memoryMonitor->finish();
+	MemoryUsage usage = memoryMonitor->getUsage();
+	NS_LOG_INFO("MEMORY: " << usage.getTotal() << " bytes at the end, " << memoryMonitor->getPeakTotal() << " bytes peak");
+
+	memoryRunResults.add(rndSeed);
+	memoryRunResults.add(run);
+	memoryRunResults.add(GetProtocolName());
+	memoryRunResults.add(memoryMonitor->getNNodes());
+	AddMemoryUsage(memoryRunResults, usage, memoryMonitor->getPeak(), memoryMonitor->getPeakTotal());
+	memoryRunResults.endRow();
+	memoryRunResults.flush();
+
+	for (uint32_t n = 0; n < memoryMonitor->getNNodes(); n++)
+	{
+		MemoryUsage nodePeak = memoryMonitor->getNodePeak(n);
+		memoryNodeResults.add(rndSeed);
+		memoryNodeResults.add(run);
+		memoryNodeResults.add(GetProtocolName());
+		memoryNodeResults.add(memoryMonitor->getNodeId(n));
+		AddMemoryUsage(memoryNodeResults, memoryMonitor->getNodeUsage(n), nodePeak, nodePeak.getTotal());
+		memoryNodeResults.endRow();
+	}
+	memoryNodeResults.flush();
+
+	if (!memorySeries.isOpen())
+		return;
+	for (const MemoryMonitor::Sample &s : memoryMonitor->getSamples())
+	{
+		memorySeries.add(rndSeed);
+		memorySeries.add(run);
+		memorySeries.add(GetProtocolName());
+		memorySeries.add(s.time.GetNanoSeconds());
+		memorySeries.add(s.usage.getTotal());
+		for (uint32_t m = 0; m < MemoryUsage::N_MODULES; m++)
+			memorySeries.add(s.usage.bytes[m]);
+		memorySeries.endRow();
+	}
+	memorySeries.flush();
+}
+
+/*
+ * Appends the critical path that ended with the last finished game (one row
+ * per step) and its breakdown into timers, MAC access and retries, air time
+ * and protocol decisions
+ */
+void WriteCausalPath(int run)
+{
+	if (!EEBTPCausalGraph::isEnabled())
+		return;
+
+	std::vector<EEBTPCausalGraph::Step> path = EEBTPCausalGraph::getCriticalPath();
+	EEBTPCausalGraph::Breakdown breakdown = EEBTPCausalGraph::getBreakdown(path);
+	int64_t time = path.empty() ? 0 : path.back().action.time - path.front().action.time;
+
+	std::stringstream summary;
+	for (uint32_t c = 0; c < EEBTPCausalGraph::N_CATEGORIES; c++)
+		summary << " " << EEBTPCausalGraph::getCategoryName(c) << "=" << NanoSeconds(breakdown.time[c]).As(Time::MS) << "/" << breakdown.steps[c];
+	NS_LOG_INFO("CRITICAL PATH: " << path.size() << " steps of " << EEBTPCausalGraph::getNActions() << " actions, " << NanoSeconds(time).As(Time::MS) << ":" << summary.str());
+
+	for (uint32_t i = 0; i < path.size(); i++)
+	{
+		const EEBTPCausalGraph::Step &s = path[i];
+		causalPathResults.add(rndSeed);
+		causalPathResults.add(run);
+		causalPathResults.add(GetProtocolName());
+		causalPathResults.add(i);
+		causalPathResults.add(s.action.time);
+		causalPathResults.add(s.action.node);
+		causalPathResults.add(EEBTPCausalGraph::getActionName(s.action.action));
+		if (s.action.frameType == EEBTPCausalGraph::NO_FRAME)
+			causalPathResults.add("");
+		else
+			causalPathResults.add((uint32_t)s.action.frameType);
+		causalPathResults.add(s.wait);
+		causalPathResults.add(EEBTPCausalGraph::getCategoryName(s.category));
+		causalPathResults.endRow();
+	}
+	causalPathResults.flush();
+
+	causalRunResults.add(rndSeed);
+	causalRunResults.add(run);
+	causalRunResults.add(GetProtocolName());
+	causalRunResults.add(EEBTPCausalGraph::getNActions());
+	causalRunResults.add((uint32_t)path.size());
+	causalRunResults.add(time);
+	for (uint32_t c = 0; c < EEBTPCausalGraph::N_CATEGORIES; c++)
+	{
+		causalRunResults.add(breakdown.time[c]);
+		causalRunResults.add(breakdown.steps[c]);
+	}
+	causalRunResults.endRow();
+	causalRunResults.flush();
+}
+
+//Prints the profile of the run (only with -DEEBTP_PROFILE, see EEBTPProfiler.h)
+void PrintProfile()
+{
+	if (!EEBTPProfiler::isEnabled())
+		return;
+
+	std::stringstream profile;
+	EEBTPProfiler::print(profile);
+	NS_LOG_UNCOND(profile.str());
+	EEBTPProfiler::reset();
+}
+
+/*
+ * Simulates replication i and prints the results, returns the result code
+ */
+std::string SimulateReplication(std::pair<NetDeviceContainer, EnergySourceContainer> pair, int i)
+{
+	SetupEventTrace(pair.first, i);
+	SetupPcapCapture(pair.first, i);
+	SetupCoreRecord(pair.first, i);
+	EEBTPProfiler::reset();
+	EEBTPCausalGraph::enable(causalRunResults.isOpen());
+	EEBTPCausalGraph::reset();
+
+	std::chrono::steady_clock::time_point wallStart = std::chrono::steady_clock::now();
+	DoSimulation(pair.first);
+	double wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+
+	CloseEventTrace(pair.first);
+	ClosePcapCapture();
+	CloseCoreRecord();
+
+	NS_LOG_INFO("<========== END OF SIMULATION ==========>");
+	NS_LOG_INFO("SIMULATION SEED: " << rndSeed << " + " << i);
+	NS_LOG_INFO("SIMULATION TIME: " << Simulator::Now());
+
+	//Scheduler load, e.g. to compare the BasicEnergySource with the LazyEnergySource
+	uint64_t events = Simulator::GetEventCount();
+	NS_LOG_INFO("SIMULATION EVENTS: " << events << " (" << (use_lazy_energy_source ? "LazyEnergySource" : "BasicEnergySource") << ")");
+	NS_LOG_INFO("EVENTS PER SIMULATED SECOND: " << (events / Simulator::Now().GetSeconds()));
+	NS_LOG_INFO("EVENTS PER WALL CLOCK SECOND: " << (events / wallTime) << " (" << wallTime << "s)");
+	if (gridChannel != 0)
+		NS_LOG_INFO("GRID CHANNEL: " << gridChannel->getNTransmissions() << " transmissions, " << gridChannel->getNCandidates() << " candidates, "
+									 << gridChannel->getNReceptions() << " receptions (YansWifiChannel: " << gridChannel->getNTransmissions() * (wifi_stations - 1) << ")");
+	if (linkLayer != 0)
+		NS_LOG_INFO("LINK LAYER: " << linkLayer->getNLinks() << " links, " << linkLayer->getNFrames() << " frames, " << linkLayer->getNReceptions() << " receptions");
+	if (completionMonitor != 0)
+		NS_LOG_INFO("EARLY STOP: " << (completionMonitor->isComplete() ? "complete" : "not complete") << " at " << Simulator::Now() << ", " << completionMonitor->getIdleTime() << " skipped");
+	if (lossCache != 0)
+		NS_LOG_INFO("LOSS CACHE: " << lossCache->getNEntries() << " links, " << lossCache->getNHits() << " hits, " << lossCache->getNMisses() << " misses");
+
+	std::string result = PrintResult(pair.first, pair.second, i);
+	WriteEnergySeries(pair.first, i);
+	WriteConvergence(i);
+	WriteMemoryUsage(i);
+	WriteCausalPath(i);
+	PrintProfile();
+
+	NS_LOG_INFO("<X=======================================X>");
+
+	NS_LOG_INFO("\n\n\n\n");
+	return result;
+}
+
+void TearDownSimulation()
+{
+	//The packet managers and the link layer reference each other
+	if (linkLayer != 0)
+		linkLayer->Dispose();
+	linkLayer = 0;
+	if (completionMonitor != 0)
+		completionMonitor->Dispose();
+	completionMonitor = 0;
+	if (convergenceSampler != 0)
+		convergenceSampler->Dispose();
+	convergenceSampler = 0;
+	if (memoryMonitor != 0)
+		memoryMonitor->Dispose();
+	memoryMonitor = 0;
+	if (pcapCapture != 0)
+		pcapCapture->Dispose();
+	pcapCapture = 0;
+	Simulator::Destroy();
+}
+
+/*
+ * Sets up and simulates replication i, returns the result code of the
+ * simulation
+ */
+std::string RunReplication(int i)
+{
+	RngSeedManager::SetRun(i);
+
+	std::pair<NetDeviceContainer, EnergySourceContainer> pair = SetupSimulation();
+	std::string result = SimulateReplication(pair, i);
+
+	TearDownSimulation();
+	return result;
+}
+
+/*
+ * Worker process of the ReplicationRunner for replication 'run', only this
+ * run is set up (see the fixed streams in SetupTopology())
+ */
+std::string RunWorker(int run)
+{
+	return RunReplication(run);
+}
+
+/*
+ * Selects the protocol of a variant: SIMPLE for the simple broadcast,
+ * otherwise a cycle prevention method of EEBTP
+ */
+void ApplyVariant(std::string variant)
+{
+	eebtp = (variant != "SIMPLE");
+	if (eebtp)
+		c_cpm = variant;
+	if (!energy_series.empty())
+		energy_series += "-" + variant;
+	if (!event_trace.empty())
+		event_trace += "-" + variant;
+	if (!pcap_prefix.empty())
+		pcap_prefix += "-" + variant;
+	if (!record_prefix.empty())
+		record_prefix += "-" + variant;
+}
+
+/*
+ * Sets up the topology of replication i once and simulates every variant in
+ * a forked copy of it, only the protocol layer is installed per variant. The
+ * cached propagation loss is calculated before forking, so it is shared too.
+ */
+bool RunVariants(int i, std::vector<std::string> variantList)
+{
+	RngSeedManager::SetRun(i);
+
+	std::chrono::steady_clock::time_point wallStart = std::chrono::steady_clock::now();
+	std::pair<NetDeviceContainer, EnergySourceContainer> pair = SetupTopology();
+	if (lossCache != 0)
+		lossCache->precompute();
+	double setupTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+	NS_LOG_INFO("TOPOLOGY SETUP: " << setupTime << "s for " << variantList.size() << " variants");
+
+	std::vector<int> indices;
+	for (uint32_t v = 0; v < variantList.size(); v++)
+		indices.push_back(v);
+
+	//The workers leave without tearing the simulation down
+	ReplicationRunner runner(jobs);
+	bool ok = runner.run(indices, [&pair, &variantList, i](int v) {
+		ApplyVariant(variantList[v]);
+
+		std::chrono::steady_clock::time_point protocolStart = std::chrono::steady_clock::now();
+		SetupProtocol(pair.first);
+		NS_LOG_INFO("PROTOCOL SETUP: " << std::chrono::duration<double>(std::chrono::steady_clock::now() - protocolStart).count() << "s (" << variantList[v] << ")");
+
+		SimulateReplication(pair, i);
+	});
+	NS_LOG_INFO("SETUP TIME SAVED: " << (setupTime * (variantList.size() - 1)) << "s");
+
+	TearDownSimulation();
+	return ok;
+}
+
 /*
  * Set the commandline arguments
  */
@@ -467,6 +1468,13 @@ CommandLine ProcessCommandLineArgs()
 	cmd.AddValue("log", "If set to true, enable logging", enable_logging);
 	cmd.AddValue("verbose", "If set to true, enable verbose logging", enable_logging_verbose);
 	cmd.AddValue("tracing", "If set to true, enable PCAP-Tracing", enable_pcap);
+	cmd.AddValue("pcap", "Selective PCAP capture into <pcap>-<rndSeed>-<run>-<node>.pcap (disabled if empty)", pcap_prefix);
+	cmd.AddValue("pcapNodes", "Node IDs to capture, e.g. '0,4-7' (empty = all)", pcap_nodes);
+	cmd.AddValue("pcapMaxDepth", "Only capture nodes up to this tree depth at the time of the frame (-1 = all)", pcap_max_depth);
+	cmd.AddValue("pcapFrameTypes", "EEBTP frame types to capture, e.g. '0,2-5' (empty = all frames)", pcap_frame_types);
+	cmd.AddValue("pcapStart", "Start of the capture window in milliseconds", pcap_start);
+	cmd.AddValue("pcapStop", "End of the capture window in milliseconds (0 = end of the run)", pcap_stop);
+	cmd.AddValue("pcapRing", "Keep the last <pcapRing> frames per node in memory and only write them on a trigger (cycle detected, frame lost at a leaf; 0 = write every frame)", pcap_ring);
 	cmd.AddValue("hopCount", "The max hop count a broadcast message can travel", maxHopCount);
 	cmd.AddValue("udpTestBrdcst", "Test simulation with an UDP broadcast", udp_test_brdcst);
 	cmd.AddValue("eebtp", "Use the EEBT protocol", eebtp);
@@ -474,7 +1482,34 @@ CommandLine ProcessCommandLineArgs()
 	cmd.AddValue("rndSeed", "Seed for randomness", rndSeed);
 	cmd.AddValue("iMax", "Number of simulations", iMax);
 	cmd.AddValue("skipTo", "Number of simulations to skip", skipTo);
+	cmd.AddValue("jobs", "Number of simulations run in parallel worker processes (1 = serial)", jobs);
+	cmd.AddValue("scenario", "Load the node positions, energy budgets, initiator and link gains from a scenario file (binary or text, see ScenarioFile.h)", scenario_file);
+	cmd.AddValue("results", "Write the results as CSV to <results>-runs.csv, <results>-nodes.csv and <results>-depths.csv (disabled if empty)", results_prefix);
+	cmd.AddValue("variants", "Comma separated protocol variants (CYCLE_TEST_ASYNC, MUTEX, PATH_TO_SRC, CORE, SIMPLE) simulated on the same topology", variants);
+	cmd.AddValue("sweep", "Run the parameter sweep of this file, finished points are skipped (see SweepSpec.h)", sweep);
+	cmd.AddValue("tune", "Search the protocol timings of this file for the best time, energy and data loss (see TimingTuner.h)", tune);
+	cmd.AddValue("test", "Run the test suite of the protocol (EEBTProtocolTest.cc) and exit", run_tests);
 	cmd.AddValue("linearEnergyModel", "Run simulation with the LinearWifiTxCurrentModel instead of the CustomWifiTxCurrentModel", use_linear_energy_model);
+	cmd.AddValue("lazyEnergy", "Use the LazyEnergySource (no periodic update events) instead of the BasicEnergySource", use_lazy_energy_source);
+	cmd.AddValue("gridChannel", "Use the range limited GridYansWifiChannel instead of the YansWifiChannel", use_grid_channel);
+	cmd.AddValue("gridChannelVerify", "Check every transmission of the GridYansWifiChannel against all nodes", grid_channel_verify);
+	cmd.AddValue("channelThreads", "Number of threads calculating the propagation loss in the GridYansWifiChannel", channel_threads);
+	cmd.AddValue("linkLayer", "Deliver the EEBTP frames over an abstract link layer (SNR graph) instead of the Wi-Fi MAC/PHY", use_link_layer);
+	cmd.AddValue("earlyStop", "Stop the simulation when the EEBTP broadcast is complete (20s stay the limit)", early_stop);
+	cmd.AddValue("earlyStopQuiet", "Milliseconds without any EEBTP frame before the broadcast is considered complete", early_stop_quiet);
+	cmd.AddValue("lossCache", "Calculate the propagation loss between all nodes once at the start of the simulation", use_loss_cache);
+	cmd.AddValue("energySeries", "Record the energy of every node over time into <energySeries>-<rndSeed>-<run>.eer (disabled if empty)", energy_series);
+	cmd.AddValue("energySeriesBucket", "Width of one bucket of the energy series in milliseconds", energy_series_bucket);
+	cmd.AddValue("eventTrace", "Record the EEBTP frames, parent and blacklist changes, cycles and finished games into <eventTrace>-<rndSeed>-<run>.eet (disabled if empty)", event_trace);
+	cmd.AddValue("eventTraceRecords", "Number of records (32 bytes each) buffered before the event trace is written", event_trace_records);
+	cmd.AddValue("eventTraceLast", "Only keep the last <eventTraceRecords> records of the event trace", event_trace_last);
+	cmd.AddValue("convergence", "Sample the tree (sum of hTx, connected nodes, parent changes, live cycles, control frames in flight) into this CSV file (disabled if empty)", convergence_file);
+	cmd.AddValue("convergenceInterval", "Milliseconds between two samples of the convergence series", convergence_interval);
+	cmd.AddValue("memory", "Write the estimated memory of the EEBTP state to <memory>-runs.csv and <memory>-nodes.csv (disabled if empty)", memory_prefix);
+	cmd.AddValue("memoryInterval", "Milliseconds between two memory samples, written to <memory>-series.csv (0 = only at the end)", memory_interval);
+	cmd.AddValue("causalPath", "Write the critical path of the tree construction to <causalPath>-paths.csv and its breakdown to <causalPath>-runs.csv (disabled if empty)", causal_path);
+	cmd.AddValue("record", "Record the inputs of the protocol core of one node into <record>-<rndSeed>-<run>.ecr for tools/EEBTPCoreReplay.cc (cpm=CORE only, disabled if empty)", record_prefix);
+	cmd.AddValue("recordNode", "Node ID recorded with 'record'", record_node);
 	cmd.AddValue("cpm", "The cycle prevention method to use", c_cpm);
 	cmd.AddValue("width", "Width (X) of the simulated area", sizeX);
 	cmd.AddValue("height", "Height (Y) of the simulated area", sizeY);
@@ -482,14 +1517,10 @@ CommandLine ProcessCommandLineArgs()
 }
 
 /*
- * main
+ * Enables the logging and checks and applies the arguments
  */
-
-int main(int argc, char *argv[])
+void ApplyArguments()
 {
-	//Pares incoming arguments
-	ProcessCommandLineArgs().Parse(argc, argv);
-
 	//Enabled logging
 	if (enable_logging)
 		LogComponentEnable("BroadcastTest", LOG_LEVEL_LOGIC);
@@ -498,32 +1529,255 @@ int main(int argc, char *argv[])
 
 	if (udp_test_brdcst && eebtp)
 		NS_FATAL_ERROR("Can't run simulation with two different protocols!");
+	if (use_link_layer && !eebtp)
+		NS_FATAL_ERROR("The abstract link layer is only supported by the EEBT protocol!");
+	if (convergence_interval == 0)
+		NS_FATAL_ERROR("The convergence interval must be at least 1ms!");
+	if (!EEBTPPcapCapture::parseIds(pcap_nodes, pcapNodeList) || !EEBTPPcapCapture::parseIds(pcap_frame_types, pcapFrameTypeList))
+		NS_FATAL_ERROR("Invalid pcapNodes or pcapFrameTypes, expected e.g. '0,4-7'");
+	for (uint32_t ft : pcapFrameTypeList)
+	{
+		if (ft > APPLICATION_DATA)
+			NS_FATAL_ERROR("Unknown frame type " << ft << " in pcapFrameTypes");
+	}
+	if (!pcap_prefix.empty() && use_link_layer)
+		NS_LOG_UNCOND("The PCAP capture needs the Wi-Fi PHY, it is disabled with linkLayer=true");
+	if (channel_threads > 1 && !use_grid_channel)
+		NS_FATAL_ERROR("Multiple channel threads are only supported by the GridYansWifiChannel (gridChannel=true)!");
 	if (use_rts_cts)
 		Config::SetDefault("ns3::WifiRemoteStationManager::RtsCtsThreshold", UintegerValue(1));
 
+	//The scenario replaces 'nWifi', 'width' and 'height'
+	if (!scenario_file.empty())
+	{
+		if (!scenario.load(scenario_file))
+			NS_FATAL_ERROR(scenario.getError());
+		if (scenario.getNNodes() == 0)
+			NS_FATAL_ERROR("Scenario " << scenario_file << " has no nodes");
+		if (scenario.getNLinks() > 0 && !use_loss_cache)
+			NS_LOG_UNCOND("The link gains of scenario " << scenario_file << " are only used with lossCache=true");
+
+		wifi_stations = scenario.getNNodes();
+		sizeX = scenario.getWidth();
+		sizeY = scenario.getHeight();
+	}
+
 	RngSeedManager::SetSeed(rndSeed);
-	for (int i = 0; i < iMax; i++)
+}
+
+/*
+ * Runs one point of a sweep in a worker process: the arguments of the point
+ * are parsed on top of the command line and the result is appended to the store
+ */
+void RunSweepPoint(const SweepPoint &point, SweepResultStore *store)
+{
+	std::vector<std::string> args;
+	args.push_back("broadcast");
+	for (std::map<std::string, std::string>::const_iterator it = point.args.begin(); it != point.args.end(); it++)
+		args.push_back("--" + it->first + "=" + it->second);
+
+	std::vector<char *> argv;
+	for (std::string &arg : args)
+		argv.push_back(&arg[0]);
+	argv.push_back(0);
+	ProcessCommandLineArgs().Parse(args.size(), argv.data());
+	ApplyArguments();
+
+	std::string result = RunWorker(point.run);
+	if (!store->append(point, result))
+		NS_FATAL_ERROR("Cannot store the result of " << point.getConfig());
+}
+
+/*
+ * The command line arguments are the same for all points of a sweep or a
+ * search, the ones which do not change the results are not part of the configuration
+ */
+std::map<std::string, std::string> GetBaseArgs(int argc, char *argv[])
+{
+	std::map<std::string, std::string> baseArgs;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		arg.erase(0, arg.find_first_not_of('-'));
+
+		size_t eq = arg.find('=');
+		std::string key = arg.substr(0, eq);
+		if (key == "sweep" || key == "tune" || key == "jobs" || key == "iMax" || key == "skipTo" || key == "log" || key == "verbose")
+			continue;
+		baseArgs[key] = (eq != std::string::npos) ? arg.substr(eq + 1) : "true";
+	}
+	if (baseArgs.find("rndSeed") == baseArgs.end())
+		baseArgs["rndSeed"] = std::to_string(rndSeed);
+	return baseArgs;
+}
+
+/*
+ * Runs all points of the sweep which are not in the result store yet
+ */
+int RunSweep(int argc, char *argv[])
+{
+	SweepSpec spec;
+	spec.load(sweep);
+	spec.setBaseArgs(GetBaseArgs(argc, argv));
+	std::vector<SweepPoint> points = spec.expand();
+
+	SweepResultStore store(spec.getStore());
+	store.load();
+
+	std::vector<int> pending;
+	for (uint32_t i = 0; i < points.size(); i++)
+	{
+		if (!store.contains(points[i]))
+			pending.push_back(i);
+	}
+	NS_LOG_UNCOND("Sweep " << sweep << ": " << points.size() << " points, " << (points.size() - pending.size()) << " done, " << pending.size() << " to run (results in " << spec.getStore() << ")");
+
+	//Every point runs in its own process, the arguments and the Config defaults of one point do not leak into the next
+	ReplicationRunner runner(jobs);
+	bool ok = runner.run(pending, [&points, &store](int i) { RunSweepPoint(points[i], &store); });
+	return ok ? 0 : 1;
+}
+
+/*
+ * Searches the protocol timings: every round the tuner proposes a batch of
+ * samples, their points run like the ones of a sweep and the results are
+ * evaluated before the next batch is proposed
+ */
+int RunTune(int argc, char *argv[])
+{
+	TimingTuner tuner;
+	tuner.load(tune);
+	tuner.setBaseArgs(GetBaseArgs(argc, argv));
+
+	SweepResultStore store(tuner.getStore());
+	store.load();
+
+	while (!tuner.isComplete())
 	{
-		RngSeedManager::SetRun(i);
+		std::vector<uint32_t> proposed = tuner.propose(tuner.getBatch() > 0 ? tuner.getBatch() : jobs);
+		if (proposed.empty())
+			break;
+
+		std::vector<SweepPoint> points;
+		std::vector<int> pending;
+		for (uint32_t sample : proposed)
+		{
+			for (const SweepPoint &point : tuner.getPoints(sample))
+			{
+				if (!store.contains(point))
+					pending.push_back(points.size());
+				points.push_back(point);
+			}
+		}
 
-		std::pair<NetDeviceContainer, EnergySourceContainer> pair = SetupSimulation();
+		ReplicationRunner runner(jobs);
+		bool ok = runner.run(pending, [&points, &store](int i) { RunSweepPoint(points[i], &store); });
 
-		if (skipTo == 0 || (skipTo > 0 && skipTo == i))
+		//The workers appended to the file, not to this store
+		store.load();
+		for (uint32_t sample : proposed)
 		{
-			DoSimulation(pair.first);
+			std::vector<std::string> results;
+			for (const SweepPoint &point : tuner.getPoints(sample))
+			{
+				std::string result;
+				if (store.get(point, result))
+					results.push_back(result);
+			}
+			tuner.evaluate(sample, results);
+		}
+		tuner.write();
 
-			NS_LOG_INFO("<========== END OF SIMULATION ==========>");
-			NS_LOG_INFO("SIMULATION SEED: " << rndSeed << " + " << i);
-			NS_LOG_INFO("SIMULATION TIME: " << Simulator::Now());
+		int32_t best = tuner.getBest();
+		NS_LOG_UNCOND("Tune " << tune << ": " << tuner.getNSamples() << " samples, " << pending.size() << " points run" << (ok ? "" : " (some failed)"));
+		if (best >= 0)
+		{
+			std::stringstream str;
+			for (const std::pair<const std::string, std::string> &arg : tuner.getSample(best).args)
+				str << " " << arg.first << "=" << arg.second;
+			NS_LOG_UNCOND("\tBest: #" << best << str.str() << ", objective " << tuner.getSample(best).objective);
+		}
+	}
+
+	NS_LOG_UNCOND("Tune " << tune << ": " << tuner.getParetoSet().size() << " Pareto optimal samples (results in " << tuner.getStore() << ")");
+	return tuner.getBest() >= 0 ? 0 : 1;
+}
 
-			PrintResult(pair.first, pair.second);
+/*
+ * Runs the test suite of the protocol with the test runner of ns-3
+ */
+int RunTests()
+{
+	char name[] = "brdcstTest";
+	char suite[] = "--suite=eebtp-protocol";
+	char verbose[] = "--verbose";
+	char *args[] = {name, suite, verbose};
+	return TestRunner::Run(3, args);
+}
 
-			NS_LOG_INFO("<X=======================================X>");
+/*
+ * main
+ */
 
-			NS_LOG_INFO("\n\n\n\n");
+int main(int argc, char *argv[])
+{
+	//Pares incoming arguments
+	ProcessCommandLineArgs().Parse(argc, argv);
+	if (run_tests)
+		return RunTests();
+
+	//Opened before any worker is forked, the workers append to the same files
+	OpenResultWriters();
+
+	//Before any argument is applied, every point applies its own
+	if (!sweep.empty())
+		return RunSweep(argc, argv);
+	if (!tune.empty())
+		return RunTune(argc, argv);
+
+	ApplyArguments();
+
+	if (!variants.empty())
+	{
+		std::vector<std::string> variantList;
+		std::stringstream str(variants);
+		std::string variant;
+		while (std::getline(str, variant, ','))
+		{
+			if (variant == "SIMPLE" && use_link_layer)
+				NS_FATAL_ERROR("The abstract link layer is only supported by the EEBT protocol!");
+			variantList.push_back(variant);
 		}
 
-		Simulator::Destroy();
+		bool ok = true;
+		for (int i = 0; i < iMax; i++)
+		{
+			if (skipTo == 0 || skipTo == i)
+				ok = RunVariants(i, variantList) && ok;
+
+			if (skipTo > 0 && i >= skipTo)
+				break;
+		}
+		return ok ? 0 : 1;
+	}
+
+	//With 'skipTo' only one replication is simulated, so the serial loop is used
+	if (jobs > 1 && skipTo == 0 && iMax > 1)
+	{
+		std::vector<int> runs;
+		for (int i = 0; i < iMax; i++)
+			runs.push_back(i);
+
+		ReplicationRunner runner(jobs);
+		if (!runner.run(runs, &RunWorker))
+			return 1;
+		return 0;
+	}
+
+	for (int i = 0; i < iMax; i++)
+	{
+		if (skipTo == 0 || skipTo == i)
+			RunReplication(i);
 
 		if (skipTo > 0 && i >= skipTo)
 			break;
@@ -0,0 +1,218 @@
+/*
+ * EEBTPCoreBench.cc
+ *
+ *  Created on: 19.10.2026
+ *
+ *  Microbenchmarks for the per-message cost of the protocol core. Every case
+ *  prepares a node with a few setup frames and then times Core::receive()
+ *  for a stream of frames of one type. The transport drops all frames and
+ *  timers, so only the handler itself is measured.
+ *
+ *  Usage: eebtp-core-bench [--reps=20] [--messages=60000]
+ */
+
+#include "chrono"
+#include "string"
+#include "vector"
+#include "cstdlib"
+#include "iostream"
+#include "iomanip"
+
+#include "../EEBTPCore.h"
+
+using namespace eebtp;
+
+class NullTransport : public Transport
+{
+public:
+	uint64_t nSent = 0;
+
+	virtual void send(const Frame &)
+	{
+		this->nSent++;
+	}
+
+	virtual void schedule(int64_t, Callback)
+	{
+	}
+
+	virtual int64_t now()
+	{
+		return 0;
+	}
+
+	virtual TxStatus getTxStatus(uint16_t)
+	{
+		return TX_ACKED;
+	}
+
+	virtual void releaseTxStatus(uint16_t)
+	{
+	}
+};
+
+static const uint64_t GID = 1;
+static const Address ME = 1;
+static const Address PARENT = 2;
+static const Address CHILD = 3;
+static const Address FIRST_SENDER = 100;
+static const uint32_t N_SENDERS = 32;
+
+static Frame makeFrame(uint8_t ft, Address sender, Address recipient, uint16_t seqNo)
+{
+	Frame frame = Frame();
+	frame.frameType = ft;
+	frame.seqNo = seqNo;
+	frame.gameId = GID;
+	frame.sender = sender;
+	frame.recipient = recipient;
+	frame.parent = BROADCAST;
+	frame.txPower = 20;
+	frame.highestMaxTxPower = 10;
+	frame.secondHighestMaxTxPower = 5;
+	return frame;
+}
+
+static RxInfo makeRxInfo()
+{
+	RxInfo rx;
+	rx.signal = -70;
+	rx.noise = -93.97;
+	rx.minSnr = 4;
+	return rx;
+}
+
+//Connects node ME to PARENT and accepts CHILD as its child
+static void connect(Core &core)
+{
+	RxInfo rx = makeRxInfo();
+	core.getGame(GID);
+	core.receive(makeFrame(NEIGHBOR_DISCOVERY, PARENT, BROADCAST, 1), rx);
+	core.receive(makeFrame(CHILD_CONFIRMATION, PARENT, ME, 2), rx);
+
+	Frame request = makeFrame(CHILD_REQUEST, CHILD, ME, 1);
+	core.receive(request, rx);
+}
+
+struct Case
+{
+	const char *name;
+	bool initiator;
+	bool connected;
+	//Frame number i of the timed stream
+	Frame (*frame)(uint32_t i);
+};
+
+static Frame neighborDiscovery(uint32_t i)
+{
+	Frame frame = makeFrame(NEIGHBOR_DISCOVERY, FIRST_SENDER + i % N_SENDERS, BROADCAST, 10 + i / N_SENDERS);
+	frame.parent = FIRST_SENDER + (i + 1) % N_SENDERS;
+	return frame;
+}
+
+static Frame childRequest(uint32_t i)
+{
+	return makeFrame(CHILD_REQUEST, FIRST_SENDER + i % N_SENDERS, ME, 10 + i / N_SENDERS);
+}
+
+static Frame endOfGame(uint32_t i)
+{
+	Frame frame = makeFrame(END_OF_GAME, CHILD, ME, 10 + i);
+	frame.parent = ME;
+	frame.gameFinished = true;
+	return frame;
+}
+
+static Frame cycleCheck(uint32_t i)
+{
+	Frame frame = makeFrame(CYCLE_CHECK, CHILD, ME, 10 + i);
+	frame.parent = ME;
+	frame.originator = CHILD;
+	frame.newParent = ME;
+	frame.oldParent = FIRST_SENDER;
+	return frame;
+}
+
+static Frame applicationData(uint32_t i)
+{
+	Frame frame = makeFrame(APPLICATION_DATA, PARENT, BROADCAST, 10 + i);
+	frame.dataSeqNo = i;
+	frame.dataLength = 1000;
+	return frame;
+}
+
+static Frame duplicate(uint32_t)
+{
+	return makeFrame(NEIGHBOR_DISCOVERY, FIRST_SENDER, BROADCAST, 10);
+}
+
+int main(int argc, char *argv[])
+{
+	uint32_t reps = 20;
+	uint32_t messages = 60000;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		std::string::size_type eq = arg.find('=');
+		std::string name = arg.substr(0, eq);
+		std::string value = (eq == std::string::npos) ? "" : arg.substr(eq + 1);
+
+		if (name == "--reps")
+			reps = std::strtoul(value.c_str(), 0, 10);
+		else if (name == "--messages")
+			messages = std::strtoul(value.c_str(), 0, 10);
+		else
+		{
+			std::cerr << "Usage: " << argv[0] << " [--reps=20] [--messages=60000]" << std::endl;
+			return 1;
+		}
+	}
+
+	//The sequence numbers of one sender must not wrap within a repetition
+	if (messages > 65000)
+		messages = 65000;
+
+	std::vector<Case> cases = {
+		{"NEIGHBOR_DISCOVERY (initiator, 32 senders)", true, false, neighborDiscovery},
+		{"CHILD_REQUEST (initiator, 32 children)", true, false, childRequest},
+		{"CYCLE_CHECK (forwarded to parent)", false, true, cycleCheck},
+		{"END_OF_GAME (from child)", false, true, endOfGame},
+		{"APPLICATION_DATA (forwarded to child)", false, true, applicationData},
+		{"duplicate frame", true, false, duplicate},
+	};
+
+	RxInfo rx = makeRxInfo();
+	std::cout << std::left << std::setw(48) << "CASE" << "NS/MSG\tSENT/MSG" << std::endl;
+	for (const Case &c : cases)
+	{
+		double seconds = 0;
+		uint64_t nSent = 0;
+		for (uint32_t rep = 0; rep < reps; rep++)
+		{
+			NullTransport transport;
+			Core core(ME, &transport, Config());
+			if (c.initiator)
+				core.initGame(GID);
+			if (c.connected)
+				connect(core);
+
+			//Build the frames first, so only receive() is timed
+			std::vector<Frame> frames;
+			frames.reserve(messages);
+			for (uint32_t i = 0; i < messages; i++)
+				frames.push_back(c.frame(i));
+
+			uint64_t sentBefore = transport.nSent;
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			for (const Frame &frame : frames)
+				core.receive(frame, rx);
+			seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			nSent += transport.nSent - sentBefore;
+		}
+
+		double n = (double)reps * messages;
+		std::cout << std::left << std::setw(48) << c.name << std::fixed << std::setprecision(1) << seconds * 1e9 / n << "\t" << std::setprecision(2) << nSent / n << std::endl;
+	}
+	return 0;
+}
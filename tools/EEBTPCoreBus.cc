@@ -0,0 +1,327 @@
+/*
+ * EEBTPCoreBus.cc
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include "cmath"
+#include "algorithm"
+
+#include "EEBTPCoreBus.h"
+
+namespace eebtp
+{
+	//MAC header (24 bytes), LLC/SNAP header (8 bytes) and FCS (4 bytes), see EEBTPLinkLayer
+	static const uint32_t MAC_OVERHEAD = 36;
+
+	Bus::Parameters::Parameters()
+	{
+		this->maxTxPower = 23;
+		this->rxThreshold = -100;
+		this->minSnr = 4;
+		this->noise = -93.97;
+		this->exponent = 3.0;			//LogDistancePropagationLossModel
+		this->referenceLoss = 46.6777;
+		this->dataRate = 6000000;
+		this->accessDelay = 100000;
+		this->preamble = 20000;
+	}
+
+	/*
+	 * Transport of one node
+	 */
+	Bus::NodeTransport::NodeTransport(Bus *bus, uint32_t index)
+	{
+		this->bus = bus;
+		this->index = index;
+	}
+
+	void Bus::NodeTransport::send(const Frame &frame)
+	{
+		this->bus->transmit(this->index, frame);
+	}
+
+	void Bus::NodeTransport::schedule(int64_t delay, Callback callback)
+	{
+		this->bus->schedule(delay, callback);
+	}
+
+	int64_t Bus::NodeTransport::now()
+	{
+		return this->bus->now();
+	}
+
+	TxStatus Bus::NodeTransport::getTxStatus(uint16_t seqNo)
+	{
+		std::unordered_map<uint16_t, TxStatus>::iterator it = this->txStatus.find(seqNo);
+		if (it == this->txStatus.end())
+			return TX_PENDING;
+		return it->second;
+	}
+
+	void Bus::NodeTransport::releaseTxStatus(uint16_t seqNo)
+	{
+		this->txStatus.erase(seqNo);
+	}
+
+	void Bus::NodeTransport::setTxStatus(uint16_t seqNo, TxStatus status)
+	{
+		this->txStatus[seqNo] = status;
+	}
+
+	/*
+	 * Implementation Bus
+	 */
+	Bus::Bus(Parameters parameters, Config config, uint8_t variant)
+	{
+		this->parameters = parameters;
+		this->config = config;
+		this->variant = variant;
+
+		this->currentTime = 0;
+		this->nextSeq = 0;
+
+		this->nLinks = 0;
+		this->nFrames = 0;
+		this->nReceptions = 0;
+	}
+
+	Bus::~Bus()
+	{
+		//The cores reference the transports
+		this->cores.clear();
+		this->transports.clear();
+	}
+
+	uint32_t Bus::addNode(double x, double y)
+	{
+		uint32_t index = this->xs.size();
+		this->xs.push_back(x);
+		this->ys.push_back(y);
+		this->busyUntil.push_back(0);
+		this->transports.push_back(std::unique_ptr<NodeTransport>(new NodeTransport(this, index)));
+		this->cores.push_back(std::unique_ptr<Core>(Core::create(this->variant, Bus::getAddress(index), this->transports.back().get(), this->config)));
+		return index;
+	}
+
+	//Address 0 is reserved (no address), so node i gets the address i + 1
+	Address Bus::getAddress(uint32_t index)
+	{
+		return (Address)index + 1;
+	}
+
+	uint32_t Bus::getIndex(Address address)
+	{
+		return (uint32_t)(address - 1);
+	}
+
+	uint32_t Bus::getNNodes()
+	{
+		return this->cores.size();
+	}
+
+	Core *Bus::getCore(uint32_t index)
+	{
+		return this->cores[index].get();
+	}
+
+	//Highest loss at which a frame with the maximum TX power still arrives
+	double Bus::getMaxLoss()
+	{
+		return std::min(this->parameters.maxTxPower - this->parameters.rxThreshold, this->parameters.maxTxPower - this->parameters.noise - this->parameters.minSnr);
+	}
+
+	double Bus::getLoss(uint32_t a, uint32_t b)
+	{
+		double dx = this->xs[a] - this->xs[b];
+		double dy = this->ys[a] - this->ys[b];
+		double distance = std::sqrt(dx * dx + dy * dy);
+		if (distance <= 1.0)
+			return this->parameters.referenceLoss;
+		return this->parameters.referenceLoss + 10.0 * this->parameters.exponent * std::log10(distance);
+	}
+
+	/*
+	 * Calculates the links of all nodes. The nodes are sorted into a
+	 * grid with the maximum range as cell size, so only the 3x3 cells
+	 * around a node have to be checked.
+	 */
+	void Bus::build()
+	{
+		uint32_t n = this->xs.size();
+		double maxLoss = this->getMaxLoss();
+		double range = std::max(1.0, std::pow(10.0, (maxLoss - this->parameters.referenceLoss) / (10.0 * this->parameters.exponent)));
+
+		double minX = 0, minY = 0, maxX = 0, maxY = 0;
+		if (n > 0)
+		{
+			minX = *std::min_element(this->xs.begin(), this->xs.end());
+			maxX = *std::max_element(this->xs.begin(), this->xs.end());
+			minY = *std::min_element(this->ys.begin(), this->ys.end());
+			maxY = *std::max_element(this->ys.begin(), this->ys.end());
+		}
+		int64_t cols = (int64_t)((maxX - minX) / range) + 1;
+		int64_t rows = (int64_t)((maxY - minY) / range) + 1;
+
+		std::unordered_map<int64_t, std::vector<uint32_t>> cells;
+		for (uint32_t i = 0; i < n; i++)
+		{
+			int64_t cx = (int64_t)((this->xs[i] - minX) / range);
+			int64_t cy = (int64_t)((this->ys[i] - minY) / range);
+			cells[cy * cols + cx].push_back(i);
+		}
+
+		this->links = std::vector<std::vector<Link>>(n);
+		this->nLinks = 0;
+		for (uint32_t i = 0; i < n; i++)
+		{
+			int64_t cx = (int64_t)((this->xs[i] - minX) / range);
+			int64_t cy = (int64_t)((this->ys[i] - minY) / range);
+			for (int64_t y = std::max((int64_t)0, cy - 1); y <= std::min(rows - 1, cy + 1); y++)
+			{
+				for (int64_t x = std::max((int64_t)0, cx - 1); x <= std::min(cols - 1, cx + 1); x++)
+				{
+					std::unordered_map<int64_t, std::vector<uint32_t>>::iterator it = cells.find(y * cols + x);
+					if (it == cells.end())
+						continue;
+
+					for (uint32_t j : it->second)
+					{
+						if (j == i)
+							continue;
+						double loss = this->getLoss(i, j);
+						if (loss <= maxLoss)
+							this->links[i].push_back(Link{j, loss});
+					}
+				}
+			}
+
+			//Sort by loss and then by node, so the receivers are always visited in the same order
+			std::sort(this->links[i].begin(), this->links[i].end(), [](const Link &a, const Link &b) {
+				return a.loss < b.loss || (a.loss == b.loss && a.node < b.node);
+			});
+			this->nLinks += this->links[i].size();
+		}
+	}
+
+	//Nodes that can be reached from 'from' over one or more links with the maximum TX power
+	std::vector<bool> Bus::getReachable(uint32_t from)
+	{
+		std::vector<bool> reachable(this->links.size(), false);
+		std::vector<uint32_t> queue(1, from);
+		reachable[from] = true;
+		for (size_t i = 0; i < queue.size(); i++)
+		{
+			for (const Link &link : this->links[queue[i]])
+			{
+				if (!reachable[link.node])
+				{
+					reachable[link.node] = true;
+					queue.push_back(link.node);
+				}
+			}
+		}
+		return reachable;
+	}
+
+	/*
+	 * Event queue
+	 */
+	void Bus::schedule(int64_t delay, Transport::Callback callback)
+	{
+		this->events.push(Event{this->currentTime + delay, this->nextSeq++, callback});
+	}
+
+	int64_t Bus::now()
+	{
+		return this->currentTime;
+	}
+
+	//Executes all events up to 'until' (ns) and returns the number of executed events
+	uint64_t Bus::run(int64_t until)
+	{
+		uint64_t nEvents = 0;
+		while (!this->events.empty() && this->events.top().time <= until)
+		{
+			Event event = this->events.top();
+			this->events.pop();
+
+			this->currentTime = event.time;
+			event.callback();
+			nEvents++;
+		}
+		return nEvents;
+	}
+
+	/*
+	 * Frames
+	 */
+	int64_t Bus::getAirtime(const Frame &frame)
+	{
+		//EEBTPHeader (27 bytes, cycle checks 45 bytes) and one byte payload or the application data
+		uint32_t size = 27;
+		if (frame.frameType == CYCLE_CHECK)
+			size += 18;
+		if (frame.frameType == APPLICATION_DATA)
+			size += 8 + frame.dataLength;
+		else
+			size += 1;
+
+		return this->parameters.preamble + (int64_t)((size + MAC_OVERHEAD) * 8 * 1e9 / this->parameters.dataRate);
+	}
+
+	void Bus::transmit(uint32_t sender, const Frame &frame)
+	{
+		this->nFrames++;
+
+		int64_t start = std::max(this->currentTime + this->parameters.accessDelay, this->busyUntil[sender]);
+		int64_t end = start + this->getAirtime(frame);
+		this->busyUntil[sender] = end;
+
+		this->schedule(end - this->currentTime, std::bind(&Bus::deliver, this, sender, frame));
+	}
+
+	//Delivers a frame at the end of its transmission to all neighbors in range
+	void Bus::deliver(uint32_t sender, const Frame &frame)
+	{
+		bool reached = false;
+		for (const Link &link : this->links[sender])
+		{
+			double rx = frame.txPower - link.loss;
+			if (rx < this->parameters.rxThreshold || rx - this->parameters.noise < this->parameters.minSnr)
+				break;
+
+			if (frame.recipient != BROADCAST && Bus::getAddress(link.node) != frame.recipient)
+				continue;
+
+			reached = true;
+			this->nReceptions++;
+
+			RxInfo info;
+			info.signal = rx;
+			info.noise = this->parameters.noise;
+			info.minSnr = this->parameters.minSnr;
+			this->cores[link.node]->receive(frame, info);
+
+			if (frame.recipient != BROADCAST)
+				break;
+		}
+
+		this->transports[sender]->setTxStatus(frame.seqNo, (frame.recipient == BROADCAST || reached) ? TX_ACKED : TX_LOST);
+	}
+
+	uint64_t Bus::getNLinks()
+	{
+		return this->nLinks;
+	}
+
+	uint64_t Bus::getNFrames()
+	{
+		return this->nFrames;
+	}
+
+	uint64_t Bus::getNReceptions()
+	{
+		return this->nReceptions;
+	}
+}
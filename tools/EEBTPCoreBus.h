@@ -0,0 +1,140 @@
+/*
+ * EEBTPCoreBus.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#ifndef BROADCAST_TOOLS_EEBTPCOREBUS_H_
+#define BROADCAST_TOOLS_EEBTPCOREBUS_H_
+
+#include "queue"
+#include "memory"
+#include "vector"
+#include "unordered_map"
+
+#include "../EEBTPCore.h"
+
+namespace eebtp
+{
+	/*
+	 * Discrete event driver and in-memory message bus for the protocol core.
+	 *
+	 * Works like EEBTPLinkLayer: the links of every node are calculated once
+	 * from the positions (log distance loss) and sorted by their loss. A frame
+	 * reaches every neighbor with txPower - loss >= RxThreshold and an SNR of
+	 * at least MinSnr; unicast frames are only delivered to the recipient and
+	 * count as acked if it is reached. Each node sends its frames back to back
+	 * after the access delay, there are no collisions.
+	 *
+	 * Events with the same time are executed in the order they were scheduled,
+	 * so a run only depends on the node positions.
+	 */
+	class Bus
+	{
+	public:
+		struct Parameters
+		{
+			double maxTxPower;		//dBm
+			double rxThreshold;		//dBm
+			double minSnr;			//dB
+			double noise;			//dBm
+			double exponent;		//Log distance path loss exponent
+			double referenceLoss;	//dB at 1m
+			double dataRate;		//bit/s
+			int64_t accessDelay;	//ns
+			int64_t preamble;		//ns
+
+			Parameters();
+		};
+
+		//Every node runs a core of the cycle prevention variant (eebtp::Variant)
+		Bus(Parameters parameters, Config config, uint8_t variant);
+		virtual ~Bus();
+
+		uint32_t addNode(double x, double y);
+		void build();
+
+		uint32_t getNNodes();
+		Core *getCore(uint32_t index);
+		static Address getAddress(uint32_t index);
+		static uint32_t getIndex(Address address);
+
+		void schedule(int64_t delay, Transport::Callback callback);
+		int64_t now();
+		uint64_t run(int64_t until);
+
+		uint64_t getNLinks();
+		std::vector<bool> getReachable(uint32_t from);
+		uint64_t getNFrames();
+		uint64_t getNReceptions();
+
+	private:
+		struct Link
+		{
+			uint32_t node;
+			double loss;
+		};
+
+		struct Event
+		{
+			int64_t time;
+			uint64_t seq;
+			Transport::Callback callback;
+		};
+
+		struct EventOrder
+		{
+			bool operator()(const Event &a, const Event &b) const
+			{
+				return a.time > b.time || (a.time == b.time && a.seq > b.seq);
+			}
+		};
+
+		class NodeTransport : public Transport
+		{
+		public:
+			NodeTransport(Bus *bus, uint32_t index);
+
+			virtual void send(const Frame &frame);
+			virtual void schedule(int64_t delay, Callback callback);
+			virtual int64_t now();
+			virtual TxStatus getTxStatus(uint16_t seqNo);
+			virtual void releaseTxStatus(uint16_t seqNo);
+
+			void setTxStatus(uint16_t seqNo, TxStatus status);
+
+		private:
+			Bus *bus;
+			uint32_t index;
+			std::unordered_map<uint16_t, TxStatus> txStatus;
+		};
+
+		Parameters parameters;
+		Config config;
+		uint8_t variant;
+
+		std::vector<double> xs;
+		std::vector<double> ys;
+		std::vector<std::vector<Link>> links;
+		std::vector<int64_t> busyUntil;
+		std::vector<std::unique_ptr<NodeTransport>> transports;
+		std::vector<std::unique_ptr<Core>> cores;
+
+		std::priority_queue<Event, std::vector<Event>, EventOrder> events;
+		int64_t currentTime;
+		uint64_t nextSeq;
+
+		uint64_t nLinks;
+		uint64_t nFrames;
+		uint64_t nReceptions;
+
+		double getMaxLoss();
+		double getLoss(uint32_t a, uint32_t b);
+		int64_t getAirtime(const Frame &frame);
+
+		void transmit(uint32_t sender, const Frame &frame);
+		void deliver(uint32_t sender, const Frame &frame);
+	};
+}
+
+#endif /* BROADCAST_TOOLS_EEBTPCOREBUS_H_ */
@@ -0,0 +1,329 @@
+/*
+ * EEBTPCoreReplay.cc
+ *
+ *  Created on: 19.10.2026
+ *
+ *  Replays the record of a single protocol core (see EEBTPCoreRecord.h),
+ *  without ns-3 and without the other nodes. The core is created with the
+ *  recorded variant, address and config and gets the recorded inputs in their
+ *  order; the timers are its own ones, due at the recorded times.
+ *  	- Prints every frame the core sends (unless '--quiet') and the state
+ *  		of its games at the end
+ *  	- Stops at the first divergence from the record (a timer that is not
+ *  		due, a missing or unexpected frame or ack query), exits with 2
+ *  	- '--until' (ns) stops the replay early, e.g. to break in a debugger
+ *  		right before a decision
+ *
+ *  Usage: eebtp-core-replay <file> [--until=<ns>] [--quiet]
+ */
+
+#include "cstdio"
+#include "cstdlib"
+#include "string"
+#include "vector"
+#include "iostream"
+#include "sstream"
+
+#include "EEBTPCoreRecord.h"
+
+using namespace eebtp;
+
+static const char *FRAME_TYPE_NAMES[N_FRAME_TYPES] = {"CYCLE_CHECK", "NEIGHBOR_DISCOVERY", "CHILD_REQUEST", "CHILD_CONFIRMATION", "CHILD_REJECTION", "PARENT_REVOCATION", "END_OF_GAME", "APPLICATION_DATA"};
+
+static std::string getFrameTypeName(uint8_t ft)
+{
+	return (ft < N_FRAME_TYPES) ? FRAME_TYPE_NAMES[ft] : std::to_string(ft);
+}
+
+static std::string getAddressString(Address address)
+{
+	if (address == BROADCAST)
+		return "ff:ff:ff:ff:ff:ff";
+
+	char str[18];
+	std::snprintf(str, sizeof(str), "%02x:%02x:%02x:%02x:%02x:%02x", (unsigned)(address >> 40) & 0xff, (unsigned)(address >> 32) & 0xff,
+				  (unsigned)(address >> 24) & 0xff, (unsigned)(address >> 16) & 0xff, (unsigned)(address >> 8) & 0xff, (unsigned)address & 0xff);
+	return str;
+}
+
+/*
+ * Feeds the core from the record: the ack queries and the sent frames are
+ * checked against the next record, the timers are kept in due order (FIFO
+ * on the same time, like the ns-3 scheduler)
+ */
+class ReplayTransport : public Transport
+{
+public:
+	ReplayTransport(std::vector<RecordEntry> &records, std::vector<std::vector<Address>> &paths, bool quiet) : records(records), paths(paths), quiet(quiet)
+	{
+		this->cursor = 0;
+		this->currentTime = 0;
+		this->nSent = 0;
+		this->nTimers = 0;
+	}
+
+	virtual void send(const Frame &frame)
+	{
+		this->nSent++;
+		if (!this->quiet)
+		{
+			std::cout << this->currentTime << "\tSENT\t" << getFrameTypeName(frame.frameType) << "\t" << getAddressString(frame.recipient) << "\t" << frame.seqNo << "\t"
+					  << frame.txPower << (frame.retransmission ? "\tretransmission" : "") << std::endl;
+		}
+
+		RecordEntry *entry = this->expect(RecordEntry::SENT);
+		if (entry == 0)
+			return;
+		if (entry->frame.frameType != frame.frameType || entry->frame.seqNo != frame.seqNo || entry->frame.recipient != frame.recipient || entry->frame.txPower != frame.txPower
+			|| entry->frame.parent != frame.parent || entry->frame.gameFinished != frame.gameFinished || this->paths[this->cursor - 1] != frame.srcPath)
+		{
+			std::stringstream ss;
+			ss << "sent " << getFrameTypeName(frame.frameType) << " #" << frame.seqNo << " to " << getAddressString(frame.recipient) << " with " << frame.txPower << " dBm, recorded "
+			   << getFrameTypeName(entry->frame.frameType) << " #" << entry->frame.seqNo << " to " << getAddressString(entry->frame.recipient) << " with " << entry->frame.txPower << " dBm";
+			if (this->paths[this->cursor - 1] != frame.srcPath)
+				ss << " (path of " << frame.srcPath.size() << " nodes, recorded " << this->paths[this->cursor - 1].size() << ")";
+			this->diverge(ss.str());
+		}
+	}
+
+	virtual void schedule(int64_t delay, Callback callback)
+	{
+		Timer timer;
+		timer.time = this->currentTime + delay;
+		timer.callback = callback;
+
+		std::vector<Timer>::iterator it = this->timers.begin();
+		while (it != this->timers.end() && it->time <= timer.time)
+			it++;
+		this->timers.insert(it, timer);
+	}
+
+	virtual int64_t now()
+	{
+		return this->currentTime;
+	}
+
+	virtual TxStatus getTxStatus(uint16_t seqNo)
+	{
+		RecordEntry *entry = this->expect(RecordEntry::TX_STATUS);
+		if (entry == 0)
+			return TX_PENDING;
+		if (entry->seqNo != seqNo)
+			this->diverge("ack query for #" + std::to_string(seqNo) + ", recorded #" + std::to_string(entry->seqNo));
+		return (TxStatus)entry->txStatus;
+	}
+
+	virtual void releaseTxStatus(uint16_t)
+	{
+	}
+
+	//Runs the next top level record, returns false at the end or on a divergence
+	bool step(Core *core)
+	{
+		if (!this->error.empty() || this->cursor >= this->records.size())
+			return false;
+
+		RecordEntry &entry = this->records[this->cursor++];
+		if (entry.time < this->currentTime)
+		{
+			this->diverge("time goes back");
+			return false;
+		}
+		this->currentTime = entry.time;
+
+		switch (entry.kind)
+		{
+		case RecordEntry::INIT_GAME:
+			core->initGame(entry.frame.gameId);
+			break;
+		case RecordEntry::SEND:
+			core->send(core->getGame(entry.frame.gameId), entry.frame.frameType, entry.frame.recipient, entry.frame.txPower);
+			break;
+		case RecordEntry::RECEIVE:
+		{
+			core->getGame(entry.frame.gameId);
+			Frame frame = Frame();
+			static_cast<FrameHeader &>(frame) = entry.frame;
+			frame.srcPath = this->paths[this->cursor - 1];
+			core->receive(frame, entry.rx);
+			break;
+		}
+		case RecordEntry::TIMER:
+		{
+			if (this->timers.empty() || this->timers.front().time != entry.time)
+			{
+				this->diverge(this->timers.empty() ? "no timer pending" : "next timer is due at " + std::to_string(this->timers.front().time));
+				return false;
+			}
+			Callback callback = this->timers.front().callback;
+			this->timers.erase(this->timers.begin());
+			this->nTimers++;
+			callback();
+			break;
+		}
+		default:
+			this->cursor--;
+			this->diverge(std::string("unexpected ") + RecordEntry::getKindName(entry.kind));
+			return false;
+		}
+		return this->error.empty();
+	}
+
+	int64_t getTime()
+	{
+		return this->currentTime;
+	}
+
+	size_t getCursor()
+	{
+		return this->cursor;
+	}
+
+	std::string getError()
+	{
+		return this->error;
+	}
+
+	uint64_t getNSent()
+	{
+		return this->nSent;
+	}
+
+	uint64_t getNTimers()
+	{
+		return this->nTimers;
+	}
+
+	size_t getNPendingTimers()
+	{
+		return this->timers.size();
+	}
+
+private:
+	struct Timer
+	{
+		int64_t time;
+		Callback callback;
+	};
+
+	std::vector<RecordEntry> &records;
+	std::vector<std::vector<Address>> &paths;
+	bool quiet;
+
+	size_t cursor;
+	int64_t currentTime;
+	std::vector<Timer> timers;
+	std::string error;
+
+	uint64_t nSent;
+	uint64_t nTimers;
+
+	//Returns the next record if it has the given kind, otherwise the replay diverged
+	RecordEntry *expect(uint8_t kind)
+	{
+		if (!this->error.empty())
+			return 0;
+		if (this->cursor >= this->records.size())
+		{
+			this->diverge(std::string("record ends before ") + RecordEntry::getKindName(kind));
+			return 0;
+		}
+		if (this->records[this->cursor].kind != kind)
+		{
+			this->diverge(std::string(RecordEntry::getKindName(kind)) + " instead of " + RecordEntry::getKindName(this->records[this->cursor].kind));
+			return 0;
+		}
+		return &this->records[this->cursor++];
+	}
+
+	//Only the first divergence is kept, everything after it is a consequence
+	void diverge(std::string error)
+	{
+		if (this->error.empty())
+			this->error = "record " + std::to_string(this->cursor) + " at " + std::to_string(this->currentTime) + " ns: " + error;
+	}
+};
+
+int main(int argc, char *argv[])
+{
+	std::string fileName;
+	int64_t until = -1;
+	bool quiet = false;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		std::string::size_type eq = arg.find('=');
+		std::string name = arg.substr(0, eq);
+		std::string value = (eq == std::string::npos) ? "" : arg.substr(eq + 1);
+
+		if (name == "--until")
+			until = std::strtoll(value.c_str(), 0, 10);
+		else if (name == "--quiet")
+			quiet = true;
+		else if (fileName.empty() && arg.compare(0, 2, "--") != 0)
+			fileName = arg;
+		else
+		{
+			fileName.clear();
+			break;
+		}
+	}
+	if (fileName.empty())
+	{
+		std::cerr << "Usage: " << argv[0] << " <file> [--until=<ns>] [--quiet]" << std::endl;
+		return 1;
+	}
+
+	RecordReader reader;
+	if (!reader.open(fileName))
+	{
+		std::cerr << reader.getError() << std::endl;
+		return 1;
+	}
+
+	std::vector<RecordEntry> records;
+	std::vector<std::vector<Address>> paths;
+	RecordEntry entry;
+	std::vector<Address> path;
+	while (reader.next(entry, path))
+	{
+		records.push_back(entry);
+		paths.push_back(path);
+	}
+	if (!reader.getError().empty())
+	{
+		std::cerr << reader.getError() << std::endl;
+		return 1;
+	}
+
+	ReplayTransport transport(records, paths, quiet);
+	Core *core = Core::create(reader.getVariant(), reader.getAddress(), &transport, reader.getConfig());
+
+	while (transport.getCursor() < records.size())
+	{
+		if (until >= 0 && records[transport.getCursor()].time > until)
+			break;
+		if (!transport.step(core))
+			break;
+	}
+
+	std::cout << "Node " << getAddressString(core->getAddress()) << ": " << transport.getCursor() << " of " << records.size() << " records, " << transport.getNTimers() << " timers, "
+			  << transport.getNSent() << " frames sent, " << transport.getNPendingTimers() << " timers pending at " << transport.getTime() << " ns" << std::endl;
+
+	for (uint32_t i = 0; i < core->getNGames(); i++)
+	{
+		Game *game = core->getGameByIndex(i);
+		std::cout << "Game " << game->gameId << (game->initiator ? " (initiator)" : "") << ": parent " << (game->parent != 0 ? getAddressString(game->parent->address) : "-") << ", "
+				  << game->getNChilds() << " children, " << game->getNNeighbors() << " neighbors, " << (game->finished ? "finished" : "not finished") << ", " << game->packetCount
+				  << " data packets" << std::endl;
+	}
+	delete core;
+
+	if (!transport.getError().empty())
+	{
+		std::cerr << "Diverged at " << transport.getError() << std::endl;
+		return 2;
+	}
+	return 0;
+}
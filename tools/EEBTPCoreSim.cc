@@ -0,0 +1,211 @@
+/*
+ * EEBTPCoreSim.cc
+ *
+ *  Created on: 19.10.2026
+ *
+ *  Builds an EEBTP tree with the protocol core on the in-memory bus,
+ *  without ns-3. The nodes are placed like in brdcstTest (random integer
+ *  positions in a square, node 0 is the initiator); by default the square
+ *  grows with the number of nodes, so the density stays the same as with
+ *  100 nodes on 501m x 501m.
+ *
+ *  Usage: eebtp-core-sim [--nodes=100] [--size=501] [--seed=1001] [--until=3600] [--packets=0] [--variant=0]
+ *  	--variant: cycle prevention, 0 = CYCLE_TEST_ASYNC, 1 = MUTEX, 2 = PATH_TO_SRC
+ */
+
+#include "cmath"
+#include "chrono"
+#include "algorithm"
+#include "random"
+#include "string"
+#include "cstdlib"
+#include "iostream"
+
+#include "EEBTPCoreBus.h"
+
+using namespace eebtp;
+
+//Returns the number of hops to the initiator or -1 if the node is not connected
+static int getDepth(Bus &bus, uint64_t gid, uint32_t node, std::vector<int> &depth, std::vector<uint8_t> &state)
+{
+	std::vector<uint32_t> path;
+	int d = -1;
+	uint32_t current = node;
+
+	//Walk up until a node with a known depth, the initiator or a cycle is found
+	while (true)
+	{
+		if (state[current] == 2)
+		{
+			d = depth[current];
+			break;
+		}
+		if (state[current] == 1)
+			break;
+		state[current] = 1;
+		path.push_back(current);
+
+		Game *game = bus.getCore(current)->getGame(gid);
+		if (game->initiator)
+		{
+			d = -2;
+			break;
+		}
+		if (game->parent == 0)
+			break;
+		current = Bus::getIndex(game->parent->address);
+	}
+
+	//Assign the depths backwards along the path
+	for (std::vector<uint32_t>::reverse_iterator it = path.rbegin(); it != path.rend(); it++)
+	{
+		if (d == -2)
+			d = 0;
+		else if (d >= 0)
+			d++;
+		depth[*it] = d;
+		state[*it] = 2;
+	}
+	return depth[node];
+}
+
+int main(int argc, char *argv[])
+{
+	uint32_t nodes = 100;
+	double size = 0;
+	uint64_t seed = 1001;
+	double until = 3600;
+	uint32_t packets = 0;
+	uint32_t variant = CYCLE_TEST_ASYNC;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		std::string::size_type eq = arg.find('=');
+		std::string name = arg.substr(0, eq);
+		std::string value = (eq == std::string::npos) ? "" : arg.substr(eq + 1);
+
+		if (name == "--nodes")
+			nodes = std::strtoul(value.c_str(), 0, 10);
+		else if (name == "--size")
+			size = std::strtod(value.c_str(), 0);
+		else if (name == "--seed")
+			seed = std::strtoull(value.c_str(), 0, 10);
+		else if (name == "--until")
+			until = std::strtod(value.c_str(), 0);
+		else if (name == "--packets")
+			packets = std::strtoul(value.c_str(), 0, 10);
+		else if (name == "--variant")
+			variant = std::strtoul(value.c_str(), 0, 10);
+		else
+		{
+			std::cerr << "Usage: " << argv[0] << " [--nodes=100] [--size=501] [--seed=1001] [--until=3600] [--packets=0] [--variant=0]" << std::endl;
+			return 1;
+		}
+	}
+	if (nodes == 0)
+	{
+		std::cerr << "At least one node is needed" << std::endl;
+		return 1;
+	}
+	if (variant >= N_VARIANTS)
+	{
+		std::cerr << "Unknown variant " << variant << std::endl;
+		return 1;
+	}
+	if (size <= 0)
+		size = 501.0 * std::sqrt(nodes / 100.0);
+
+	Config config;
+	config.maxPackets = packets;
+
+	std::chrono::steady_clock::time_point wallStart = std::chrono::steady_clock::now();
+
+	Bus bus(Bus::Parameters(), config, variant);
+	std::mt19937_64 random(seed);
+	std::uniform_int_distribution<int64_t> position(0, (int64_t)size - 1);
+	for (uint32_t i = 0; i < nodes; i++)
+	{
+		double x = position(random);
+		double y = position(random);
+		bus.addNode(x, y);
+	}
+	bus.build();
+
+	std::chrono::steady_clock::time_point wallBuilt = std::chrono::steady_clock::now();
+
+	//Start the game like initEEBroadcast()
+	uint64_t gid = Bus::getAddress(0);
+	Core *initiator = bus.getCore(0);
+	initiator->send(initiator->initGame(gid), NEIGHBOR_DISCOVERY, BROADCAST, 20.0);
+
+	//Run in steps of 100ms until all nodes have finished the game and a step passed
+	//without events. Finished nodes may still be part of a cycle that a cycle check
+	//in flight resolves, and finished nodes with unfinished children keep their
+	//neighbor discovery timer running, so the event queue itself may not run empty
+	uint64_t nEvents = 0;
+	int64_t end = (int64_t)(until * 1e9);
+	for (int64_t t = 0; t < end; )
+	{
+		t = std::min(end, t + 100000000);
+		uint64_t nStepEvents = bus.run(t);
+		nEvents += nStepEvents;
+
+		bool allFinished = true;
+		for (uint32_t i = 0; i < nodes && allFinished; i++)
+			allFinished = bus.getCore(i)->getGame(gid)->finished;
+		if (allFinished && nStepEvents == 0)
+			break;
+	}
+
+	std::chrono::steady_clock::time_point wallEnd = std::chrono::steady_clock::now();
+
+	//Evaluate the tree
+	uint32_t connected = 0, finished = 0, reachable = 0;
+	int maxDepth = 0;
+	double depthSum = 0;
+	double txPower = 0;
+	int64_t constructionTime = 0;
+	std::vector<int> depth(nodes, -1);
+	std::vector<uint8_t> state(nodes, 0);
+	std::vector<bool> reached = bus.getReachable(0);
+	for (uint32_t i = 0; i < nodes; i++)
+	{
+		if (i > 0 && reached[i])
+			reachable++;
+
+		Game *game = bus.getCore(i)->getGame(gid);
+		if (game->finished)
+		{
+			finished++;
+			constructionTime = std::max(constructionTime, game->finishTime);
+		}
+		if (game->getNChilds() > 0)
+			txPower += Core::dbmToW(game->highestTxPower);
+
+		int d = getDepth(bus, gid, i, depth, state);
+		if (d > 0)
+		{
+			connected++;
+			depthSum += d;
+			maxDepth = std::max(maxDepth, d);
+		}
+	}
+
+	double buildSeconds = std::chrono::duration<double>(wallBuilt - wallStart).count();
+	double runSeconds = std::chrono::duration<double>(wallEnd - wallBuilt).count();
+
+	std::cout << "NODES:\t\t\t" << nodes << " on " << size << "m x " << size << "m" << std::endl;
+	std::cout << "LINKS:\t\t\t" << bus.getNLinks() << " (" << (double)bus.getNLinks() / nodes << " per node)" << std::endl;
+	std::cout << "EVENTS:\t\t\t" << nEvents << std::endl;
+	std::cout << "FRAMES:\t\t\t" << bus.getNFrames() << std::endl;
+	std::cout << "RECEPTIONS:\t\t" << bus.getNReceptions() << std::endl;
+	std::cout << "CONNECTED:\t\t" << connected << "/" << (nodes - 1) << " (" << reachable << " reachable)" << std::endl;
+	std::cout << "FINISHED:\t\t" << finished << "/" << nodes << std::endl;
+	std::cout << "TREE DEPTH:\t\tmax " << maxDepth << ", mean " << (connected > 0 ? depthSum / connected : 0) << std::endl;
+	std::cout << "TOTAL TX POWER:\t\t" << txPower << "W" << std::endl;
+	std::cout << "CONSTRUCTION TIME:\t" << constructionTime / 1e9 << "s (simulated)" << std::endl;
+	std::cout << "LAST EVENT:\t\t" << bus.now() / 1e9 << "s (simulated)" << std::endl;
+	std::cout << "WALL TIME:\t\t" << buildSeconds << "s links, " << runSeconds << "s events (" << (runSeconds > 0 ? bus.getNReceptions() / runSeconds : 0) << " receptions/s)" << std::endl;
+	return 0;
+}
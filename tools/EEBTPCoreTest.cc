@@ -0,0 +1,149 @@
+/*
+ * EEBTPCoreTest.cc
+ *
+ *  Created on: 19.10.2026
+ *
+ *  Convergence test of the protocol core on the in-memory bus. Every cycle
+ *  prevention variant builds trees on random networks (placed like in
+ *  eebtp-core-sim); a run passes if the bus runs empty within the time
+ *  limit, every node that can reach the initiator over links is connected
+ *  to it and all of them have finished the game.
+ *
+ *  Usage: eebtp-core-test [--nodes=200] [--seeds=5] [--until=600]
+ *  	Returns 0 if all runs passed, 1 otherwise
+ */
+
+#include "cmath"
+#include "random"
+#include "string"
+#include "cstdlib"
+#include "iostream"
+
+#include "EEBTPCoreBus.h"
+
+using namespace eebtp;
+
+static const char *VARIANT_NAMES[N_VARIANTS] = {"CYCLE_TEST_ASYNC", "MUTEX", "PATH_TO_SRC"};
+
+//Follows the parents of a node, true if the initiator is reached without a cycle
+static bool isConnected(Bus &bus, uint64_t gid, uint32_t node)
+{
+	uint32_t current = node;
+	for (uint32_t hops = 0; hops <= bus.getNNodes(); hops++)
+	{
+		Game *game = bus.getCore(current)->getGame(gid);
+		if (game->initiator)
+			return true;
+		if (game->parent == 0)
+			return false;
+		current = Bus::getIndex(game->parent->address);
+	}
+	return false;
+}
+
+//Returns the number of errors of one run
+static uint32_t runTest(uint8_t variant, uint32_t nodes, uint64_t seed, double until)
+{
+	double size = 501.0 * std::sqrt(nodes / 100.0);
+
+	Bus bus(Bus::Parameters(), Config(), variant);
+	std::mt19937_64 random(seed);
+	std::uniform_int_distribution<int64_t> position(0, (int64_t)size - 1);
+	for (uint32_t i = 0; i < nodes; i++)
+	{
+		double x = position(random);
+		double y = position(random);
+		bus.addNode(x, y);
+	}
+	bus.build();
+
+	uint64_t gid = Bus::getAddress(0);
+	Core *initiator = bus.getCore(0);
+	initiator->send(initiator->initGame(gid), NEIGHBOR_DISCOVERY, BROADCAST, 20.0);
+
+	//Run until no frame or timer is left
+	int64_t end = (int64_t)(until * 1e9);
+	bool quiet = false;
+	for (int64_t t = 0; t < end && !quiet; )
+	{
+		t = std::min(end, t + 100000000);
+		quiet = (bus.run(t) == 0);
+	}
+
+	std::vector<bool> reachable = bus.getReachable(0);
+	uint32_t nReachable = 0, nConnected = 0, nFinished = 0, errors = 0;
+	for (uint32_t i = 1; i < nodes; i++)
+	{
+		if (!reachable[i])
+			continue;
+		nReachable++;
+
+		Game *game = bus.getCore(i)->getGame(gid);
+		if (isConnected(bus, gid, i))
+			nConnected++;
+		if (game->finished)
+			nFinished++;
+	}
+
+	if (!quiet)
+		errors++;
+	if (nConnected != nReachable)
+		errors++;
+	if (nFinished != nReachable)
+		errors++;
+
+	std::cout << (errors == 0 ? "PASS" : "FAIL") << "\t" << VARIANT_NAMES[variant] << "\tnodes " << nodes << "\tseed " << seed
+			<< "\tconnected " << nConnected << "/" << nReachable << "\tfinished " << nFinished << "/" << nReachable
+			<< "\tlast event " << bus.now() / 1e9 << "s" << (quiet ? "" : " (still running)") << std::endl;
+	return errors;
+}
+
+int main(int argc, char *argv[])
+{
+	uint32_t nodes = 200;
+	uint32_t seeds = 5;
+	double until = 600;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		std::string::size_type eq = arg.find('=');
+		std::string name = arg.substr(0, eq);
+		std::string value = (eq == std::string::npos) ? "" : arg.substr(eq + 1);
+
+		if (name == "--nodes")
+			nodes = std::strtoul(value.c_str(), 0, 10);
+		else if (name == "--seeds")
+			seeds = std::strtoul(value.c_str(), 0, 10);
+		else if (name == "--until")
+			until = std::strtod(value.c_str(), 0);
+		else
+		{
+			std::cerr << "Usage: " << argv[0] << " [--nodes=200] [--seeds=5] [--until=600]" << std::endl;
+			return 1;
+		}
+	}
+	if (nodes == 0)
+	{
+		std::cerr << "At least one node is needed" << std::endl;
+		return 1;
+	}
+
+	uint32_t failed = 0;
+	for (uint8_t variant = 0; variant < N_VARIANTS; variant++)
+	{
+		for (uint64_t seed = 1; seed <= seeds; seed++)
+		{
+			if (runTest(variant, nodes, seed, until) > 0)
+				failed++;
+		}
+	}
+
+	if (failed > 0)
+	{
+		std::cout << failed << " of " << (N_VARIANTS * seeds) << " runs failed" << std::endl;
+		return 1;
+	}
+	std::cout << "All " << (N_VARIANTS * seeds) << " runs passed" << std::endl;
+	return 0;
+}
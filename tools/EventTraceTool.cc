@@ -0,0 +1,169 @@
+/*
+ * EventTraceTool.cc
+ *
+ *  Created on: 19.10.2026
+ *
+ *  Decodes event traces (see EEBTPEventTrace.h), without ns-3.
+ *  	- Prints one tab separated line per record: time in ns, node, event,
+ *  		frame type, peer, seqNo, TX and RX power in dBm
+ *  	- '--node', '--event' (name or number), '--frameType' (number), '--from'
+ *  		and '--to' (ns) filter the records
+ *  	- '--summary' prints the number of records per event and frame type
+ *  		instead of the records
+ *
+ *  Usage: event-trace-tool <file> [--node=<n>] [--event=<e>] [--frameType=<ft>] [--from=<ns>] [--to=<ns>] [--summary]
+ */
+
+#include "cerrno"
+#include "cstdio"
+#include "cstdlib"
+#include "cstring"
+#include "string"
+#include "vector"
+#include "iostream"
+
+#include "EEBTPEventTrace.h"
+
+using namespace ns3;
+
+static const char *FRAME_TYPE_NAMES[8] = {"CYCLE_CHECK", "NEIGHBOR_DISCOVERY", "CHILD_REQUEST", "CHILD_CONFIRMATION", "CHILD_REJECTION", "PARENT_REVOCATION", "END_OF_GAME", "APPLICATION_DATA"};
+
+static std::string getFrameTypeName(uint8_t ft)
+{
+	if (ft == EEBTPEventTrace::NO_FRAME)
+		return "-";
+	//The highest bit marks receiving problems
+	std::string name = ((ft & 0x7f) < 8) ? FRAME_TYPE_NAMES[ft & 0x7f] : std::to_string(ft & 0x7f);
+	return (ft & 0x80) ? name + "*" : name;
+}
+
+static std::string getAddressString(uint64_t address)
+{
+	if (address == EEBTPEventTrace::BROADCAST)
+		return "ff:ff:ff:ff:ff:ff";
+
+	char str[18];
+	std::snprintf(str, sizeof(str), "%02x:%02x:%02x:%02x:%02x:%02x", (unsigned)(address >> 40) & 0xff, (unsigned)(address >> 32) & 0xff,
+				  (unsigned)(address >> 24) & 0xff, (unsigned)(address >> 16) & 0xff, (unsigned)(address >> 8) & 0xff, (unsigned)address & 0xff);
+	return str;
+}
+
+static int parseEvent(std::string value)
+{
+	for (int e = 0; e < EEBTPEventTrace::N_EVENTS; e++)
+	{
+		if (value == EEBTPEventTrace::getEventName(e))
+			return e;
+	}
+	return std::atoi(value.c_str());
+}
+
+int main(int argc, char *argv[])
+{
+	std::string fileName;
+	int64_t node = -1, event = -1, frameType = -1;
+	int64_t from = INT64_MIN, to = INT64_MAX;
+	bool summary = false, usage = false;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		std::string::size_type eq = arg.find('=');
+		std::string name = arg.substr(0, eq);
+		std::string value = (eq == std::string::npos) ? "" : arg.substr(eq + 1);
+
+		if (name == "--node")
+			node = std::strtoll(value.c_str(), 0, 10);
+		else if (name == "--event")
+			event = parseEvent(value);
+		else if (name == "--frameType")
+			frameType = std::strtoll(value.c_str(), 0, 10);
+		else if (name == "--from")
+			from = std::strtoll(value.c_str(), 0, 10);
+		else if (name == "--to")
+			to = std::strtoll(value.c_str(), 0, 10);
+		else if (name == "--summary")
+			summary = true;
+		else if (fileName.empty() && arg.compare(0, 2, "--") != 0)
+			fileName = arg;
+		else
+			usage = true;
+	}
+
+	if (usage || fileName.empty())
+	{
+		std::cerr << "Usage: " << argv[0] << " <file> [--node=<n>] [--event=<e>] [--frameType=<ft>] [--from=<ns>] [--to=<ns>] [--summary]" << std::endl;
+		return 1;
+	}
+
+	FILE *in = std::fopen(fileName.c_str(), "rb");
+	if (in == 0)
+	{
+		std::cerr << "Cannot open " << fileName << ": " << std::strerror(errno) << std::endl;
+		return 1;
+	}
+
+	char magic[8];
+	uint32_t recordSize = 0, nEvents = 0;
+	uint64_t overwritten = 0;
+	if (std::fread(magic, 8, 1, in) != 1 || std::memcmp(magic, "EEBTPET1", 8) != 0 || std::fread(&recordSize, 4, 1, in) != 1 ||
+		std::fread(&nEvents, 4, 1, in) != 1 || std::fread(&overwritten, 8, 1, in) != 1)
+	{
+		std::cerr << fileName << " is no event trace" << std::endl;
+		std::fclose(in);
+		return 1;
+	}
+	if (recordSize != sizeof(EEBTPEventTrace::Record))
+	{
+		std::cerr << fileName << " has records of " << recordSize << " bytes, expected " << sizeof(EEBTPEventTrace::Record) << std::endl;
+		std::fclose(in);
+		return 1;
+	}
+
+	uint64_t nRecords = 0, nSelected = 0;
+	std::vector<uint64_t> perEvent(EEBTPEventTrace::N_EVENTS + 1, 0);
+	std::vector<std::vector<uint64_t>> perFrameType(EEBTPEventTrace::N_EVENTS + 1, std::vector<uint64_t>(9, 0));
+
+	std::vector<EEBTPEventTrace::Record> block(65536);
+	size_t n;
+	while ((n = std::fread(block.data(), sizeof(EEBTPEventTrace::Record), block.size(), in)) > 0)
+	{
+		for (size_t i = 0; i < n; i++)
+		{
+			const EEBTPEventTrace::Record &r = block[i];
+			nRecords++;
+			if ((node >= 0 && r.node != node) || (event >= 0 && r.event != event) || (frameType >= 0 && (r.frameType & 0x7f) != frameType) || r.time < from || r.time > to)
+				continue;
+			nSelected++;
+
+			if (summary)
+			{
+				uint32_t e = (r.event < EEBTPEventTrace::N_EVENTS) ? r.event : (uint32_t)EEBTPEventTrace::N_EVENTS;
+				perEvent[e]++;
+				perFrameType[e][(r.frameType & 0x7f) < 8 ? (r.frameType & 0x7f) : 8]++;
+				continue;
+			}
+
+			std::printf("%lld\t%u\t%s\t%s\t%s\t%u\t%.2f\t%.2f\n", (long long)r.time, r.node, EEBTPEventTrace::getEventName(r.event), getFrameTypeName(r.frameType).c_str(),
+						getAddressString(r.peer).c_str(), r.seqNo, r.txPower, r.rxPower);
+		}
+	}
+	std::fclose(in);
+
+	if (summary)
+	{
+		std::cout << "RECORDS:\t" << nRecords << " (" << nSelected << " selected, " << overwritten << " overwritten)" << std::endl;
+		for (uint32_t e = 0; e <= EEBTPEventTrace::N_EVENTS; e++)
+		{
+			if (perEvent[e] == 0)
+				continue;
+			std::cout << EEBTPEventTrace::getEventName(e) << ":\t" << perEvent[e] << std::endl;
+			for (uint32_t ft = 0; ft < 8; ft++)
+			{
+				if (perFrameType[e][ft] > 0 && (e == EEBTPEventTrace::FRAME_SENT || e == EEBTPEventTrace::FRAME_RECEIVED))
+					std::cout << "\t" << FRAME_TYPE_NAMES[ft] << ":\t" << perFrameType[e][ft] << std::endl;
+			}
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,153 @@
+/*
+ * ScenarioTool.cc
+ *
+ *  Created on: 19.10.2026
+ *
+ *  Converts, generates and inspects scenario files (see ScenarioFile.h),
+ *  without ns-3.
+ *  	- '--in=<file>' loads a text or binary scenario, '--out=<file>' writes it
+ *  		as binary scenario
+ *  	- '--generate=<n>' places n nodes like brdcstTest (random integer
+ *  		positions in a square of '--size' meters, node 0 is the initiator)
+ *  	- '--links=<maxLoss>' adds the log-distance loss (same parameters as
+ *  		the LogDistancePropagationLossModel) of all pairs up to maxLoss dB
+ *
+ *  Usage: scenario-tool (--in=<file> | --generate=<n> [--size=501] [--seed=1001]) [--links=<maxLoss>] [--out=<file>]
+ */
+
+#include "cmath"
+#include "chrono"
+#include "random"
+#include "string"
+#include "cstdlib"
+#include "iostream"
+#include "unordered_map"
+
+#include "ScenarioFile.h"
+
+using namespace ns3;
+
+//Log-distance loss of the LogDistancePropagationLossModel (exponent 3, 46.6777 dB at 1 m)
+static double getLoss(const ScenarioFile::Node &a, const ScenarioFile::Node &b)
+{
+	double distance = std::sqrt((a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y) + (a.z - b.z) * (a.z - b.z));
+	if (distance <= 1.0)
+		return 46.6777;
+	return 46.6777 + 30.0 * std::log10(distance);
+}
+
+//Adds all links up to 'maxLoss', the nodes are sorted into cells as wide as the range
+static void addLinks(ScenarioFile &scenario, double maxLoss)
+{
+	double range = std::max(1.0, std::pow(10.0, (maxLoss - 46.6777) / 30.0));
+
+	std::unordered_map<int64_t, std::vector<uint32_t>> cells;
+	for (uint32_t i = 0; i < scenario.getNNodes(); i++)
+	{
+		const ScenarioFile::Node &node = scenario.getNode(i);
+		cells[((int64_t)std::floor(node.x / range) << 32) ^ (uint32_t)std::floor(node.y / range)].push_back(i);
+	}
+
+	for (uint32_t i = 0; i < scenario.getNNodes(); i++)
+	{
+		ScenarioFile::Node node = scenario.getNode(i);
+		int64_t cx = std::floor(node.x / range), cy = std::floor(node.y / range);
+		for (int64_t dx = -1; dx <= 1; dx++)
+		{
+			for (int64_t dy = -1; dy <= 1; dy++)
+			{
+				std::unordered_map<int64_t, std::vector<uint32_t>>::iterator it = cells.find(((cx + dx) << 32) ^ (uint32_t)(cy + dy));
+				if (it == cells.end())
+					continue;
+
+				for (uint32_t j : it->second)
+				{
+					if (i == j)
+						continue;
+					double loss = getLoss(node, scenario.getNode(j));
+					if (loss <= maxLoss)
+						scenario.addLink(i, j, loss);
+				}
+			}
+		}
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	std::string in, out;
+	uint32_t generate = 0;
+	double size = 501.0;
+	uint64_t seed = 1001;
+	double maxLoss = 0;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		std::string::size_type eq = arg.find('=');
+		std::string name = arg.substr(0, eq);
+		std::string value = (eq == std::string::npos) ? "" : arg.substr(eq + 1);
+
+		if (name == "--in")
+			in = value;
+		else if (name == "--out")
+			out = value;
+		else if (name == "--generate")
+			generate = std::strtoul(value.c_str(), 0, 10);
+		else if (name == "--size")
+			size = std::strtod(value.c_str(), 0);
+		else if (name == "--seed")
+			seed = std::strtoull(value.c_str(), 0, 10);
+		else if (name == "--links")
+			maxLoss = std::strtod(value.c_str(), 0);
+		else
+		{
+			std::cerr << "Usage: " << argv[0] << " (--in=<file> | --generate=<n> [--size=501] [--seed=1001]) [--links=<maxLoss>] [--out=<file>]" << std::endl;
+			return 1;
+		}
+	}
+
+	ScenarioFile scenario;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	if (!in.empty())
+	{
+		if (!scenario.load(in))
+		{
+			std::cerr << scenario.getError() << std::endl;
+			return 1;
+		}
+	}
+	else if (generate > 0)
+	{
+		std::mt19937_64 random(seed);
+		std::uniform_int_distribution<int> x(0, size - 1);
+		scenario.setSize(size, size);
+		scenario.setInitiator(0);
+		for (uint32_t i = 0; i < generate; i++)
+		{
+			double px = x(random);
+			scenario.addNode(px, x(random), 0, 0);
+		}
+	}
+	else
+	{
+		std::cerr << "Either --in or --generate is needed" << std::endl;
+		return 1;
+	}
+	double loadTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	if (maxLoss > 0)
+		addLinks(scenario, maxLoss);
+
+	std::cout << "NODES:\t\t" << scenario.getNNodes() << " on " << scenario.getWidth() << "m x " << scenario.getHeight() << "m" << std::endl;
+	std::cout << "INITIATOR:\t" << scenario.getInitiator() << std::endl;
+	std::cout << "LINKS:\t\t" << scenario.getNLinks() << std::endl;
+	std::cout << "LOAD TIME:\t" << loadTime << "s (" << (scenario.isMapped() ? "mapped" : "built") << ")" << std::endl;
+
+	if (!out.empty() && !scenario.save(out))
+	{
+		std::cerr << scenario.getError() << std::endl;
+		return 1;
+	}
+	return 0;
+}